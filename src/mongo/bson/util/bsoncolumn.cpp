@@ -0,0 +1,470 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/util/bsoncolumn.h"
+
+#include <cmath>
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+using namespace bsoncolumn;
+
+namespace {
+
+constexpr double kPow10[kMaxDoubleScale + 1] = {1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8};
+
+// Doubles are only scaled to integers that they can represent exactly.
+constexpr double kMaxExactDoubleInteger = 9007199254740992.0;  // 2^53
+
+bool isPackable(BSONType type) {
+    switch (type) {
+        case NumberInt:
+        case NumberLong:
+        case NumberDouble:
+        case Date:
+        case bsonTimestamp:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool scaleDouble(double value, int scale, uint64_t* out) {
+    if (!std::isfinite(value) || (value == 0 && std::signbit(value))) {
+        return false;
+    }
+
+    const double scaled = value * kPow10[scale];
+    if (std::abs(scaled) > kMaxExactDoubleInteger || scaled != std::trunc(scaled)) {
+        return false;
+    }
+
+    const auto integer = static_cast<int64_t>(scaled);
+    if (static_cast<double>(integer) / kPow10[scale] != value) {
+        return false;
+    }
+
+    *out = static_cast<uint64_t>(integer);
+    return true;
+}
+
+/**
+ * Returns the integer representation of a packable value used for computing differences, where
+ * doubles are multiplied by 10^scale. Returns false if a double cannot be represented exactly.
+ */
+bool toPackedInteger(const BSONElement& elem, int scale, uint64_t* out) {
+    switch (elem.type()) {
+        case NumberInt:
+            *out = static_cast<uint64_t>(static_cast<int64_t>(elem._numberInt()));
+            return true;
+        case NumberLong:
+            *out = static_cast<uint64_t>(elem._numberLong());
+            return true;
+        case Date:
+            *out = static_cast<uint64_t>(elem.date().toMillisSinceEpoch());
+            return true;
+        case bsonTimestamp:
+            *out = elem.timestamp().asULL();
+            return true;
+        case NumberDouble:
+            return scaleDouble(elem._numberDouble(), scale, out);
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+/**
+ * Returns the smallest scale at which 'elem' has an exact integer representation, or -1 if there
+ * is none.
+ */
+int minimumScale(const BSONElement& elem) {
+    if (elem.type() != NumberDouble) {
+        return 0;
+    }
+
+    uint64_t unused;
+    for (int scale = 0; scale <= kMaxDoubleScale; ++scale) {
+        if (scaleDouble(elem._numberDouble(), scale, &unused)) {
+            return scale;
+        }
+    }
+    return -1;
+}
+
+void writeScratch(char* scratch, BSONType type, uint64_t value, int scale) {
+    scratch[0] = type;
+    scratch[1] = '\0';
+    DataView view(scratch + 2);
+    switch (type) {
+        case NumberInt:
+            view.write<LittleEndian<int32_t>>(static_cast<int32_t>(static_cast<int64_t>(value)));
+            return;
+        case NumberLong:
+        case Date:
+            view.write<LittleEndian<int64_t>>(static_cast<int64_t>(value));
+            return;
+        case bsonTimestamp:
+            view.write<LittleEndian<uint64_t>>(value);
+            return;
+        case NumberDouble:
+            view.write<LittleEndian<double>>(static_cast<double>(static_cast<int64_t>(value)) /
+                                             kPow10[scale]);
+            return;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+uint64_t zigzagEncode(uint64_t value) {
+    const auto signedValue = static_cast<int64_t>(value);
+    return (value << 1) ^ static_cast<uint64_t>(signedValue >> 63);
+}
+
+uint64_t zigzagDecode(uint64_t value) {
+    return (value >> 1) ^ (~(value & 1) + 1);
+}
+
+int bitWidth(uint64_t value) {
+    return 64 - countLeadingZeros64(value);
+}
+
+void appendVarUInt(BufBuilder* out, uint64_t value) {
+    while (value >= 0x80) {
+        out->appendChar(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out->appendChar(static_cast<char>(value));
+}
+
+uint64_t readVarUInt(const char*& pos, const char* end) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uassert(5716250, "Truncated BSON column", pos < end);
+        const auto byte = static_cast<uint8_t>(*pos++);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    uasserted(5716251, "Invalid count in BSON column");
+}
+
+uint8_t readByte(const char*& pos, const char* end) {
+    uassert(5716252, "Truncated BSON column", pos < end);
+    return static_cast<uint8_t>(*pos++);
+}
+
+/**
+ * Appends the low 'width' bits of each value, least significant bit first.
+ */
+void appendBitPacked(BufBuilder* out, const uint64_t* values, size_t count, int width) {
+    uint64_t word = 0;
+    int wordBits = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t value = values[i];
+        int remaining = width;
+        while (remaining > 0) {
+            const int take = std::min(remaining, 64 - wordBits);
+            const uint64_t bits = take == 64 ? value : value & ((uint64_t{1} << take) - 1);
+            word |= bits << wordBits;
+            wordBits += take;
+            remaining -= take;
+            value = take == 64 ? 0 : value >> take;
+            if (wordBits == 64) {
+                out->appendNum(static_cast<long long>(word));
+                word = 0;
+                wordBits = 0;
+            }
+        }
+    }
+    for (; wordBits > 0; wordBits -= 8) {
+        out->appendChar(static_cast<char>(word & 0xff));
+        word >>= 8;
+    }
+}
+
+uint64_t readBitPacked(const char* data, size_t bitOffset, int width) {
+    uint64_t value = 0;
+    int read = 0;
+    while (read < width) {
+        const auto byte = static_cast<uint8_t>(data[bitOffset / 8]);
+        const int shift = bitOffset % 8;
+        const int take = std::min(8 - shift, width - read);
+        value |= static_cast<uint64_t>((byte >> shift) & ((1 << take) - 1)) << read;
+        read += take;
+        bitOffset += take;
+    }
+    return value;
+}
+
+}  // namespace
+
+BSONBinData BSONColumnBuilder::finalize() {
+    _buffer.reset();
+    _buffer.appendChar(static_cast<char>(kFormatVersion));
+    appendVarUInt(&_buffer, _values.size());
+
+    BSONElement previous;
+    _previousDelta = 0;
+
+    size_t i = 0;
+    while (i < _values.size()) {
+        const BSONElement& value = _values[i];
+        if (!value) {
+            size_t end = i + 1;
+            while (end < _values.size() && !_values[end]) {
+                ++end;
+            }
+            _buffer.appendChar(static_cast<char>(Control::kSkip));
+            appendVarUInt(&_buffer, end - i);
+            i = end;
+            continue;
+        }
+
+        if (previous && previous.type() == value.type() && isPackable(value.type())) {
+            // Doubles in a kPacked operation share a scale, so it may only grow as long as the
+            // previous value and all of the values before it can still be represented.
+            int scale = minimumScale(previous);
+            size_t end = i;
+            while (end < _values.size() && end - i < kMaxPackedCount && _values[end] &&
+                   _values[end].type() == value.type()) {
+                if (value.type() == NumberDouble) {
+                    const int newScale = std::max(scale, minimumScale(_values[end]));
+                    uint64_t unused;
+                    auto representable = [&](const BSONElement& elem) {
+                        return scaleDouble(elem._numberDouble(), newScale, &unused);
+                    };
+                    if (minimumScale(_values[end]) < 0 || !representable(_values[end]) ||
+                        (newScale != scale &&
+                         (!representable(previous) ||
+                          !std::all_of(
+                              _values.begin() + i, _values.begin() + end, representable)))) {
+                        break;
+                    }
+                    scale = newScale;
+                }
+                ++end;
+            }
+
+            if (end > i) {
+                _appendPacked(previous, i, end, scale);
+                previous = _values[end - 1];
+                i = end;
+                continue;
+            }
+        }
+
+        if (previous && value.binaryEqualValues(previous)) {
+            size_t end = i + 1;
+            while (end < _values.size() && _values[end] &&
+                   _values[end].binaryEqualValues(previous)) {
+                ++end;
+            }
+            _buffer.appendChar(static_cast<char>(Control::kRepeat));
+            appendVarUInt(&_buffer, end - i);
+            _previousDelta = 0;
+            i = end;
+            continue;
+        }
+
+        _buffer.appendChar(static_cast<char>(Control::kLiteral));
+        _buffer.appendChar(static_cast<char>(value.type()));
+        _buffer.appendChar('\0');
+        _buffer.appendBuf(value.value(), value.valuesize());
+        previous = value;
+        _previousDelta = 0;
+        ++i;
+    }
+
+    return BSONBinData(_buffer.buf(), _buffer.len(), BinDataGeneral);
+}
+
+void BSONColumnBuilder::_appendPacked(const BSONElement& previous,
+                                      size_t begin,
+                                      size_t end,
+                                      int scale) {
+    uint64_t deltas[kMaxPackedCount];
+    uint64_t deltasOfDeltas[kMaxPackedCount];
+    uint64_t deltaBits = 0;
+    uint64_t deltaOfDeltaBits = 0;
+
+    uint64_t previousInt;
+    invariant(toPackedInteger(previous, scale, &previousInt));
+    for (size_t i = begin; i < end; ++i) {
+        uint64_t current;
+        invariant(toPackedInteger(_values[i], scale, &current));
+
+        // Differences wrap around, which the decoder undoes with the same unsigned arithmetic.
+        const uint64_t delta = current - previousInt;
+        deltas[i - begin] = zigzagEncode(delta);
+        deltasOfDeltas[i - begin] = zigzagEncode(delta - _previousDelta);
+        deltaBits |= deltas[i - begin];
+        deltaOfDeltaBits |= deltasOfDeltas[i - begin];
+
+        previousInt = current;
+        _previousDelta = delta;
+    }
+
+    const bool useDeltaOfDelta = bitWidth(deltaOfDeltaBits) < bitWidth(deltaBits);
+    const int width = bitWidth(useDeltaOfDelta ? deltaOfDeltaBits : deltaBits);
+
+    _buffer.appendChar(static_cast<char>(Control::kPacked));
+    _buffer.appendChar(
+        static_cast<char>(useDeltaOfDelta ? PackedMode::kDeltaOfDelta : PackedMode::kDelta));
+    _buffer.appendChar(static_cast<char>(scale));
+    _buffer.appendChar(static_cast<char>(width));
+    appendVarUInt(&_buffer, end - begin);
+    appendBitPacked(&_buffer, useDeltaOfDelta ? deltasOfDeltas : deltas, end - begin, width);
+}
+
+BSONColumn::BSONColumn(const char* data, int size) : _begin(data), _end(data + size) {
+    uassert(5716253,
+            "Unsupported BSON column format version",
+            readByte(_begin, _end) == kFormatVersion);
+    _size = readVarUInt(_begin, _end);
+}
+
+BSONColumn::BSONColumn(const BSONElement& binData) {
+    uassert(5716254,
+            str::stream() << "Expected a BinData column but found " << typeName(binData.type()),
+            binData.type() == BinData);
+    int size;
+    const char* data = binData.binData(size);
+    *this = BSONColumn(data, size);
+}
+
+BSONElement BSONColumn::Iterator::next() {
+    uassert(5716255, "Read past the end of a BSON column", more());
+    while (_remaining == 0) {
+        _readOperation();
+    }
+
+    --_remaining;
+    ++_index;
+    switch (_control) {
+        case Control::kSkip:
+            return BSONElement();
+        case Control::kLiteral:
+        case Control::kRepeat:
+            return _previous();
+        case Control::kPacked:
+            return _nextPacked();
+    }
+    MONGO_UNREACHABLE;
+}
+
+void BSONColumn::Iterator::_readOperation() {
+    const auto control = static_cast<Control>(readByte(_pos, _end));
+    switch (control) {
+        case Control::kLiteral: {
+            uassert(5716256,
+                    "Invalid literal in BSON column",
+                    _end - _pos >= 2 && _pos[0] != EOO && _pos[1] == '\0');
+            BSONElement literal(_pos);
+            uassert(5716257, "Truncated BSON column", literal.size() <= _end - _pos);
+            _previousLiteral = _pos;
+            _previousInScratch = false;
+            _previousDelta = 0;
+            _pos += literal.size();
+            _remaining = 1;
+            break;
+        }
+        case Control::kSkip:
+            _remaining = readVarUInt(_pos, _end);
+            break;
+        case Control::kRepeat:
+            uassert(5716258, "Repeat without a value in BSON column", _previous());
+            _remaining = readVarUInt(_pos, _end);
+            _previousDelta = 0;
+            break;
+        case Control::kPacked: {
+            _mode = static_cast<PackedMode>(readByte(_pos, _end));
+            _scale = readByte(_pos, _end);
+            _bitWidth = readByte(_pos, _end);
+            _remaining = readVarUInt(_pos, _end);
+
+            auto previous = _previous();
+            uassert(5716259,
+                    "Invalid packed values in BSON column",
+                    (_mode == PackedMode::kDelta || _mode == PackedMode::kDeltaOfDelta) &&
+                        _scale <= kMaxDoubleScale && _bitWidth <= 64 &&
+                        _remaining <= kMaxPackedCount && previous &&
+                        isPackable(previous.type()) &&
+                        toPackedInteger(previous, _scale, &_previousInt));
+
+            const uint64_t bytes = (_remaining * _bitWidth + 7) / 8;
+            uassert(5716260, "Truncated BSON column", bytes <= static_cast<uint64_t>(_end - _pos));
+            _packedType = previous.type();
+            _packed = _pos;
+            _bitOffset = 0;
+            _pos += bytes;
+            break;
+        }
+        default:
+            uasserted(5716261,
+                      str::stream() << "Invalid control byte in BSON column: "
+                                    << static_cast<int>(control));
+    }
+
+    _control = control;
+    uassert(5716262, "BSON column has more values than expected", _remaining <= _size - _index);
+}
+
+BSONElement BSONColumn::Iterator::_previous() const {
+    if (_previousInScratch) {
+        return BSONElement(_scratch);
+    }
+    return _previousLiteral ? BSONElement(_previousLiteral) : BSONElement();
+}
+
+BSONElement BSONColumn::Iterator::_nextPacked() {
+    uint64_t value = _bitWidth ? zigzagDecode(readBitPacked(_packed, _bitOffset, _bitWidth)) : 0;
+    _bitOffset += _bitWidth;
+
+    if (_mode == PackedMode::kDeltaOfDelta) {
+        value += _previousDelta;
+    }
+    _previousDelta = value;
+    _previousInt += value;
+
+    writeScratch(_scratch, _packedType, _previousInt, _scale);
+    _previousInScratch = true;
+    return BSONElement(_scratch);
+}
+
+}  // namespace mongo
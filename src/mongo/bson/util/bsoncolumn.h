@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/util/builder.h"
+
+namespace mongo {
+
+/**
+ * Binary encoding of a column of BSON values, such as the values of one field across all of the
+ * measurements in a time-series bucket, where values may be missing. The encoding starts with a
+ * format version byte and the number of values in the column as an unsigned LEB128 varint,
+ * followed by a sequence of operations, each introduced by a control byte:
+ *
+ *   kLiteral   The value, stored as a BSONElement with an empty field name.
+ *   kSkip      A varint count of values that are missing.
+ *   kRepeat    A varint count of values equal to the previous value.
+ *   kPacked    A mode byte, a scale byte, a bit width byte and a varint count, followed by that
+ *              many bit-packed, zigzag-encoded integers. In kDelta mode each integer is the
+ *              difference from the previous value and in kDeltaOfDelta mode it is the difference
+ *              from the previous difference. Only used for values of the same numeric, Date or
+ *              Timestamp type as the previous value; doubles are multiplied by 10^scale to make
+ *              them integral.
+ *
+ * The previous value persists across skipped values, and the previous difference is reset to zero
+ * by every kLiteral and kRepeat operation.
+ */
+namespace bsoncolumn {
+constexpr uint8_t kFormatVersion = 1;
+
+enum class Control : uint8_t { kLiteral = 1, kSkip = 2, kRepeat = 3, kPacked = 4 };
+enum class PackedMode : uint8_t { kDelta = 0, kDeltaOfDelta = 1 };
+
+// The largest number of values in one kPacked operation, so that an outlier only widens the bit
+// width of the values around it.
+constexpr size_t kMaxPackedCount = 64;
+
+// Doubles are only scaled by powers of ten that are exactly representable.
+constexpr int kMaxDoubleScale = 8;
+}  // namespace bsoncolumn
+
+/**
+ * Builds the binary encoding of a column. The appended elements are referenced rather than copied,
+ * so their backing buffers must outlive the call to finalize().
+ */
+class BSONColumnBuilder {
+public:
+    /**
+     * Appends 'elem' as the next value of the column. An EOO element appends a missing value.
+     */
+    void append(const BSONElement& elem) {
+        _values.push_back(elem);
+    }
+
+    /**
+     * Appends a missing value.
+     */
+    void skip() {
+        _values.emplace_back();
+    }
+
+    size_t size() const {
+        return _values.size();
+    }
+
+    /**
+     * Encodes the column. The returned BinData refers to memory owned by this builder, which must
+     * not be appended to afterwards.
+     */
+    BSONBinData finalize();
+
+private:
+    void _appendPacked(const BSONElement& previous, size_t begin, size_t end, int scale);
+
+    std::vector<BSONElement> _values;
+    BufBuilder _buffer;
+
+    // The difference between the last two values encoded by a kPacked operation, or zero.
+    uint64_t _previousDelta = 0;
+};
+
+/**
+ * Read-only view over the binary encoding of a column produced by BSONColumnBuilder. The memory it
+ * refers to must outlive the view and any of its iterators.
+ */
+class BSONColumn {
+public:
+    /**
+     * Iterates the values of a column in order, decoding them as it goes. Each value is returned
+     * as a BSONElement with an empty field name, or EOO if the value is missing. An element is
+     * only valid until the next call to next().
+     */
+    class Iterator {
+    public:
+        bool more() const {
+            return _index < _size;
+        }
+
+        BSONElement next();
+
+    private:
+        friend class BSONColumn;
+
+        Iterator(const char* pos, const char* end, size_t size)
+            : _pos(pos), _end(end), _size(size) {}
+
+        void _readOperation();
+        BSONElement _previous() const;
+        BSONElement _nextPacked();
+
+        const char* _pos;
+        const char* _end;
+        size_t _index = 0;
+        size_t _size;
+
+        // The operation currently being decoded and the number of values it has left.
+        bsoncolumn::Control _control = bsoncolumn::Control::kSkip;
+        size_t _remaining = 0;
+
+        // State of the current kPacked operation.
+        bsoncolumn::PackedMode _mode = bsoncolumn::PackedMode::kDelta;
+        BSONType _packedType = EOO;
+        int _scale = 0;
+        int _bitWidth = 0;
+        const char* _packed = nullptr;
+        size_t _bitOffset = 0;
+        uint64_t _previousInt = 0;
+        uint64_t _previousDelta = 0;
+
+        // The previous value is either a literal in the encoded column or, once a kPacked
+        // operation has produced a value, the element held in '_scratch'. The element is rebuilt
+        // on demand so that iterators can be copied.
+        const char* _previousLiteral = nullptr;
+        bool _previousInScratch = false;
+        char _scratch[2 + sizeof(uint64_t)];
+    };
+
+    BSONColumn(const char* data, int size);
+
+    /**
+     * Constructs a view over the contents of a BinData element. Throws if 'binData' is not one.
+     */
+    explicit BSONColumn(const BSONElement& binData);
+
+    /**
+     * Returns the number of values in the column, including missing ones.
+     */
+    size_t size() const {
+        return _size;
+    }
+
+    Iterator begin() const {
+        return Iterator(_begin, _end, _size);
+    }
+
+private:
+    const char* _begin;
+    const char* _end;
+    size_t _size;
+};
+
+}  // namespace mongo
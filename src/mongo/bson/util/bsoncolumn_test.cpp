@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/util/bsoncolumn.h"
+
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Encodes the values of 'obj', with undefined values standing in for missing ones, and checks that
+ * decoding gives back exactly the same values.
+ */
+BSONBinData assertRoundTrip(const BSONObj& obj, BSONColumnBuilder* builder) {
+    for (auto&& elem : obj) {
+        if (elem.type() == Undefined) {
+            builder->skip();
+        } else {
+            builder->append(elem);
+        }
+    }
+    auto binData = builder->finalize();
+
+    BSONColumn column(static_cast<const char*>(binData.data), binData.length);
+    ASSERT_EQ(column.size(), static_cast<size_t>(obj.nFields()));
+
+    auto it = column.begin();
+    for (auto&& expected : obj) {
+        ASSERT_TRUE(it.more());
+        auto actual = it.next();
+        if (expected.type() == Undefined) {
+            ASSERT_TRUE(actual.eoo()) << expected;
+        } else {
+            ASSERT_TRUE(actual.binaryEqualValues(expected)) << expected << " != " << actual;
+            ASSERT_EQ(actual.fieldNameStringData(), ""_sd);
+        }
+    }
+    ASSERT_FALSE(it.more());
+    return binData;
+}
+
+TEST(BSONColumnTest, Empty) {
+    BSONColumnBuilder builder;
+    assertRoundTrip(BSONObj(), &builder);
+}
+
+TEST(BSONColumnTest, MixedTypes) {
+    BSONColumnBuilder builder;
+    assertRoundTrip(BSON_ARRAY(1 << 2LL << 3.5 << "a"
+                                 << "a" << BSONUndefined << "a" << BSON("x" << 1) << BSON("x" << 1)
+                                 << true << BSONNULL << Date_t::fromMillisSinceEpoch(5)
+                                 << Timestamp(1, 2) << Timestamp(1, 3) << 4 << BSONUndefined),
+                    &builder);
+}
+
+TEST(BSONColumnTest, IntegerExtremes) {
+    BSONColumnBuilder builder;
+    assertRoundTrip(BSON_ARRAY(std::numeric_limits<int>::min()
+                               << std::numeric_limits<int>::max() << 0
+                               << std::numeric_limits<int>::min()
+                               << std::numeric_limits<long long>::max()
+                               << std::numeric_limits<long long>::min() << 0LL
+                               << std::numeric_limits<long long>::max()),
+                    &builder);
+}
+
+TEST(BSONColumnTest, Doubles) {
+    BSONColumnBuilder builder;
+    assertRoundTrip(
+        BSON_ARRAY(21.5 << 21.6 << 21.7 << 0.1 << 110.00000000000001 << 1.1 * 3 << 1e300
+                        << std::numeric_limits<double>::quiet_NaN()
+                        << std::numeric_limits<double>::infinity() << -0.0 << 0.0 << -0.0
+                        << 0.123456789 << -7.25 << BSONUndefined << -7.5),
+        &builder);
+}
+
+TEST(BSONColumnTest, RegularTimestampsArePackedToAFewBits) {
+    BSONArrayBuilder times;
+    for (int i = 0; i < 1000; ++i) {
+        times.append(Date_t::fromMillisSinceEpoch(1600000000000LL + i * 1000));
+    }
+    auto obj = times.arr();
+
+    BSONColumnBuilder builder;
+    auto binData = assertRoundTrip(obj, &builder);
+
+    // The differences between the differences are all zero, so each kPacked operation takes a few
+    // bytes regardless of how many values it holds.
+    ASSERT_LT(binData.length, 200);
+    ASSERT_LT(binData.length * 50, obj.objsize());
+}
+
+TEST(BSONColumnTest, SparseColumn) {
+    BSONArrayBuilder values;
+    for (int i = 0; i < 500; ++i) {
+        if (i % 7 == 0) {
+            values.append(i * i);
+        } else {
+            values.appendUndefined();
+        }
+    }
+
+    BSONColumnBuilder builder;
+    assertRoundTrip(values.arr(), &builder);
+}
+
+TEST(BSONColumnTest, IteratorsCanBeCopied) {
+    BSONColumnBuilder builder;
+    auto binData = assertRoundTrip(BSON_ARRAY(1 << 2 << 3 << 4), &builder);
+    BSONColumn column(static_cast<const char*>(binData.data), binData.length);
+
+    auto it = column.begin();
+    ASSERT_EQ(it.next().numberInt(), 1);
+    ASSERT_EQ(it.next().numberInt(), 2);
+
+    auto copy = it;
+    ASSERT_EQ(it.next().numberInt(), 3);
+    ASSERT_EQ(copy.next().numberInt(), 3);
+    ASSERT_EQ(copy.next().numberInt(), 4);
+}
+
+TEST(BSONColumnTest, RejectsInvalidData) {
+    BSONColumnBuilder builder;
+    auto binData = assertRoundTrip(BSON_ARRAY("a" << 1 << 2 << 3), &builder);
+    const auto* data = static_cast<const char*>(binData.data);
+
+    std::string badVersion(data, binData.length);
+    badVersion[0] = 2;
+    ASSERT_THROWS_CODE(BSONColumn(badVersion.data(), badVersion.size()), DBException, 5716253);
+
+    // Values must not be read past the end of a truncated column.
+    BSONColumn truncated(data, binData.length - 1);
+    auto it = truncated.begin();
+    ASSERT_THROWS(
+        [&] {
+            while (it.more()) {
+                it.next();
+            }
+        }(),
+        DBException);
+
+    ASSERT_THROWS_CODE(BSONColumn(BSON("a" << 1).firstElement()), DBException, 5716254);
+}
+
+}  // namespace
+}  // namespace mongo
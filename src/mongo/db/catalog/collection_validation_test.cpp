@@ -34,6 +34,7 @@
 #include "mongo/db/catalog/catalog_test_fixture.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/fail_point.h"
@@ -266,6 +267,55 @@ TEST_F(CollectionValidationTest, ValidateEnforceFastCount) {
                        {CollectionValidation::ValidateMode::kForegroundFullEnforceFastCount});
 }
 
+// Verify that a columnstore index, which holds several entries per document without being
+// multikey, is not reported as having more entries than there are documents.
+TEST_F(CollectionValidationTest, ValidateColumnStoreIndex) {
+    RAIIServerParameterControllerForTest featureFlag("featureFlagColumnstoreIndexes", true);
+    auto opCtx = operationContext();
+    ASSERT_OK(storageInterface()->createIndexesOnEmptyCollection(
+        opCtx,
+        kNss,
+        {BSON("v" << 2 << "name"
+                  << "a_b_columnstore"
+                  << "key"
+                  << BSON("a"
+                          << "columnstore"
+                          << "b"
+                          << "columnstore"))}));
+
+    {
+        AutoGetCollection coll(opCtx, kNss, MODE_IX);
+        std::vector<InsertStatement> inserts;
+        for (int i = 0; i < 5; ++i) {
+            inserts.push_back(
+                InsertStatement(BSON("_id" << i << "a" << i << "b" << BSON("c" << i))));
+        }
+
+        WriteUnitOfWork wuow(opCtx);
+        ASSERT_OK(coll->insertDocuments(opCtx, inserts.begin(), inserts.end(), nullptr, false));
+        wuow.commit();
+    }
+
+    foregroundValidate(opCtx,
+                       /*valid*/ true,
+                       /*numRecords*/ 5,
+                       /*numInvalidDocuments*/ 0,
+                       /*numErrors*/ 0);
+}
+
+TEST_F(CollectionValidationTest, ColumnStoreIndexRequiresFeatureFlag) {
+    auto opCtx = operationContext();
+    ASSERT_EQ(ErrorCodes::CannotCreateIndex,
+              storageInterface()->createIndexesOnEmptyCollection(
+                  opCtx,
+                  kNss,
+                  {BSON("v" << 2 << "name"
+                            << "a_columnstore"
+                            << "key"
+                            << BSON("a"
+                                    << "columnstore"))}));
+}
+
 /**
  * Waits for a parallel running collection validation operation to start and then hang at a
  * failpoint.
@@ -64,6 +64,7 @@
 #include "mongo/db/query/collection_index_usage_tracker_decoration.h"
 #include "mongo/db/query/collection_query_info.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/query_feature_flags_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl_set_member_in_standalone_mode.h"
 #include "mongo/db/server_options.h"
@@ -648,6 +649,22 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx,
     }
 
     const string pluginName = IndexNames::findPluginName(key);
+
+    // Queries cannot scan a columnstore index yet, so one is only built when the feature flag is
+    // enabled. (Generic FCV reference): Binaries of an earlier version cannot open a columnstore
+    // index, so it may only be created once the FCV is fully upgraded.
+    if (pluginName == IndexNames::COLUMN) {
+        const auto& fcv = serverGlobalParams.featureCompatibility;
+        if (!feature_flags::gFeatureFlagColumnstoreIndexes.isEnabledAndIgnoreFCV() ||
+            (fcv.isVersionInitialized() &&
+             !feature_flags::gFeatureFlagColumnstoreIndexes.isEnabled(fcv))) {
+            return Status(ErrorCodes::CannotCreateIndex,
+                          str::stream() << "Index type '" << pluginName
+                                        << "' requires featureFlagColumnstoreIndexes and a fully "
+                                           "upgraded featureCompatibilityVersion");
+        }
+    }
+
     std::unique_ptr<CollatorInterface> collator;
     BSONElement collationElement = spec.getField("collation");
     if (collationElement) {
@@ -688,7 +705,7 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx,
 
     const bool isSparse = spec["sparse"].trueValue();
 
-    if (pluginName == IndexNames::WILDCARD) {
+    if (pluginName == IndexNames::WILDCARD || pluginName == IndexNames::COLUMN) {
         if (isSparse) {
             return Status(ErrorCodes::CannotCreateIndex,
                           str::stream() << "Index type '" << pluginName
@@ -721,6 +738,13 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx,
                           "cannot mix \"partialFilterExpression\" and \"sparse\" options");
         }
 
+        // A columnstore index must hold an entry for every document in its row id column.
+        if (pluginName == IndexNames::COLUMN) {
+            return Status(ErrorCodes::CannotCreateIndex,
+                          str::stream() << "Index type '" << pluginName
+                                        << "' does not support the partialFilterExpression option");
+        }
+
         if (filterElement.type() != Object) {
             return Status(ErrorCodes::CannotCreateIndex,
                           "\"partialFilterExpression\" for an index must be a document");
@@ -760,6 +784,10 @@ Status IndexCatalogImpl::_isSpecOk(OperationContext* opCtx,
             "Text indexes are not supported on collections clustered by _id",
             !collection->isClustered() || pluginName != IndexNames::TEXT);
 
+    uassert(ErrorCodes::InvalidOptions,
+            "Columnstore indexes are not supported on collections clustered by _id",
+            !collection->isClustered() || pluginName != IndexNames::COLUMN);
+
     if (IndexDescriptor::isIdIndexPattern(key)) {
         if (collection->isClustered()) {
             return Status(ErrorCodes::CannotCreateIndex,
@@ -150,7 +150,7 @@ Status validateKeyPattern(const BSONObj& key, IndexDescriptor::IndexVersion inde
                                           << static_cast<int>(indexVersion)};
                 }
 
-                if (pluginName == IndexNames::WILDCARD) {
+                if (pluginName == IndexNames::WILDCARD || pluginName == IndexNames::COLUMN) {
                     return {code,
                             str::stream() << "'" << pluginName
                                           << "' index plugin is not allowed with index version v:"
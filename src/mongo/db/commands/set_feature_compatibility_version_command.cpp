@@ -35,6 +35,7 @@
 
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/coll_mod.h"
+#include "mongo/db/catalog/collection_catalog_helper.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/drop_collection.h"
@@ -49,6 +50,7 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/index_builds_coordinator.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/persistent_task_store.h"
@@ -285,6 +287,11 @@ void dropReshardingCollectionsOnShard(OperationContext* opCtx) {
                        NamespaceString::kReshardingTxnClonerProgressNamespace,
                        &unusedReply,
                        DropCollectionSystemCollectionMode::kAllowSystemCollectionDrops));
+    uassertStatusOKIgnoreNSNotFound(
+        dropCollection(opCtx,
+                       NamespaceString::kReshardingCollectionClonerRangesNamespace,
+                       &unusedReply,
+                       DropCollectionSystemCollectionMode::kAllowSystemCollectionDrops));
 }
 
 /**
@@ -673,6 +680,27 @@ private:
             });
         }
 
+        // Binaries of an earlier version cannot open columnstore indexes, so they must be dropped
+        // before downgrading.
+        for (const auto& dbName : DatabaseHolder::get(opCtx)->getNames()) {
+            Lock::DBLock dbLock(opCtx, dbName, MODE_IS);
+            catalog::forEachCollectionFromDb(
+                opCtx, dbName, MODE_IS, [&](const CollectionPtr& collection) {
+                    auto it = collection->getIndexCatalog()->getIndexIterator(opCtx, true);
+                    while (it->more()) {
+                        auto desc = it->next()->descriptor();
+                        uassert(ErrorCodes::CannotDowngrade,
+                                str::stream()
+                                    << "Cannot downgrade the cluster when there are columnstore "
+                                       "indexes present; drop all columnstore indexes before "
+                                       "downgrading. First detected columnstore index: "
+                                    << desc->indexName() << " on " << collection->ns(),
+                                desc->getIndexType() != IndexType::INDEX_COLUMN);
+                    }
+                    return true;
+                });
+        }
+
         // TODO (SERVER-56171): Remove once 5.0 is last-lts.
         removeTimeseriesEntriesFromConfigTransactions(opCtx);
 
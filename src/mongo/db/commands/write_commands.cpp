@@ -27,12 +27,15 @@
  *    it in the license file.
  */
 
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/bson/mutable/element.h"
+#include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/client.h"
@@ -41,6 +44,7 @@
 #include "mongo/db/commands/write_commands_common.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/dbhelpers.h"
 #include "mongo/db/json.h"
 #include "mongo/db/lasterror.h"
 #include "mongo/db/matcher/doc_validation_error.h"
@@ -64,9 +68,13 @@
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/storage/duplicate_key_error_info.h"
 #include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/db/timeseries/bucket_compaction.h"
+#include "mongo/db/timeseries/timeseries_constants.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/db/write_concern.h"
+#include "mongo/logv2/log.h"
 #include "mongo/logv2/redaction.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/util/fail_point.h"
@@ -120,9 +128,6 @@ bool isTimeseries(OperationContext* opCtx, const NamespaceString& ns) {
         .get();
 }
 
-// Default for control.version in time-series bucket collection.
-const int kTimeseriesControlVersion = 1;
-
 /**
  * Transforms a single time-series insert to an update request on an existing bucket.
  */
@@ -219,7 +224,8 @@ BSONObj makeTimeseriesInsertDocument(std::shared_ptr<BucketCatalog::WriteBatch>
     builder.append("_id", batch->bucket()->id());
     {
         BSONObjBuilder bucketControlBuilder(builder.subobjStart("control"));
-        bucketControlBuilder.append("version", kTimeseriesControlVersion);
+        bucketControlBuilder.append(timeseries::kBucketControlVersionFieldName,
+                                    timeseries::kTimeseriesControlDefaultVersion);
         bucketControlBuilder.append("min", batch->min());
         bucketControlBuilder.append("max", batch->max());
     }
@@ -637,7 +643,7 @@ public:
                                      std::vector<size_t>* docsToRetry) const {
             auto& bucketCatalog = BucketCatalog::get(opCtx);
 
-            auto metadata = bucketCatalog.getMetadata(batch->bucket());
+            auto metadata = bucketCatalog.getMetadata(batch);
             bool prepared = bucketCatalog.prepareCommit(batch);
             if (!prepared) {
                 invariant(batch->finished());
@@ -687,8 +693,13 @@ public:
 
             getOpTimeAndElectionId(opCtx, opTime, electionId);
 
-            bucketCatalog.finish(batch, BucketCatalog::CommitInfo{*opTime, *electionId});
+            auto closedBucket =
+                bucketCatalog.finish(batch, BucketCatalog::CommitInfo{*opTime, *electionId});
             batchGuard.dismiss();
+
+            if (closedBucket) {
+                timeseries::scheduleBucketCompression(opCtx, *closedBucket);
+            }
         }
 
         bool _commitTimeseriesBucketsAtomically(OperationContext* opCtx,
@@ -721,7 +732,7 @@ public:
             std::vector<write_ops::UpdateCommandRequest> updateOps;
 
             for (auto batch : batchesToCommit) {
-                auto metadata = bucketCatalog.getMetadata(batch.get()->bucket());
+                auto metadata = bucketCatalog.getMetadata(batch);
                 if (!bucketCatalog.prepareCommit(batch)) {
                     for (auto batchToAbort : batchesToCommit) {
                         bucketCatalog.abort(batchToAbort);
@@ -751,14 +762,42 @@ public:
 
             getOpTimeAndElectionId(opCtx, opTime, electionId);
 
+            std::vector<BucketCatalog::ClosedBucket> closedBuckets;
             for (auto batch : batchesToCommit) {
-                bucketCatalog.finish(batch, BucketCatalog::CommitInfo{*opTime, *electionId});
+                if (auto closedBucket = bucketCatalog.finish(
+                        batch, BucketCatalog::CommitInfo{*opTime, *electionId})) {
+                    closedBuckets.push_back(std::move(*closedBucket));
+                }
                 batch.get().reset();
             }
 
+            for (const auto& closedBucket : closedBuckets) {
+                timeseries::scheduleBucketCompression(opCtx, closedBucket);
+            }
+
             return true;
         }
 
+        /**
+         * Lets the bucket catalog reopen a persisted bucket for the series of 'doc' when it has no
+         * open bucket for it, so that late measurements are appended to an existing bucket rather
+         * than each opening a new, small one. Failing to find or read such a bucket, including for
+         * lack of an index to find it with, only means a new bucket is opened.
+         */
+        void _reopenBucketForMeasurement(OperationContext* opCtx,
+                                         const Collection* bucketsColl,
+                                         const BSONObj& doc) const {
+            auto bucketsNs = bucketsColl->ns();
+            BucketCatalog::get(opCtx).tryReopenBucket(
+                ns(),
+                bucketsColl->getDefaultCollator(),
+                *bucketsColl->getTimeseriesOptions(),
+                doc,
+                [&](const BSONObj& query) {
+                    return timeseries::findBucketToReopen(opCtx, bucketsNs, query);
+                });
+        }
+
         std::tuple<TimeseriesBatches, TimeseriesStmtIds, size_t> _insertIntoBucketCatalog(
             OperationContext* opCtx,
             size_t start,
@@ -798,12 +837,17 @@ public:
                     return true;
                 }
 
+                const auto& doc = request().getDocuments()[start + index];
+                if (gTimeseriesBucketReopening.load()) {
+                    _reopenBucketForMeasurement(opCtx, bucketsColl.get(), doc);
+                }
+
                 auto result =
                     bucketCatalog.insert(opCtx,
                                          ns(),
                                          bucketsColl->getDefaultCollator(),
                                          *bucketsColl->getTimeseriesOptions(),
-                                         request().getDocuments()[start + index],
+                                         doc,
                                          _canCombineTimeseriesInsertWithOtherClients(opCtx));
 
                 if (auto error = generateError(opCtx, result, start + index, errors->size())) {
@@ -30,7 +30,9 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/exec/bucket_unpacker.h"
+#include "mongo/db/timeseries/bucket_compression.h"
 #include "mongo/db/timeseries/timeseries_constants.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
 
@@ -88,6 +90,8 @@ int BucketUnpacker::computeMeasurementCount(int targetTimestampObjSize) {
 void BucketUnpacker::reset(BSONObj&& bucket) {
     _fieldIters.clear();
     _timeFieldIter = boost::none;
+    _compressedFieldIters.clear();
+    _compressedTimeFieldIter = boost::none;
 
     _bucket = std::move(bucket);
     uassert(5346510, "An empty bucket cannot be unpacked", !_bucket.isEmpty());
@@ -104,7 +108,15 @@ void BucketUnpacker::reset(BSONObj&& bucket) {
             "The $_internalUnpackBucket stage requires the data region to have a timeField object",
             timeFieldElem);
 
-    _timeFieldIter = BSONObjIterator{timeFieldElem.Obj()};
+    const bool compressed = timeseries::isCompressedBucket(_bucket);
+    if (compressed) {
+        BSONColumn timeColumn(timeFieldElem);
+        _compressedTimeFieldIter = timeColumn.begin();
+        _numberOfMeasurements = timeColumn.size();
+    } else {
+        _timeFieldIter = BSONObjIterator{timeFieldElem.Obj()};
+        _numberOfMeasurements = computeMeasurementCount(timeFieldElem.objsize());
+    }
 
     _metaValue = _bucket[timeseries::kBucketMetaFieldName];
     if (_spec.metaField) {
@@ -136,7 +148,19 @@ void BucketUnpacker::reset(BSONObj&& bucket) {
 
         // Includes a field when '_unpackerBehavior' is 'kInclude' and it's found in 'fieldSet' or
         // _unpackerBehavior is 'kExclude' and it's not found in 'fieldSet'.
-        if (determineIncludeField(colName, _unpackerBehavior, _spec)) {
+        if (!determineIncludeField(colName, _unpackerBehavior, _spec)) {
+            continue;
+        }
+
+        if (compressed) {
+            BSONColumn column(elem);
+            uassert(5716270,
+                    str::stream() << "Compressed time-series bucket column '" << colName
+                                  << "' has " << column.size() << " values but the bucket has "
+                                  << _numberOfMeasurements << " measurements",
+                    column.size() == static_cast<size_t>(_numberOfMeasurements));
+            _compressedFieldIters.emplace_back(colName.toString(), column.begin());
+        } else {
             _fieldIters.emplace_back(colName.toString(), BSONObjIterator{elem.Obj()});
         }
     }
@@ -147,9 +171,6 @@ void BucketUnpacker::reset(BSONObj&& bucket) {
             _computedMetaProjections[name] = _bucket[name];
         }
     }
-
-    // Save the measurement count for the bucket.
-    _numberOfMeasurements = computeMeasurementCount(timeFieldElem.objsize());
 }
 
 void BucketUnpacker::setBucketSpecAndBehavior(BucketSpec&& bucketSpec, Behavior behavior) {
@@ -183,7 +204,9 @@ Document BucketUnpacker::getNext() {
     tassert(5422100, "'getNext()' was called after the bucket has been exhausted", hasNext());
 
     auto measurement = MutableDocument{};
-    auto&& timeElem = _timeFieldIter->next();
+    auto&& timeElem =
+        _compressedTimeFieldIter ? _compressedTimeFieldIter->next() : _timeFieldIter->next();
+    uassert(5716271, "Time-series bucket is missing a time value", timeElem);
     if (_includeTimeField) {
         measurement.addField(_spec.timeField, Value{timeElem});
     }
@@ -193,11 +216,20 @@ Document BucketUnpacker::getNext() {
         measurement.addField(*_spec.metaField, Value{_metaValue});
     }
 
-    auto& currentIdx = timeElem.fieldNameStringData();
-    for (auto&& [colName, colIter] : _fieldIters) {
-        if (auto&& elem = *colIter; colIter.more() && elem.fieldNameStringData() == currentIdx) {
-            measurement.addField(colName, Value{elem});
-            colIter.advance(elem);
+    if (_compressedTimeFieldIter) {
+        for (auto&& [colName, colIter] : _compressedFieldIters) {
+            if (auto&& elem = colIter.next()) {
+                measurement.addField(colName, Value{elem});
+            }
+        }
+    } else {
+        auto& currentIdx = timeElem.fieldNameStringData();
+        for (auto&& [colName, colIter] : _fieldIters) {
+            if (auto&& elem = *colIter;
+                colIter.more() && elem.fieldNameStringData() == currentIdx) {
+                measurement.addField(colName, Value{elem});
+                colIter.advance(elem);
+            }
         }
     }
 
@@ -209,6 +241,83 @@ Document BucketUnpacker::getNext() {
     return measurement.freeze();
 }
 
+void BucketUnpacker::skipNext() {
+    tassert(5716273, "'skipNext()' was called after the bucket has been exhausted", hasNext());
+
+    if (_compressedTimeFieldIter) {
+        _compressedTimeFieldIter->next();
+        for (auto&& [colName, colIter] : _compressedFieldIters) {
+            colIter.next();
+        }
+        return;
+    }
+
+    auto&& timeElem = _timeFieldIter->next();
+    auto& currentIdx = timeElem.fieldNameStringData();
+    for (auto&& [colName, colIter] : _fieldIters) {
+        if (auto&& elem = *colIter; colIter.more() && elem.fieldNameStringData() == currentIdx) {
+            colIter.advance(elem);
+        }
+    }
+}
+
+void BucketUnpacker::extractColumn(StringData fieldName, std::vector<BSONElement>* values) {
+    values->assign(_numberOfMeasurements, BSONElement());
+
+    auto&& column = _bucket.getField(timeseries::kBucketDataFieldName).Obj()[fieldName];
+    if (!column) {
+        return;
+    }
+
+    if (_compressedTimeFieldIter) {
+        BSONColumn decoded(column);
+        uassert(5716274,
+                str::stream() << "Compressed time-series bucket column '" << fieldName
+                              << "' has " << decoded.size() << " values but the bucket has "
+                              << _numberOfMeasurements << " measurements",
+                decoded.size() == static_cast<size_t>(_numberOfMeasurements));
+
+        // Copy the values out of the iterator, remembering which measurement each belongs to.
+        BSONObjBuilder builder;
+        std::vector<size_t> positions;
+        size_t j = 0;
+        for (auto it = decoded.begin(); it.more(); ++j) {
+            auto elem = it.next();
+            if (!elem.eoo()) {
+                builder.appendAs(elem, ""_sd);
+                positions.push_back(j);
+            }
+        }
+        _decodedColumn = builder.obj();
+
+        auto position = positions.begin();
+        for (auto&& elem : _decodedColumn) {
+            (*values)[*position++] = elem;
+        }
+        return;
+    }
+
+    // Uncompressed columns are keyed by the position of the measurement in the bucket. Keys that
+    // do not name a measurement are ignored, just as 'getNext()' would never reach them.
+    for (auto&& elem : column.Obj()) {
+        size_t j = 0;
+        auto key = elem.fieldNameStringData();
+        if (key.empty() || key.size() > 9) {
+            continue;
+        }
+        for (char c : key) {
+            if (c < '0' || c > '9') {
+                j = values->size();
+                break;
+            }
+            j = j * 10 + (c - '0');
+        }
+        if (j < values->size()) {
+            (*values)[j] = elem;
+        }
+    }
+}
+
 Document BucketUnpacker::extractSingleMeasurement(int j) {
     tassert(5422101,
             "'extractSingleMeasurment' expects j to be greater than or equal to zero and less than "
@@ -220,6 +329,7 @@ Document BucketUnpacker::extractSingleMeasurement(int j) {
     auto rowKey = std::to_string(j);
     auto targetIdx = StringData{rowKey};
     auto&& dataRegion = _bucket.getField(timeseries::kBucketDataFieldName).Obj();
+    const bool compressed = timeseries::isCompressedBucket(_bucket);
 
     if (_includeMetaField && !_metaValue.isNull()) {
         measurement.addField(*_spec.metaField, Value{_metaValue});
@@ -230,6 +340,18 @@ Document BucketUnpacker::extractSingleMeasurement(int j) {
         if (!determineIncludeField(colName, _unpackerBehavior, _spec)) {
             continue;
         }
+        if (compressed) {
+            // Compressed columns can only be decoded in order, so this is linear in 'j'.
+            auto it = BSONColumn(dataElem).begin();
+            for (int i = 0; i < j; ++i) {
+                it.next();
+            }
+            if (auto value = it.next()) {
+                measurement.addField(dataElem.fieldNameStringData(), Value{value});
+            }
+            continue;
+        }
+
         auto value = dataElem[targetIdx];
         if (value) {
             measurement.addField(dataElem.fieldNameStringData(), Value{value});
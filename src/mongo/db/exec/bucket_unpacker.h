@@ -33,6 +33,7 @@
 #include <set>
 
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/util/bsoncolumn.h"
 #include "mongo/db/exec/document_value/document.h"
 
 namespace mongo {
@@ -100,6 +101,22 @@ public:
      */
     Document getNext();
 
+    /**
+     * Advances past the next measurement without materializing it. A precondition of this method
+     * is that 'hasNext()' must be true.
+     */
+    void skipNext();
+
+    /**
+     * Fills 'values' with the value of the data column 'fieldName' for each measurement of the
+     * bucket, in the order 'getNext()' produces them, without materializing any measurement.
+     * Measurements that have no value for the field, including all of them if the bucket has no
+     * such column, get an EOO element. The elements point into the bucket, or into a copy of the
+     * decoded column held by the unpacker when the bucket is compressed, so they are valid until
+     * the next call to 'reset()' or 'extractColumn()'.
+     */
+    void extractColumn(StringData fieldName, std::vector<BSONElement>* values);
+
     /**
      * This method will extract the j-th measurement from the bucket. A precondition of this method
      * is that j >= 0 && j <= the number of measurements within the underlying bucket.
@@ -107,7 +124,8 @@ public:
     Document extractSingleMeasurement(int j);
 
     bool hasNext() const {
-        return _timeFieldIter && _timeFieldIter->more();
+        return (_timeFieldIter && _timeFieldIter->more()) ||
+            (_compressedTimeFieldIter && _compressedTimeFieldIter->more());
     }
 
     /**
@@ -169,6 +187,16 @@ private:
     // phase according to the provided 'Behavior' and 'BucketSpec'.
     std::vector<std::pair<std::string, BSONObjIterator>> _fieldIters;
 
+    // Used instead of '_timeFieldIter' and '_fieldIters' when the columns of the bucket are
+    // compressed. Every column has one value, possibly missing, per measurement, so these iterators
+    // advance in lockstep.
+    boost::optional<BSONColumn::Iterator> _compressedTimeFieldIter;
+    std::vector<std::pair<std::string, BSONColumn::Iterator>> _compressedFieldIters;
+
+    // Owns the values of the compressed column most recently decoded by 'extractColumn()', since
+    // the elements returned by a BSONColumn::Iterator do not outlive it.
+    BSONObj _decodedColumn;
+
     // Map <name, BSONElement> for the computed meta field projections. Updated for
     // every bucket upon reset().
     stdx::unordered_map<std::string, BSONElement> _computedMetaProjections;
@@ -32,6 +32,7 @@
 #include "mongo/bson/json.h"
 #include "mongo/db/exec/bucket_unpacker.h"
 #include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/timeseries/bucket_compression.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -592,5 +593,65 @@ TEST_F(BucketUnpackerTest, ComputeMeasurementCountInLargerIntervals) {
     ASSERT_EQ(11111, BucketUnpacker::computeMeasurementCount(155560));
     ASSERT_EQ(449998, BucketUnpacker::computeMeasurementCount(7088863));
 }
+
+TEST_F(BucketUnpackerTest, CompressedBucketUnpacksLikeUncompressedBucket) {
+    auto bucket = fromjson(
+        "{control: {version: 1, min: {time: 1}, max: {time: 5}}, meta: {m1: 999}, "
+        "data: {_id: {'0':1, '1':2, '2':3, '3':4, '4':5}, "
+        "time: {'0':1, '1':2, '2':3, '3':4, '4':5}, a: {'0':1.5, '2':2.5, '3':2.5}, "
+        "b: {'1':'x', '4':'x'}, c: {'4': {d: 1}}}}");
+    auto compressed = timeseries::compressBucket(bucket, kUserDefinedTimeName);
+    ASSERT(compressed);
+    ASSERT(timeseries::isCompressedBucket(*compressed));
+    ASSERT_EQ(BinData, compressed->getObjectField("data")["a"].type());
+
+    for (auto behavior : {BucketUnpacker::Behavior::kInclude, BucketUnpacker::Behavior::kExclude}) {
+        std::set<std::string> fields{kUserDefinedTimeName.toString(), "a", "c"};
+        auto expected =
+            makeBucketUnpacker(fields, behavior, bucket, kUserDefinedMetaName.toString());
+        auto actual =
+            makeBucketUnpacker(fields, behavior, *compressed, kUserDefinedMetaName.toString());
+        ASSERT_EQ(5, actual.numberOfMeasurements());
+
+        for (int j = 0; j < 5; ++j) {
+            ASSERT_DOCUMENT_EQ(expected.extractSingleMeasurement(j),
+                               actual.extractSingleMeasurement(j));
+        }
+        while (expected.hasNext()) {
+            ASSERT_TRUE(actual.hasNext());
+            ASSERT_DOCUMENT_EQ(expected.getNext(), actual.getNext());
+        }
+        ASSERT_FALSE(actual.hasNext());
+    }
+}
+
+TEST_F(BucketUnpackerTest, ExtractColumnAndSkipNextDoNotMaterializeMeasurements) {
+    auto bucket = fromjson(
+        "{control: {version: 1}, data: {time: {'0':1, '1':2, '2':3}, "
+        "a: {'0':'x', '2':'z'}}}");
+    auto compressed = timeseries::compressBucket(bucket, kUserDefinedTimeName);
+    ASSERT(compressed);
+
+    for (auto&& b : {bucket, *compressed}) {
+        auto unpacker = makeBucketUnpacker({}, BucketUnpacker::Behavior::kExclude, b);
+
+        std::vector<BSONElement> values;
+        unpacker.extractColumn("a", &values);
+        ASSERT_EQ(3U, values.size());
+        ASSERT_EQ("x", values[0].str());
+        ASSERT_TRUE(values[1].eoo());
+        ASSERT_EQ("z", values[2].str());
+
+        unpacker.extractColumn("missing", &values);
+        ASSERT_EQ(3U, values.size());
+        ASSERT_TRUE(std::all_of(values.begin(), values.end(), [](auto&& e) { return e.eoo(); }));
+
+        unpacker.skipNext();
+        unpacker.skipNext();
+        ASSERT_DOCUMENT_EQ(Document(fromjson("{time: 3, a: 'z'}")), unpacker.getNext());
+        ASSERT_FALSE(unpacker.hasNext());
+    }
+}
+
 }  // namespace
 }  // namespace mongo
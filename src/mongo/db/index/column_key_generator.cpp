@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/column_key_generator.h"
+
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+constexpr StringData ColumnKeyGenerator::kRowIdPath;
+
+ColumnKeyGenerator::CellKind ColumnKeyGenerator::extractCell(const BSONObj& doc,
+                                                             const FieldRef& path,
+                                                             BSONElement* value) {
+    BSONObj current = doc;
+    for (FieldIndex i = 0; i < path.numParts(); ++i) {
+        BSONElement elem = current[path.getPart(i)];
+        if (elem.eoo()) {
+            // A path which ends below an existing sub-object still projects that sub-object, e.g.
+            // {"a.b": 1} applied to {a: {c: 1}} yields {a: {}}, which a column cannot express.
+            return i == 0 ? CellKind::kMissing : CellKind::kFallback;
+        }
+
+        if (i == path.numParts() - 1) {
+            *value = elem;
+            return CellKind::kValue;
+        }
+
+        switch (elem.type()) {
+            case BSONType::Object:
+                current = elem.embeddedObject();
+                break;
+            case BSONType::Array:
+                return CellKind::kFallback;
+            default:
+                return CellKind::kMissing;
+        }
+    }
+    MONGO_UNREACHABLE;
+}
+
+KeyString::Value ColumnKeyGenerator::makeColumnStartKey(StringData path,
+                                                        KeyString::Version keyStringVersion,
+                                                        Ordering ordering) {
+    KeyString::Builder keyString(keyStringVersion,
+                                 BSON("" << path),
+                                 ordering,
+                                 KeyString::Discriminator::kExclusiveBefore);
+    return keyString.getValueCopy();
+}
+
+ColumnKeyGenerator::ColumnKeyGenerator(BSONObj keyPattern,
+                                       KeyString::Version keyStringVersion,
+                                       Ordering ordering)
+    : _keyStringVersion(keyStringVersion), _ordering(ordering) {
+    for (auto&& elem : keyPattern) {
+        _paths.emplace_back(elem.fieldNameStringData());
+    }
+}
+
+void ColumnKeyGenerator::generateKeys(SharedBufferFragmentBuilder& pooledBufferBuilder,
+                                      const BSONObj& inputDoc,
+                                      KeyStringSet* keys,
+                                      const RecordId& id) const {
+    auto keysSequence = keys->extract_sequence();
+    _addKey(pooledBufferBuilder, kRowIdPath, id, BSONElement(), &keysSequence);
+
+    for (auto&& path : _paths) {
+        BSONElement value;
+        switch (extractCell(inputDoc, path, &value)) {
+            case CellKind::kMissing:
+                break;
+            case CellKind::kValue:
+                _addKey(pooledBufferBuilder, path.dottedField(), id, value, &keysSequence);
+                break;
+            case CellKind::kFallback:
+                _addKey(pooledBufferBuilder, path.dottedField(), id, BSONElement(), &keysSequence);
+                break;
+        }
+    }
+    keys->adopt_sequence(std::move(keysSequence));
+}
+
+void ColumnKeyGenerator::_addKey(SharedBufferFragmentBuilder& pooledBufferBuilder,
+                                 StringData path,
+                                 const RecordId& id,
+                                 BSONElement value,
+                                 KeyStringSet::sequence_type* keys) const {
+    // The RecordId is stored as a key component so that each column is ordered by RecordId, and
+    // then appended once more as the index entry's RecordId.
+    KeyString::PooledBuilder keyString(pooledBufferBuilder, _keyStringVersion, _ordering);
+    keyString.appendString(path);
+    keyString.appendNumberLong(id.getLong());
+    if (value) {
+        keyString.appendBSONElement(value);
+    }
+    keyString.appendRecordId(id);
+    keys->push_back(keyString.release());
+}
+
+}  // namespace mongo
@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/field_ref.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_string.h"
+
+namespace mongo {
+
+/**
+ * Generates the index keys for a 'columnstore' index. Such an index is declared with a key pattern
+ * listing the paths to store, e.g. { a: "columnstore", "b.c": "columnstore" }, and lays out the
+ * values of each path as a separate column ordered by RecordId:
+ *
+ *      { '': "path.to.field", '': NumberLong(<recordId>), '': <value> }
+ *
+ * Every document additionally contributes one entry to the "row id" column, which lives under the
+ * reserved empty path and has no value component. It lets a reader enumerate every document in the
+ * collection, including those which contain none of the indexed paths.
+ *
+ * Values are only stored in a column when they can be reconstructed exactly from that column alone,
+ * that is when the path traverses a chain of objects and ends at an element. A document in which
+ * the path is missing contributes no entry to that column. If the path runs through an array, or if
+ * it ends in a missing field below an existing sub-object, the column holds a 'fallback' entry of
+ * the form { '': "path.to.field", '': NumberLong(<recordId>) } instead, telling readers that they
+ * must consult the full document to compute the value of this path.
+ */
+class ColumnKeyGenerator {
+public:
+    // The path of the column which holds an entry for every document in the collection.
+    static constexpr StringData kRowIdPath = ""_sd;
+
+    /**
+     * The kind of entry stored for a given (path, RecordId) pair in the column for that path.
+     */
+    enum class CellKind { kMissing, kValue, kFallback };
+
+    /**
+     * Looks up 'path' in 'doc' according to the rules above, returning the kind of entry it
+     * produces and, for 'kValue', setting 'value' to the element to store.
+     */
+    static CellKind extractCell(const BSONObj& doc, const FieldRef& path, BSONElement* value);
+
+    /**
+     * Returns the key which sorts immediately before every entry in the column for 'path'.
+     */
+    static KeyString::Value makeColumnStartKey(StringData path,
+                                               KeyString::Version keyStringVersion,
+                                               Ordering ordering);
+
+    ColumnKeyGenerator(BSONObj keyPattern, KeyString::Version keyStringVersion, Ordering ordering);
+
+    const std::vector<FieldRef>& getPaths() const {
+        return _paths;
+    }
+
+    /**
+     * Adds one key to 'keys' for the row id column, and one for each indexed path which is present
+     * in 'inputDoc' or which requires a fallback to the full document.
+     */
+    void generateKeys(SharedBufferFragmentBuilder& pooledBufferBuilder,
+                      const BSONObj& inputDoc,
+                      KeyStringSet* keys,
+                      const RecordId& id) const;
+
+private:
+    void _addKey(SharedBufferFragmentBuilder& pooledBufferBuilder,
+                 StringData path,
+                 const RecordId& id,
+                 BSONElement value,
+                 KeyStringSet::sequence_type* keys) const;
+
+    std::vector<FieldRef> _paths;
+    const KeyString::Version _keyStringVersion;
+    const Ordering _ordering;
+};
+}  // namespace mongo
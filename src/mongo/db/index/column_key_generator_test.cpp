@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/index/column_key_generator.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+KeyStringSet makeKeySet(std::initializer_list<BSONObj> init, RecordId id) {
+    KeyStringSet keys;
+    Ordering ordering = Ordering::make(BSONObj());
+    for (const auto& key : init) {
+        KeyString::HeapBuilder keyString(KeyString::Version::kLatestVersion, key, ordering);
+        keyString.appendRecordId(id);
+        keys.insert(keyString.release());
+    }
+    return keys;
+}
+
+std::string dumpKeyset(const KeyStringSet& keyStrings) {
+    std::stringstream ss;
+    ss << "[ ";
+    for (auto& keyString : keyStrings) {
+        ss << KeyString::toBson(keyString, Ordering::make(BSONObj())).toString() << " ";
+    }
+    ss << "]";
+    return ss.str();
+}
+
+struct ColumnKeyGeneratorTest : public unittest::Test {
+    KeyStringSet generateKeys(const char* keyPattern, const char* doc, RecordId id) {
+        ColumnKeyGenerator keyGen{
+            fromjson(keyPattern), KeyString::Version::kLatestVersion, Ordering::make(BSONObj())};
+        KeyStringSet keys;
+        keyGen.generateKeys(allocator, fromjson(doc), &keys, id);
+        return keys;
+    }
+
+    SharedBufferFragmentBuilder allocator{KeyString::HeapBuilder::kHeapAllocatorDefaultBytes};
+};
+
+TEST_F(ColumnKeyGeneratorTest, StoresEachPathInItsOwnColumn) {
+    RecordId id(7);
+    auto keys = generateKeys("{a: 'columnstore', 'b.c': 'columnstore'}",
+                             "{_id: 0, a: 'one', b: {c: [1, 2], d: 3}, e: 4}",
+                             id);
+
+    auto expected = makeKeySet({fromjson("{'': '', '': NumberLong(7)}"),
+                                fromjson("{'': 'a', '': NumberLong(7), '': 'one'}"),
+                                fromjson("{'': 'b.c', '': NumberLong(7), '': [1, 2]}")},
+                               id);
+    ASSERT_EQ(dumpKeyset(expected), dumpKeyset(keys));
+}
+
+TEST_F(ColumnKeyGeneratorTest, MissingPathsOnlyProduceRowIdEntry) {
+    RecordId id(1);
+    auto keys = generateKeys("{a: 'columnstore', 'b.c': 'columnstore'}", "{x: 1, b: 2}", id);
+
+    auto expected = makeKeySet({fromjson("{'': '', '': NumberLong(1)}")}, id);
+    ASSERT_EQ(dumpKeyset(expected), dumpKeyset(keys));
+}
+
+TEST_F(ColumnKeyGeneratorTest, PathThroughArrayProducesFallbackEntry) {
+    RecordId id(3);
+    auto keys = generateKeys("{'a.b': 'columnstore'}", "{a: [{b: 1}, {b: 2}]}", id);
+
+    auto expected = makeKeySet(
+        {fromjson("{'': '', '': NumberLong(3)}"), fromjson("{'': 'a.b', '': NumberLong(3)}")}, id);
+    ASSERT_EQ(dumpKeyset(expected), dumpKeyset(keys));
+}
+
+TEST_F(ColumnKeyGeneratorTest, MissingLeafBelowSubObjectProducesFallbackEntry) {
+    RecordId id(4);
+    auto keys = generateKeys("{'a.b': 'columnstore'}", "{a: {c: 1}}", id);
+
+    auto expected = makeKeySet(
+        {fromjson("{'': '', '': NumberLong(4)}"), fromjson("{'': 'a.b', '': NumberLong(4)}")}, id);
+    ASSERT_EQ(dumpKeyset(expected), dumpKeyset(keys));
+}
+
+TEST_F(ColumnKeyGeneratorTest, ColumnsAreOrderedByRecordId) {
+    auto keys = generateKeys("{a: 'columnstore'}", "{a: 'z'}", RecordId(2));
+    auto other = generateKeys("{a: 'columnstore'}", "{a: 'a'}", RecordId(10));
+    ASSERT_LT(*keys.rbegin(), *other.rbegin());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -108,6 +108,7 @@
 #include "mongo/db/op_observer_registry.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/periodic_runner_job_abort_expired_transactions.h"
+#include "mongo/db/periodic_runner_job_compact_timeseries_buckets.h"
 #include "mongo/db/pipeline/process_interface/replica_set_node_process_interface.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/read_write_concern_defaults_cache_lookup_mongod.h"
@@ -736,6 +737,7 @@ ExitCode _initAndListen(ServiceContext* serviceContext, int listenPort) {
     if (storageEngine->supportsReadConcernSnapshot()) {
         try {
             PeriodicThreadToAbortExpiredTransactions::get(serviceContext)->start();
+            PeriodicThreadToCompactTimeseriesBuckets::get(serviceContext)->start();
         } catch (ExceptionFor<ErrorCodes::PeriodicJobIsStopped>&) {
             LOGV2_WARNING(4747501, "Not starting periodic jobs as shutdown is in progress");
             // Shutdown has already started before initialization is complete. Wait for the
@@ -1213,6 +1215,9 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
         if (storageEngine->supportsReadConcernSnapshot()) {
             LOGV2(4784908, "Shutting down the PeriodicThreadToAbortExpiredTransactions");
             PeriodicThreadToAbortExpiredTransactions::get(serviceContext)->stop();
+
+            LOGV2(5716280, "Shutting down the PeriodicThreadToCompactTimeseriesBuckets");
+            PeriodicThreadToCompactTimeseriesBuckets::get(serviceContext)->stop();
         }
 
         ServiceContext::UniqueOperationContext uniqueOpCtx;
@@ -121,6 +121,9 @@ const NamespaceString NamespaceString::kReshardingApplierProgressNamespace(
 const NamespaceString NamespaceString::kReshardingTxnClonerProgressNamespace(
     NamespaceString::kConfigDb, "localReshardingOperations.recipient.progress_txn_cloner");
 
+const NamespaceString NamespaceString::kReshardingCollectionClonerRangesNamespace(
+    NamespaceString::kConfigDb, "localReshardingOperations.recipient.collection_cloner_ranges");
+
 const NamespaceString NamespaceString::kReshardingOplogView(
     NamespaceString::kLocalDb, "system.resharding.slimOplogForGraphLookup");
 
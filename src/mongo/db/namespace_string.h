@@ -172,6 +172,9 @@ public:
     // Namespace for storing config.transactions cloner progress for resharding.
     static const NamespaceString kReshardingTxnClonerProgressNamespace;
 
+    // Namespace for storing the _id ranges copied in parallel by the resharding collection cloner.
+    static const NamespaceString kReshardingCollectionClonerRangesNamespace;
+
     // Namespace for view on local.oplog.rs for resharding.
     static const NamespaceString kReshardingOplogView;
 
@@ -683,7 +683,7 @@ void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArg
     } else if (args.nss.isTimeseriesBucketsCollection()) {
         if (args.updateArgs.source != OperationSource::kTimeseries) {
             auto& bucketCatalog = BucketCatalog::get(opCtx);
-            bucketCatalog.clear(args.updateArgs.updatedDoc["_id"].OID());
+            bucketCatalog.clear(opCtx, args.updateArgs.updatedDoc["_id"].OID());
         }
     }
 }
@@ -704,7 +704,7 @@ void OpObserverImpl::aboutToDelete(OperationContext* opCtx,
 
     if (nss.isTimeseriesBucketsCollection()) {
         auto& bucketCatalog = BucketCatalog::get(opCtx);
-        bucketCatalog.clear(doc["_id"].OID());
+        bucketCatalog.clear(opCtx, doc["_id"].OID());
     }
 }
 
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/periodic_runner_job_compact_timeseries_buckets.h"
+
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/timeseries/bucket_compaction.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/periodic_runner.h"
+
+namespace mongo {
+
+namespace {
+
+// The job wakes up at this period to compress the buckets closed since its last run and to check
+// whether a compaction pass is due, so that changes to timeseriesBucketCompactionIntervalSecs take
+// effect without restarting the job.
+constexpr Seconds kCheckPeriod{1};
+
+void compactAllTimeseriesBuckets(OperationContext* opCtx) {
+    auto catalog = CollectionCatalog::get(opCtx);
+    for (auto&& dbName : catalog->getAllDbNames()) {
+        for (auto&& nss : catalog->getAllCollectionNamesFromDb(opCtx, dbName)) {
+            if (nss.isTimeseriesBucketsCollection()) {
+                timeseries::compactBuckets(opCtx, nss);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+auto PeriodicThreadToCompactTimeseriesBuckets::get(ServiceContext* serviceContext)
+    -> PeriodicThreadToCompactTimeseriesBuckets& {
+    auto& jobContainer = _serviceDecoration(serviceContext);
+    jobContainer._init(serviceContext);
+
+    return jobContainer;
+}
+
+auto PeriodicThreadToCompactTimeseriesBuckets::operator*() const noexcept -> PeriodicJobAnchor& {
+    stdx::lock_guard lk(_mutex);
+    return *_anchor;
+}
+
+auto PeriodicThreadToCompactTimeseriesBuckets::operator-> () const noexcept -> PeriodicJobAnchor* {
+    stdx::lock_guard lk(_mutex);
+    return _anchor.get();
+}
+
+void PeriodicThreadToCompactTimeseriesBuckets::_init(ServiceContext* serviceContext) {
+    stdx::lock_guard lk(_mutex);
+    if (_anchor) {
+        return;
+    }
+
+    auto periodicRunner = serviceContext->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    PeriodicRunner::PeriodicJob job(
+        "compactTimeseriesBuckets",
+        [lastPass = Date_t()](Client* client) mutable {
+            // The opCtx destructor handles unsetting itself from the Client. (The PeriodicRunner's
+            // Client must be reset before returning.)
+            auto opCtx = client->makeOperationContext();
+            try {
+                // Buckets closed by inserts are compressed on every run, so that they do not wait
+                // for a compaction pass.
+                timeseries::compressScheduledBuckets(opCtx.get());
+
+                auto interval = gTimeseriesBucketCompactionIntervalSecs.load();
+                if (interval == 0) {
+                    return;
+                }
+                auto now = client->getServiceContext()->getFastClockSource()->now();
+                if (now - lastPass < Seconds(interval)) {
+                    return;
+                }
+                lastPass = now;
+
+                compactAllTimeseriesBuckets(opCtx.get());
+            } catch (ExceptionForCat<ErrorCategory::CancellationError>& ex) {
+                LOGV2_DEBUG(5716278, 2, "Periodic job canceled", "reason"_attr = ex.reason());
+            } catch (const DBException& ex) {
+                LOGV2(5716279,
+                      "Failed to compress or compact time-series buckets",
+                      "error"_attr = ex.toStatus());
+            }
+        },
+        kCheckPeriod);
+
+    _anchor = std::make_shared<PeriodicJobAnchor>(periodicRunner->makeJob(std::move(job)));
+}
+
+}  // namespace mongo
@@ -42,6 +42,8 @@
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/matcher/expression_internal_expr_comparison.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/pipeline/document_source_add_fields.h"
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -51,6 +53,7 @@
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/util/make_data_structure.h"
 #include "mongo/db/timeseries/timeseries_constants.h"
 #include "mongo/logv2/log.h"
@@ -305,6 +308,7 @@ boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createF
     auto hasBucketMaxSpanSeconds = false;
     auto bucketMaxSpanSeconds = 0;
     std::vector<std::string> computedMetaProjFields;
+    boost::optional<BSONObj> eventFilter;
     for (auto&& elem : specElem.embeddedObject()) {
         auto fieldName = elem.fieldNameStringData();
         if (fieldName == kInclude || fieldName == kExclude) {
@@ -375,6 +379,11 @@ boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createF
                         field.find('.') == std::string::npos);
                 bucketSpec.computedMetaProjFields.emplace_back(field);
             }
+        } else if (fieldName == kEventFilter) {
+            uassert(5716275,
+                    str::stream() << "eventFilter field must be an object, got: " << elem.type(),
+                    elem.type() == BSONType::Object);
+            eventFilter = elem.Obj();
         } else {
             uasserted(5346506,
                       str::stream()
@@ -389,8 +398,12 @@ boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createF
             "The $_internalUnpackBucket stage requires a bucketMaxSpanSeconds parameter",
             hasBucketMaxSpanSeconds);
 
-    return make_intrusive<DocumentSourceInternalUnpackBucket>(
+    auto unpackStage = make_intrusive<DocumentSourceInternalUnpackBucket>(
         expCtx, BucketUnpacker{std::move(bucketSpec), unpackerBehavior}, bucketMaxSpanSeconds);
+    if (eventFilter) {
+        unpackStage->setEventFilter(*eventFilter);
+    }
+    return unpackStage;
 }
 
 boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createFromBsonExternal(
@@ -469,6 +482,10 @@ void DocumentSourceInternalUnpackBucket::serializeToArray(
                          return compFields;
                      }()});
 
+    if (_eventFilter) {
+        out.addField(kEventFilter, Value{_eventFilterBson});
+    }
+
     if (!explain) {
         array.push_back(Value(DOC(getSourceName() << out.freeze())));
         if (_sampleSize) {
@@ -484,9 +501,110 @@ void DocumentSourceInternalUnpackBucket::serializeToArray(
     }
 }
 
+void DocumentSourceInternalUnpackBucket::setEventFilter(const BSONObj& filter) {
+    _eventFilterBson = filter.getOwned();
+    _eventFilter = uassertStatusOK(MatchExpressionParser::parse(
+        _eventFilterBson, pExpCtx, ExtensionsCallbackNoop(), Pipeline::kAllowedMatcherFeatures));
+
+    // A comparison can be evaluated on the raw values of a column if it is one of the conjuncts of
+    // the filter and its path is a top-level field that the unpacked measurements contain as is,
+    // since the filter is applied to the measurements this stage would otherwise return.
+    const auto& spec = _bucketUnpacker.bucketSpec();
+    auto isColumnarPredicate = [&](const MatchExpression* expr) {
+        if (!ComparisonMatchExpression::isComparisonMatchExpression(expr)) {
+            return false;
+        }
+        auto path = expr->path();
+        if (path.empty() || path.find('.') != std::string::npos ||
+            (spec.metaField && path == *spec.metaField) || fieldIsComputed(spec, path.toString())) {
+            return false;
+        }
+        return path == spec.timeField
+            ? _bucketUnpacker.includeTimeField()
+            : determineIncludeField(path, _bucketUnpacker.behavior(), spec);
+    };
+
+    _columnPredicates.clear();
+    _eventFilterIsColumnar = true;
+    auto collect = [&](const MatchExpression* expr) {
+        if (isColumnarPredicate(expr)) {
+            _columnPredicates.push_back(static_cast<const ComparisonMatchExpression*>(expr));
+        } else {
+            _eventFilterIsColumnar = false;
+        }
+    };
+    if (_eventFilter->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < _eventFilter->numChildren(); ++i) {
+            collect(_eventFilter->getChild(i));
+        }
+    } else {
+        collect(_eventFilter.get());
+    }
+}
+
+void DocumentSourceInternalUnpackBucket::selectMeasurements() {
+    const auto numMeasurements = static_cast<size_t>(_bucketUnpacker.numberOfMeasurements());
+    _selections.assign(numMeasurements,
+                       _eventFilterIsColumnar ? Selection::kSelected : Selection::kNeedsRecheck);
+    _nextMeasurement = 0;
+
+    for (auto&& predicate : _columnPredicates) {
+        _bucketUnpacker.extractColumn(predicate->path(), &_columnValues);
+        for (size_t j = 0; j < numMeasurements; ++j) {
+            if (_selections[j] == Selection::kRejected) {
+                continue;
+            }
+
+            // The comparison may match an element of an array rather than the array as a whole,
+            // so such measurements are left to the full filter.
+            auto&& value = _columnValues[j];
+            if (value.type() == BSONType::Array) {
+                _selections[j] = Selection::kNeedsRecheck;
+            } else if (!predicate->matchesSingleElement(value)) {
+                _selections[j] = Selection::kRejected;
+            }
+        }
+    }
+}
+
 DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::doGetNext() {
     tassert(5521502, "calling doGetNext() when '_sampleSize' is set is disallowed", !_sampleSize);
 
+    if (_eventFilter) {
+        while (true) {
+            while (_bucketUnpacker.hasNext()) {
+                auto selection = _nextMeasurement < _selections.size()
+                    ? _selections[_nextMeasurement]
+                    : Selection::kNeedsRecheck;
+                ++_nextMeasurement;
+
+                if (selection == Selection::kRejected) {
+                    _bucketUnpacker.skipNext();
+                    continue;
+                }
+
+                auto measurement = _bucketUnpacker.getNext();
+                if (selection == Selection::kSelected ||
+                    _eventFilter->matchesBSON(measurement.toBson())) {
+                    return measurement;
+                }
+            }
+
+            auto nextResult = pSource->getNext();
+            if (!nextResult.isAdvanced()) {
+                return nextResult;
+            }
+            _bucketUnpacker.reset(nextResult.releaseDocument().toBson());
+            uassert(5716276,
+                    str::stream()
+                        << "A bucket with _id "
+                        << _bucketUnpacker.bucket()[timeseries::kBucketIdFieldName].toString()
+                        << " contains an empty data region",
+                    _bucketUnpacker.hasNext());
+            selectMeasurements();
+        }
+    }
+
     // Otherwise, fallback to unpacking every measurement in all buckets until the child stage is
     // exhausted.
     if (_bucketUnpacker.hasNext()) {
@@ -784,26 +902,49 @@ DocumentSourceInternalUnpackBucket::rewriteGroupByMinMax(Pipeline::SourceContain
         return {};
     }
 
+    const auto& timeField = _bucketUnpacker.bucketSpec().timeField;
     bool suitable = true;
     std::vector<AccumulationStatement> accumulationStatements;
     for (const AccumulationStatement& stmt : groupPtr->getAccumulatedFields()) {
         const std::string& op = stmt.makeAccumulator()->getOpName();
         const bool isMin = op == "$min";
         const bool isMax = op == "$max";
+        const auto* exprArg = stmt.expr.argument.get();
+
+        // A count of the measurements, which is how $count is desugared, is the sum of the number
+        // of measurements in each bucket. Compressed buckets record it in the control fields, and
+        // in other buckets it is the number of entries in the time column.
+        if (const auto* exprArgConst = dynamic_cast<const ExpressionConstant*>(exprArg);
+            op == "$sum" && exprArgConst && exprArgConst->getValue().getType() == NumberInt &&
+            exprArgConst->getValue().getInt() == 1) {
+            std::string controlCountPath = str::stream()
+                << "$" << timeseries::kBucketControlFieldName << "."
+                << timeseries::kBucketControlCountFieldName;
+            std::string timeColumnPath = str::stream()
+                << "$" << timeseries::kBucketDataFieldName << "." << timeField;
+            auto bucketCount = BSON(
+                "$ifNull" << BSON_ARRAY(controlCountPath << BSON(
+                                            "$size" << BSON("$objectToArray" << timeColumnPath))));
+            AccumulationExpression accExpr = stmt.expr;
+            accExpr.argument = Expression::parseOperand(
+                pExpCtx.get(), bucketCount.firstElement(), pExpCtx->variablesParseState);
+            accumulationStatements.emplace_back(stmt.fieldName, std::move(accExpr));
+            continue;
+        }
 
-        // Rewrite is valid only for min and max aggregates.
+        // Otherwise the rewrite is valid only for min and max aggregates.
         if (!isMin && !isMax) {
             suitable = false;
             break;
         }
 
-        const auto* exprArg = stmt.expr.argument.get();
         if (const auto* exprArgPath = dynamic_cast<const ExpressionFieldPath*>(exprArg)) {
             const auto& path = exprArgPath->getFieldPath();
             if (path.getPathLength() <= 1 ||
-                path.getFieldName(1) == _bucketUnpacker.bucketSpec().timeField) {
-                // Rewrite not valid for time field. We want to eliminate the bucket
-                // unpack stage here.
+                (path.getFieldName(1) == timeField && (isMin || path.getPathLength() > 2))) {
+                // The control.min value of the time field is rounded down to the start of the
+                // bucket's time range, so only the maximum time can be read from the control
+                // fields. Otherwise we must unpack the bucket.
                 suitable = false;
                 break;
             }
@@ -871,6 +1012,16 @@ Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimi
         return container->end();
     }
 
+    // Once a $match has been absorbed, rewrites that change the measurements this stage returns, or
+    // that move later stages ahead of it, would change what the event filter is applied to.
+    if (_eventFilter) {
+        if (!_optimizedEndOfPipeline) {
+            _optimizedEndOfPipeline = true;
+            optimizeEndOfPipeline(itr, container);
+        }
+        return container->end();
+    }
+
     // Some optimizations may not be safe to do if we have computed the metaField via an $addFields
     // or a computed $project. We won't do those optimizations if 'haveComputedMetaField' is true.
     bool haveComputedMetaField = _bucketUnpacker.bucketSpec().metaField &&
@@ -1006,6 +1157,16 @@ Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimi
         }
     }
 
+    // Absorb a $match that directly follows this stage. By now its predicates on the control
+    // fields have been pushed down, and the fields it depends on are unpacked, so it can be
+    // evaluated column by column before any measurement is materialized.
+    if (auto nextMatch = dynamic_cast<DocumentSourceMatch*>(std::next(itr)->get());
+        nextMatch && !nextMatch->isTextQuery() && !_sampleSize &&
+        internalQueryTimeseriesPushDownEventFilter.load()) {
+        setEventFilter(nextMatch->getQuery());
+        container->erase(std::next(itr));
+    }
+
     return container->end();
 }
 }  // namespace mongo
@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "mongo/db/exec/bucket_unpacker.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
 
@@ -44,6 +45,7 @@ public:
     static constexpr StringData kInclude = "include"_sd;
     static constexpr StringData kExclude = "exclude"_sd;
     static constexpr StringData kBucketMaxSpanSeconds = "bucketMaxSpanSeconds"_sd;
+    static constexpr StringData kEventFilter = "eventFilter"_sd;
 
     static boost::intrusive_ptr<DocumentSource> createFromBsonInternal(
         BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
@@ -191,6 +193,17 @@ public:
      */
     std::pair<BSONObj, bool> extractProjectForPushDown(DocumentSource* src) const;
 
+    /**
+     * Makes this stage return only the measurements that match 'filter', as if it were followed by
+     * {$match: filter}. Comparisons on included top-level fields are evaluated a column at a time
+     * against the raw values of each bucket, so measurements they reject are never materialized.
+     */
+    void setEventFilter(const BSONObj& filter);
+
+    const MatchExpression* eventFilter() const {
+        return _eventFilter.get();
+    }
+
     /**
      * Helper method which checks if we can avoid unpacking if we have a group stage with min/max
      * aggregates. If a rewrite is possible, 'container' is modified, and we returns result value
@@ -200,8 +213,17 @@ public:
         Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container);
 
 private:
+    // What is known about a measurement of the current bucket before it is materialized.
+    enum class Selection : uint8_t { kRejected, kSelected, kNeedsRecheck };
+
     GetNextResult doGetNext() final;
 
+    /**
+     * Evaluates the column predicates of the event filter against the current bucket and fills
+     * '_selections' with the outcome for each of its measurements.
+     */
+    void selectMeasurements();
+
     BucketUnpacker _bucketUnpacker;
     int _bucketMaxSpanSeconds;
 
@@ -213,5 +235,21 @@ private:
     bool _triedBucketLevelFieldsPredicatesPushdown = false;
     bool _optimizedEndOfPipeline = false;
     bool _triedInternalizeProject = false;
+
+    // A predicate absorbed from a $match after this stage, and the BSON it was parsed from.
+    BSONObj _eventFilterBson;
+    std::unique_ptr<MatchExpression> _eventFilter;
+
+    // The comparisons of '_eventFilter' that can be evaluated on the values of one column. When
+    // '_eventFilterIsColumnar' is true these are all of '_eventFilter', so a measurement only has
+    // to be checked against the whole filter if one of the values is an array.
+    std::vector<const ComparisonMatchExpression*> _columnPredicates;
+    bool _eventFilterIsColumnar = false;
+
+    // The selection for each measurement of the current bucket, the position of the next
+    // measurement, and scratch space for one column of values.
+    std::vector<Selection> _selections;
+    size_t _nextMeasurement = 0;
+    std::vector<BSONElement> _columnValues;
 };
 }  // namespace mongo
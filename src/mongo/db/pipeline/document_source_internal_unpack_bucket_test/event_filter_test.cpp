@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/util/make_data_structure.h"
+#include "mongo/db/timeseries/bucket_compression.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/unittest/bson_test_util.h"
+
+namespace mongo {
+namespace {
+
+using InternalUnpackBucketEventFilterTest = AggregationContextFixture;
+
+const char* kBucket =
+    "{control: {version: 1}, meta: 'm', data: {time: {'0': 0, '1': 1, '2': 2, '3': 3}, "
+    "a: {'0': 1, '1': 2, '2': [0, 5], '3': 3}, b: {'1': 'x', '3': 'y'}}}";
+
+boost::intrusive_ptr<DocumentSource> makeUnpack(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const std::string& includeOrExclude,
+    const BSONObj& eventFilter) {
+    auto spec = BSON("$_internalUnpackBucket"
+                     << BSON(includeOrExclude << BSONArray() << "timeField"
+                                              << "time"
+                                              << "metaField"
+                                              << "myMeta"
+                                              << "bucketMaxSpanSeconds" << 3600 << "eventFilter"
+                                              << eventFilter));
+    return DocumentSourceInternalUnpackBucket::createFromBsonInternal(spec.firstElement(), expCtx);
+}
+
+std::vector<BSONObj> unpackAll(DocumentSource* unpack) {
+    std::vector<BSONObj> results;
+    for (auto next = unpack->getNext(); !next.isEOF(); next = unpack->getNext()) {
+        ASSERT_TRUE(next.isAdvanced());
+        results.push_back(next.getDocument().toBson());
+    }
+    return results;
+}
+
+TEST_F(InternalUnpackBucketEventFilterTest, MatchIsAbsorbedAfterControlPredicatesArePushedDown) {
+    RAIIServerParameterControllerForTest controller("internalQueryTimeseriesPushDownEventFilter",
+                                                    true);
+    auto unpack = fromjson(
+        "{$_internalUnpackBucket: {exclude: [], timeField: 'time', metaField: 'myMeta', "
+        "bucketMaxSpanSeconds: 3600}}");
+    auto pipeline = Pipeline::parse(
+        makeVector(unpack, fromjson("{$match: {myMeta: {$gte: 0}, a: {$lte: 4}}}")), getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(2u, serialized.size());
+    ASSERT_BSONOBJ_EQ(fromjson("{$match: {$and: [{'control.min.a': {$_internalExprLte: 4}}, "
+                               "{meta: {$gte: 0}}]}}"),
+                      serialized[0]);
+    ASSERT_BSONOBJ_EQ(
+        fromjson("{$_internalUnpackBucket: {exclude: [], timeField: 'time', metaField: 'myMeta', "
+                 "bucketMaxSpanSeconds: 3600, eventFilter: {a: {$lte: 4}}}}"),
+        serialized[1]);
+
+    // The stage parses back to the same specification.
+    auto reparsed = Pipeline::parse(serialized, getExpCtx());
+    ASSERT_BSONOBJ_EQ(serialized[1], reparsed->serializeToBson()[1]);
+}
+
+TEST_F(InternalUnpackBucketEventFilterTest, MatchIsNotAbsorbedByDefault) {
+    auto unpack = fromjson(
+        "{$_internalUnpackBucket: {exclude: [], timeField: 'time', metaField: 'myMeta', "
+        "bucketMaxSpanSeconds: 3600}}");
+    auto pipeline =
+        Pipeline::parse(makeVector(unpack, fromjson("{$match: {a: {$lte: 4}}}")), getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(3u, serialized.size());
+    ASSERT_BSONOBJ_EQ(unpack, serialized[1]);
+}
+
+TEST_F(InternalUnpackBucketEventFilterTest, ColumnarFilterChecksArrayValuesAgainstTheWholeFilter) {
+    auto unpack = makeUnpack(getExpCtx(), "exclude", fromjson("{a: {$gte: 2}}"));
+    auto source = DocumentSourceMock::createForTest(kBucket, getExpCtx());
+    unpack->setSource(source.get());
+
+    auto results = unpackAll(unpack.get());
+    ASSERT_EQ(3u, results.size());
+    ASSERT_BSONOBJ_EQ(fromjson("{time: 1, myMeta: 'm', a: 2, b: 'x'}"), results[0]);
+    ASSERT_BSONOBJ_EQ(fromjson("{time: 2, myMeta: 'm', a: [0, 5]}"), results[1]);
+    ASSERT_BSONOBJ_EQ(fromjson("{time: 3, myMeta: 'm', a: 3, b: 'y'}"), results[2]);
+}
+
+TEST_F(InternalUnpackBucketEventFilterTest, NonColumnarPredicatesAreAppliedToMeasurements) {
+    auto unpack = makeUnpack(
+        getExpCtx(), "exclude", fromjson("{a: {$gte: 2}, b: {$exists: true}, myMeta: 'm'}"));
+    auto source = DocumentSourceMock::createForTest(kBucket, getExpCtx());
+    unpack->setSource(source.get());
+
+    auto results = unpackAll(unpack.get());
+    ASSERT_EQ(2u, results.size());
+    ASSERT_EQ(1, results[0]["time"].numberInt());
+    ASSERT_EQ(3, results[1]["time"].numberInt());
+}
+
+TEST_F(InternalUnpackBucketEventFilterTest, FilterSeesOnlyTheUnpackedFields) {
+    // Nothing is unpacked into the measurements, so there is no 'a' for the filter to match.
+    auto unpack = makeUnpack(getExpCtx(), "include", fromjson("{a: {$gte: 2}}"));
+    auto source = DocumentSourceMock::createForTest(kBucket, getExpCtx());
+    unpack->setSource(source.get());
+
+    ASSERT_TRUE(unpackAll(unpack.get()).empty());
+}
+
+TEST_F(InternalUnpackBucketEventFilterTest, CompressedBucketsAreFilteredByColumn) {
+    auto compressed = timeseries::compressBucket(fromjson(kBucket), "time"_sd);
+    ASSERT(compressed);
+
+    auto unpack = makeUnpack(getExpCtx(), "exclude", fromjson("{a: {$lt: 3}, time: {$gt: 0}}"));
+    auto source = DocumentSourceMock::createForTest(Document(*compressed), getExpCtx());
+    unpack->setSource(source.get());
+
+    auto results = unpackAll(unpack.get());
+    ASSERT_EQ(2u, results.size());
+    ASSERT_BSONOBJ_EQ(fromjson("{time: 1, myMeta: 'm', a: 2, b: 'x'}"), results[0]);
+    ASSERT_BSONOBJ_EQ(fromjson("{time: 2, myMeta: 'm', a: [0, 5]}"), results[1]);
+}
+
+TEST_F(InternalUnpackBucketEventFilterTest, CompressedPackedValuesAreComparedIndividually) {
+    // The ascending times are bit-packed, so each value is decoded from the previous one.
+    auto compressed = timeseries::compressBucket(
+        fromjson("{control: {version: 1}, meta: 'm', data: {time: {'0': 1, '1': 2, '2': 3}}}"),
+        "time"_sd);
+    ASSERT(compressed);
+
+    auto unpack = makeUnpack(getExpCtx(), "exclude", fromjson("{time: {$gt: 1}}"));
+    auto source = DocumentSourceMock::createForTest(Document(*compressed), getExpCtx());
+    unpack->setSource(source.get());
+
+    auto results = unpackAll(unpack.get());
+    ASSERT_EQ(2u, results.size());
+    ASSERT_BSONOBJ_EQ(fromjson("{time: 2, myMeta: 'm'}"), results[0]);
+    ASSERT_BSONOBJ_EQ(fromjson("{time: 3, myMeta: 'm'}"), results[1]);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -126,5 +126,38 @@ TEST_F(InternalUnpackBucketGroupReorder, MinMaxGroupOnMetadataNegative1) {
     ASSERT_BSONOBJ_EQ(groupSpecObj, serialized[1]);
 }
 
+TEST_F(InternalUnpackBucketGroupReorder, MaxTimeAndCountGroupOnMetadata) {
+    auto unpackSpecObj = fromjson(
+        "{$_internalUnpackBucket: { include: ['a', 'b', 'c'], metaField: 'meta1', timeField: 't', "
+        "bucketMaxSpanSeconds: 3600}}");
+    auto groupSpecObj = fromjson("{$group: {_id: '$meta1', last: {$max: '$t'}, n: {$sum: 1}}}");
+
+    auto pipeline = Pipeline::parse(makeVector(unpackSpecObj, groupSpecObj), getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(1, serialized.size());
+
+    auto optimized = fromjson(
+        "{$group: {_id: '$meta', last: {$max: '$control.max.t'}, n: {$sum: {$ifNull: "
+        "['$control.count', {$size: [{$objectToArray: ['$data.t']}]}]}}}}");
+    ASSERT_BSONOBJ_EQ(optimized, serialized[0]);
+}
+
+TEST_F(InternalUnpackBucketGroupReorder, MinTimeGroupOnMetadataNegative) {
+    auto unpackSpecObj = fromjson(
+        "{$_internalUnpackBucket: { include: ['a', 'b', 'c'], timeField: 't', metaField: 'meta', "
+        "bucketMaxSpanSeconds: 3600}}");
+    auto groupSpecObj = fromjson("{$group: {_id: '$meta', first: {$min: '$t'}}}");
+
+    auto pipeline = Pipeline::parse(makeVector(unpackSpecObj, groupSpecObj), getExpCtx());
+    pipeline->optimizePipeline();
+
+    // control.min.t is rounded down, so the buckets must be unpacked.
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(2, serialized.size());
+    ASSERT_BSONOBJ_EQ(groupSpecObj, serialized[1]);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -424,6 +424,12 @@ std::pair<DocumentSourceSample*, DocumentSourceInternalUnpackBucket*> extractSam
         unpackStage = dynamic_cast<DocumentSourceInternalUnpackBucket*>(sourcesIt->get());
         ++sourcesIt;
 
+        // Sampling unpacks buckets without going through the stage, so it cannot apply a filter
+        // that was absorbed into it.
+        if (unpackStage && unpackStage->eventFilter()) {
+            return std::pair{sampleStage, unpackStage};
+        }
+
         if (unpackStage && sourcesIt != sources.end()) {
             sampleStage = dynamic_cast<DocumentSourceSample*>(sourcesIt->get());
             return std::pair{sampleStage, unpackStage};
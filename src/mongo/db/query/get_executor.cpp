@@ -293,6 +293,10 @@ void fillOutPlannerParams(OperationContext* opCtx,
         // Skip the addition of hidden indexes to prevent use in query planning.
         if (ice->descriptor()->hidden())
             continue;
+
+        // Columnstore indexes cannot answer predicates or provide a sort.
+        if (indexType == IndexType::INDEX_COLUMN)
+            continue;
         plannerParams->indices.push_back(
             indexEntryFromIndexCatalogEntry(opCtx, collection, *ice, canonicalQuery));
     }
@@ -2159,6 +2163,8 @@ QueryPlannerParams fillOutPlannerParamsForDistinct(OperationContext* opCtx,
         // Skip the addition of hidden indexes to prevent use in query planning.
         if (desc->hidden())
             continue;
+        if (desc->getIndexType() == IndexType::INDEX_COLUMN)
+            continue;
         if (desc->keyPattern().hasField(parsedDistinct.getKey())) {
             if (!mayUnwindArrays &&
                 isAnyComponentOfPathMultikey(desc->keyPattern(),
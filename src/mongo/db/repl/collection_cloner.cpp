@@ -31,6 +31,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/commands/list_collections_filter.h"
 #include "mongo/db/index_build_entry_helpers.h"
@@ -39,9 +41,12 @@
 #include "mongo/db/repl/collection_cloner.h"
 #include "mongo/db/repl/database_cloner_gen.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/db/repl/replication_auth.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
 
 #include "mongo/util/assert_util.h"
 
@@ -96,7 +101,9 @@ CollectionCloner::CollectionCloner(const NamespaceString& sourceNss,
           _dbWorkTaskRunner.schedule(std::move(task));
           return executor::TaskExecutor::CallbackHandle();
       }),
-      _dbWorkTaskRunner(dbPool) {
+      _dbWorkTaskRunner(dbPool),
+      _createClientFn(
+          [] { return std::make_unique<DBClientConnection>(true /* autoReconnect */); }) {
     invariant(sourceNss.isValid());
     invariant(collectionOptions.uuid);
     _sourceDbAndUuid = NamespaceStringOrUUID(sourceNss.db().toString(), *collectionOptions.uuid);
@@ -236,7 +243,11 @@ BaseCloner::AfterStageBehavior CollectionCloner::createCollectionStage() {
 }
 
 BaseCloner::AfterStageBehavior CollectionCloner::queryStage() {
-    runQuery();
+    if (shouldCloneIdRangesInParallel()) {
+        runIdRangeQueries();
+    } else {
+        runQuery();
+    }
     waitForDatabaseWorkToComplete();
     // We want to free the _collLoader regardless of whether the commit succeeds.
     std::unique_ptr<CollectionBulkLoader> loader = std::move(_collLoader);
@@ -371,17 +382,19 @@ void CollectionCloner::runQuery() {
     }
 }
 
-void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
-    {
-        stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
-        if (!getSharedData()->getStatus(lk).isOK()) {
-            static constexpr char message[] =
-                "Collection cloning cancelled due to initial sync failure";
-            LOGV2(21136, message, "error"_attr = getSharedData()->getStatus(lk));
-            uasserted(ErrorCodes::CallbackCanceled,
-                      str::stream() << message << ": " << getSharedData()->getStatus(lk));
-        }
+void CollectionCloner::uassertInitialSyncNotFailed() {
+    stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+    if (!getSharedData()->getStatus(lk).isOK()) {
+        static constexpr char message[] =
+            "Collection cloning cancelled due to initial sync failure";
+        LOGV2(21136, message, "error"_attr = getSharedData()->getStatus(lk));
+        uasserted(ErrorCodes::CallbackCanceled,
+                  str::stream() << message << ": " << getSharedData()->getStatus(lk));
     }
+}
+
+void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
+    uassertInitialSyncNotFailed();
 
     // If this is 'true', it means that something happened to our remote cursor for a reason other
     // than the collection being dropped, all while we were running a non-resumable (4.2) clone.
@@ -442,6 +455,256 @@ void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
         });
 }
 
+std::vector<CollectionCloner::IdRange> CollectionCloner::makeIdRanges(
+    const std::vector<BSONObj>& splitKeys) {
+    std::vector<IdRange> ranges;
+    ranges.reserve(splitKeys.size() + 1);
+    BSONObj min;
+    for (const auto& splitKey : splitKeys) {
+        IdRange range;
+        range.min = min;
+        range.max = splitKey.getOwned();
+        min = range.max;
+        ranges.push_back(std::move(range));
+    }
+    IdRange last;
+    last.min = min;
+    ranges.push_back(std::move(last));
+    return ranges;
+}
+
+Query CollectionCloner::makeIdRangeQuery(const IdRange& range) {
+    Query query;
+    query.hint(BSON("_id" << 1));
+    // A resumed range restarts at its last received document, which is skipped when it is
+    // received again.
+    const auto& min = range.lastIdCloned.isEmpty() ? range.min : range.lastIdCloned;
+    if (!min.isEmpty()) {
+        query.minKey(min);
+    }
+    if (!range.max.isEmpty()) {
+        query.maxKey(range.max);
+    }
+    return query;
+}
+
+bool CollectionCloner::shouldCloneIdRangesInParallel() {
+    if (_idRangesInitialized) {
+        return !_idRanges.empty();
+    }
+    _idRangesInitialized = true;
+
+    // Capped collections must be cloned in natural order, and ranges can only be resumed by _id.
+    const auto maxRanges = collectionClonerParallelRanges.load();
+    if (maxRanges <= 1 || !_resumeSupported || _collectionOptions.capped ||
+        _idIndexSpec.isEmpty()) {
+        return false;
+    }
+
+    long long bytesToCopy;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        bytesToCopy = _stats.bytesToCopy;
+    }
+    if (bytesToCopy < collectionClonerParallelRangeMinBytes.load()) {
+        return false;
+    }
+
+    // splitVector places a split point every half 'maxChunkSizeBytes', so ask for twice the
+    // desired range size.
+    BSONObj res;
+    getClient()->runCommand(_sourceNss.db().toString(),
+                            BSON("splitVector" << _sourceNss.ns() << "keyPattern"
+                                               << BSON("_id" << 1) << "maxChunkSizeBytes"
+                                               << 2 * (bytesToCopy / maxRanges) << "maxSplitPoints"
+                                               << maxRanges - 1),
+                            res,
+                            QueryOption_SecondaryOk);
+    if (auto status = getStatusFromCommandResult(res); !status.isOK()) {
+        LOGV2_DEBUG(5716282,
+                    1,
+                    "Cloning collection over a single cursor because it could not be split into "
+                    "_id ranges",
+                    "namespace"_attr = _sourceNss,
+                    "error"_attr = status);
+        return false;
+    }
+
+    std::vector<BSONObj> splitKeys;
+    for (auto&& splitKey : res.getField("splitKeys").Array()) {
+        splitKeys.push_back(splitKey.Obj());
+    }
+    if (splitKeys.empty()) {
+        return false;
+    }
+
+    _idRanges = makeIdRanges(splitKeys);
+    LOGV2(5716283,
+          "Cloning collection as parallel _id ranges",
+          "namespace"_attr = _sourceNss,
+          "numRanges"_attr = _idRanges.size(),
+          "bytesToCopy"_attr = bytesToCopy);
+    return true;
+}
+
+void CollectionCloner::runIdRangeQueries() {
+    const size_t numUnfinished = std::count_if(
+        _idRanges.begin(), _idRanges.end(), [](const IdRange& range) { return !range.done; });
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _nextIdRange = 0;
+        _idRangeQueriesStatus = Status::OK();
+    }
+
+    // The calling thread clones ranges over the cloner's own connection. Additional workers run on
+    // the database thread pool, each over a connection of its own, leaving one pool thread free so
+    // that the documents received keep being inserted while the ranges are cloned.
+    const auto maxThreads = getDBPool()->getStats().options.maxThreads;
+    const size_t numWorkers =
+        numUnfinished > 1 ? std::min(numUnfinished - 1, maxThreads - 1) : 0;
+    for (size_t i = 0; i < numWorkers; ++i) {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            ++_numIdRangeWorkers;
+        }
+        getDBPool()->schedule([this](Status status) {
+            ON_BLOCK_EXIT([this] {
+                stdx::lock_guard<Latch> lk(_mutex);
+                --_numIdRangeWorkers;
+                _idRangeWorkersCV.notify_all();
+            });
+            try {
+                uassertStatusOK(status);
+                auto client = _createClientFn();
+                uassertStatusOK(
+                    client->connect(getSource(), "CollectionClonerRange"_sd, boost::none));
+                uassertStatusOK(replAuthenticate(client.get())
+                                    .withContext(str::stream()
+                                                 << "Failed to authenticate to " << getSource()));
+                cloneIdRanges(client.get());
+            } catch (const DBException& e) {
+                cancelIdRangeQueries(e.toStatus());
+            }
+        });
+    }
+
+    try {
+        cloneIdRanges(getClient());
+    } catch (const DBException& e) {
+        cancelIdRangeQueries(e.toStatus());
+    }
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    _idRangeWorkersCV.wait(lk, [this] { return _numIdRangeWorkers == 0; });
+    // Ranges that failed or were cancelled keep their progress and are resumed if the stage is
+    // retried.
+    uassertStatusOK(_idRangeQueriesStatus);
+}
+
+void CollectionCloner::cloneIdRanges(DBClientConnection* client) {
+    while (true) {
+        IdRange* range;
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            while (_nextIdRange < _idRanges.size() && _idRanges[_nextIdRange].done) {
+                ++_nextIdRange;
+            }
+            if (!_idRangeQueriesStatus.isOK() || _nextIdRange == _idRanges.size()) {
+                return;
+            }
+            range = &_idRanges[_nextIdRange++];
+        }
+        cloneIdRange(client, range);
+    }
+}
+
+void CollectionCloner::cloneIdRange(DBClientConnection* client, IdRange* range) {
+    if (!range->lastIdCloned.isEmpty()) {
+        LOGV2_DEBUG(5716284,
+                    1,
+                    "Resuming clone of _id range",
+                    "namespace"_attr = _sourceNss,
+                    "lastIdCloned"_attr = redact(range->lastIdCloned));
+    }
+
+    client->query(
+        [this, range](DBClientCursorBatchIterator& iter) { handleNextIdRangeBatch(range, iter); },
+        _sourceDbAndUuid,
+        makeIdRangeQuery(*range),
+        nullptr /* fieldsToReturn */,
+        QueryOption_NoCursorTimeout | QueryOption_SecondaryOk |
+            (collectionClonerUsesExhaust ? QueryOption_Exhaust : 0),
+        _collectionClonerBatchSize,
+        ReadConcernArgs::kImplicitDefault);
+    range->done = true;
+}
+
+void CollectionCloner::cancelIdRangeQueries(Status status) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_idRangeQueriesStatus.isOK()) {
+        _idRangeQueriesStatus = std::move(status);
+    }
+}
+
+void CollectionCloner::handleNextIdRangeBatch(IdRange* range, DBClientCursorBatchIterator& iter) {
+    uassertInitialSyncNotFailed();
+
+    bool mustScheduleInsert;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        uassert(ErrorCodes::CallbackCanceled,
+                str::stream() << "Cloning of _id range cancelled because another range failed: "
+                              << _idRangeQueriesStatus,
+                _idRangeQueriesStatus.isOK());
+
+        _stats.receivedBatches++;
+        // An insertion is pending whenever the buffer is non-empty, and it will pick up any
+        // documents added here.
+        mustScheduleInsert = _documentsToInsert.empty();
+        while (iter.moreInCurrentBatch()) {
+            auto doc = iter.nextSafe();
+            auto id = doc["_id"];
+            if (!range->lastIdCloned.isEmpty() &&
+                id.woCompare(range->lastIdCloned.firstElement(), false) == 0) {
+                // The document a resumed range restarts at was already cloned.
+                continue;
+            }
+            range->lastIdCloned = BSON("_id" << id);
+            _documentsToInsert.emplace_back(std::move(doc));
+        }
+        mustScheduleInsert = mustScheduleInsert && !_documentsToInsert.empty();
+    }
+
+    if (mustScheduleInsert) {
+        uassertStatusOKWithContext(
+            _scheduleDbWorkFn([=](const executor::TaskExecutor::CallbackArgs& cbd) {
+                insertDocumentsCallback(cbd);
+            }).getStatus(),
+            str::stream() << "Error cloning collection '" << _sourceNss.ns() << "'");
+    }
+
+    initialSyncHangCollectionClonerAfterHandlingBatchResponse.executeIf(
+        [&](const BSONObj&) {
+            auto isCancelled = [&] {
+                stdx::lock_guard<Latch> lk(_mutex);
+                return !_idRangeQueriesStatus.isOK();
+            };
+            while (MONGO_unlikely(
+                       initialSyncHangCollectionClonerAfterHandlingBatchResponse.shouldFail()) &&
+                   !mustExit() && !isCancelled()) {
+                LOGV2(5716291,
+                      "initialSyncHangCollectionClonerAfterHandlingBatchResponse fail point "
+                      "enabled for an _id range. Blocking until fail point is disabled",
+                      "namespace"_attr = _sourceNss.toString());
+                mongo::sleepsecs(1);
+            }
+        },
+        [&](const BSONObj& data) {
+            auto nss = data["nss"].str();
+            return nss.empty() || nss == _sourceNss.toString();
+        });
+}
+
 void CollectionCloner::insertDocumentsCallback(const executor::TaskExecutor::CallbackArgs& cbd) {
     uassertStatusOK(cbd.status);
 
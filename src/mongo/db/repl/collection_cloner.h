@@ -29,13 +29,16 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <vector>
 
+#include "mongo/client/query.h"
 #include "mongo/db/repl/base_cloner.h"
 #include "mongo/db/repl/initial_sync_base_cloner.h"
 #include "mongo/db/repl/initial_sync_shared_data.h"
 #include "mongo/db/repl/task_runner.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/progress_meter.h"
 
 namespace mongo {
@@ -77,6 +80,41 @@ public:
     using ScheduleDbWorkFn = unique_function<StatusWith<executor::TaskExecutor::CallbackHandle>(
         executor::TaskExecutor::CallbackFn)>;
 
+    /**
+     * Type of function to create the additional connections used to clone _id ranges in parallel.
+     */
+    using CreateClientFn = std::function<std::unique_ptr<DBClientConnection>()>;
+
+    /**
+     * A contiguous range of the source collection's _id index that is cloned by its own query
+     * when the collection is large enough to be split. 'min' is inclusive and 'max' is
+     * exclusive, both as _id index keys. An empty bound leaves that side of the range open.
+     */
+    struct IdRange {
+        BSONObj min;
+        BSONObj max;
+
+        // _id index key of the last document received for this range. A retried query stage
+        // resumes the range from here instead of recloning it.
+        BSONObj lastIdCloned;
+
+        // Set once every document in the range has been received.
+        bool done = false;
+    };
+
+    /**
+     * Returns the ranges delimited by 'splitKeys', which must be sorted _id index keys such as
+     * those returned by the splitVector command. The first and last ranges are open-ended.
+     */
+    static std::vector<IdRange> makeIdRanges(const std::vector<BSONObj>& splitKeys);
+
+    /**
+     * Returns the query that reads the documents of 'range' that have not been received yet, in
+     * _id order. Bounds are expressed as index bounds rather than a filter so that ranges
+     * spanning several BSON types are not subject to type bracketing.
+     */
+    static Query makeIdRangeQuery(const IdRange& range);
+
     CollectionCloner(const NamespaceString& ns,
                      const CollectionOptions& collectionOptions,
                      InitialSyncSharedData* sharedData,
@@ -122,6 +160,15 @@ public:
         _scheduleDbWorkFn = std::move(scheduleDbWorkFn);
     }
 
+    /**
+     * Overrides how connections used to clone _id ranges in parallel are created.
+     *
+     * For testing only.
+     */
+    void setCreateClientFn_forTest(CreateClientFn createClientFn) {
+        _createClientFn = std::move(createClientFn);
+    }
+
 protected:
     ClonerStages getStages() final;
 
@@ -212,6 +259,49 @@ private:
      */
     void handleNextBatch(DBClientCursorBatchIterator& iter);
 
+    /**
+     * Throws if initial sync has failed, to terminate an in-progress query.
+     */
+    void uassertInitialSyncNotFailed();
+
+    /**
+     * Returns true if the collection should be cloned as several _id ranges in parallel. Splits
+     * the collection into '_idRanges' on the first call; later calls reuse those ranges so that a
+     * retried query stage resumes the ranges that were not finished.
+     */
+    bool shouldCloneIdRangesInParallel();
+
+    /**
+     * Clones every range in '_idRanges' that is not done yet. The calling thread clones ranges over
+     * the cloner's connection, alongside workers on the database thread pool that each have their
+     * own. The first error encountered cancels the other ranges, and is thrown once all range
+     * workers have exited.
+     */
+    void runIdRangeQueries();
+
+    /**
+     * Clones ranges over 'client' until none is left or the range queries have been cancelled.
+     */
+    void cloneIdRanges(DBClientConnection* client);
+
+    /**
+     * Clones a single _id range over 'client', resuming from its last received document.
+     */
+    void cloneIdRange(DBClientConnection* client, IdRange* range);
+
+    /**
+     * Stops the range queries in progress after their current batch, and keeps further ranges
+     * from being started. 'status' is reported by runIdRangeQueries() unless an earlier error
+     * was.
+     */
+    void cancelIdRangeQueries(Status status);
+
+    /**
+     * Buffers the documents from a range query batch and schedules their insertion, unless an
+     * insertion that will pick them up is already pending.
+     */
+    void handleNextIdRangeBatch(IdRange* range, DBClientCursorBatchIterator& iter);
+
     /**
      * Called whenever there is a new batch of documents ready from the DBClientConnection.
      *
@@ -278,6 +368,25 @@ private:
     // If true, it means we are starting a new query or resuming an interrupted one.
     bool _firstBatchOfQueryRound = true;  // (X)
 
+    // The ranges the collection was split into for parallel cloning. Empty if the collection is
+    // cloned over a single cursor. While the query stage runs, each element is only accessed by
+    // the range worker cloning it.
+    std::vector<IdRange> _idRanges;  // (X)
+
+    // Whether '_idRanges' has been computed.
+    bool _idRangesInitialized = false;  // (X)
+
+    // Creates the connections used by range workers.
+    CreateClientFn _createClientFn;  // (R)
+
+    // While the query stage clones '_idRanges', the index of the next range to hand out, the
+    // number of range workers running on the database thread pool, and the first error
+    // encountered by any range, which cancels the others.
+    size_t _nextIdRange = 0;                      // (M)
+    int _numIdRangeWorkers = 0;                   // (M)
+    Status _idRangeQueriesStatus = Status::OK();  // (M)
+    stdx::condition_variable _idRangeWorkersCV;   // (M)
+
     // Only set during non-resumable (4.2) queries.
     // Signifies that there were changes to the collection on the sync source that resulted in
     // our remote cursor getting killed.
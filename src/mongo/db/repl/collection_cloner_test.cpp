@@ -41,6 +41,7 @@
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace repl {
@@ -157,6 +158,39 @@ class CollectionClonerTestNonResumable : public CollectionClonerTest {
     }
 };
 
+class CollectionClonerTestParallelRanges : public CollectionClonerTest {
+protected:
+    void setUp() final {
+        CollectionClonerTest::setUp();
+        setInitialSyncId();
+
+        _parallelRangesDefault = collectionClonerParallelRanges.load();
+        _parallelRangeMinBytesDefault = collectionClonerParallelRangeMinBytes.load();
+        collectionClonerParallelRanges.store(4);
+        collectionClonerParallelRangeMinBytes.store(0);
+
+        // Split the collection into the ranges [MinKey, 3) and [3, MaxKey).
+        _mockServer->setCommandReply("replSetGetRBID", fromjson("{ok:1, rbid:1}"));
+        setMockServerReplies(BSON("size" << 10),
+                             createCountResponse(5),
+                             createCursorResponse(_nss.ns(), BSON_ARRAY(_idIndexSpec)));
+        _mockServer->setCommandReply(
+            "splitVector", BSON("splitKeys" << BSON_ARRAY(BSON("_id" << 3)) << "ok" << 1));
+        for (int i = 1; i <= 5; ++i) {
+            _mockServer->insert(_nss.ns(), BSON("_id" << i));
+        }
+    }
+
+    void tearDown() final {
+        collectionClonerParallelRanges.store(_parallelRangesDefault);
+        collectionClonerParallelRangeMinBytes.store(_parallelRangeMinBytesDefault);
+        CollectionClonerTest::tearDown();
+    }
+
+    int _parallelRangesDefault;
+    long long _parallelRangeMinBytesDefault;
+};
+
 TEST_F(CollectionClonerTestResumable, CollectionClonerPassesThroughErrorFromCollStatsCommand) {
     auto cloner = makeCollectionCloner();
     cloner->setStopAfterStage_forTest("count");
@@ -373,6 +407,184 @@ TEST_F(CollectionClonerTestResumable, InsertDocumentsSingleBatch) {
     ASSERT_EQUALS(1u, stats.receivedBatches);
 }
 
+TEST_F(CollectionClonerTestResumable, MakeIdRangesFromSplitKeys) {
+    auto ranges = CollectionCloner::makeIdRanges({BSON("_id" << 10), BSON("_id" << 20)});
+    ASSERT_EQUALS(3u, ranges.size());
+    ASSERT_BSONOBJ_EQ(BSONObj(), ranges[0].min);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 10), ranges[0].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 10), ranges[1].min);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 20), ranges[1].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 20), ranges[2].min);
+    ASSERT_BSONOBJ_EQ(BSONObj(), ranges[2].max);
+    for (const auto& range : ranges) {
+        ASSERT_FALSE(range.done);
+        ASSERT_TRUE(range.lastIdCloned.isEmpty());
+    }
+}
+
+TEST_F(CollectionClonerTestResumable, MakeIdRangeQueryResumesFromLastIdCloned) {
+    CollectionCloner::IdRange range;
+    range.min = BSON("_id" << 10);
+    range.max = BSON("_id" << 20);
+
+    auto query = CollectionCloner::makeIdRangeQuery(range);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1), query.getHint());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 10), query.obj["$min"].Obj());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 20), query.obj["$max"].Obj());
+
+    range.lastIdCloned = BSON("_id" << 15);
+    query = CollectionCloner::makeIdRangeQuery(range);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 15), query.obj["$min"].Obj());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 20), query.obj["$max"].Obj());
+
+    // Open-ended ranges have no bound on that side.
+    query = CollectionCloner::makeIdRangeQuery(CollectionCloner::IdRange());
+    ASSERT_FALSE(query.obj.hasField("$min"));
+    ASSERT_FALSE(query.obj.hasField("$max"));
+}
+
+TEST_F(CollectionClonerTestResumable, ParallelRangesFallBackToSingleCursorWithoutSplitPoints) {
+    auto parallelRangesDefault = collectionClonerParallelRanges.load();
+    auto parallelRangeMinBytesDefault = collectionClonerParallelRangeMinBytes.load();
+    collectionClonerParallelRanges.store(4);
+    collectionClonerParallelRangeMinBytes.store(0);
+    ON_BLOCK_EXIT([&]() {
+        collectionClonerParallelRanges.store(parallelRangesDefault);
+        collectionClonerParallelRangeMinBytes.store(parallelRangeMinBytesDefault);
+    });
+
+    setMockServerReplies(BSON("size" << 10),
+                         createCountResponse(2),
+                         createCursorResponse(_nss.ns(), BSON_ARRAY(_idIndexSpec)));
+    _mockServer->setCommandReply("splitVector", BSON("splitKeys" << BSONArray() << "ok" << 1));
+    _mockServer->insert(_nss.ns(), BSON("_id" << 1));
+    _mockServer->insert(_nss.ns(), BSON("_id" << 2));
+
+    auto cloner = makeCollectionCloner();
+    int clientsCreated = 0;
+    cloner->setCreateClientFn_forTest([&] {
+        ++clientsCreated;
+        return std::unique_ptr<DBClientConnection>();
+    });
+    ASSERT_OK(cloner->run());
+
+    ASSERT_EQUALS(0, clientsCreated);
+    ASSERT_EQUALS(2, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+}
+
+TEST_F(CollectionClonerTestParallelRanges, RangesAreClonedOverTheClonersConnection) {
+    auto cloner = makeCollectionCloner();
+    int clientsCreated = 0;
+    cloner->setCreateClientFn_forTest([&] {
+        ++clientsCreated;
+        return std::unique_ptr<DBClientConnection>();
+    });
+    auto queriesBefore = _mockServer->getQueryCount();
+    ASSERT_OK(cloner->run());
+
+    // The database thread pool of the fixture has a single thread, which is left for inserting
+    // documents, so both ranges are cloned one after the other by the cloner itself.
+    ASSERT_EQUALS(0, clientsCreated);
+    ASSERT_EQUALS(queriesBefore + 2, _mockServer->getQueryCount());
+    ASSERT_EQUALS(5, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+    ASSERT_EQUALS(5u, cloner->getStats().documentsCopied);
+}
+
+TEST_F(CollectionClonerTestParallelRanges, RetriedQueryResumesRangesFromLastIdCloned) {
+    auto afterBatchFailpoint =
+        globalFailPointRegistry().find("initialSyncHangCollectionClonerAfterHandlingBatchResponse");
+    auto timesEnteredAfterBatch = afterBatchFailpoint->setMode(FailPoint::alwaysOn, 0);
+
+    auto cloner = makeCollectionCloner();
+    cloner->setBatchSize_forTest(1);
+
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        ASSERT_OK(cloner->run());
+    });
+
+    // Wait for the first batch of the first range, then fail its next batch transiently, which
+    // cancels the second range before it starts.
+    afterBatchFailpoint->waitForTimesEntered(timesEnteredAfterBatch + 1);
+    auto failNextBatch = globalFailPointRegistry().find("mockCursorThrowErrorOnGetMore");
+    failNextBatch->setMode(FailPoint::nTimes, 1, fromjson("{errorType: 'HostUnreachable'}"));
+    afterBatchFailpoint->setMode(FailPoint::off, 0);
+    clonerThread.join();
+
+    // The first range resumed after {_id: 1} rather than starting over, which would have inserted
+    // that document twice.
+    ASSERT_EQUALS(5, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+    ASSERT_EQUALS(5u, cloner->getStats().documentsCopied);
+}
+
+TEST_F(CollectionClonerTestParallelRanges, FailedRangeKeepsOtherRangesFromStarting) {
+    auto cloner = makeCollectionCloner();
+    auto beforeStageFailPoint = globalFailPointRegistry().find("hangBeforeClonerStage");
+    auto timesEnteredBeforeStage = beforeStageFailPoint->setMode(
+        FailPoint::alwaysOn, 0, fromjson("{cloner: 'CollectionCloner', stage: 'query'}"));
+
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        ASSERT_EQUALS(ErrorCodes::UnknownError, cloner->run());
+    });
+
+    beforeStageFailPoint->waitForTimesEntered(timesEnteredBeforeStage + 1);
+    auto queriesBefore = _mockServer->getQueryCount();
+    auto failNextBatch = globalFailPointRegistry().find("mockCursorThrowErrorOnGetMore");
+    failNextBatch->setMode(FailPoint::nTimes, 1, fromjson("{errorType: 'UnknownError'}"));
+    beforeStageFailPoint->setMode(FailPoint::off, 0);
+    clonerThread.join();
+
+    // Only the first range was queried.
+    ASSERT_EQUALS(queriesBefore + 1, _mockServer->getQueryCount());
+    ASSERT_EQUALS(0, _collectionStats->insertCount);
+}
+
+TEST_F(CollectionClonerTestParallelRanges, FailedRangeCancelsConcurrentRanges) {
+    ThreadPool::Options options;
+    options.minThreads = 2U;
+    options.maxThreads = 2U;
+    options.onCreateThread = [](StringData threadName) { Client::initThread(threadName); };
+    ThreadPool dbPool(options);
+    dbPool.startup();
+
+    CollectionOptions collectionOptions;
+    collectionOptions.uuid = _collUuid;
+    auto cloner = std::make_unique<CollectionCloner>(_nss,
+                                                     collectionOptions,
+                                                     getSharedData(),
+                                                     _source,
+                                                     _mockClient.get(),
+                                                     &_storageInterface,
+                                                     &dbPool);
+    ON_BLOCK_EXIT([&] {
+        cloner.reset();
+        dbPool.shutdown();
+        dbPool.join();
+    });
+    cloner->setBatchSize_forTest(1);
+    int clientsCreated = 0;
+    cloner->setCreateClientFn_forTest([&]() -> std::unique_ptr<DBClientConnection> {
+        ++clientsCreated;
+        uasserted(ErrorCodes::UnknownError, "Failing range worker for test");
+    });
+
+    // Whichever range the cloner's own connection picks up hangs after its first batch until it
+    // is cancelled by the failure of the other worker.
+    auto afterBatchFailpoint =
+        globalFailPointRegistry().find("initialSyncHangCollectionClonerAfterHandlingBatchResponse");
+    afterBatchFailpoint->setMode(FailPoint::alwaysOn, 0);
+    ON_BLOCK_EXIT([&] { afterBatchFailpoint->setMode(FailPoint::off, 0); });
+
+    ASSERT_EQUALS(ErrorCodes::UnknownError, cloner->run());
+    ASSERT_EQUALS(1, clientsCreated);
+    ASSERT_LTE(_collectionStats->insertCount, 1);
+    ASSERT_FALSE(_collectionStats->commitCalled);
+}
+
 TEST_F(CollectionClonerTestResumable, BatchSizeStoredInConstructor) {
     auto batchSizeDefault = collectionClonerBatchSize;
     collectionClonerBatchSize = 3;
@@ -31,6 +31,8 @@
 
 #include "mongo/db/repl/oplog_applier_impl.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/database.h"
@@ -52,6 +54,7 @@
 #include "mongo/platform/basic.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/log_with_sampling.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -311,9 +314,8 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
 
         // Extract some info from ops that we'll need after releasing the batch below.
         const auto firstOpTimeInBatch = ops.front().getOpTime();
-        const auto lastOpInBatch = ops.back();
-        const auto lastOpTimeInBatch = lastOpInBatch.getOpTime();
-        const auto lastWallTimeInBatch = lastOpInBatch.getWallClockTime();
+        const auto lastOpTimeInBatch = ops.back().getOpTime();
+        const auto lastWallTimeInBatch = ops.back().getWallClockTime();
         const auto lastAppliedOpTimeAtStartOfBatch = _replCoord->getMyLastAppliedOpTime();
 
         // Make sure the oplog doesn't go back in time or repeat an entry.
@@ -331,6 +333,8 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
 
         // Apply the operations in this batch. '_applyOplogBatch' returns the optime of the
         // last op that was applied, which should be the last optime in the batch.
+        const auto numOpsInBatch = ops.getBatch().size();
+        Timer applyTimer;
         auto swLastOpTimeAppliedInBatch = _applyOplogBatch(&opCtx, ops.releaseBatch());
         if (swLastOpTimeAppliedInBatch.getStatus().code() == ErrorCodes::InterruptedAtShutdown) {
             // If an operation was interrupted at shutdown, fail the batch without advancing
@@ -341,6 +345,7 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
             return;
         }
         fassertNoTrace(34437, swLastOpTimeAppliedInBatch);
+        _oplogBatcher->recordBatchApplied(numOpsInBatch, Milliseconds(applyTimer.millis()));
         invariant(swLastOpTimeAppliedInBatch.getValue() == lastOpTimeInBatch);
 
         // Update various things that care about our last applied optime. Tests rely on 1 happening
@@ -453,7 +458,12 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
     // Increment the batch size stat.
     oplogApplicationBatchSize.increment(ops.size());
 
-    std::vector<WorkerMultikeyPathInfo> multikeyVector(_writerPool->getStats().options.maxThreads);
+    // Operations are hashed into more partitions than there are writer threads. Each non-empty
+    // partition is scheduled as its own task, so threads that finish their partitions early pick up
+    // the remaining ones instead of idling behind the thread that was assigned the most work.
+    const size_t numPartitions = _writerPool->getStats().options.maxThreads *
+        static_cast<size_t>(replWriterPartitionsPerThread);
+    std::vector<WorkerMultikeyPathInfo> multikeyVector(numPartitions);
     {
         // Each node records cumulative batch application stats for itself using this timer.
         TimerHolder timer(&applyBatchStats);
@@ -478,8 +488,7 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
         //   and create a pseudo oplog.
         std::vector<std::vector<OplogEntry>> derivedOps;
 
-        std::vector<std::vector<const OplogEntry*>> writerVectors(
-            _writerPool->getStats().options.maxThreads);
+        std::vector<std::vector<const OplogEntry*>> writerVectors(numPartitions);
         fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
 
         // Wait for writes to finish before applying ops.
@@ -506,15 +515,24 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
 
         {
 
-            std::vector<Status> statusVector(_writerPool->getStats().options.maxThreads,
-                                             Status::OK());
-            // Doles out all the work to the writer pool threads. writerVectors is not modified,
-            // but  applyOplogBatchPerWorker will modify the vectors that it contains.
+            std::vector<Status> statusVector(numPartitions, Status::OK());
             invariant(writerVectors.size() == statusVector.size());
+
+            // Schedule the largest partitions first so that the long-running tasks start as early
+            // as possible and the small ones fill in the gaps at the end of the batch.
+            std::vector<size_t> partitionOrder;
+            partitionOrder.reserve(writerVectors.size());
             for (size_t i = 0; i < writerVectors.size(); i++) {
-                if (writerVectors[i].empty())
-                    continue;
+                if (!writerVectors[i].empty())
+                    partitionOrder.push_back(i);
+            }
+            std::stable_sort(partitionOrder.begin(), partitionOrder.end(), [&](size_t l, size_t r) {
+                return writerVectors[l].size() > writerVectors[r].size();
+            });
 
+            // Doles out all the work to the writer pool threads. writerVectors is not modified,
+            // but  applyOplogBatchPerWorker will modify the vectors that it contains.
+            for (auto i : partitionOrder) {
                 _writerPool->schedule([this,
                                        &writer = writerVectors.at(i),
                                        &status = statusVector.at(i),
@@ -547,7 +565,7 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
                         "Failed to apply batch of operations. Number of operations in "
                         "batch: {numOperationsInBatch}. First operation: {firstOperation}. "
                         "Last operation: "
-                        "{lastOperation}. Oplog application failed in writer thread "
+                        "{lastOperation}. Oplog application failed in writer partition "
                         "{failedWriterThread}: {error}",
                         "Failed to apply batch of operations",
                         "numOperationsInBatch"_attr = ops.size(),
@@ -580,8 +598,8 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
     Timestamp firstTimeInBatch = ops.front().getTimestamp();
     // Set any indexes to multikey that this batch ignored. This must be done while holding the
     // parallel batch writer mode lock.
-    for (WorkerMultikeyPathInfo infoVector : multikeyVector) {
-        for (MultikeyPathInfo info : infoVector) {
+    for (const auto& infoVector : multikeyVector) {
+        for (const auto& info : infoVector) {
             // We timestamp every multikey write with the first timestamp in the batch. It is always
             // safe to set an index as multikey too early, just not too late. We conservatively pick
             // the first timestamp in the batch since we do not have enough information to find out
@@ -2512,6 +2512,57 @@ TEST_F(OplogApplierImplTest, SerializeOplogApplicationOfWritesToTenantMigrationN
     ASSERT_BSONOBJ_EQ(opsToApply[3].getEntry().toBSON(), applied[3].getEntry().toBSON());
 }
 
+TEST_F(OplogApplierImplTest, ApplyBatchWithMorePartitionsThanWriterThreadsPreservesDocumentOrder) {
+    auto partitionsPerThreadDefault = replWriterPartitionsPerThread;
+    replWriterPartitionsPerThread = 4;
+    ON_BLOCK_EXIT([&]() { replWriterPartitionsPerThread = partitionsPerThreadDefault; });
+
+    auto writerPool = makeReplWriterPool(2);
+    NoopOplogApplierObserver observer;
+    TrackOpsAppliedApplier oplogApplier(
+        nullptr,  // executor
+        nullptr,  // oplogBuffer
+        &observer,
+        ReplicationCoordinator::get(_opCtx.get()),
+        getConsistencyMarkers(),
+        getStorageInterface(),
+        repl::OplogApplier::Options(repl::OplogApplication::Mode::kSecondary),
+        writerPool.get());
+
+    // All operations target a single collection, so they are only spread across partitions by
+    // document _id.
+    const NamespaceString nss("test.t");
+    const int numDocs = 40;
+    std::vector<OplogEntry> opsToApply;
+    for (int i = 0; i < numDocs; ++i) {
+        opsToApply.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(1), i + 1), 1LL}, nss, BSON("_id" << i)));
+    }
+    for (int i = 0; i < numDocs; ++i) {
+        opsToApply.push_back(makeUpdateDocumentOplogEntry({Timestamp(Seconds(2), i + 1), 1LL},
+                                                          nss,
+                                                          BSON("_id" << i),
+                                                          BSON("$set" << BSON("x" << i))));
+    }
+
+    ASSERT_OK(oplogApplier.applyOplogBatch(_opCtx.get(), opsToApply));
+    const auto applied = oplogApplier.getOperationsApplied();
+    ASSERT_EQ(opsToApply.size(), applied.size());
+
+    // Every document must see its insert applied before its update.
+    std::vector<bool> inserted(numDocs, false);
+    for (const auto& op : applied) {
+        auto id = op.getIdElement().numberInt();
+        if (op.getOpType() == OpTypeEnum::kInsert) {
+            ASSERT_FALSE(inserted[id]);
+            inserted[id] = true;
+        } else {
+            ASSERT_TRUE(op.getOpType() == OpTypeEnum::kUpdate);
+            ASSERT_TRUE(inserted[id]) << "update applied before insert for _id " << id;
+        }
+    }
+}
+
 
 class OplogApplierImplTxnTableTest : public OplogApplierImplTest {
 public:
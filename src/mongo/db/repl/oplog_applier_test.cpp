@@ -38,7 +38,9 @@
 #include "mongo/db/repl/oplog_applier.h"
 #include "mongo/db/repl/oplog_batcher_test_fixture.h"
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace repl {
@@ -358,6 +360,88 @@ TEST_F(OplogApplierTest, LastOpInLargeTransactionIsProcessedIndividually) {
     ASSERT_EQUALS(srcOps[4], batch[0]);
 }
 
+TEST_F(OplogApplierTest, AdaptiveBatchLimitUsesConfiguredLimitWhenDisabled) {
+    auto targetDefault = replBatchTargetApplyMillis.load();
+    replBatchTargetApplyMillis.store(0);
+    ON_BLOCK_EXIT([&]() { replBatchTargetApplyMillis.store(targetDefault); });
+
+    OplogBatcher batcher(_applier.get(), _buffer.get());
+    batcher.recordBatchApplied(1000, Milliseconds(1000));
+    ASSERT_EQUALS(5000U, batcher.getAdaptiveBatchLimitOps(5000, 0));
+}
+
+TEST_F(OplogApplierTest, AdaptiveBatchLimitShrinksWhenBatchesExceedTarget) {
+    auto targetDefault = replBatchTargetApplyMillis.load();
+    replBatchTargetApplyMillis.store(100);
+    ON_BLOCK_EXIT([&]() { replBatchTargetApplyMillis.store(targetDefault); });
+
+    OplogBatcher batcher(_applier.get(), _buffer.get());
+
+    // No batch has been applied yet.
+    ASSERT_EQUALS(5000U, batcher.getAdaptiveBatchLimitOps(5000, 0));
+
+    // 5000 ops in 500ms, so 1000 ops fit in the 100ms target.
+    batcher.recordBatchApplied(5000, Milliseconds(500));
+    ASSERT_EQUALS(1000U, batcher.getAdaptiveBatchLimitOps(5000, 0));
+
+    // Each applied batch only adjusts the limit once.
+    ASSERT_EQUALS(1000U, batcher.getAdaptiveBatchLimitOps(5000, 0));
+
+    // Never smaller than the adaptive minimum, unless the configured limit is smaller.
+    OplogBatcher slowBatcher(_applier.get(), _buffer.get());
+    slowBatcher.recordBatchApplied(1, Milliseconds(60 * 1000));
+    ASSERT_EQUALS(100U, slowBatcher.getAdaptiveBatchLimitOps(5000, 0));
+    ASSERT_EQUALS(50U, slowBatcher.getAdaptiveBatchLimitOps(50, 0));
+}
+
+TEST_F(OplogApplierTest, AdaptiveBatchLimitGrowsWhenBufferIsDeep) {
+    auto targetDefault = replBatchTargetApplyMillis.load();
+    replBatchTargetApplyMillis.store(100);
+    ON_BLOCK_EXIT([&]() { replBatchTargetApplyMillis.store(targetDefault); });
+
+    OplogBatcher batcher(_applier.get(), _buffer.get());
+    batcher.recordBatchApplied(5000, Milliseconds(500));
+    ASSERT_EQUALS(1000U, batcher.getAdaptiveBatchLimitOps(5000, 0));
+
+    // A buffer holding less than a full batch leaves the limit alone.
+    ASSERT_EQUALS(1000U, batcher.getAdaptiveBatchLimitOps(5000, 999));
+
+    // A buffer holding a full batch means the node is lagging, so the limit grows even though the
+    // last batches took longer than the target, up to the configured limit.
+    batcher.recordBatchApplied(1000, Milliseconds(200));
+    ASSERT_EQUALS(2000U, batcher.getAdaptiveBatchLimitOps(5000, 1000));
+    ASSERT_EQUALS(4000U, batcher.getAdaptiveBatchLimitOps(5000, 100 * 1000));
+    ASSERT_EQUALS(5000U, batcher.getAdaptiveBatchLimitOps(5000, 100 * 1000));
+    ASSERT_EQUALS(5000U, batcher.getAdaptiveBatchLimitOps(5000, 100 * 1000));
+}
+
+TEST_F(OplogApplierTest, AdaptiveBatchLimitRecoversAfterSmallBatches) {
+    auto targetDefault = replBatchTargetApplyMillis.load();
+    replBatchTargetApplyMillis.store(100);
+    ON_BLOCK_EXIT([&]() { replBatchTargetApplyMillis.store(targetDefault); });
+
+    OplogBatcher batcher(_applier.get(), _buffer.get());
+    batcher.recordBatchApplied(1, Milliseconds(60 * 1000));
+    ASSERT_EQUALS(100U, batcher.getAdaptiveBatchLimitOps(5000, 0));
+
+    // Small batches applied within the target, as seen with a shallow buffer, have a low ops/ms
+    // rate but do not push the limit down further.
+    for (int i = 0; i < 10; ++i) {
+        batcher.recordBatchApplied(10, Milliseconds(5));
+        ASSERT_EQUALS(100U, batcher.getAdaptiveBatchLimitOps(5000, 10));
+    }
+
+    // Once the buffer is deep the limit climbs back to the configured limit.
+    std::size_t limit = 100;
+    for (int i = 0; i < 10 && limit < 5000U; ++i) {
+        batcher.recordBatchApplied(limit, Milliseconds(50));
+        auto nextLimit = batcher.getAdaptiveBatchLimitOps(5000, 10 * 1000);
+        ASSERT_GT(nextLimit, limit);
+        limit = nextLimit;
+    }
+    ASSERT_EQUALS(5000U, limit);
+}
+
 }  // namespace
 }  // namespace repl
 }  // namespace mongo
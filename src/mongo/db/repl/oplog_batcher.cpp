@@ -41,6 +41,12 @@ namespace mongo {
 namespace repl {
 MONGO_FAIL_POINT_DEFINE(skipOplogBatcherWaitForData);
 
+namespace {
+// Adaptive sizing never shrinks a batch below this many operations, so that a single slow batch
+// cannot collapse batching altogether.
+constexpr std::size_t kMinAdaptiveBatchLimitOps = 100;
+}  // namespace
+
 OplogBatcher::OplogBatcher(OplogApplier* oplogApplier, OplogBuffer* oplogBuffer)
     : _oplogApplier(oplogApplier), _oplogBuffer(oplogBuffer), _ops(0) {}
 OplogBatcher::~OplogBatcher() {
@@ -70,6 +76,46 @@ OplogBatch OplogBatcher::getNextBatch(Seconds maxWaitTime) {
     return ops;
 }
 
+void OplogBatcher::recordBatchApplied(std::size_t numOps, Milliseconds duration) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _lastBatchOps = numOps;
+    _lastBatchDuration = duration;
+}
+
+std::size_t OplogBatcher::getAdaptiveBatchLimitOps(std::size_t configuredLimitOps,
+                                                   std::size_t bufferedOps) {
+    const auto targetMillis = replBatchTargetApplyMillis.load();
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (targetMillis <= 0) {
+        _adaptiveBatchLimitOps = 0;
+        return configuredLimitOps;
+    }
+    if (_adaptiveBatchLimitOps == 0) {
+        _adaptiveBatchLimitOps = configuredLimitOps;
+    }
+
+    if (bufferedOps >= _adaptiveBatchLimitOps) {
+        // The buffer holds at least another full batch, so the applier is falling behind. Grow
+        // the batches to amortize the per-batch overhead, regardless of how long they take.
+        _adaptiveBatchLimitOps *= 2;
+    } else if (_lastBatchOps > 0 && _lastBatchDuration > Milliseconds(targetMillis)) {
+        // The applier is keeping up but the last batch took longer than the target. Shrink to the
+        // number of operations that batch could have applied within the target. Batches that
+        // finish within the target, such as the small batches seen when the buffer is shallow,
+        // never lower the limit.
+        _adaptiveBatchLimitOps = std::size_t(double(_lastBatchOps) * targetMillis /
+                                             double(_lastBatchDuration.count()));
+    }
+    // Each applied batch adjusts the limit at most once.
+    _lastBatchOps = 0;
+
+    _adaptiveBatchLimitOps =
+        std::max(std::min(_adaptiveBatchLimitOps, configuredLimitOps),
+                 std::min(kMinAdaptiveBatchLimitOps, configuredLimitOps));
+    return _adaptiveBatchLimitOps;
+}
+
 void OplogBatcher::startup(StorageInterface* storageInterface) {
     _thread = std::make_unique<stdx::thread>([this, storageInterface] { _run(storageInterface); });
 }
@@ -262,10 +308,11 @@ void OplogBatcher::_run(StorageInterface* storageInterface) {
         batchLimits.slaveDelayLatestTimestamp = _calculateSlaveDelayLatestTimestamp();
 
         // Check the limits once per batch since users can change them at runtime.
-        batchLimits.ops = getBatchLimitOplogEntries();
+        batchLimits.ops =
+            getAdaptiveBatchLimitOps(getBatchLimitOplogEntries(), _oplogBuffer->getCount());
 
         // Use the OplogBuffer to populate a local OplogBatch. Note that the buffer may be empty.
-        OplogBatch ops(batchLimits.ops);
+        OplogBatch ops(0);
         {
             auto opCtx = cc().makeOperationContext();
 
@@ -280,14 +327,12 @@ void OplogBatcher::_run(StorageInterface* storageInterface) {
             // Locks the oplog to check its max size, do this in the UninterruptibleLockGuard.
             batchLimits.bytes = getBatchLimitOplogBytes(opCtx.get(), storageInterface);
 
-            auto oplogEntries =
-                fassertNoTrace(31004, getNextApplierBatch(opCtx.get(), batchLimits));
-            for (const auto& oplogEntry : oplogEntries) {
-                ops.emplace_back(oplogEntry);
-            }
+            // The entries were parsed from the buffered documents, whose sub-objects share the
+            // fetched batch's buffer. Hand them over without copying.
+            ops = OplogBatch(fassertNoTrace(31004, getNextApplierBatch(opCtx.get(), batchLimits)));
 
             // If we don't have anything in the batch, wait a bit for something to appear.
-            if (oplogEntries.empty()) {
+            if (ops.empty()) {
                 if (_oplogApplier->inShutdown()) {
                     ops.setMustShutdownFlag();
                 } else {
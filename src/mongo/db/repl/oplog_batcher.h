@@ -49,6 +49,7 @@ public:
     explicit OplogBatch(std::size_t batchLimitOps) {
         _batch.reserve(batchLimitOps);
     }
+    explicit OplogBatch(std::vector<OplogEntry> batch) : _batch(std::move(batch)) {}
     bool empty() const {
         return _batch.empty();
     }
@@ -173,6 +174,25 @@ public:
     StatusWith<std::vector<OplogEntry>> getNextApplierBatch(OperationContext* opCtx,
                                                             const BatchLimits& batchLimits);
 
+    /**
+     * Records that the applier took 'duration' to apply a batch of 'numOps' oplog entries. The
+     * next call to getAdaptiveBatchLimitOps() uses it to size later batches when
+     * replBatchTargetApplyMillis is set.
+     */
+    void recordBatchApplied(std::size_t numOps, Milliseconds duration);
+
+    /**
+     * Returns the maximum number of operations the next batch may contain, given the configured
+     * limit and the number of operations currently waiting in the oplog buffer.
+     *
+     * When replBatchTargetApplyMillis is set, the limit doubles, up to the configured limit,
+     * whenever the buffer holds at least a full batch, since the node is then lagging and larger
+     * batches amortize the per-batch overhead. Otherwise, a batch that took longer than the target
+     * to apply shrinks the limit to what could have been applied within the target, which keeps
+     * lastApplied advancing smoothly. Called once per batch.
+     */
+    std::size_t getAdaptiveBatchLimitOps(std::size_t configuredLimitOps, std::size_t bufferedOps);
+
     /**
      * Helper method indicating that this oplog entry must be in a batch of its own.
      */
@@ -202,7 +222,7 @@ private:
     OplogApplier* _oplogApplier;
     OplogBuffer* const _oplogBuffer;
 
-    Mutex _mutex = MONGO_MAKE_LATCH("OplogBatcher::_mutex");
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("OplogBatcher::_mutex");
     stdx::condition_variable _cv;
 
     /**
@@ -210,6 +230,17 @@ private:
      */
     OplogBatch _ops;
 
+    /**
+     * The current adaptive batch limit, in operations. Zero until adaptive sizing is first used.
+     */
+    std::size_t _adaptiveBatchLimitOps = 0;
+
+    /**
+     * Size and apply time of the last applied batch not yet used to adjust the adaptive limit.
+     */
+    std::size_t _lastBatchOps = 0;
+    Milliseconds _lastBatchDuration{0};
+
     std::unique_ptr<stdx::thread> _thread;
 };
 
@@ -36,6 +36,7 @@
 #include <random>
 
 #include "mongo/db/s/balancer/type_migration.h"
+#include "mongo/db/s/sharding_config_server_parameters_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
@@ -58,6 +59,23 @@ namespace {
 // optimal average across all shards for a zone for a rebalancing migration to be initiated.
 const size_t kDefaultImbalanceThreshold = 1;
 
+/**
+ * Returns the hottest range reported by the shard, which matches the specified chunk, or nullptr
+ * if the chunk had no recent writes.
+ */
+const ClusterStatistics::RangeLoad* findRangeLoad(const ClusterStatistics::ShardStatistics& stat,
+                                                  const NamespaceString& nss,
+                                                  const ChunkType& chunk) {
+    for (const auto& rangeLoad : stat.hotRanges) {
+        if (rangeLoad.nss == nss && rangeLoad.min.woCompare(chunk.getMin()) == 0 &&
+            rangeLoad.max.woCompare(chunk.getMax()) == 0) {
+            return &rangeLoad;
+        }
+    }
+
+    return nullptr;
+}
+
 }  // namespace
 
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
@@ -548,6 +566,16 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
             ;
     }
 
+    // 4) If the chunks are balanced, balance the write load
+    if (migrations.empty()) {
+        _singleLoadBalance(shardStats,
+                           distribution,
+                           &migrations,
+                           usedShards,
+                           forceJumbo ? MoveChunkRequest::ForceJumbo::kForceBalancer
+                                      : MoveChunkRequest::ForceJumbo::kDoNotForce);
+    }
+
     return migrations;
 }
 
@@ -624,8 +652,12 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
         return false;
 
     const vector<ChunkType>& chunks = distribution.getChunks(from);
+    const auto& fromStat = *std::find_if(shardStats.begin(),
+                                         shardStats.end(),
+                                         [&](const auto& stat) { return stat.shardId == from; });
 
     unsigned numJumboChunks = 0;
+    const ChunkType* chunkToMove = nullptr;
 
     for (const auto& chunk : chunks) {
         if (distribution.getTagForChunk(chunk) != tag)
@@ -636,8 +668,20 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
             continue;
         }
 
-        migrations->emplace_back(to, chunk, forceJumbo, MigrateInfo::chunksImbalance);
-        invariant(usedShards->insert(chunk.getShard()).second);
+        if (!chunkToMove)
+            chunkToMove = &chunk;
+
+        // Prefer moving a chunk without recent writes, so that balancing the number of chunks does
+        // not undo the migrations made to balance the write load
+        if (!findRangeLoad(fromStat, distribution.nss(), chunk)) {
+            chunkToMove = &chunk;
+            break;
+        }
+    }
+
+    if (chunkToMove) {
+        migrations->emplace_back(to, *chunkToMove, forceJumbo, MigrateInfo::chunksImbalance);
+        invariant(usedShards->insert(chunkToMove->getShard()).second);
         invariant(usedShards->insert(to).second);
         return true;
     }
@@ -657,6 +701,97 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+bool BalancerPolicy::_singleLoadBalance(const ShardStatisticsVector& shardStats,
+                                        const DistributionStatus& distribution,
+                                        vector<MigrateInfo>* migrations,
+                                        set<ShardId>* usedShards,
+                                        MoveChunkRequest::ForceJumbo forceJumbo) {
+    const double imbalanceRatio = balancerLoadImbalanceRatio.load();
+    if (imbalanceRatio < 1)
+        return false;
+
+    const ClusterStatistics::ShardStatistics* from = nullptr;
+    const ClusterStatistics::ShardStatistics* to = nullptr;
+    uint64_t maxWriteOps = 0;
+    uint64_t minWriteOps = numeric_limits<uint64_t>::max();
+
+    for (const auto& stat : shardStats) {
+        if (usedShards->count(stat.shardId) || stat.isDraining)
+            continue;
+
+        // The shard reports the writes to all ranges of the collection, not only the hottest ones
+        auto collectionWriteOpsIt = stat.collectionWriteOps.find(distribution.nss());
+        const uint64_t writeOps = collectionWriteOpsIt != stat.collectionWriteOps.end()
+            ? collectionWriteOpsIt->second
+            : 0;
+
+        if (!from || writeOps > maxWriteOps) {
+            from = &stat;
+            maxWriteOps = writeOps;
+        }
+
+        if (!to || writeOps < minWriteOps) {
+            to = &stat;
+            minWriteOps = writeOps;
+        }
+    }
+
+    if (!from || !to || from == to)
+        return false;
+
+    if (maxWriteOps < static_cast<uint64_t>(balancerMinWriteOpsForLoadImbalance.load()) ||
+        maxWriteOps < imbalanceRatio * std::max<uint64_t>(minWriteOps, 1))
+        return false;
+
+    const uint64_t loadDifference = maxWriteOps - minWriteOps;
+    const vector<ChunkType>& chunks = distribution.getChunks(from->shardId);
+
+    const ChunkType* chunkToMove = nullptr;
+    uint64_t remainingLoadDifference = loadDifference;
+
+    for (const auto& rangeLoad : from->hotRanges) {
+        if (rangeLoad.nss != distribution.nss() || rangeLoad.writeOps >= loadDifference)
+            continue;
+
+        const uint64_t loadDifferenceAfterMove = rangeLoad.writeOps * 2 > loadDifference
+            ? rangeLoad.writeOps * 2 - loadDifference
+            : loadDifference - rangeLoad.writeOps * 2;
+        if (loadDifferenceAfterMove >= remainingLoadDifference)
+            continue;
+
+        auto it = std::find_if(chunks.begin(), chunks.end(), [&](const ChunkType& chunk) {
+            return rangeLoad.min.woCompare(chunk.getMin()) == 0 &&
+                rangeLoad.max.woCompare(chunk.getMax()) == 0;
+        });
+        if (it == chunks.end() || it->getJumbo())
+            continue;
+
+        if (!isShardSuitableReceiver(*to, distribution.getTagForChunk(*it)).isOK())
+            continue;
+
+        chunkToMove = &(*it);
+        remainingLoadDifference = loadDifferenceAfterMove;
+    }
+
+    LOGV2_DEBUG(5716286,
+                1,
+                "Balancing write load",
+                "namespace"_attr = distribution.nss().ns(),
+                "fromShardId"_attr = from->shardId,
+                "fromShardWriteOps"_attr = maxWriteOps,
+                "toShardId"_attr = to->shardId,
+                "toShardWriteOps"_attr = minWriteOps,
+                "chunk"_attr = chunkToMove ? redact(chunkToMove->toString()) : "none");
+
+    if (!chunkToMove)
+        return false;
+
+    migrations->emplace_back(to->shardId, *chunkToMove, forceJumbo, MigrateInfo::loadImbalance);
+    invariant(usedShards->insert(from->shardId).second);
+    invariant(usedShards->insert(to->shardId).second);
+    return true;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
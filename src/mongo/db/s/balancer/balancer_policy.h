@@ -54,7 +54,7 @@ struct ZoneRange {
 };
 
 struct MigrateInfo {
-    enum MigrationReason { drain, zoneViolation, chunksImbalance };
+    enum MigrationReason { drain, zoneViolation, chunksImbalance, loadImbalance };
 
     MigrateInfo(const ShardId& a_to,
                 const ChunkType& a_chunk,
@@ -229,7 +229,9 @@ public:
      *
      * The balancing logic calculates the optimum number of chunks per shard for each zone and if
      * any of the shards have chunks, which are sufficiently higher than this number, suggests
-     * moving chunks to shards, which are under this number.
+     * moving chunks to shards, which are under this number. Once the chunks are balanced, if load
+     * based balancing is enabled, suggests moving a hot chunk from the shard with the most writes
+     * to the collection to the shard with the fewest.
      *
      * The usedShards parameter is in/out and it contains the set of shards, which have already been
      * used for migrations. Used so we don't return multiple conflicting migrations for the same
@@ -286,6 +288,22 @@ private:
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards,
                                    MoveChunkRequest::ForceJumbo forceJumbo);
+
+    /**
+     * Selects one chunk to be moved from the shard with the most recent writes to the collection
+     * to the shard with the fewest, if the former has more than 'balancerLoadImbalanceRatio' times
+     * the writes of the latter. Among the hottest ranges reported by the donor, picks the one whose
+     * move brings the write load of the two shards closest to each other. A range with more writes
+     * than the difference between the two shards is never moved, since that would only move the
+     * hot spot. Such a range has to be split first.
+     *
+     * Returns true if a migration was suggested, false otherwise.
+     */
+    static bool _singleLoadBalance(const ShardStatisticsVector& shardStats,
+                                   const DistributionStatus& distribution,
+                                   std::vector<MigrateInfo>* migrations,
+                                   std::set<ShardId>* usedShards,
+                                   MoveChunkRequest::ForceJumbo forceJumbo);
 };
 
 }  // namespace mongo
@@ -33,9 +33,11 @@
 
 #include "mongo/db/keypattern.h"
 #include "mongo/db/s/balancer/balancer_policy.h"
+#include "mongo/db/s/sharding_config_server_parameters_gen.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -692,6 +694,103 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(balanceChunks(cluster.first, distribution, false, false).empty());
 }
 
+TEST(BalancerPolicy, BalancerMovesChunkToEvenOutWriteLoad) {
+    const auto originalRatio = balancerLoadImbalanceRatio.load();
+    balancerLoadImbalanceRatio.store(2);
+    ON_BLOCK_EXIT([&] { balancerLoadImbalanceRatio.store(originalRatio); });
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3}});
+
+    cluster.first[0].collectionWriteOps = {{kNamespace, 3000}};
+    cluster.first[0].hotRanges = {{kNamespace, BSON("x" << 1), BSON("x" << 2), 2000, 0},
+                                  {kNamespace, BSON("x" << MINKEY), BSON("x" << 1), 500, 0},
+                                  {kNamespace, BSON("x" << 2), BSON("x" << 3), 500, 0}};
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(BSON("x" << 1), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(BSON("x" << 2), migrations[0].maxKey);
+    ASSERT_EQ(MigrateInfo::loadImbalance, migrations[0].reason);
+}
+
+TEST(BalancerPolicy, BalancerDoesNotMoveChunkWithMoreWritesThanTheImbalance) {
+    const auto originalRatio = balancerLoadImbalanceRatio.load();
+    balancerLoadImbalanceRatio.store(2);
+    ON_BLOCK_EXIT([&] { balancerLoadImbalanceRatio.store(originalRatio); });
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3}});
+
+    // Moving the only hot chunk would just make the other shard hot
+    cluster.first[0].collectionWriteOps = {{kNamespace, 5000}};
+    cluster.first[0].hotRanges = {{kNamespace, BSON("x" << 1), BSON("x" << 2), 5000, 0}};
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false, false));
+    ASSERT(migrations.empty());
+}
+
+TEST(BalancerPolicy, BalancerCountsWritesToRangesWhichAreNotAmongTheHottest) {
+    const auto originalRatio = balancerLoadImbalanceRatio.load();
+    balancerLoadImbalanceRatio.store(2);
+    ON_BLOCK_EXIT([&] { balancerLoadImbalanceRatio.store(originalRatio); });
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3}});
+
+    // Judged by the reported range alone, moving it would only move the hot spot. The writes to
+    // the other ranges of the donor make the difference large enough.
+    cluster.first[0].collectionWriteOps = {{kNamespace, 5000}};
+    cluster.first[0].hotRanges = {{kNamespace, BSON("x" << 1), BSON("x" << 2), 2000, 0}};
+    cluster.first[1].collectionWriteOps = {{kNamespace, 2000}};
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(BSON("x" << 1), migrations[0].minKey);
+    ASSERT_EQ(MigrateInfo::loadImbalance, migrations[0].reason);
+}
+
+TEST(BalancerPolicy, BalancerIgnoresWriteLoadWhenLoadBalancingIsDisabled) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, kNoMaxSize, 3, false, emptyTagSet, emptyShardVersion), 3}});
+
+    cluster.first[0].collectionWriteOps = {{kNamespace, 2500}};
+    cluster.first[0].hotRanges = {{kNamespace, BSON("x" << 1), BSON("x" << 2), 2000, 0},
+                                  {kNamespace, BSON("x" << 2), BSON("x" << 3), 500, 0}};
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false, false));
+    ASSERT(migrations.empty());
+}
+
+TEST(BalancerPolicy, BalancerPrefersMovingChunksWithoutWritesToBalanceChunkCounts) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 4, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+
+    cluster.first[0].collectionWriteOps = {{kNamespace, 2000}};
+    cluster.first[0].hotRanges = {{kNamespace, BSON("x" << MINKEY), BSON("x" << 1), 2000, 0}};
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(BSON("x" << 1), migrations[0].minKey);
+    ASSERT_EQ(MigrateInfo::chunksImbalance, migrations[0].reason);
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
@@ -73,6 +73,8 @@ BSONObj ClusterStatistics::ShardStatistics::toBSON() const {
     }
 
     builder.append("version", mongoVersion);
+    builder.append("writeOps", static_cast<long long>(writeOps));
+    builder.append("bytesWritten", static_cast<long long>(bytesWritten));
     return builder.obj();
 }
 
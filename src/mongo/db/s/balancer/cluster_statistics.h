@@ -29,11 +29,14 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/s/client/shard.h"
 
 namespace mongo {
@@ -53,6 +56,17 @@ class ClusterStatistics {
     ClusterStatistics& operator=(const ClusterStatistics&) = delete;
 
 public:
+    /**
+     * Structure, which describes the write load on a single chunk range of a shard.
+     */
+    struct RangeLoad {
+        NamespaceString nss;
+        BSONObj min;
+        BSONObj max;
+        uint64_t writeOps{0};
+        uint64_t bytesWritten{0};
+    };
+
     /**
      * Structure, which describes the statistics of a single shard host.
      */
@@ -93,6 +107,19 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // Number of writes and bytes written to sharded collections on this shard over the recent
+        // load reporting window
+        uint64_t writeOps{0};
+        uint64_t bytesWritten{0};
+
+        // Number of writes to each sharded collection on this shard over the recent load
+        // reporting window, including those to ranges not listed in 'hotRanges'
+        std::map<NamespaceString, uint64_t> collectionWriteOps;
+
+        // The ranges with the most writes on this shard over the recent load reporting window, in
+        // descending order of writes
+        std::vector<RangeLoad> hotRanges;
     };
 
     virtual ~ClusterStatistics();
@@ -49,16 +49,16 @@ namespace mongo {
 namespace {
 
 const char kVersionField[] = "version";
+const char kShardingLoadField[] = "shardingLoad";
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard, including the write load
+ * statistics, which are not reported by default.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Returns the serverStatus response or an error. Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -70,7 +70,8 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
         shard->runCommandWithFixedRetryAttempts(opCtx,
                                                 ReadPreferenceSetting{ReadPreference::PrimaryOnly},
                                                 "admin",
-                                                BSON("serverStatus" << 1),
+                                                BSON("serverStatus" << 1 << kShardingLoadField
+                                                                    << 1),
                                                 Shard::RetryPolicy::kIdempotent);
     if (!commandResponse.isOK()) {
         return commandResponse.getStatus();
@@ -79,8 +80,16 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
 
+/**
+ * Extracts the version of the running MongoD service from a serverStatus response.
+ *
+ * Returns the MongoD version in strig format or an error. Known error codes are:
+ *  NoSuchKey if the version could not be retrieved
+ */
+StatusWith<std::string> extractShardMongoDVersion(const BSONObj& serverStatus) {
     std::string version;
     Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
     if (!status.isOK()) {
@@ -90,6 +99,39 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
     return version;
 }
 
+/**
+ * Fills in the recent write load of the shard from a serverStatus response. The shard computes the
+ * load over its own reporting window, so the values are used as they are.
+ */
+void extractShardLoad(const BSONObj& serverStatus, ClusterStatistics::ShardStatistics* stat) {
+    const auto shardingLoad = serverStatus[kShardingLoadField];
+    if (shardingLoad.type() != Object) {
+        return;
+    }
+
+    const auto shardingLoadObj = shardingLoad.Obj();
+    stat->writeOps = shardingLoadObj["writeOps"].safeNumberLong();
+    stat->bytesWritten = shardingLoadObj["bytesWritten"].safeNumberLong();
+
+    for (const auto& collectionElem : shardingLoadObj.getObjectField("collections")) {
+        const auto collectionObj = collectionElem.Obj();
+        stat->collectionWriteOps[NamespaceString(collectionObj["ns"].String())] =
+            collectionObj["writeOps"].safeNumberLong();
+    }
+
+    for (const auto& rangeElem : shardingLoadObj.getObjectField("hotRanges")) {
+        const auto rangeObj = rangeElem.Obj();
+
+        ClusterStatistics::RangeLoad rangeLoad;
+        rangeLoad.nss = NamespaceString(rangeObj["ns"].String());
+        rangeLoad.min = rangeObj["min"].Obj().getOwned();
+        rangeLoad.max = rangeObj["max"].Obj().getOwned();
+        rangeLoad.writeOps = rangeObj["writeOps"].safeNumberLong();
+        rangeLoad.bytesWritten = rangeObj["bytesWritten"].safeNumberLong();
+        stat->hotRanges.push_back(std::move(rangeLoad));
+    }
+}
+
 }  // namespace
 
 using ShardStatistics = ClusterStatistics::ShardStatistics;
@@ -135,7 +177,10 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
 
         std::string mongoDVersion;
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
+        auto serverStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        auto mongoDVersionStatus = serverStatus.isOK()
+            ? extractShardMongoDVersion(serverStatus.getValue())
+            : StatusWith<std::string>(serverStatus.getStatus());
         if (mongoDVersionStatus.isOK()) {
             mongoDVersion = std::move(mongoDVersionStatus.getValue());
         } else {
@@ -160,6 +205,12 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+
+        // Like the version, the load is only advisory, so a shard which could not report it is
+        // simply treated as having no load
+        if (serverStatus.isOK()) {
+            extractShardLoad(serverStatus.getValue(), &stats.back());
+        }
     }
 
     return stats;
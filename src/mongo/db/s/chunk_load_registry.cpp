@@ -0,0 +1,187 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_load_registry.h"
+
+#include <algorithm>
+#include <map>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/s/chunk.h"
+#include "mongo/s/chunk_writes_tracker.h"
+
+namespace mongo {
+namespace {
+
+const auto getChunkLoadRegistry = ServiceContext::declareDecoration<ChunkLoadRegistry>();
+
+}  // namespace
+
+ChunkLoadRegistry& ChunkLoadRegistry::get(ServiceContext* serviceContext) {
+    return getChunkLoadRegistry(serviceContext);
+}
+
+ChunkLoadRegistry& ChunkLoadRegistry::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+void ChunkLoadRegistry::recordWrite(const NamespaceString& nss,
+                                    const Chunk& chunk,
+                                    uint64_t bytesWritten) {
+    auto writesTracker = chunk.getWritesTracker();
+    writesTracker->addOperation(bytesWritten);
+
+    if (!writesTracker->markRegisteredForLoadReporting()) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    // Drop the entries of chunks which are no longer part of the routing information whenever the
+    // registry has doubled in size, so that its size stays proportional to the number of chunks.
+    if (_entries.size() >= 2 * std::max<size_t>(_entriesAfterLastPrune, 64)) {
+        _entries.erase(std::remove_if(_entries.begin(),
+                                      _entries.end(),
+                                      [](const Entry& entry) {
+                                          return entry.writesTracker.expired();
+                                      }),
+                       _entries.end());
+        _entriesAfterLastPrune = _entries.size();
+    }
+
+    _entries.push_back({nss, chunk.getMin(), chunk.getMax(), std::move(writesTracker)});
+}
+
+void ChunkLoadRegistry::report(BSONObjBuilder* builder, size_t maxRanges, Date_t now) {
+    struct RangeLoad {
+        const Entry* entry;
+        uint64_t writeOps;
+        uint64_t bytesWritten;
+    };
+
+    struct CollectionLoad {
+        uint64_t writeOps{0};
+        uint64_t bytesWritten{0};
+    };
+
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    _entries.erase(std::remove_if(_entries.begin(),
+                                  _entries.end(),
+                                  [](const Entry& entry) { return entry.writesTracker.expired(); }),
+                   _entries.end());
+    _entriesAfterLastPrune = _entries.size();
+
+    std::vector<RangeLoad> rangeLoads;
+    std::map<NamespaceString, CollectionLoad> collectionLoads;
+    uint64_t totalWriteOps = 0;
+    uint64_t totalBytesWritten = 0;
+
+    for (auto& entry : _entries) {
+        auto writesTracker = entry.writesTracker.lock();
+        if (!writesTracker)
+            continue;
+
+        const Snapshot current{
+            writesTracker->getNumOperations(), writesTracker->getOperationBytes(), now};
+
+        // A range registered since the last report received all of its writes since then, whereas
+        // the writes made before the very first report are not attributed to any window
+        if (!entry.baseline) {
+            entry.baseline = _lastReportedAt ? Snapshot{0, 0, *_lastReportedAt} : current;
+        }
+
+        if (!entry.next) {
+            if (now - entry.baseline->takenAt >= kLoadReportingWindow) {
+                entry.next = current;
+            }
+        } else if (now - entry.next->takenAt >= kLoadReportingWindow) {
+            entry.baseline = std::move(entry.next);
+            entry.next = current;
+        }
+
+        const uint64_t writeOps =
+            current.writeOps - std::min(current.writeOps, entry.baseline->writeOps);
+        const uint64_t bytesWritten =
+            current.bytesWritten - std::min(current.bytesWritten, entry.baseline->bytesWritten);
+        if (writeOps == 0)
+            continue;
+
+        rangeLoads.push_back({&entry, writeOps, bytesWritten});
+
+        auto& collectionLoad = collectionLoads[entry.nss];
+        collectionLoad.writeOps += writeOps;
+        collectionLoad.bytesWritten += bytesWritten;
+
+        totalWriteOps += writeOps;
+        totalBytesWritten += bytesWritten;
+    }
+
+    _lastReportedAt = now;
+
+    builder->append("writeOps", static_cast<long long>(totalWriteOps));
+    builder->append("bytesWritten", static_cast<long long>(totalBytesWritten));
+
+    BSONArrayBuilder collectionsBuilder(builder->subarrayStart("collections"));
+    for (const auto& [nss, collectionLoad] : collectionLoads) {
+        BSONObjBuilder collectionBuilder(collectionsBuilder.subobjStart());
+        collectionBuilder.append("ns", nss.ns());
+        collectionBuilder.append("writeOps", static_cast<long long>(collectionLoad.writeOps));
+        collectionBuilder.append("bytesWritten",
+                                 static_cast<long long>(collectionLoad.bytesWritten));
+    }
+    collectionsBuilder.doneFast();
+
+    const auto numRanges = std::min(maxRanges, rangeLoads.size());
+    std::partial_sort(rangeLoads.begin(),
+                      rangeLoads.begin() + numRanges,
+                      rangeLoads.end(),
+                      [](const RangeLoad& lhs, const RangeLoad& rhs) {
+                          return lhs.writeOps > rhs.writeOps;
+                      });
+
+    BSONArrayBuilder rangesBuilder(builder->subarrayStart("hotRanges"));
+    for (size_t i = 0; i < numRanges; ++i) {
+        const auto& rangeLoad = rangeLoads[i];
+
+        BSONObjBuilder rangeBuilder(rangesBuilder.subobjStart());
+        rangeBuilder.append("ns", rangeLoad.entry->nss.ns());
+        rangeBuilder.append("min", rangeLoad.entry->min);
+        rangeBuilder.append("max", rangeLoad.entry->max);
+        rangeBuilder.append("writeOps", static_cast<long long>(rangeLoad.writeOps));
+        rangeBuilder.append("bytesWritten", static_cast<long long>(rangeLoad.bytesWritten));
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class Chunk;
+class ChunkWritesTracker;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Keeps track of the chunks of sharded collections which have received writes on this shard, so
+ * that the load per chunk range can be reported to the balancer. The counters themselves live in
+ * the ChunkWritesTracker of each chunk, so a range stops being reported once the routing
+ * information it belongs to has been replaced (for example after the chunk was split or moved).
+ *
+ * The load is reported as the number of writes over a recent window of between one and two times
+ * kLoadReportingWindow, measured against a snapshot of the counters of each range which rolls
+ * forward as the load is reported. This keeps the reported load independent of how often it is
+ * requested and of the lifetime of the chunk.
+ *
+ * There is one instance of this object per service context.
+ */
+class ChunkLoadRegistry {
+    ChunkLoadRegistry(const ChunkLoadRegistry&) = delete;
+    ChunkLoadRegistry& operator=(const ChunkLoadRegistry&) = delete;
+
+public:
+    ChunkLoadRegistry() = default;
+
+    // The minimum age of the snapshot against which the recent writes of a range are computed
+    static constexpr Minutes kLoadReportingWindow{1};
+
+    static ChunkLoadRegistry& get(ServiceContext* serviceContext);
+    static ChunkLoadRegistry& get(OperationContext* opCtx);
+
+    /**
+     * Records a write of 'bytesWritten' bytes to the specified chunk of collection 'nss'.
+     */
+    void recordWrite(const NamespaceString& nss, const Chunk& chunk, uint64_t bytesWritten);
+
+    /**
+     * Appends the number of recent writes and bytes written on this shard, in total and for each
+     * collection, along with up to 'maxRanges' of the ranges with the most recent writes, in
+     * descending order of writes. Ranges without recent writes are not reported.
+     */
+    void report(BSONObjBuilder* builder, size_t maxRanges, Date_t now);
+
+private:
+    struct Snapshot {
+        uint64_t writeOps;
+        uint64_t bytesWritten;
+        Date_t takenAt;
+    };
+
+    struct Entry {
+        NamespaceString nss;
+        BSONObj min;
+        BSONObj max;
+        std::weak_ptr<ChunkWritesTracker> writesTracker;
+
+        // The counters against which the recent writes are computed, which are replaced by the
+        // next snapshot once that one is old enough. Not set until the range is first reported.
+        boost::optional<Snapshot> baseline;
+        boost::optional<Snapshot> next;
+    };
+
+    // Protects the members below
+    Mutex _mutex = MONGO_MAKE_LATCH("ChunkLoadRegistry::_mutex");
+
+    // One entry for each chunk which received writes, until its writes tracker is destroyed
+    std::vector<Entry> _entries;
+
+    // When the load was last reported. All the writes to ranges registered since then were made
+    // after that time.
+    boost::optional<Date_t> _lastReportedAt;
+
+    // Size of _entries after expired entries were last removed
+    size_t _entriesAfterLastPrune{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,197 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_load_registry.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/chunk.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.foo");
+const ShardId kShardId("shard0");
+
+std::unique_ptr<ChunkInfo> makeChunkInfo(const BSONObj& min, const BSONObj& max) {
+    ChunkType chunkType(kNss,
+                        ChunkRange{min, max},
+                        ChunkVersion{1, 0, OID::gen(), boost::none /* timestamp */},
+                        kShardId);
+    return std::make_unique<ChunkInfo>(chunkType);
+}
+
+BSONObj report(ChunkLoadRegistry& registry, Date_t now, size_t maxRanges = 10) {
+    BSONObjBuilder builder;
+    registry.report(&builder, maxRanges, now);
+    return builder.obj();
+}
+
+TEST(ChunkLoadRegistryTest, ReportsHottestRangesFirst) {
+    ChunkLoadRegistry registry;
+    const auto start = Date_t::now();
+    report(registry, start);
+
+    auto coldChunkInfo = makeChunkInfo(BSON("a" << MINKEY), BSON("a" << 0));
+    auto hotChunkInfo = makeChunkInfo(BSON("a" << 0), BSON("a" << MAXKEY));
+
+    registry.recordWrite(kNss, Chunk(*coldChunkInfo, boost::none), 10);
+    for (int i = 0; i < 3; ++i) {
+        registry.recordWrite(kNss, Chunk(*hotChunkInfo, boost::none), 100);
+    }
+
+    const auto loadReport = report(registry, start + Seconds(10));
+    ASSERT_EQ(4, loadReport["writeOps"].numberLong());
+    ASSERT_EQ(310, loadReport["bytesWritten"].numberLong());
+
+    const auto hotRanges = loadReport["hotRanges"].Array();
+    ASSERT_EQ(2U, hotRanges.size());
+    ASSERT_EQ(kNss.ns(), hotRanges[0]["ns"].str());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 0), hotRanges[0]["min"].Obj());
+    ASSERT_BSONOBJ_EQ(BSON("a" << MAXKEY), hotRanges[0]["max"].Obj());
+    ASSERT_EQ(3, hotRanges[0]["writeOps"].numberLong());
+    ASSERT_EQ(300, hotRanges[0]["bytesWritten"].numberLong());
+    ASSERT_EQ(1, hotRanges[1]["writeOps"].numberLong());
+}
+
+TEST(ChunkLoadRegistryTest, CollectionTotalsIncludeRangesBeyondMaxRanges) {
+    ChunkLoadRegistry registry;
+    const auto start = Date_t::now();
+    report(registry, start);
+
+    auto firstChunkInfo = makeChunkInfo(BSON("a" << MINKEY), BSON("a" << 0));
+    auto secondChunkInfo = makeChunkInfo(BSON("a" << 0), BSON("a" << MAXKEY));
+
+    registry.recordWrite(kNss, Chunk(*firstChunkInfo, boost::none), 10);
+    registry.recordWrite(kNss, Chunk(*secondChunkInfo, boost::none), 10);
+    registry.recordWrite(kNss, Chunk(*secondChunkInfo, boost::none), 10);
+
+    const auto loadReport = report(registry, start + Seconds(10), 1);
+    const auto hotRanges = loadReport["hotRanges"].Array();
+    ASSERT_EQ(1U, hotRanges.size());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 0), hotRanges[0]["min"].Obj());
+
+    const auto collections = loadReport["collections"].Array();
+    ASSERT_EQ(1U, collections.size());
+    ASSERT_EQ(kNss.ns(), collections[0]["ns"].str());
+    ASSERT_EQ(3, collections[0]["writeOps"].numberLong());
+    ASSERT_EQ(30, collections[0]["bytesWritten"].numberLong());
+}
+
+TEST(ChunkLoadRegistryTest, RangesOfDestroyedChunksAreNotReported) {
+    ChunkLoadRegistry registry;
+    const auto start = Date_t::now();
+    report(registry, start);
+
+    auto chunkInfo = makeChunkInfo(BSON("a" << MINKEY), BSON("a" << MAXKEY));
+    registry.recordWrite(kNss, Chunk(*chunkInfo, boost::none), 10);
+    chunkInfo.reset();
+
+    const auto loadReport = report(registry, start + Seconds(10));
+    ASSERT_EQ(0, loadReport["writeOps"].numberLong());
+    ASSERT_EQ(0U, loadReport["hotRanges"].Array().size());
+}
+
+TEST(ChunkLoadRegistryTest, WritesBeforeTheFirstReportAreNotReported) {
+    ChunkLoadRegistry registry;
+    const auto start = Date_t::now();
+
+    auto chunkInfo = makeChunkInfo(BSON("a" << MINKEY), BSON("a" << MAXKEY));
+    registry.recordWrite(kNss, Chunk(*chunkInfo, boost::none), 10);
+
+    ASSERT_EQ(0, report(registry, start)["writeOps"].numberLong());
+
+    registry.recordWrite(kNss, Chunk(*chunkInfo, boost::none), 10);
+    ASSERT_EQ(1, report(registry, start + Seconds(10))["writeOps"].numberLong());
+}
+
+TEST(ChunkLoadRegistryTest, OnlyWritesWithinTheWindowAreReported) {
+    ChunkLoadRegistry registry;
+    const auto start = Date_t::now();
+    const auto window = ChunkLoadRegistry::kLoadReportingWindow;
+    report(registry, start);
+
+    auto chunkInfo = makeChunkInfo(BSON("a" << MINKEY), BSON("a" << MAXKEY));
+    for (int i = 0; i < 5; ++i) {
+        registry.recordWrite(kNss, Chunk(*chunkInfo, boost::none), 10);
+    }
+
+    // The snapshot taken once the baseline is old enough only replaces the baseline a window later
+    ASSERT_EQ(5, report(registry, start + window)["writeOps"].numberLong());
+
+    registry.recordWrite(kNss, Chunk(*chunkInfo, boost::none), 10);
+    ASSERT_EQ(6, report(registry, start + window + Seconds(30))["writeOps"].numberLong());
+
+    // The writes made before the snapshot are no longer reported once it becomes the baseline
+    auto loadReport = report(registry, start + window * 2);
+    ASSERT_EQ(1, loadReport["writeOps"].numberLong());
+    ASSERT_EQ(10, loadReport["bytesWritten"].numberLong());
+
+    loadReport = report(registry, start + window * 3);
+    ASSERT_EQ(0, loadReport["writeOps"].numberLong());
+    ASSERT_EQ(0U, loadReport["hotRanges"].Array().size());
+}
+
+TEST(ChunkLoadRegistryTest, RangeWhichBecomesHotAgainReportsOnlyItsRecentWrites) {
+    ChunkLoadRegistry registry;
+    const auto start = Date_t::now();
+    const auto window = ChunkLoadRegistry::kLoadReportingWindow;
+    report(registry, start);
+
+    auto hotChunkInfo = makeChunkInfo(BSON("a" << MINKEY), BSON("a" << 0));
+    auto otherChunkInfo = makeChunkInfo(BSON("a" << 0), BSON("a" << MAXKEY));
+    for (int i = 0; i < 1000; ++i) {
+        registry.recordWrite(kNss, Chunk(*hotChunkInfo, boost::none), 10);
+    }
+
+    // The range drops out of the report while it receives no writes
+    BSONObj loadReport;
+    for (int i = 1; i <= 4; ++i) {
+        registry.recordWrite(kNss, Chunk(*otherChunkInfo, boost::none), 10);
+        registry.recordWrite(kNss, Chunk(*otherChunkInfo, boost::none), 10);
+        loadReport = report(registry, start + window * i);
+    }
+    auto hotRanges = loadReport["hotRanges"].Array();
+    ASSERT_EQ(1U, hotRanges.size());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 0), hotRanges[0]["min"].Obj());
+
+    registry.recordWrite(kNss, Chunk(*hotChunkInfo, boost::none), 10);
+    hotRanges = report(registry, start + window * 4 + Seconds(10))["hotRanges"].Array();
+    ASSERT_EQ(2U, hotRanges.size());
+    ASSERT_BSONOBJ_EQ(BSON("a" << MINKEY), hotRanges[1]["min"].Obj());
+    ASSERT_EQ(1, hotRanges[1]["writeOps"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -273,12 +273,18 @@ Status MigrationChunkClonerSourceLegacy::startClone(OperationContext* opCtx,
         opCtx->recoveryUnit()->setPrepareConflictBehavior(
             PrepareConflictBehavior::kIgnoreConflicts);
 
-        auto storeCurrentLocsStatus = _storeCurrentLocs(opCtx);
+        const bool streamFromIndexScan = migrateCloneStreamFromIndexScan.load();
+
+        auto storeCurrentLocsStatus = _storeCurrentLocs(opCtx, !streamFromIndexScan);
         if (storeCurrentLocsStatus == ErrorCodes::ChunkTooBig && _forceJumbo) {
             stdx::lock_guard<Latch> sl(_mutex);
-            _jumboChunkCloneState.emplace();
+            _jumboChunk = true;
+            _indexScanCloneState.emplace();
         } else if (!storeCurrentLocsStatus.isOK()) {
             return storeCurrentLocsStatus;
+        } else if (streamFromIndexScan) {
+            stdx::lock_guard<Latch> sl(_mutex);
+            _indexScanCloneState.emplace();
         }
     }
 
@@ -330,8 +336,7 @@ Status MigrationChunkClonerSourceLegacy::awaitUntilCriticalSectionIsAppropriate(
     invariant(!opCtx->lockState()->isLocked());
     // If this migration is manual migration that specified "force", enter the critical section
     // immediately. This means the entire cloning phase will be done under the critical section.
-    if (_jumboChunkCloneState &&
-        _args.getForceJumbo() == MoveChunkRequest::ForceJumbo::kForceManual) {
+    if (_jumboChunk && _args.getForceJumbo() == MoveChunkRequest::ForceJumbo::kForceManual) {
         return Status::OK();
     }
 
@@ -341,16 +346,14 @@ Status MigrationChunkClonerSourceLegacy::awaitUntilCriticalSectionIsAppropriate(
 StatusWith<BSONObj> MigrationChunkClonerSourceLegacy::commitClone(OperationContext* opCtx) {
     invariant(_state == kCloning);
     invariant(!opCtx->lockState()->isLocked());
-    if (_jumboChunkCloneState && _forceJumbo) {
-        if (_args.getForceJumbo() == MoveChunkRequest::ForceJumbo::kForceManual) {
-            auto status = _checkRecipientCloningStatus(opCtx, kMaxWaitToCommitCloneForJumboChunk);
-            if (!status.isOK()) {
-                return status;
-            }
-        } else {
-            invariant(PlanExecutor::IS_EOF == _jumboChunkCloneState->clonerState);
-            invariant(_cloneLocs.empty());
+    if (_jumboChunk && _args.getForceJumbo() == MoveChunkRequest::ForceJumbo::kForceManual) {
+        auto status = _checkRecipientCloningStatus(opCtx, kMaxWaitToCommitCloneForJumboChunk);
+        if (!status.isOK()) {
+            return status;
         }
+    } else if (_indexScanCloneState) {
+        invariant(PlanExecutor::IS_EOF == _indexScanCloneState->clonerState);
+        invariant(_cloneLocs.empty());
     }
 
     if (_sessionCatalogSource) {
@@ -594,13 +597,13 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromIndexScan(OperationCon
                            internalQueryExecYieldIterations.load(),
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
-    if (!_jumboChunkCloneState->clonerExec) {
+    if (!_indexScanCloneState->clonerExec) {
         auto exec = uassertStatusOK(_getIndexScanExecutor(
             opCtx, collection, InternalPlanner::IndexScanOptions::IXSCAN_FETCH));
-        _jumboChunkCloneState->clonerExec = std::move(exec);
+        _indexScanCloneState->clonerExec = std::move(exec);
     } else {
-        _jumboChunkCloneState->clonerExec->reattachToOperationContext(opCtx);
-        _jumboChunkCloneState->clonerExec->restoreState(&collection);
+        _indexScanCloneState->clonerExec->reattachToOperationContext(opCtx);
+        _indexScanCloneState->clonerExec->restoreState(&collection);
     }
 
     PlanExecutor::ExecState execState;
@@ -608,10 +611,10 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromIndexScan(OperationCon
         BSONObj obj;
         RecordId recordId;
         while (PlanExecutor::ADVANCED ==
-               (execState = _jumboChunkCloneState->clonerExec->getNext(&obj, nullptr))) {
+               (execState = _indexScanCloneState->clonerExec->getNext(&obj, nullptr))) {
 
             stdx::unique_lock<Latch> lk(_mutex);
-            _jumboChunkCloneState->clonerState = execState;
+            _indexScanCloneState->clonerState = execState;
             lk.unlock();
 
             opCtx->checkForInterrupt();
@@ -620,14 +623,14 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromIndexScan(OperationCon
             // that we take into consideration the overhead of BSONArray indices.
             if (arrBuilder->arrSize() &&
                 (arrBuilder->len() + obj.objsize() + 1024) > BSONObjMaxUserSize) {
-                _jumboChunkCloneState->clonerExec->enqueue(obj);
+                _indexScanCloneState->clonerExec->enqueue(obj);
                 break;
             }
 
             arrBuilder->append(obj);
 
             lk.lock();
-            _jumboChunkCloneState->docsCloned++;
+            _indexScanCloneState->docsCloned++;
             lk.unlock();
 
             ShardingStatistics::get(opCtx).countDocsClonedOnDonor.addAndFetch(1);
@@ -638,11 +641,11 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromIndexScan(OperationCon
     }
 
     stdx::unique_lock<Latch> lk(_mutex);
-    _jumboChunkCloneState->clonerState = execState;
+    _indexScanCloneState->clonerState = execState;
     lk.unlock();
 
-    _jumboChunkCloneState->clonerExec->saveState();
-    _jumboChunkCloneState->clonerExec->detachFromOperationContext();
+    _indexScanCloneState->clonerExec->saveState();
+    _indexScanCloneState->clonerExec->detachFromOperationContext();
 }
 
 void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromCloneLocs(OperationContext* opCtx,
@@ -688,11 +691,15 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromCloneLocs(OperationCon
 
 uint64_t MigrationChunkClonerSourceLegacy::getCloneBatchBufferAllocationSize() {
     stdx::lock_guard<Latch> sl(_mutex);
-    if (_jumboChunkCloneState && _forceJumbo)
+    if (_jumboChunk)
         return static_cast<uint64_t>(BSONObjMaxUserSize);
 
+    const uint64_t docsRemainingToClone = _indexScanCloneState
+        ? _numRecordsInChunk -
+            std::min<uint64_t>(_numRecordsInChunk, _indexScanCloneState->docsCloned)
+        : _cloneLocs.size();
     return std::min(static_cast<uint64_t>(BSONObjMaxUserSize),
-                    _averageObjectSizeForCloneLocs * _cloneLocs.size());
+                    _averageObjectSizeForCloneLocs * docsRemainingToClone);
 }
 
 Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
@@ -701,8 +708,8 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
     dassert(opCtx->lockState()->isCollectionLockedForMode(_args.getNss(), MODE_IS));
 
     // If this chunk is too large to store records in _cloneLocs and the command args specify to
-    // attempt to move it, scan the collection directly.
-    if (_jumboChunkCloneState && _forceJumbo) {
+    // attempt to move it, or if streaming was requested, scan the chunk range directly.
+    if (_indexScanCloneState) {
         try {
             _nextCloneBatchFromIndexScan(opCtx, collection, arrBuilder);
             return Status::OK();
@@ -826,7 +833,8 @@ MigrationChunkClonerSourceLegacy::_getIndexScanExecutor(
                                       scanOption);
 }
 
-Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opCtx) {
+Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opCtx,
+                                                           bool storeRecordIds) {
     AutoGetCollection collection(opCtx, _args.getNss(), MODE_IS);
     if (!collection) {
         return {ErrorCodes::NamespaceNotFound,
@@ -876,7 +884,7 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
                 return interruptStatus;
             }
 
-            if (!isLargeChunk) {
+            if (storeRecordIds && !isLargeChunk) {
                 stdx::lock_guard<Latch> lk(_mutex);
                 _cloneLocs.insert(recordId);
             }
@@ -923,6 +931,7 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
     stdx::lock_guard<Latch> lk(_mutex);
     _averageObjectSizeForCloneLocs = collectionAverageObjectSize + defaultObjectIdSize;
     _averageObjectIdSize = std::max(averageObjectIdSize, defaultObjectIdSize);
+    _numRecordsInChunk = recCount;
     return Status::OK();
 }
 
@@ -1005,14 +1014,14 @@ Status MigrationChunkClonerSourceLegacy::_checkRecipientCloningStatus(OperationC
 
         const std::size_t cloneLocsRemaining = _cloneLocs.size();
 
-        if (_forceJumbo && _jumboChunkCloneState) {
+        if (_indexScanCloneState) {
             LOGV2(21992,
                   "moveChunk data transfer progress: {response} mem used: {memoryUsedBytes} "
                   "documents cloned so far: {docsCloned}",
                   "moveChunk data transfer progress",
                   "response"_attr = redact(res),
                   "memoryUsedBytes"_attr = _memoryUsed,
-                  "docsCloned"_attr = _jumboChunkCloneState->docsCloned);
+                  "docsCloned"_attr = _indexScanCloneState->docsCloned);
         } else {
             LOGV2(21993,
                   "moveChunk data transfer progress: {response} mem used: {memoryUsedBytes} "
@@ -1025,8 +1034,8 @@ Status MigrationChunkClonerSourceLegacy::_checkRecipientCloningStatus(OperationC
 
         if (res["state"].String() == "steady") {
             if (cloneLocsRemaining != 0 ||
-                (_jumboChunkCloneState && _forceJumbo &&
-                 PlanExecutor::IS_EOF != _jumboChunkCloneState->clonerState)) {
+                (_indexScanCloneState &&
+                 PlanExecutor::IS_EOF != _indexScanCloneState->clonerState)) {
                 return {ErrorCodes::OperationIncomplete,
                         str::stream() << "Unable to enter critical section because the recipient "
                                          "shard thinks all data is cloned while there are still "
@@ -1091,7 +1100,7 @@ Status MigrationChunkClonerSourceLegacy::_checkRecipientCloningStatus(OperationC
 
         if (_args.getForceJumbo() != MoveChunkRequest::ForceJumbo::kForceManual &&
             (_memoryUsed > 500 * 1024 * 1024 ||
-             (_jumboChunkCloneState && MONGO_unlikely(failTooMuchMemoryUsed.shouldFail())))) {
+             (_jumboChunk && MONGO_unlikely(failTooMuchMemoryUsed.shouldFail())))) {
             // This is too much memory for us to use so we're going to abort the migration
             return {ErrorCodes::ExceededMemoryLimit,
                     "Aborting migration because of high memory usage"};
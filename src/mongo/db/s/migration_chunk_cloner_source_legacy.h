@@ -235,12 +235,13 @@ private:
                                       BSONArrayBuilder* arrBuilder);
 
     /**
-     * Get the disklocs that belong to the chunk migrated and sort them in _cloneLocs (to avoid
-     * seeking disk later).
+     * Get the disklocs that belong to the chunk migrated and, if 'storeRecordIds' is true, sort
+     * them in _cloneLocs (to avoid seeking disk later). Otherwise only counts the documents in the
+     * chunk, which will then be streamed from an index scan by _nextCloneBatchFromIndexScan.
      *
      * Returns OK or any error status otherwise.
      */
-    Status _storeCurrentLocs(OperationContext* opCtx);
+    Status _storeCurrentLocs(OperationContext* opCtx, bool storeRecordIds);
 
     /**
      * Adds the OpTime to the list of OpTimes for oplog entries that we should consider migrating as
@@ -360,6 +361,9 @@ private:
     // The estimated average object _id size during the clone phase.
     uint64_t _averageObjectIdSize{0};
 
+    // The number of documents found in the chunk when the clone started.
+    uint64_t _numRecordsInChunk{0};
+
     // Represents all of the requested but not yet fulfilled operations to be tracked, with regards
     // to the chunk being cloned.
     uint64_t _outstandingOperationTrackRequests{0};
@@ -383,19 +387,23 @@ private:
     // False if the move chunk request specified ForceJumbo::kDoNotForce, true otherwise.
     const bool _forceJumbo;
 
-    struct JumboChunkCloneState {
-        // Plan executor for collection scan used to clone docs.
+    // True once its discovered a chunk is jumbo and the move chunk request allows moving it.
+    bool _jumboChunk{false};
+
+    struct IndexScanCloneState {
+        // Plan executor for the index scan over the chunk range used to clone docs.
         std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> clonerExec;
 
         // The current state of 'clonerExec'.
         PlanExecutor::ExecState clonerState;
 
-        // Number docs in jumbo chunk cloned so far
+        // Number docs in the chunk cloned so far
         int docsCloned = 0;
     };
 
-    // Set only once its discovered a chunk is jumbo
-    boost::optional<JumboChunkCloneState> _jumboChunkCloneState;
+    // Set if the documents are streamed from an index scan instead of from _cloneLocs, which is
+    // always the case for jumbo chunks.
+    boost::optional<IndexScanCloneState> _indexScanCloneState;
 };
 
 }  // namespace mongo
@@ -66,6 +66,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/session_catalog_mongod.h"
+#include "mongo/db/storage/duplicate_key_error_info.h"
 #include "mongo/db/storage/remove_saver.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/db/vector_clock.h"
@@ -143,6 +144,18 @@ void runWithoutSession(OperationContext* opCtx, Callable&& callable) {
     checkOutSessionAndVerifyTxnState(opCtx);
 }
 
+/**
+ * Returns true if 'status' is a duplicate key error on the _id index.
+ */
+bool isDuplicateIdKeyError(const Status& status) {
+    if (status != ErrorCodes::DuplicateKey) {
+        return false;
+    }
+
+    const auto dupKeyInfo = status.extraInfo<DuplicateKeyErrorInfo>();
+    return dupKeyInfo && IndexDescriptor::isIdIndexPattern(dupKeyInfo->getKeyPattern());
+}
+
 /**
  * Returns a human-readabale name of the migration manager's state.
  */
@@ -200,6 +213,28 @@ bool willOverrideLocalId(OperationContext* opCtx,
     return false;
 }
 
+/**
+ * Returns true if a cloned document whose insert failed with a duplicate _id error can be skipped,
+ * because the local document with the same _id is either identical or has its shard key in the
+ * migrating range. The latter happens when an index scan on the donor returns a document twice
+ * because its shard key was updated during the scan, and the latest version arrives with the
+ * transfer mods. Any other local document with the same _id is a genuine conflict.
+ */
+bool canSkipDuplicateClonedDocument(OperationContext* opCtx,
+                                    const NamespaceString& nss,
+                                    const BSONObj& doc,
+                                    const BSONObj& min,
+                                    const BSONObj& max,
+                                    const BSONObj& shardKeyPattern) {
+    AutoGetCollection collection(opCtx, nss, MODE_IS);
+    BSONObj localDoc;
+    if (!collection ||
+        !Helpers::findOne(opCtx, collection.getCollection(), BSON("_id" << doc["_id"]), localDoc)) {
+        return false;
+    }
+    return localDoc.binaryEqual(doc) || isInRange(localDoc, min, max, shardKeyPattern);
+}
+
 /**
  * Returns true if the majority of the nodes and the nodes corresponding to the given writeConcern
  * (if not empty) have applied till the specified lastOp.
@@ -449,15 +484,21 @@ Status MigrationDestinationManager::start(OperationContext* opCtx,
 repl::OpTime MigrationDestinationManager::cloneDocumentsFromDonor(
     OperationContext* opCtx,
     std::function<void(OperationContext*, BSONObj)> insertBatchFn,
-    std::function<BSONObj(OperationContext*)> fetchBatchFn) {
+    std::function<BSONObj(OperationContext*)> fetchBatchFn,
+    int numInserterThreads) {
+    invariant(numInserterThreads > 0);
+
+    // Bound the number of fetched batches waiting to be inserted so that the memory used by the
+    // clone stays proportional to the number of inserters, regardless of the size of the chunk.
+    SingleProducerMultiConsumerQueue<BSONObj>::Options options;
+    options.maxQueueDepth = numInserterThreads;
 
-    SingleProducerSingleConsumerQueue<BSONObj>::Options options;
-    options.maxQueueDepth = 1;
+    SingleProducerMultiConsumerQueue<BSONObj> batches(options);
 
-    SingleProducerSingleConsumerQueue<BSONObj> batches(options);
+    Mutex lastOpAppliedMutex = MONGO_MAKE_LATCH("cloneDocumentsFromDonor::lastOpAppliedMutex");
     repl::OpTime lastOpApplied;
 
-    stdx::thread inserterThread{[&] {
+    auto runInserter = [&] {
         Client::initThread("chunkInserter", opCtx->getServiceContext(), nullptr);
         auto client = Client::getCurrent();
         {
@@ -466,9 +507,11 @@ repl::OpTime MigrationDestinationManager::cloneDocumentsFromDonor(
         }
 
         auto inserterOpCtx = client->makeOperationContext();
-        auto consumerGuard = makeGuard([&] {
-            batches.closeConsumerEnd();
-            lastOpApplied = repl::ReplClientInfo::forClient(inserterOpCtx->getClient()).getLastOp();
+        ON_BLOCK_EXIT([&] {
+            const auto& lastOp =
+                repl::ReplClientInfo::forClient(inserterOpCtx->getClient()).getLastOp();
+            stdx::lock_guard<Latch> lk(lastOpAppliedMutex);
+            lastOpApplied = std::max(lastOpApplied, lastOp);
         });
 
         try {
@@ -480,7 +523,13 @@ repl::OpTime MigrationDestinationManager::cloneDocumentsFromDonor(
                 }
                 insertBatchFn(inserterOpCtx.get(), arr);
             }
+        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueConsumed>&) {
+            // The fetcher has finished and all of the batches have been inserted.
+        } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+            // Another inserter failed and has already reported the error.
         } catch (...) {
+            batches.closeConsumerEnd();
+
             stdx::lock_guard<Client> lk(*opCtx->getClient());
             opCtx->getServiceContext()->killOperation(lk, opCtx, ErrorCodes::Error(51008));
             LOGV2(21999,
@@ -488,30 +537,39 @@ repl::OpTime MigrationDestinationManager::cloneDocumentsFromDonor(
                   "Batch insertion failed",
                   "error"_attr = redact(exceptionToStatus()));
         }
-    }};
+    };
 
+    std::vector<stdx::thread> inserterThreads;
+    inserterThreads.reserve(numInserterThreads);
+    for (int i = 0; i < numInserterThreads; ++i) {
+        inserterThreads.emplace_back(runInserter);
+    }
 
     {
-        auto inserterThreadJoinGuard = makeGuard([&] {
+        auto inserterThreadsJoinGuard = makeGuard([&] {
             batches.closeProducerEnd();
-            inserterThread.join();
+            for (auto& inserterThread : inserterThreads) {
+                inserterThread.join();
+            }
         });
 
         while (true) {
             auto res = fetchBatchFn(opCtx);
             try {
-                batches.push(res.getOwned(), opCtx);
+                // The end of the clone is signalled by closing the producer end of the queue
+                // rather than by pushing the empty batch, so that every inserter observes it.
                 auto arr = res["objects"].Obj();
                 if (arr.isEmpty()) {
                     break;
                 }
+                batches.push(res.getOwned(), opCtx);
             } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
                 break;
             }
         }
     }  // This scope ensures that the guard is destroyed
 
-    // This check is necessary because the consumer thread uses killOp to propagate errors to the
+    // This check is necessary because the consumer threads use killOp to propagate errors to the
     // producer thread (this thread)
     opCtx->checkForInterrupt();
     return lastOpApplied;
@@ -1082,6 +1140,11 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
             uassert(50748, "Migration aborted while copying documents", getState() != ABORT);
         };
 
+        // The inserters share the session checked out on 'outerOpCtx', so only one of them at a
+        // time may check it in while waiting for the secondary throttle.
+        auto secondaryThrottleMutex =
+            MONGO_MAKE_LATCH("MigrationDestinationManager::secondaryThrottleMutex");
+
         auto insertBatchFn = [&](OperationContext* opCtx, BSONObj arr) {
             auto it = arr.begin();
             while (it != arr.end()) {
@@ -1092,7 +1155,7 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
                 assertNotAborted(opCtx);
 
                 write_ops::InsertCommandRequest insertOp(_nss);
-                insertOp.getWriteCommandRequestBase().setOrdered(true);
+                insertOp.getWriteCommandRequestBase().setOrdered(false);
                 insertOp.setDocuments([&] {
                     std::vector<BSONObj> toInsert;
                     while (it != arr.end() &&
@@ -1111,6 +1174,17 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
                     write_ops_exec::performInserts(opCtx, insertOp, OperationSource::kFromMigrate);
 
                 for (unsigned long i = 0; i < reply.results.size(); ++i) {
+                    if (isDuplicateIdKeyError(reply.results[i].getStatus()) &&
+                        canSkipDuplicateClonedDocument(opCtx,
+                                                       _nss,
+                                                       insertOp.getDocuments()[i],
+                                                       _min,
+                                                       _max,
+                                                       _shardKeyPattern)) {
+                        --batchNumCloned;
+                        continue;
+                    }
+
                     uassertStatusOKWithContext(
                         reply.results[i],
                         str::stream() << "Insert of " << insertOp.getDocuments()[i] << " failed.");
@@ -1124,6 +1198,7 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
                     _clonedBytes += batchClonedBytes;
                 }
                 if (_writeConcern.needToWaitForOtherNodes()) {
+                    stdx::lock_guard<Latch> secondaryThrottleLock(secondaryThrottleMutex);
                     runWithoutSession(outerOpCtx, [&] {
                         repl::ReplicationCoordinator::StatusAndDuration replStatus =
                             repl::ReplicationCoordinator::get(opCtx)->awaitReplication(
@@ -1162,7 +1237,8 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
 
         // If running on a replicated system, we'll need to flush the docs we cloned to the
         // secondaries
-        lastOpApplied = cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn);
+        lastOpApplied = cloneDocumentsFromDonor(
+            opCtx, insertBatchFn, fetchBatchFn, chunkMigrationConcurrency.load());
 
         timing.done(3);
         migrateThreadHangAtStep3.pauseWhileSet();
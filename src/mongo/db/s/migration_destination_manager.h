@@ -114,12 +114,15 @@ public:
                  const WriteConcernOptions& writeConcern);
 
     /**
-     * Clones documents from a donor shard.
+     * Clones documents from a donor shard. A single fetcher pulls batches with 'fetchBatchFn'
+     * while 'numInserterThreads' threads concurrently apply them with 'insertBatchFn'. Returns the
+     * latest OpTime written by any of the inserters.
      */
     static repl::OpTime cloneDocumentsFromDonor(
         OperationContext* opCtx,
         std::function<void(OperationContext*, BSONObj)> insertBatchFn,
-        std::function<BSONObj(OperationContext*)> fetchBatchFn);
+        std::function<BSONObj(OperationContext*)> fetchBatchFn,
+        int numInserterThreads = 1);
 
     /**
      * Idempotent method, which causes the current ongoing migration to abort only if it has the
@@ -30,6 +30,9 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/s/migration_destination_manager.h"
+
+#include <set>
+
 #include "mongo/db/s/shard_server_test_fixture.h"
 #include "mongo/s/catalog_cache_test_fixture.h"
 
@@ -105,6 +108,47 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWorksCorrectly) {
     }
 }
 
+// Tests that every fetched batch is inserted exactly once when several inserters run concurrently.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWithConcurrentInserters) {
+    const int kNumBatches = 50;
+    const int kNumDocsPerBatch = 10;
+    int numBatchesFetched = 0;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONArrayBuilder arrayBuilder;
+        if (numBatchesFetched < kNumBatches) {
+            for (int i = 0; i < kNumDocsPerBatch; ++i) {
+                arrayBuilder.append(createDocument(numBatchesFetched * kNumDocsPerBatch + i));
+            }
+            ++numBatchesFetched;
+        }
+
+        BSONObjBuilder fetchBatchResultBuilder;
+        fetchBatchResultBuilder.append("objects", arrayBuilder.arr());
+        return fetchBatchResultBuilder.obj();
+    };
+
+    auto mutex = MONGO_MAKE_LATCH();
+    std::set<int> insertedIds;
+    int numDocsInserted = 0;
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {
+        stdx::lock_guard<Latch> lk(mutex);
+        for (auto&& docToClone : docs) {
+            insertedIds.insert(docToClone.Obj()["_id"].numberInt());
+            ++numDocsInserted;
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn, 4 /* numInserterThreads */);
+
+    ASSERT_EQ(kNumBatches * kNumDocsPerBatch, numDocsInserted);
+    ASSERT_EQ(static_cast<size_t>(kNumBatches * kNumDocsPerBatch), insertedIds.size());
+    ASSERT_EQ(0, *insertedIds.begin());
+    ASSERT_EQ(kNumBatches * kNumDocsPerBatch - 1, *insertedIds.rbegin());
+}
+
 // Tests that an exception in the fetch logic will successfully throw an exception on the main
 // thread.
 TEST_F(MigrationDestinationManagerTest, CloneDocumentsThrowsFetchErrors) {
@@ -33,6 +33,7 @@
 
 #include "mongo/db/s/resharding/resharding_collection_cloner.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "mongo/bson/json.h"
@@ -42,13 +43,16 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value_comparator.h"
 #include "mongo/db/logical_session_id_helpers.h"
+#include "mongo/db/persistent_task_store.h"
 #include "mongo/db/pipeline/aggregation_request_helper.h"
 #include "mongo/db/pipeline/document_source_lookup.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_replace_root.h"
 #include "mongo/db/pipeline/sharded_agg_helpers.h"
 #include "mongo/db/query/query_request_helper.h"
+#include "mongo/db/s/resharding/resharding_collection_cloner_ranges_gen.h"
 #include "mongo/db/s/resharding/resharding_data_copy_util.h"
 #include "mongo/db/s/resharding/resharding_future_util.h"
 #include "mongo/db/s/resharding/resharding_metrics.h"
@@ -59,12 +63,20 @@
 #include "mongo/executor/task_executor.h"
 #include "mongo/logv2/log.h"
 #include "mongo/s/stale_shard_version_helpers.h"
+#include "mongo/util/fail_point.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
 namespace {
 
+MONGO_FAIL_POINT_DEFINE(reshardingCollectionClonerFailIdRange);
+MONGO_FAIL_POINT_DEFINE(reshardingPauseCollectionClonerBeforeIdRange);
+
+// Number of _id values sampled from the donor shards for each range when choosing the boundaries of
+// the ranges cloned concurrently.
+constexpr int kSampledIdsPerRange = 100;
+
 bool collectionHasSimpleCollation(OperationContext* opCtx, const NamespaceString& nss) {
     auto catalogCache = Grid::get(opCtx)->catalogCache();
     auto sourceChunkMgr = uassertStatusOK(catalogCache->getCollectionRoutingInfo(opCtx, nss));
@@ -79,6 +91,7 @@ bool collectionHasSimpleCollation(OperationContext* opCtx, const NamespaceString
 }  // namespace
 
 ReshardingCollectionCloner::ReshardingCollectionCloner(std::unique_ptr<Env> env,
+                                                       UUID reshardingUUID,
                                                        ShardKeyPattern newShardKeyPattern,
                                                        NamespaceString sourceNss,
                                                        CollectionUUID sourceUUID,
@@ -86,6 +99,7 @@ ReshardingCollectionCloner::ReshardingCollectionCloner(std::unique_ptr<Env> env,
                                                        Timestamp atClusterTime,
                                                        NamespaceString outputNss)
     : _env(std::move(env)),
+      _reshardingUUID(std::move(reshardingUUID)),
       _newShardKeyPattern(std::move(newShardKeyPattern)),
       _sourceNss(std::move(sourceNss)),
       _sourceUUID(std::move(sourceUUID)),
@@ -96,7 +110,8 @@ ReshardingCollectionCloner::ReshardingCollectionCloner(std::unique_ptr<Env> env,
 std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::makePipeline(
     OperationContext* opCtx,
     std::shared_ptr<MongoProcessInterface> mongoProcessInterface,
-    Value resumeId) {
+    Value resumeId,
+    IdRange idRange) {
     using Doc = Document;
     using Arr = std::vector<Value>;
     using V = Value;
@@ -141,12 +156,24 @@ std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::makePipel
 
     Pipeline::SourceContainer stages;
 
-    if (!resumeId.missing()) {
-        stages.emplace_back(DocumentSourceMatch::create(
-            Doc{{"$expr",
-                 Doc{{"$gte", Arr{V{"$_id"_sd}, V{Doc{{"$literal", std::move(resumeId)}}}}}}}}
-                .toBson(),
-            expCtx));
+    // Resuming starts from the last document inserted, which is inside of the _id range.
+    Arr idBounds;
+    if (auto min = resumeId.missing() ? std::move(idRange.min) : std::move(resumeId);
+        !min.missing()) {
+        idBounds.emplace_back(
+            Doc{{"$gte", Arr{V{"$_id"_sd}, V{Doc{{"$literal", std::move(min)}}}}}});
+    }
+
+    if (!idRange.max.missing()) {
+        idBounds.emplace_back(
+            Doc{{"$lt", Arr{V{"$_id"_sd}, V{Doc{{"$literal", std::move(idRange.max)}}}}}});
+    }
+
+    if (!idBounds.empty()) {
+        auto idBoundsExpr = idBounds.size() == 1 ? std::move(idBounds[0])
+                                                 : V{Doc{{"$and", std::move(idBounds)}}};
+        stages.emplace_back(
+            DocumentSourceMatch::create(Doc{{"$expr", std::move(idBoundsExpr)}}.toBson(), expCtx));
     }
 
     stages.emplace_back(DocumentSourceReplaceRoot::createFromBson(
@@ -214,6 +241,137 @@ std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::makePipel
     return Pipeline::create(std::move(stages), std::move(expCtx));
 }
 
+std::vector<Value> ReshardingCollectionCloner::chooseIdRangeBoundaries(
+    std::vector<Value> sampledIds, int numRanges) {
+    std::sort(sampledIds.begin(), sampledIds.end(), ValueComparator::kInstance.getLessThan());
+    sampledIds.erase(
+        std::unique(sampledIds.begin(), sampledIds.end(), ValueComparator::kInstance.getEqualTo()),
+        sampledIds.end());
+
+    std::vector<Value> boundaries;
+    size_t lastIndex = 0;
+    for (int i = 1; i < numRanges; ++i) {
+        const size_t index = sampledIds.size() * i / numRanges;
+        if (index > lastIndex) {
+            boundaries.push_back(sampledIds[index]);
+            lastIndex = index;
+        }
+    }
+
+    return boundaries;
+}
+
+std::vector<Value> ReshardingCollectionCloner::_sampleIds(OperationContext* opCtx,
+                                                          int sampleSize) {
+    StringMap<ExpressionContext::ResolvedNamespace> resolvedNamespaces;
+    resolvedNamespaces[_sourceNss.coll()] = {_sourceNss, std::vector<BSONObj>{}};
+
+    auto expCtx = make_intrusive<ExpressionContext>(opCtx,
+                                                    boost::none, /* explain */
+                                                    false,       /* fromMongos */
+                                                    false,       /* needsMerge */
+                                                    false,       /* allowDiskUse */
+                                                    false,       /* bypassDocumentValidation */
+                                                    false,       /* isMapReduceCommand */
+                                                    _sourceNss,
+                                                    boost::none, /* runtimeConstants */
+                                                    nullptr,     /* collator */
+                                                    MongoProcessInterface::create(opCtx),
+                                                    std::move(resolvedNamespaces),
+                                                    _sourceUUID);
+
+    // The boundaries only need to split the documents evenly enough, so the sample is read at the
+    // latest cluster time rather than at the time the documents are cloned at.
+    const std::vector<BSONObj> rawPipeline{BSON("$sample" << BSON("size" << sampleSize)),
+                                           BSON("$project" << BSON("_id" << 1))};
+    auto pipeline = Pipeline::parse(rawPipeline, expCtx);
+
+    AggregateCommandRequest request(_sourceNss, pipeline->serializeToBson());
+    request.setCollectionUUID(_sourceUUID);
+
+    auto* curOp = CurOp::get(opCtx);
+    curOp->ensureStarted();
+    ON_BLOCK_EXIT([curOp] { curOp->done(); });
+
+    auto mergePipeline = shardVersionRetry(
+        opCtx,
+        Grid::get(opCtx)->catalogCache(),
+        _sourceNss,
+        "targeting donor shards for sampling resharding collection cloning ranges"_sd,
+        [&] { return sharded_agg_helpers::targetShardsAndAddMergeCursors(expCtx, request); });
+
+    std::vector<Value> sampledIds;
+    while (auto doc = mergePipeline->getNext()) {
+        if (auto id = (*doc)["_id"]; !id.missing()) {
+            sampledIds.push_back(std::move(id));
+        }
+    }
+
+    return sampledIds;
+}
+
+std::vector<ReshardingCollectionCloner::IdRange>
+ReshardingCollectionCloner::_fetchOrChooseIdRanges(OperationContext* opCtx) {
+    PersistentTaskStore<ReshardingCollectionClonerRanges> store(
+        NamespaceString::kReshardingCollectionClonerRangesNamespace);
+
+    boost::optional<std::vector<BSONObj>> boundaries;
+    store.forEach(
+        opCtx,
+        QUERY(ReshardingCollectionClonerRanges::kReshardingUUIDFieldName << _reshardingUUID),
+        [&](const auto& doc) {
+            boundaries = doc.getBoundaries();
+            return false;
+        });
+
+    if (!boundaries) {
+        const int numRanges = resharding::gReshardingCollectionClonerParallelRanges.load();
+
+        // The progress of cloning a single range is only tracked by the highest _id inserted so
+        // far, so documents copied before the ranges were recorded must keep being copied as one
+        // range. The _id bounds are compared with the simple collation, which only matches the
+        // order of the _id index for collections with the simple default collation.
+        const bool outputCollectionIsEmpty = [&] {
+            AutoGetCollection outputColl(opCtx, _outputNss, MODE_IS);
+            uassert(ErrorCodes::NamespaceNotFound,
+                    str::stream() << "Resharding collection cloner's output collection '"
+                                  << _outputNss << "' did not already exist",
+                    outputColl);
+            return outputColl->isEmpty(opCtx);
+        }();
+
+        std::vector<Value> boundaryIds;
+        if (numRanges > 1 && outputCollectionIsEmpty &&
+            collectionHasSimpleCollation(opCtx, _sourceNss)) {
+            boundaryIds = chooseIdRangeBoundaries(
+                _sampleIds(opCtx, numRanges * kSampledIdsPerRange), numRanges);
+        }
+
+        boundaries.emplace();
+        for (const auto& id : boundaryIds) {
+            BSONObjBuilder builder;
+            id.addToBsonObj(&builder, "_id");
+            boundaries->push_back(builder.obj());
+        }
+
+        store.add(opCtx, ReshardingCollectionClonerRanges(_reshardingUUID, *boundaries));
+
+        LOGV2(5716287,
+              "Chose the _id ranges for cloning sharded collection",
+              "sourceNamespace"_attr = _sourceNss,
+              "outputNamespace"_attr = _outputNss,
+              "numRanges"_attr = boundaries->size() + 1);
+    }
+
+    std::vector<IdRange> idRanges(boundaries->size() + 1);
+    for (size_t i = 0; i < boundaries->size(); ++i) {
+        idRanges[i].max = Value((*boundaries)[i]["_id"]);
+        idRanges[i + 1].min = idRanges[i].max;
+    }
+
+    return idRanges;
+}
+
 std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::_targetAggregationRequest(
     OperationContext* opCtx, const Pipeline& pipeline) {
     // We associate the aggregation cursors established on each donor shard with a logical session
@@ -253,14 +411,15 @@ std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::_targetAg
 }
 
 std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::_restartPipeline(
-    OperationContext* opCtx) {
+    OperationContext* opCtx, const IdRange& idRange) {
     auto idToResumeFrom = [&] {
         AutoGetCollection outputColl(opCtx, _outputNss, MODE_IS);
         uassert(ErrorCodes::NamespaceNotFound,
                 str::stream() << "Resharding collection cloner's output collection '" << _outputNss
                               << "' did not already exist",
                 outputColl);
-        return resharding::data_copy::findHighestInsertedId(opCtx, *outputColl);
+        return resharding::data_copy::findHighestInsertedId(
+            opCtx, *outputColl, idRange.min, idRange.max);
     }();
 
     // The BlockingResultsMerger underlying by the $mergeCursors stage records how long the
@@ -271,7 +430,8 @@ std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::_restartP
     ON_BLOCK_EXIT([curOp] { curOp->done(); });
 
     auto pipeline = _targetAggregationRequest(
-        opCtx, *makePipeline(opCtx, MongoProcessInterface::create(opCtx), idToResumeFrom));
+        opCtx,
+        *makePipeline(opCtx, MongoProcessInterface::create(opCtx), idToResumeFrom, idRange));
 
     if (!idToResumeFrom.missing()) {
         // Skip inserting the first document retrieved after resuming because $gte was used in the
@@ -320,6 +480,53 @@ SemiFuture<void> ReshardingCollectionCloner::run(
     std::shared_ptr<executor::TaskExecutor> cleanupExecutor,
     CancellationToken cancelToken,
     CancelableOperationContextFactory factory) {
+    auto idRanges = std::make_shared<std::vector<IdRange>>();
+
+    return resharding::WithAutomaticRetry([this, idRanges, factory] {
+               auto opCtx = factory.makeOperationContext(&cc());
+               *idRanges = _fetchOrChooseIdRanges(opCtx.get());
+           })
+        .onTransientError([this](const Status& status) {
+            LOGV2(5716288,
+                  "Transient error while choosing the _id ranges for cloning sharded collection",
+                  "sourceNamespace"_attr = _sourceNss,
+                  "outputNamespace"_attr = _outputNss,
+                  "error"_attr = redact(status));
+        })
+        .onUnrecoverableError([this](const Status& status) {
+            LOGV2_ERROR(5716289,
+                        "Operation-fatal error for resharding while choosing the _id ranges for "
+                        "cloning sharded collection",
+                        "sourceNamespace"_attr = _sourceNss,
+                        "outputNamespace"_attr = _outputNss,
+                        "error"_attr = redact(status));
+        })
+        .until([](const Status& status) { return status.isOK(); })
+        .on(executor, cancelToken)
+        .then([this, idRanges, executor, cleanupExecutor, cancelToken, factory] {
+            // An error cloning any of the ranges cancels cloning the others, and is only reported
+            // once all of them have stopped so that none outlives the cloner.
+            CancellationSource errorSource(cancelToken);
+
+            std::vector<SharedSemiFuture<void>> idRangeFutures;
+            idRangeFutures.reserve(idRanges->size());
+            for (const auto& idRange : *idRanges) {
+                idRangeFutures.emplace_back(
+                    _runIdRange(executor, cleanupExecutor, errorSource.token(), factory, idRange)
+                        .share());
+            }
+
+            return resharding::cancelWhenAnyErrorThenQuiesce(idRangeFutures, executor, errorSource);
+        })
+        .semi();
+}
+
+SemiFuture<void> ReshardingCollectionCloner::_runIdRange(
+    std::shared_ptr<executor::TaskExecutor> executor,
+    std::shared_ptr<executor::TaskExecutor> cleanupExecutor,
+    CancellationToken cancelToken,
+    CancelableOperationContextFactory factory,
+    IdRange idRange) {
     struct ChainContext {
         std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
         bool moreToCome = true;
@@ -327,10 +534,25 @@ SemiFuture<void> ReshardingCollectionCloner::run(
 
     auto chainCtx = std::make_shared<ChainContext>();
 
-    return resharding::WithAutomaticRetry([this, chainCtx, factory] {
+    return resharding::WithAutomaticRetry([this, chainCtx, factory, idRange] {
                if (!chainCtx->pipeline) {
                    auto opCtx = factory.makeOperationContext(&cc());
-                   chainCtx->pipeline = _restartPipeline(opCtx.get());
+
+                   // Fails the range whose lower bound is the 'min' of the failpoint data, which
+                   // is the first range when 'min' is not given.
+                   reshardingCollectionClonerFailIdRange.executeIf(
+                       [](const BSONObj&) {
+                           uasserted(ErrorCodes::InternalError,
+                                     "Failing resharding collection cloner _id range due to "
+                                     "failpoint");
+                       },
+                       [&](const BSONObj& data) {
+                           return ValueComparator::kInstance.evaluate(Value(data["min"]) ==
+                                                                      idRange.min);
+                       });
+                   reshardingPauseCollectionClonerBeforeIdRange.pauseWhileSet(opCtx.get());
+
+                   chainCtx->pipeline = _restartPipeline(opCtx.get(), idRange);
                }
 
                auto opCtx = factory.makeOperationContext(&cc());
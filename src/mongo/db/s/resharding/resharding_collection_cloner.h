@@ -30,6 +30,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/cancelable_operation_context.h"
@@ -73,7 +74,17 @@ public:
         ReshardingMetrics* const _metrics;
     };
 
+    /**
+     * Bounds [min, max) on the _id of the documents copied by one of the pipelines run
+     * concurrently. A missing bound leaves the range open on that side.
+     */
+    struct IdRange {
+        Value min;
+        Value max;
+    };
+
     ReshardingCollectionCloner(std::unique_ptr<Env> env,
+                               UUID reshardingUUID,
                                ShardKeyPattern newShardKeyPattern,
                                NamespaceString sourceNss,
                                CollectionUUID sourceUUID,
@@ -84,10 +95,18 @@ public:
     std::unique_ptr<Pipeline, PipelineDeleter> makePipeline(
         OperationContext* opCtx,
         std::shared_ptr<MongoProcessInterface> mongoProcessInterface,
-        Value resumeId = Value());
+        Value resumeId = Value(),
+        IdRange idRange = IdRange());
+
+    /**
+     * Picks up to 'numRanges - 1' distinct values from 'sampledIds', in ascending order, which
+     * split the sampled _id values into ranges of roughly the same size.
+     */
+    static std::vector<Value> chooseIdRangeBoundaries(std::vector<Value> sampledIds, int numRanges);
 
     /**
-     * Schedules work to repeatedly fetch and insert batches of documents.
+     * Schedules work to repeatedly fetch and insert batches of documents, concurrently for each of
+     * the _id ranges the documents were split into when cloning started.
      *
      * Returns a future that becomes ready when either:
      *   (a) all documents have been fetched and inserted, or
@@ -107,12 +126,31 @@ public:
     bool doOneBatch(OperationContext* opCtx, Pipeline& pipeline);
 
 private:
+    /**
+     * Returns the _id ranges which were persisted when cloning started, or chooses and persists
+     * them if cloning is starting now.
+     */
+    std::vector<IdRange> _fetchOrChooseIdRanges(OperationContext* opCtx);
+
+    /**
+     * Returns up to 'sampleSize' _id values sampled at random from the donor shards.
+     */
+    std::vector<Value> _sampleIds(OperationContext* opCtx, int sampleSize);
+
+    SemiFuture<void> _runIdRange(std::shared_ptr<executor::TaskExecutor> executor,
+                                 std::shared_ptr<executor::TaskExecutor> cleanupExecutor,
+                                 CancellationToken cancelToken,
+                                 CancelableOperationContextFactory factory,
+                                 IdRange idRange);
+
     std::unique_ptr<Pipeline, PipelineDeleter> _targetAggregationRequest(OperationContext* opCtx,
                                                                          const Pipeline& pipeline);
 
-    std::unique_ptr<Pipeline, PipelineDeleter> _restartPipeline(OperationContext* opCtx);
+    std::unique_ptr<Pipeline, PipelineDeleter> _restartPipeline(OperationContext* opCtx,
+                                                                const IdRange& idRange);
 
     const std::unique_ptr<Env> _env;
+    const UUID _reshardingUUID;
     const ShardKeyPattern _newShardKeyPattern;
     const NamespaceString _sourceNss;
     const CollectionUUID _sourceUUID;
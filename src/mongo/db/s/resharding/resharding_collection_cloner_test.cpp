@@ -35,14 +35,27 @@
 
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/json.h"
+#include "mongo/db/cancelable_operation_context.h"
+#include "mongo/db/catalog_raii.h"
 #include "mongo/db/exec/document_value/document_value_test_util.h"
 #include "mongo/db/hasher.h"
+#include "mongo/db/persistent_task_store.h"
 #include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/s/resharding/resharding_collection_cloner.h"
+#include "mongo/db/s/resharding/resharding_collection_cloner_ranges_gen.h"
+#include "mongo/db/s/resharding/resharding_data_copy_util.h"
 #include "mongo/db/s/resharding/resharding_metrics.h"
 #include "mongo/db/s/resharding_util.h"
+#include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/db/service_context_test_fixture.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/executor/network_interface_factory.h"
+#include "mongo/executor/thread_pool_task_executor.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -79,11 +92,13 @@ protected:
         ShardKeyPattern newShardKeyPattern,
         ShardId recipientShard,
         std::deque<DocumentSource::GetNextResult> sourceCollectionData,
-        std::deque<DocumentSource::GetNextResult> configCacheChunksData) {
+        std::deque<DocumentSource::GetNextResult> configCacheChunksData,
+        ReshardingCollectionCloner::IdRange idRange = ReshardingCollectionCloner::IdRange()) {
         auto tempNss = constructTemporaryReshardingNss(_sourceNss.db(), _sourceUUID);
 
         ReshardingCollectionCloner cloner(
             std::make_unique<ReshardingCollectionCloner::Env>(&*_metrics),
+            UUID::gen(),
             std::move(newShardKeyPattern),
             _sourceNss,
             _sourceUUID,
@@ -92,7 +107,10 @@ protected:
             std::move(tempNss));
 
         auto pipeline = cloner.makePipeline(
-            _opCtx.get(), std::make_shared<MockMongoInterface>(std::move(configCacheChunksData)));
+            _opCtx.get(),
+            std::make_shared<MockMongoInterface>(std::move(configCacheChunksData)),
+            Value(),
+            std::move(idRange));
 
         pipeline->addInitialSource(DocumentSourceMock::createForTest(
             std::move(sourceCollectionData), pipeline->getContext()));
@@ -272,5 +290,198 @@ TEST_F(ReshardingCollectionClonerTest, CompoundHashedShardKey) {
     ASSERT_FALSE(pipeline->getNext());
 }
 
+TEST_F(ReshardingCollectionClonerTest, IdRange) {
+    auto pipeline = makePipeline(
+        ShardKeyPattern(fromjson("{x: 1}")),
+        ShardId("shard1"),
+        {Doc(fromjson("{_id: 1, x: 1}")),
+         Doc(fromjson("{_id: 2, x: 2}")),
+         Doc(fromjson("{_id: 3, x: 3}")),
+         Doc(fromjson("{_id: 4, x: 4}")),
+         Doc(fromjson("{_id: 5, x: 5}"))},
+        {Doc(fromjson("{_id: {x: {$minKey: 1}}, max: {x: {$maxKey: 1}}, shard: 'shard1'}"))},
+        {V{2}, V{4}});
+
+    auto next = pipeline->getNext();
+    ASSERT(next);
+    ASSERT_BSONOBJ_BINARY_EQ(BSON("_id" << 2 << "x" << 2 << "$sortKey" << BSON_ARRAY(2)),
+                             next->toBson());
+
+    next = pipeline->getNext();
+    ASSERT(next);
+    ASSERT_BSONOBJ_BINARY_EQ(BSON("_id" << 3 << "x" << 3 << "$sortKey" << BSON_ARRAY(3)),
+                             next->toBson());
+
+    ASSERT_FALSE(pipeline->getNext());
+}
+
+TEST_F(ReshardingCollectionClonerTest, ChooseIdRangeBoundaries) {
+    auto boundaries = ReshardingCollectionCloner::chooseIdRangeBoundaries(
+        {V{5}, V{1}, V{3}, V{3}, V{2}, V{4}, V{6}, V{8}, V{7}, V{0}}, 4);
+    ASSERT_EQ(boundaries.size(), 3U);
+    ASSERT_VALUE_EQ(boundaries[0], V{2});
+    ASSERT_VALUE_EQ(boundaries[1], V{4});
+    ASSERT_VALUE_EQ(boundaries[2], V{6});
+
+    // Fewer distinct values than ranges yields fewer, but still distinct, boundaries.
+    boundaries = ReshardingCollectionCloner::chooseIdRangeBoundaries({V{1}, V{2}, V{2}}, 4);
+    ASSERT_EQ(boundaries.size(), 1U);
+    ASSERT_VALUE_EQ(boundaries[0], V{2});
+
+    ASSERT(ReshardingCollectionCloner::chooseIdRangeBoundaries({}, 4).empty());
+    ASSERT(ReshardingCollectionCloner::chooseIdRangeBoundaries({V{1}, V{2}}, 1).empty());
+}
+
+class ReshardingCollectionClonerStorageTest : public ServiceContextMongoDTest {
+protected:
+    void setUp() override {
+        ServiceContextMongoDTest::setUp();
+
+        auto serviceContext = getServiceContext();
+        auto replCoord = std::make_unique<repl::ReplicationCoordinatorMock>(serviceContext);
+        ASSERT_OK(replCoord->setFollowerMode(repl::MemberState::RS_PRIMARY));
+        repl::ReplicationCoordinator::set(serviceContext, std::move(replCoord));
+
+        {
+            auto opCtx = makeOperationContext();
+            repl::createOplog(opCtx.get());
+            resharding::data_copy::ensureCollectionExists(
+                opCtx.get(), _outputNss, CollectionOptions{});
+        }
+
+        _metrics = std::make_unique<ReshardingMetrics>(serviceContext);
+        _metrics->onStart(ReshardingMetrics::Role::kRecipient,
+                          serviceContext->getFastClockSource()->now());
+        _metrics->setRecipientState(RecipientStateEnum::kCloning);
+    }
+
+    void tearDown() override {
+        _metrics = nullptr;
+        ServiceContextMongoDTest::tearDown();
+    }
+
+    void insertIds(OperationContext* opCtx, const std::vector<int>& ids) {
+        AutoGetCollection outputColl(opCtx, _outputNss, MODE_IX);
+        WriteUnitOfWork wuow(opCtx);
+        for (int id : ids) {
+            ASSERT_OK(outputColl->insertDocument(
+                opCtx, InsertStatement{BSON("_id" << id << "x" << id)}, nullptr));
+        }
+        wuow.commit();
+    }
+
+    Value findHighestInsertedId(OperationContext* opCtx, Value minId, Value maxId) {
+        AutoGetCollection outputColl(opCtx, _outputNss, MODE_IS);
+        return resharding::data_copy::findHighestInsertedId(opCtx, *outputColl, minId, maxId);
+    }
+
+    std::unique_ptr<ReshardingCollectionCloner> makeCloner() {
+        return std::make_unique<ReshardingCollectionCloner>(
+            std::make_unique<ReshardingCollectionCloner::Env>(_metrics.get()),
+            _reshardingUUID,
+            ShardKeyPattern(fromjson("{x: 1}")),
+            _sourceNss,
+            _sourceUUID,
+            ShardId("shard1"),
+            Timestamp(1, 0), /* dummy value */
+            _outputNss);
+    }
+
+    void persistIdRangeBoundaries(OperationContext* opCtx, std::vector<BSONObj> boundaries) {
+        PersistentTaskStore<ReshardingCollectionClonerRanges> store(
+            NamespaceString::kReshardingCollectionClonerRangesNamespace);
+        store.add(opCtx, ReshardingCollectionClonerRanges(_reshardingUUID, std::move(boundaries)));
+    }
+
+    std::shared_ptr<executor::ThreadPoolTaskExecutor> makeTaskExecutorForCloner(int maxThreads) {
+        // The ReshardingCollectionCloner expects there to already be a Client associated with the
+        // thread from the thread pool.
+        ThreadPool::Options threadPoolOptions;
+        threadPoolOptions.maxThreads = maxThreads;
+        threadPoolOptions.threadNamePrefix = "TestReshardCollectionCloning-";
+        threadPoolOptions.poolName = "TestReshardCollectionCloningThreadPool";
+        threadPoolOptions.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+
+        auto executor = std::make_shared<executor::ThreadPoolTaskExecutor>(
+            std::make_unique<ThreadPool>(std::move(threadPoolOptions)),
+            executor::makeNetworkInterface("TestReshardCollectionCloningNetwork"));
+        executor->startup();
+        return executor;
+    }
+
+    std::shared_ptr<ThreadPool> makeCancelableOpCtxExecutor() {
+        auto executor = std::make_shared<ThreadPool>([] {
+            ThreadPool::Options options;
+            options.poolName = "TestReshardCollectionClonerCancelableOpCtxPool";
+            options.minThreads = 1;
+            options.maxThreads = 1;
+            return options;
+        }());
+        executor->startup();
+        return executor;
+    }
+
+private:
+    const UUID _reshardingUUID = UUID::gen();
+    const NamespaceString _sourceNss = NamespaceString("test"_sd, "collection_being_resharded"_sd);
+    const CollectionUUID _sourceUUID = UUID::gen();
+    const NamespaceString _outputNss =
+        constructTemporaryReshardingNss(_sourceNss.db(), _sourceUUID);
+
+    std::unique_ptr<ReshardingMetrics> _metrics;
+};
+
+TEST_F(ReshardingCollectionClonerStorageTest, FindHighestInsertedIdWithinIdRange) {
+    auto opCtx = makeOperationContext();
+
+    ASSERT_VALUE_EQ(findHighestInsertedId(opCtx.get(), V{10}, V{20}), V());
+
+    insertIds(opCtx.get(), {21, 1, 12, 3, 11, 2, 20, 10});
+
+    ASSERT_VALUE_EQ(findHighestInsertedId(opCtx.get(), V(), V()), V{21});
+    ASSERT_VALUE_EQ(findHighestInsertedId(opCtx.get(), V(), V{10}), V{3});
+    ASSERT_VALUE_EQ(findHighestInsertedId(opCtx.get(), V{10}, V{20}), V{12});
+    ASSERT_VALUE_EQ(findHighestInsertedId(opCtx.get(), V{20}, V()), V{21});
+
+    // The lower bound is inclusive and the upper bound is exclusive.
+    ASSERT_VALUE_EQ(findHighestInsertedId(opCtx.get(), V{12}, V{20}), V{12});
+    ASSERT_VALUE_EQ(findHighestInsertedId(opCtx.get(), V{3}, V{10}), V{3});
+
+    // A range without documents yields no _id, even when there are documents on both sides.
+    ASSERT_VALUE_EQ(findHighestInsertedId(opCtx.get(), V{4}, V{10}), V());
+    ASSERT_VALUE_EQ(findHighestInsertedId(opCtx.get(), V{13}, V{20}), V());
+}
+
+TEST_F(ReshardingCollectionClonerStorageTest, FailedIdRangeCancelsTheOtherRanges) {
+    {
+        auto opCtx = makeOperationContext();
+        persistIdRangeBoundaries(opCtx.get(), {BSON("_id" << 10), BSON("_id" << 20)});
+    }
+
+    // The other ranges wait until they are cancelled, so the cloner only stops if the failed range
+    // cancels them.
+    FailPointEnableBlock failRange("reshardingCollectionClonerFailIdRange", BSON("min" << 10));
+    FailPointEnableBlock pauseRanges("reshardingPauseCollectionClonerBeforeIdRange");
+
+    auto executor = makeTaskExecutorForCloner(4);
+    auto cancelableOpCtxExecutor = makeCancelableOpCtxExecutor();
+    ON_BLOCK_EXIT([&] {
+        executor->shutdown();
+        executor->join();
+        cancelableOpCtxExecutor->shutdown();
+        cancelableOpCtxExecutor->join();
+    });
+
+    CancellationSource cancelSource;
+    CancelableOperationContextFactory factory(cancelSource.token(), cancelableOpCtxExecutor);
+
+    auto cloner = makeCloner();
+    auto status = cloner->run(executor, executor, cancelSource.token(), factory).getNoThrow();
+    ASSERT_EQ(ErrorCodes::InternalError, status);
+    ASSERT_FALSE(cancelSource.token().isCanceled());
+}
+
 }  // namespace
 }  // namespace mongo
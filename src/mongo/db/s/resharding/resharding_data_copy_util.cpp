@@ -40,6 +40,8 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/persistent_task_store.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/s/resharding/resharding_collection_cloner_ranges_gen.h"
 #include "mongo/db/s/resharding/resharding_oplog_applier_progress_gen.h"
 #include "mongo/db/s/resharding/resharding_txn_cloner_progress_gen.h"
 #include "mongo/db/s/resharding_util.h"
@@ -97,6 +99,14 @@ void ensureOplogCollectionsDropped(OperationContext* opCtx,
                                    const UUID& reshardingUUID,
                                    const UUID& sourceUUID,
                                    const std::vector<DonorShardFetchTimestamp>& donorShards) {
+    // Remove the _id ranges doc of the collection cloner.
+    PersistentTaskStore<ReshardingCollectionClonerRanges> collectionClonerRangesStore(
+        NamespaceString::kReshardingCollectionClonerRangesNamespace);
+    collectionClonerRangesStore.remove(
+        opCtx,
+        QUERY(ReshardingCollectionClonerRanges::kReshardingUUIDFieldName << reshardingUUID),
+        WriteConcernOptions());
+
     for (const auto& donor : donorShards) {
         auto reshardingSourceId = ReshardingSourceId{reshardingUUID, donor.getShardId()};
 
@@ -161,18 +171,57 @@ void ensureTemporaryReshardingCollectionRenamed(OperationContext* opCtx,
         renameCollection(opCtx, metadata.getTempReshardingNss(), metadata.getSourceNss(), options));
 }
 
-Value findHighestInsertedId(OperationContext* opCtx, const CollectionPtr& collection) {
-    auto findCommand = std::make_unique<FindCommandRequest>(collection->ns());
-    findCommand->setLimit(1);
-    findCommand->setSort(BSON("_id" << -1));
+Value findHighestInsertedId(OperationContext* opCtx,
+                            const CollectionPtr& collection,
+                            const Value& minId,
+                            const Value& maxId) {
+    BSONObj doc;
+    if (minId.missing() && maxId.missing()) {
+        auto findCommand = std::make_unique<FindCommandRequest>(collection->ns());
+        findCommand->setLimit(1);
+        findCommand->setSort(BSON("_id" << -1));
+
+        auto recordId =
+            Helpers::findOne(opCtx, collection, std::move(findCommand), true /* requireIndex */);
+        if (recordId.isNull()) {
+            return Value{};
+        }
+
+        doc = collection->docFor(opCtx, recordId).value();
+    } else {
+        const auto* idIndex = collection->getIndexCatalog()->findIdIndex(opCtx);
+        uassert(ErrorCodes::IndexNotFound,
+                str::stream() << "Missing _id index on " << collection->ns(),
+                idIndex);
+
+        const auto makeKey = [](const Value& id, bool isMinKey) {
+            BSONObjBuilder builder;
+            if (id.missing()) {
+                isMinKey ? builder.appendMinKey("") : builder.appendMaxKey("");
+            } else {
+                id.addToBsonObj(&builder, "");
+            }
+            return builder.obj();
+        };
+
+        // Scan the _id index backwards from just before 'maxId' down to 'minId'.
+        auto exec = InternalPlanner::indexScan(opCtx,
+                                               &collection,
+                                               idIndex,
+                                               makeKey(maxId, false),
+                                               makeKey(minId, true),
+                                               BoundInclusion::kIncludeEndKeyOnly,
+                                               PlanYieldPolicy::YieldPolicy::NO_YIELD,
+                                               InternalPlanner::BACKWARD,
+                                               InternalPlanner::IXSCAN_FETCH);
+
+        if (exec->getNext(&doc, nullptr) != PlanExecutor::ADVANCED) {
+            return Value{};
+        }
 
-    auto recordId =
-        Helpers::findOne(opCtx, collection, std::move(findCommand), true /* requireIndex */);
-    if (recordId.isNull()) {
-        return Value{};
+        doc = doc.getOwned();
     }
 
-    auto doc = collection->docFor(opCtx, recordId).value();
     auto value = Value{doc["_id"]};
     uassert(4929300,
             "Missing _id field for document in temporary resharding collection",
@@ -68,10 +68,10 @@ void ensureCollectionDropped(OperationContext* opCtx,
                              const NamespaceString& nss,
                              const boost::optional<CollectionUUID>& uuid = boost::none);
 /**
- * Removes documents from the oplog applier progress and transaction applier progress collections
- * that are associated with an in-progress resharding operation. Also drops all oplog buffer
- * collections and conflict stash collections that are associated with the in-progress resharding
- * operation.
+ * Removes documents from the oplog applier progress, transaction applier progress, and collection
+ * cloner ranges collections that are associated with an in-progress resharding operation. Also
+ * drops all oplog buffer collections and conflict stash collections that are associated with the
+ * in-progress resharding operation.
  */
 void ensureOplogCollectionsDropped(OperationContext* opCtx,
                                    const UUID& reshardingUUID,
@@ -89,9 +89,13 @@ void ensureTemporaryReshardingCollectionRenamed(OperationContext* opCtx,
                                                 const CommonReshardingMetadata& metadata);
 
 /**
- * Returns the largest _id value in the collection.
+ * Returns the largest _id value in the collection, or in the range [minId, maxId) when either bound
+ * is given. The collection must have the simple collation for the range to be meaningful.
  */
-Value findHighestInsertedId(OperationContext* opCtx, const CollectionPtr& collection);
+Value findHighestInsertedId(OperationContext* opCtx,
+                            const CollectionPtr& collection,
+                            const Value& minId = Value(),
+                            const Value& maxId = Value());
 
 /**
  * Returns a batch of documents suitable for being inserted with insertBatch().
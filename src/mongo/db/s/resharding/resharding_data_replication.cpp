@@ -86,6 +86,7 @@ std::unique_ptr<ReshardingCollectionCloner> ReshardingDataReplication::_makeColl
     Timestamp cloneTimestamp) {
     return std::make_unique<ReshardingCollectionCloner>(
         std::make_unique<ReshardingCollectionCloner::Env>(metrics),
+        metadata.getReshardingUUID(),
         ShardKeyPattern{metadata.getReshardingKey()},
         metadata.getSourceNss(),
         metadata.getSourceUUID(),
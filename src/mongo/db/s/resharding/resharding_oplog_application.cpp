@@ -33,6 +33,7 @@
 
 #include "mongo/db/s/resharding/resharding_oplog_application.h"
 
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/index/index_access_method.h"
@@ -44,6 +45,7 @@
 #include "mongo/db/ops/update.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_applier_utils.h"
 #include "mongo/db/s/resharding/resharding_server_parameters_gen.h"
 #include "mongo/db/session_catalog_mongod.h"
@@ -194,6 +196,101 @@ Status ReshardingOplogApplicationRules::applyOperation(OperationContext* opCtx,
     });
 }
 
+StatusWith<size_t> ReshardingOplogApplicationRules::applyInserts(OperationContext* opCtx,
+                                                                 OpIterator begin,
+                                                                 OpIterator end) const {
+    invariant(!opCtx->lockState()->inAWriteUnitOfWork());
+    invariant(opCtx->writesAreReplicated());
+
+    try {
+        WriteUnitOfWork wuow(opCtx);
+
+        AutoGetCollection autoCollOutput(opCtx,
+                                         _outputNss,
+                                         MODE_IX,
+                                         AutoGetCollectionViewMode::kViewsForbidden,
+                                         getDeadline(opCtx));
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "Failed to apply op during resharding due to missing collection "
+                              << _outputNss.ns(),
+                autoCollOutput);
+
+        AutoGetCollection autoCollStash(opCtx,
+                                        _myStashNss,
+                                        MODE_IX,
+                                        AutoGetCollectionViewMode::kViewsForbidden,
+                                        getDeadline(opCtx));
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "Failed to apply op during resharding due to missing collection "
+                              << _myStashNss.ns(),
+                autoCollStash);
+
+        // Only the inserts which would be applied by rule #2 of _applyInsert_inlock() are grouped
+        // together. Any other insert is left for applyOperation() to apply on its own.
+        std::vector<InsertStatement> inserts;
+        SimpleBSONObjUnorderedSet insertedIds;
+        for (auto it = begin; it != end; ++it) {
+            const auto& op = **it;
+            if (op.getOpType() != repl::OpTypeEnum::kInsert) {
+                break;
+            }
+
+            BSONObj oField = op.getObject();
+            auto idField = oField["_id"];
+            if (idField.eoo()) {
+                break;
+            }
+
+            BSONObj idQuery = idField.wrap();
+            if (!insertedIds.insert(idQuery).second ||
+                !_queryStashCollById(opCtx, autoCollOutput.getDb(), *autoCollStash, idQuery)
+                     .isEmpty() ||
+                !Helpers::findById(opCtx, *autoCollOutput, idQuery).isNull()) {
+                break;
+            }
+
+            LOGV2_DEBUG(5716290,
+                        3,
+                        "Applying op for resharding as part of a grouped insert",
+                        "op"_attr = redact(op.toBSONForLogging()));
+            inserts.emplace_back(oField);
+        }
+
+        if (inserts.empty()) {
+            return size_t(0);
+        }
+
+        // Writes are replicated, so use global op counters.
+        globalOpCounters.gotInserts(inserts.size());
+
+        auto oplogSlots = repl::getNextOpTimes(opCtx, inserts.size());
+        for (size_t i = 0; i < inserts.size(); ++i) {
+            inserts[i].oplogSlot = oplogSlots[i];
+        }
+
+        uassertStatusOK(autoCollOutput->insertDocuments(opCtx,
+                                                        inserts.begin(),
+                                                        inserts.end(),
+                                                        nullptr /* nullOpDebug*/,
+                                                        false /* fromMigrate */));
+
+        wuow.commit();
+        return inserts.size();
+    } catch (const DBException& ex) {
+        if (ex.code() == ErrorCodes::WriteConflict || ex.code() == ErrorCodes::LockTimeout) {
+            throw WriteConflictException();
+        }
+
+        if (ex.code() == ErrorCodes::DuplicateKey) {
+            // The output collection's default collation may consider two of the _id values to be
+            // equal. Leave it to applyOperation() to resolve them one at a time.
+            return size_t(0);
+        }
+
+        return ex.toStatus();
+    }
+}
+
 void ReshardingOplogApplicationRules::_applyInsert_inlock(OperationContext* opCtx,
                                                           Database* db,
                                                           const CollectionPtr& outputColl,
@@ -34,6 +34,7 @@
 #include <vector>
 
 #include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/catalog/collection_catalog.h"
@@ -54,6 +55,8 @@ class OperationContext;
  */
 class ReshardingOplogApplicationRules {
 public:
+    using OpIterator = std::vector<const repl::OplogEntry*>::const_iterator;
+
     ReshardingOplogApplicationRules(NamespaceString outputNss,
                                     std::vector<NamespaceString> allStashNss,
                                     size_t myStashIdx,
@@ -66,6 +69,20 @@ public:
      */
     Status applyOperation(OperationContext* opCtx, const repl::OplogEntry& op) const;
 
+    /**
+     * Applies the leading run of insert operations in [begin, end) as a single multi-document
+     * insert into the output collection. The run stops at the first operation which isn't an
+     * insert of a document absent from both the output collection and the stash collection.
+     * Returns the number of operations applied, which is 0 when the first operation must instead
+     * be applied through applyOperation().
+     *
+     * Unlike applyOperation(), write conflicts are not retried here but are thrown to the caller as
+     * a WriteConflictException so it may retry with fewer operations.
+     */
+    StatusWith<size_t> applyInserts(OperationContext* opCtx,
+                                    OpIterator begin,
+                                    OpIterator end) const;
+
 private:
     // Applies an insert operation
     void _applyInsert_inlock(OperationContext* opCtx,
@@ -33,11 +33,14 @@
 
 #include "mongo/db/s/resharding/resharding_oplog_batch_applier.h"
 
+#include <algorithm>
 #include <memory>
 
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/s/resharding/resharding_future_util.h"
 #include "mongo/db/s/resharding/resharding_oplog_application.h"
 #include "mongo/db/s/resharding/resharding_oplog_session_application.h"
+#include "mongo/db/s/resharding/resharding_server_parameters_gen.h"
 #include "mongo/logv2/log.h"
 
 namespace mongo {
@@ -56,10 +59,13 @@ SemiFuture<void> ReshardingOplogBatchApplier::applyBatch(
     struct ChainContext {
         OplogBatch batch;
         size_t nextToApply = 0;
+        size_t insertGroupSize = 0;
     };
 
     auto chainCtx = std::make_shared<ChainContext>();
     chainCtx->batch = std::move(batch);
+    chainCtx->insertGroupSize =
+        size_t(resharding::gReshardingOplogApplierMaxInsertGroupSize.load());
 
     return resharding::WithAutomaticRetry<unique_function<SemiFuture<void>()>>(
                [this, chainCtx, cancelToken, factory] {
@@ -69,6 +75,15 @@ SemiFuture<void> ReshardingOplogBatchApplier::applyBatch(
                        const auto& oplogEntry = *chainCtx->batch[i];
                        auto opCtx = factory.makeOperationContext(&cc());
 
+                       if (!IsForSessionApplication &&
+                           oplogEntry.getOpType() == repl::OpTypeEnum::kInsert) {
+                           if (auto numApplied = _applyInsertGroup(
+                                   opCtx.get(), chainCtx->batch, i, chainCtx->insertGroupSize)) {
+                               i += numApplied - 1;
+                               continue;
+                           }
+                       }
+
                        if constexpr (IsForSessionApplication) {
                            auto hitPreparedTxn =
                                _sessionApplication.tryApplyOperation(opCtx.get(), oplogEntry);
@@ -107,6 +122,41 @@ SemiFuture<void> ReshardingOplogBatchApplier::applyBatch(
         .semi();
 }
 
+size_t ReshardingOplogBatchApplier::_applyInsertGroup(OperationContext* opCtx,
+                                                      const OplogBatch& batch,
+                                                      size_t first,
+                                                      size_t& groupSize) const {
+    const auto maxGroupSize = size_t(resharding::gReshardingOplogApplierMaxInsertGroupSize.load());
+
+    if (groupSize < 2) {
+        // Write conflicts have shrunk the group down to a single insert, which applyOperation()
+        // handles on its own. Allow the next insert to be grouped again.
+        groupSize = std::min(groupSize + 1, maxGroupSize);
+        return 0;
+    }
+
+    // The server parameter may have been lowered since the group size was last adjusted.
+    groupSize = std::min(groupSize, maxGroupSize);
+
+    while (groupSize > 1) {
+        auto begin = batch.cbegin() + first;
+        auto end = begin + std::min(groupSize, batch.size() - first);
+
+        try {
+            auto numApplied = uassertStatusOK(_crudApplication.applyInserts(opCtx, begin, end));
+            if (numApplied > 0) {
+                groupSize = std::min(groupSize + 1, maxGroupSize);
+            }
+            return numApplied;
+        } catch (const WriteConflictException&) {
+            opCtx->recoveryUnit()->abandonSnapshot();
+            groupSize /= 2;
+        }
+    }
+
+    return 0;
+}
+
 template SemiFuture<void> ReshardingOplogBatchApplier::applyBatch<false>(
     OplogBatch batch,
     std::shared_ptr<executor::TaskExecutor> executor,
@@ -59,6 +59,19 @@ public:
                                 CancelableOperationContextFactory factory) const;
 
 private:
+    /**
+     * Attempts to apply the run of inserts starting at batch[first] as a single multi-document
+     * insert of up to 'groupSize' operations. Returns the number of operations applied, which is 0
+     * when batch[first] must be applied on its own instead.
+     *
+     * 'groupSize' is halved each time a write conflict is encountered and grows by one after each
+     * group applied without one, up to reshardingOplogApplierMaxInsertGroupSize.
+     */
+    size_t _applyInsertGroup(OperationContext* opCtx,
+                             const OplogBatch& batch,
+                             size_t first,
+                             size_t& groupSize) const;
+
     const ReshardingOplogApplicationRules& _crudApplication;
     const ReshardingOplogSessionApplication& _sessionApplication;
 };
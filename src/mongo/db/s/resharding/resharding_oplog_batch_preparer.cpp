@@ -31,13 +31,16 @@
 
 #include "mongo/db/s/resharding/resharding_oplog_batch_preparer.h"
 
+#include <algorithm>
 #include <third_party/murmurhash3/MurmurHash3.h>
 
 #include "mongo/bson/bsonelement_comparator.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/repl/apply_ops.h"
 #include "mongo/db/s/resharding/resharding_server_parameters_gen.h"
+#include "mongo/db/update/update_oplog_entry_serialization.h"
 #include "mongo/logv2/redaction.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/str.h"
@@ -71,6 +74,32 @@ bool shouldUpdateTxnTable(const repl::OplogEntry& op) {
     return false;
 }
 
+/**
+ * Removes the update operations from 'writer' which are followed by a replacement-style update to
+ * the same document with no insert or delete of that document in between. The later replacement
+ * overwrites the full contents of the document wherever the earlier updates would have left it, so
+ * applying them would only be wasted work.
+ */
+void elideSupersededUpdates(ReshardingOplogBatchPreparer::OplogBatchToApply& writer) {
+    SimpleBSONObjUnorderedSet replacedIds;
+
+    for (auto it = writer.rbegin(); it != writer.rend(); ++it) {
+        const auto* op = *it;
+        auto idQuery = op->getIdElement().wrap();
+
+        if (op->getOpType() != repl::OpTypeEnum::kUpdate) {
+            replacedIds.erase(idQuery);
+        } else if (replacedIds.find(idQuery) != replacedIds.end()) {
+            *it = nullptr;
+        } else if (update_oplog_entry::extractUpdateType(op->getObject()) ==
+                   update_oplog_entry::UpdateType::kReplacement) {
+            replacedIds.insert(std::move(idQuery));
+        }
+    }
+
+    writer.erase(std::remove(writer.begin(), writer.end(), nullptr), writer.end());
+}
+
 }  // anonymous namespace
 
 using WriterVectors = ReshardingOplogBatchPreparer::WriterVectors;
@@ -144,6 +173,10 @@ WriterVectors ReshardingOplogBatchPreparer::makeCrudOpWriterVectors(
         }
     }
 
+    for (auto& writer : writerVectors) {
+        elideSupersededUpdates(writer);
+    }
+
     return writerVectors;
 }
 
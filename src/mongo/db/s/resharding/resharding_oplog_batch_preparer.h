@@ -63,7 +63,8 @@ public:
      *
      * The returned writer vectors guarantee that modifications to the same document (as identified
      * by its _id) will be in the same writer vector and will appear in their corresponding `batch`
-     * order.
+     * order. Additionally, an update to a document which is followed by a replacement-style update
+     * to the same document, with no insert or delete of it in between, will be elided.
      *
      * The returned writer vectors refer to memory owned by `batch` and `derivedOps`. The caller
      * must take care to ensure both `batch` and `derivedOps` outlive the writer vectors all being
@@ -66,6 +66,33 @@ protected:
         return {op.toBSON()};
     }
 
+    repl::OplogEntry makeModifierUpdateOp(BSONObj idQuery, BSONObj updateMod) {
+        repl::MutableOplogEntry op;
+        op.setOpType(repl::OpTypeEnum::kUpdate);
+        op.setObject2(std::move(idQuery));
+        op.setObject(std::move(updateMod));
+
+        // These are unused by ReshardingOplogBatchPreparer but required by IDL parsing.
+        op.setNss({});
+        op.setOpTime({{}, {}});
+        op.setWallClockTime({});
+
+        return {op.toBSON()};
+    }
+
+    repl::OplogEntry makeCrudOp(repl::OpTypeEnum opType, BSONObj document) {
+        repl::MutableOplogEntry op;
+        op.setOpType(opType);
+        op.setObject(std::move(document));
+
+        // These are unused by ReshardingOplogBatchPreparer but required by IDL parsing.
+        op.setNss({});
+        op.setOpTime({{}, {}});
+        op.setWallClockTime({});
+
+        return {op.toBSON()};
+    }
+
     repl::OplogEntry makeApplyOps(BSONObj document,
                                   bool isPrepare,
                                   bool isPartial,
@@ -150,9 +177,10 @@ private:
 TEST_F(ReshardingOplogBatchPreparerTest, AssignsCrudOpsToWriterVectorsById) {
     OplogBatch batch;
 
+    // Modifier-style updates are used so none of them are elided for being superseded.
     int numOps = 10;
     for (int i = 0; i < numOps; ++i) {
-        batch.emplace_back(makeUpdateOp(BSON("_id" << 0 << "n" << i)));
+        batch.emplace_back(makeModifierUpdateOp(BSON("_id" << 0), BSON("$set" << BSON("n" << i))));
     }
 
     std::list<repl::OplogEntry> derivedOps;
@@ -163,10 +191,37 @@ TEST_F(ReshardingOplogBatchPreparerTest, AssignsCrudOpsToWriterVectorsById) {
     auto writer = getNonEmptyWriterVector(writerVectors);
     ASSERT_EQ(writer.size(), numOps);
     for (int i = 0; i < numOps; ++i) {
-        ASSERT_BSONOBJ_BINARY_EQ(writer[i]->getObject(), BSON("_id" << 0 << "n" << i));
+        ASSERT_BSONOBJ_BINARY_EQ(writer[i]->getObject(), BSON("$set" << BSON("n" << i)));
     }
 }
 
+TEST_F(ReshardingOplogBatchPreparerTest, ElidesUpdatesSupersededByReplacement) {
+    OplogBatch batch;
+    batch.emplace_back(makeModifierUpdateOp(BSON("_id" << 0), BSON("$set" << BSON("n" << 0))));
+    batch.emplace_back(makeUpdateOp(BSON("_id" << 0 << "n" << 1)));
+    batch.emplace_back(makeModifierUpdateOp(BSON("_id" << 0), BSON("$set" << BSON("n" << 2))));
+    batch.emplace_back(makeCrudOp(repl::OpTypeEnum::kDelete, BSON("_id" << 0)));
+    batch.emplace_back(makeCrudOp(repl::OpTypeEnum::kInsert, BSON("_id" << 0 << "n" << 3)));
+    batch.emplace_back(makeUpdateOp(BSON("_id" << 0 << "n" << 4)));
+    batch.emplace_back(makeModifierUpdateOp(BSON("_id" << 0), BSON("$set" << BSON("n" << 5))));
+    batch.emplace_back(makeUpdateOp(BSON("_id" << 0 << "n" << 6)));
+
+    std::list<repl::OplogEntry> derivedOps;
+    auto writerVectors = _batchPreparer.makeCrudOpWriterVectors(batch, derivedOps);
+    ASSERT_EQ(writerVectors.size(), kNumWriterVectors);
+
+    // The first update is superseded by the replacement after it. The update before the delete
+    // isn't followed by a replacement until after the delete and so must still be applied. The
+    // updates after the insert are superseded by the final replacement.
+    auto writer = getNonEmptyWriterVector(writerVectors);
+    ASSERT_EQ(writer.size(), 5U);
+    ASSERT_BSONOBJ_BINARY_EQ(writer[0]->getObject(), BSON("_id" << 0 << "n" << 1));
+    ASSERT_BSONOBJ_BINARY_EQ(writer[1]->getObject(), BSON("$set" << BSON("n" << 2)));
+    ASSERT(writer[2]->getOpType() == repl::OpTypeEnum::kDelete);
+    ASSERT(writer[3]->getOpType() == repl::OpTypeEnum::kInsert);
+    ASSERT_BSONOBJ_BINARY_EQ(writer[4]->getObject(), BSON("_id" << 0 << "n" << 6));
+}
+
 TEST_F(ReshardingOplogBatchPreparerTest, DistributesCrudOpsToWriterVectorsFairly) {
     OplogBatch batch;
 
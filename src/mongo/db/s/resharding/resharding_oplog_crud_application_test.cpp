@@ -339,6 +339,42 @@ TEST_F(ReshardingOplogCrudApplicationTest, InsertOpBecomesReplacementUpdateOnOut
     }
 }
 
+TEST_F(ReshardingOplogCrudApplicationTest, InsertOpsAreGroupedUntilExistingDocument) {
+    // Only inserts which would be applied by rule #2 described in
+    // ReshardingOplogApplicationRules::_applyInsert_inlock are grouped together by applyInserts().
+    {
+        auto opCtx = makeOperationContext();
+        ASSERT_OK(
+            applier()->applyOperation(opCtx.get(), makeInsertOp(BSON("_id" << 2 << sk() << 1))));
+    }
+
+    std::vector<repl::OplogEntry> ops = {makeInsertOp(BSON("_id" << 0)),
+                                         makeInsertOp(BSON("_id" << 1)),
+                                         makeInsertOp(BSON("_id" << 2 << sk() << 2)),
+                                         makeInsertOp(BSON("_id" << 3))};
+    std::vector<const repl::OplogEntry*> opPtrs;
+    for (const auto& op : ops) {
+        opPtrs.emplace_back(&op);
+    }
+
+    {
+        auto opCtx = makeOperationContext();
+        auto numApplied = unittest::assertGet(
+            applier()->applyInserts(opCtx.get(), opPtrs.cbegin(), opPtrs.cend()));
+        ASSERT_EQ(numApplied, 2U);
+    }
+
+    {
+        auto opCtx = makeOperationContext();
+        checkCollectionContents(
+            opCtx.get(),
+            outputNss(),
+            {BSON("_id" << 0), BSON("_id" << 1), BSON("_id" << 2 << sk() << 1)});
+        checkCollectionContents(opCtx.get(), myStashNss(), {});
+        checkCollectionContents(opCtx.get(), otherStashNss(), {});
+    }
+}
+
 TEST_F(ReshardingOplogCrudApplicationTest, InsertOpWritesToStashCollectionAfterConflict) {
     // This case tests applying rules #1 and #4 described in
     // ReshardingOplogApplicationRules::_applyInsert_inlock.
@@ -36,6 +36,7 @@
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/op_observer_impl.h"
+#include "mongo/db/s/chunk_load_registry.h"
 #include "mongo/db/s/chunk_split_state_driver.h"
 #include "mongo/db/s/chunk_splitter.h"
 #include "mongo/db/s/collection_critical_section_document_gen.h"
@@ -197,8 +198,11 @@ void incrementChunkOnInsertOrUpdate(OperationContext* opCtx,
     auto chunkWritesTracker = chunk.getWritesTracker();
     chunkWritesTracker->addBytesWritten(dataWritten);
     // Don't trigger chunk splits from inserts happening due to migration since
-    // we don't necessarily own that chunk yet
+    // we don't necessarily own that chunk yet. These inserts also don't count towards the load on
+    // the chunk reported to the balancer.
     if (!fromMigrate) {
+        ChunkLoadRegistry::get(opCtx).recordWrite(nss, chunk, dataWritten);
+
         const auto balancerConfig = Grid::get(opCtx)->getBalancerConfiguration();
 
         if (balancerConfig->getShouldAutoSplit() &&
@@ -32,10 +32,12 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/s/active_migrations_registry.h"
+#include "mongo/db/s/chunk_load_registry.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/resharding/resharding_metrics.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/sharding_statistics.h"
+#include "mongo/db/service_context.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/shard_registry.h"
@@ -127,5 +129,33 @@ public:
 
 } shardingStatisticsServerStatus;
 
+class ShardingLoadServerStatus final : public ServerStatusSection {
+public:
+    ShardingLoadServerStatus() : ServerStatusSection("shardingLoad") {}
+
+    // The number of ranges with the most recent writes, which are reported
+    static constexpr size_t kMaxReportedRanges = 100;
+
+    bool includeByDefault() const override {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        if (!isClusterNode())
+            return {};
+
+        auto const shardingState = ShardingState::get(opCtx);
+        if (!shardingState->enabled())
+            return {};
+
+        BSONObjBuilder result;
+        ChunkLoadRegistry::get(opCtx).report(
+            &result, kMaxReportedRanges, opCtx->getServiceContext()->getFastClockSource()->now());
+        return result.obj();
+    }
+
+} shardingLoadServerStatus;
+
 }  // namespace
 }  // namespace mongo
@@ -56,13 +56,16 @@
 #include "mongo/config.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/sorter/sorter_file_format.h"
 #include "mongo/db/storage/encryption_hooks.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/is_mongos.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/destructor_guard.h"
+#include "mongo/util/future.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -194,6 +197,14 @@ public:
         Settings;
     typedef std::pair<Key, Value> Data;
 
+    /**
+     * A block of serialized key-value pairs, after decryption and decompression.
+     */
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
     FileIterator(const std::string& fileFullPath,
                  std::streampos fileStartOffset,
                  std::streampos fileEndOffset,
@@ -212,6 +223,10 @@ public:
                 boost::filesystem::file_size(_fileFullPath) != 0);
     }
 
+    ~FileIterator() {
+        _waitForReadAhead();
+    }
+
     void openSource() {
         _file.open(_fileFullPath.c_str(), std::ios::in | std::ios::binary);
         uassert(16814,
@@ -227,6 +242,7 @@ public:
     }
 
     void closeSource() {
+        _waitForReadAhead();
         _file.close();
         uassert(50969,
                 str::stream() << "error closing file \"" << _fileFullPath
@@ -295,64 +311,172 @@ private:
      * read, then _done is set to true and the function returns immediately.
      */
     void fillBufferFromDisk() {
-        int32_t rawSize;
-        read(&rawSize, sizeof(rawSize));
-        if (_done)
+        boost::optional<Block> block;
+        if (_readAhead) {
+            block = std::move(*_readAhead).get();
+            _readAhead.reset();
+        } else {
+            block = _readBlock();
+        }
+
+        if (!block) {
+            _done = true;
             return;
+        }
+
+        // hold on to the block's data until the next block replaces it
+        _buffer = std::move(block->data);
+        _bufferReader.reset(new BufReader(_buffer.get(), block->size));
+
+        if (gSorterSpillReadAhead.load()) {
+            _scheduleReadAhead();
+        }
+    }
+
+    /**
+     * Reads the next block on the read-ahead pool, so that its I/O, decryption and decompression
+     * overlap with the consumption of the current block. Only one block is read ahead at a time,
+     * and nothing else touches _file until it has been waited for.
+     */
+    void _scheduleReadAhead() {
+        auto pf = makePromiseFuture<boost::optional<Block>>();
+        _readAhead.emplace(std::move(pf.future));
+        sorter::getSorterReadAheadPool()->schedule(
+            [this, promise = std::move(pf.promise)](Status status) mutable {
+                promise.setWith([&] {
+                    uassertStatusOK(status);
+                    return _readBlock();
+                });
+            });
+    }
+
+    void _waitForReadAhead() noexcept {
+        if (_readAhead) {
+            // Errors are rethrown by fillBufferFromDisk(), the only place the block is needed.
+            std::move(*_readAhead).getNoThrow().getStatus().ignore();
+            _readAhead.reset();
+        }
+    }
+
+    /**
+     * Reads, decrypts and decompresses the next block of the range, returning boost::none if the
+     * end of the range has been reached.
+     */
+    boost::optional<Block> _readBlock() {
+        int32_t rawSize;
+        if (!read(&rawSize, sizeof(rawSize)))
+            return boost::none;
+
+        if (rawSize == sorter::kExtendedBlockMarker)
+            return _readExtendedBlock();
 
         // negative size means compressed
         const bool compressed = rawSize < 0;
         int32_t blockSize = std::abs(rawSize);
 
-        _buffer.reset(new char[blockSize]);
-        read(_buffer.get(), blockSize);
-        uassert(16816, "file too short?", !_done);
-
-        if (auto encryptionHooks = getEncryptionHooksIfEnabled()) {
-            std::unique_ptr<char[]> out(new char[blockSize]);
-            size_t outLen;
-            Status status =
-                encryptionHooks->unprotectTmpData(reinterpret_cast<const uint8_t*>(_buffer.get()),
-                                                  blockSize,
-                                                  reinterpret_cast<uint8_t*>(out.get()),
-                                                  blockSize,
-                                                  &outLen,
-                                                  _dbName);
-            uassert(28841,
-                    str::stream() << "Failed to unprotect data: " << status.toString(),
-                    status.isOK());
-            blockSize = outLen;
-            _buffer.swap(out);
-        }
+        std::unique_ptr<char[]> buffer(new char[blockSize]);
+        uassert(16816, "file too short?", read(buffer.get(), blockSize));
+        _unprotect(&buffer, &blockSize);
 
         if (!compressed) {
-            _bufferReader.reset(new BufReader(_buffer.get(), blockSize));
-            return;
+            return Block{std::move(buffer), static_cast<size_t>(blockSize)};
         }
 
-        dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
+        dassert(snappy::IsValidCompressedBuffer(buffer.get(), blockSize));
 
         size_t uncompressedSize;
         uassert(17061,
                 "couldn't get uncompressed length",
-                snappy::GetUncompressedLength(_buffer.get(), blockSize, &uncompressedSize));
+                snappy::GetUncompressedLength(buffer.get(), blockSize, &uncompressedSize));
 
         std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
         uassert(17062,
                 "decompression failed",
-                snappy::RawUncompress(_buffer.get(), blockSize, decompressionBuffer.get()));
+                snappy::RawUncompress(buffer.get(), blockSize, decompressionBuffer.get()));
 
-        // hold on to decompressed data and throw out compressed data at block exit
-        _buffer.swap(decompressionBuffer);
-        _bufferReader.reset(new BufReader(_buffer.get(), uncompressedSize));
+        // throw out compressed data at block exit
+        return Block{std::move(decompressionBuffer), uncompressedSize};
     }
 
     /**
-     * Attempts to read data from disk. Sets _done to true when file offset reaches _fileEndOffset.
+     * Reads the remainder of a block written in the format described in sorter_file_format.h.
+     */
+    Block _readExtendedBlock() {
+        uint8_t codec;
+        uint8_t flags;
+        int32_t sizes[3];
+        uassert(5716240,
+                "file too short?",
+                read(&codec, sizeof(codec)) && read(&flags, sizeof(flags)) &&
+                    read(&sizes[0], sizeof(sizes)));
+
+        int32_t blockSize = sizes[0];
+        const int32_t encodedSize = sizes[1];
+        const int32_t plainSize = sizes[2];
+        uassert(5716241,
+                str::stream() << "invalid block header in file \"" << _fileFullPath << "\"",
+                blockSize >= 0 && encodedSize >= 0 && plainSize >= 0 &&
+                    (flags & ~sorter::kPrefixCompressedKeys) == 0);
+
+        std::unique_ptr<char[]> buffer(new char[blockSize]);
+        uassert(5716242, "file too short?", read(buffer.get(), blockSize));
+        _unprotect(&buffer, &blockSize);
+
+        const auto spillCodec = static_cast<sorter::SpillCodec>(codec);
+        if (spillCodec != sorter::SpillCodec::kNone) {
+            std::unique_ptr<char[]> decompressionBuffer(new char[encodedSize]);
+            sorter::uncompressSpillBlock(
+                spillCodec, buffer.get(), blockSize, decompressionBuffer.get(), encodedSize);
+            buffer.swap(decompressionBuffer);
+            blockSize = encodedSize;
+        }
+        uassert(5716243,
+                str::stream() << "unexpected block size in file \"" << _fileFullPath << "\"",
+                blockSize == encodedSize);
+
+        if (!(flags & sorter::kPrefixCompressedKeys)) {
+            uassert(5716244,
+                    str::stream() << "unexpected block size in file \"" << _fileFullPath << "\"",
+                    encodedSize == plainSize);
+            return Block{std::move(buffer), static_cast<size_t>(plainSize)};
+        }
+
+        std::unique_ptr<char[]> plain(new char[plainSize]);
+        sorter::decodePrefixCompressedBlock(buffer.get(), encodedSize, plain.get(), plainSize);
+        return Block{std::move(plain), static_cast<size_t>(plainSize)};
+    }
+
+    /**
+     * Decrypts the 'size' bytes of 'buffer' in place if encryption is enabled.
+     */
+    void _unprotect(std::unique_ptr<char[]>* buffer, int32_t* size) {
+        auto encryptionHooks = getEncryptionHooksIfEnabled();
+        if (!encryptionHooks)
+            return;
+
+        std::unique_ptr<char[]> out(new char[*size]);
+        size_t outLen;
+        Status status =
+            encryptionHooks->unprotectTmpData(reinterpret_cast<const uint8_t*>(buffer->get()),
+                                              *size,
+                                              reinterpret_cast<uint8_t*>(out.get()),
+                                              *size,
+                                              &outLen,
+                                              _dbName);
+        uassert(28841,
+                str::stream() << "Failed to unprotect data: " << status.toString(),
+                status.isOK());
+        *size = outLen;
+        buffer->swap(out);
+    }
+
+    /**
+     * Attempts to read data from disk. Returns false, without reading anything, when the file
+     * offset reaches _fileEndOffset.
      *
      * Masserts on any file errors
      */
-    void read(void* out, size_t size) {
+    bool read(void* out, size_t size) {
         invariant(_file.is_open());
 
         const std::streampos offset = _file.tellg();
@@ -363,8 +487,7 @@ private:
 
         if (offset >= _fileEndOffset) {
             invariant(offset == _fileEndOffset);
-            _done = true;
-            return;
+            return false;
         }
 
         _file.read(reinterpret_cast<char*>(out), size);
@@ -373,6 +496,7 @@ private:
                               << "\": " << myErrnoWithDescription(),
                 _file.good());
         verify(_file.gcount() == static_cast<std::streamsize>(size));
+        return true;
     }
 
     const Settings _settings;
@@ -380,6 +504,10 @@ private:
 
     std::unique_ptr<char[]> _buffer;
     std::unique_ptr<BufReader> _bufferReader;
+
+    // The next block, when it is being read ahead of the one in _buffer.
+    boost::optional<Future<boost::optional<Block>>> _readAhead;
+
     std::string _fileFullPath;        // File containing the sorted data range.
     std::streampos _fileStartOffset;  // File offset at which the sorted data range starts.
     std::streampos _fileEndOffset;    // File offset at which the sorted data range ends.
@@ -1047,7 +1175,10 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts,
       // _file.tellp() is not initialized on all systems to reflect this. Therefore, we must also
       // pass in the expected offset to this constructor.
       _fileStartOffset(fileStartOffset),
-      _dbName(opts.dbName) {
+      _dbName(opts.dbName),
+      _blockSizeBytes(gSorterSpillBlockSizeBytes.load()),
+      _codec(sorter::getConfiguredSpillCodec()),
+      _prefixCompressKeys(gSorterSpillPrefixCompression.load()) {
 
     // This should be checked by consumers, but if we get here don't allow writes.
     uassert(
@@ -1074,23 +1205,47 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts,
 
 template <typename Key, typename Value>
 void SortedFileWriter<Key, Value>::addAlreadySorted(const Key& key, const Value& val) {
+    if (_prefixCompressKeys) {
+        _addPrefixCompressed(key, val);
+    } else {
+        // Offset that points to the place in the buffer where a new data object will be stored.
+        int _nextObjPos = _buffer.len();
+
+        // Add serialized key and value to the buffer.
+        key.serializeForSorter(_buffer);
+        val.serializeForSorter(_buffer);
+
+        // Serializing the key and value grows the buffer, but _buffer.buf() still points to the
+        // beginning. Use _buffer.len() to determine portion of buffer containing new datum.
+        _checksum =
+            addDataToChecksum(_buffer.buf() + _nextObjPos, _buffer.len() - _nextObjPos, _checksum);
+        _plainSize = _buffer.len();
+    }
 
-    // Offset that points to the place in the buffer where a new data object will be stored.
-    int _nextObjPos = _buffer.len();
-
-    // Add serialized key and value to the buffer.
-    key.serializeForSorter(_buffer);
-    val.serializeForSorter(_buffer);
-
-    // Serializing the key and value grows the buffer, but _buffer.buf() still points to the
-    // beginning. Use _buffer.len() to determine portion of buffer containing new datum.
-    _checksum =
-        addDataToChecksum(_buffer.buf() + _nextObjPos, _buffer.len() - _nextObjPos, _checksum);
-
-    if (_buffer.len() > 64 * 1024)
+    if (_plainSize > _blockSizeBytes)
         spill();
 }
 
+template <typename Key, typename Value>
+void SortedFileWriter<Key, Value>::_addPrefixCompressed(const Key& key, const Value& val) {
+    // The checksum covers the serialized data as the FileIterator sees it once the block has been
+    // expanded, so serialize into a scratch buffer first and encode from there.
+    _scratch.reset();
+    key.serializeForSorter(_scratch);
+    const int keySize = _scratch.len();
+    val.serializeForSorter(_scratch);
+    _checksum = addDataToChecksum(_scratch.buf(), _scratch.len(), _checksum);
+
+    const StringData serializedKey(_scratch.buf(), keySize);
+    sorter::appendPrefixCompressedEntry(&_buffer,
+                                        _lastKey,
+                                        serializedKey,
+                                        StringData(_scratch.buf() + keySize,
+                                                   _scratch.len() - keySize));
+    _lastKey.assign(serializedKey.rawData(), serializedKey.size());
+    _plainSize += _scratch.len();
+}
+
 template <typename Key, typename Value>
 void SortedFileWriter<Key, Value>::spill() {
     int32_t size = _buffer.len();
@@ -1099,14 +1254,22 @@ void SortedFileWriter<Key, Value>::spill() {
     if (size == 0)
         return;
 
-    std::string compressed;
-    snappy::Compress(outBuffer, size, &compressed);
-    verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
+    // Blocks written with the default settings keep the original format, so that files spilled
+    // by this version can still be read by older ones, e.g. when resuming an index build.
+    const bool extendedFormat = _prefixCompressKeys || _codec != sorter::SpillCodec::kSnappy;
+    const int32_t encodedSize = size;
 
-    const bool shouldCompress = compressed.size() < size_t(_buffer.len() / 10 * 9);
-    if (shouldCompress) {
-        size = compressed.size();
-        outBuffer = const_cast<char*>(compressed.data());
+    std::string compressed;
+    bool shouldCompress = false;
+    if (_codec != sorter::SpillCodec::kNone) {
+        sorter::compressSpillBlock(_codec, outBuffer, size, &compressed);
+        verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
+
+        shouldCompress = compressed.size() < size_t(_buffer.len() / 10 * 9);
+        if (shouldCompress) {
+            size = compressed.size();
+            outBuffer = const_cast<char*>(compressed.data());
+        }
     }
 
     std::unique_ptr<char[]> out;
@@ -1127,11 +1290,22 @@ void SortedFileWriter<Key, Value>::spill() {
         size = resultLen;
     }
 
-    // negative size means compressed
-    size = shouldCompress ? -size : size;
     try {
-        _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
-        _file.write(outBuffer, std::abs(size));
+        if (extendedFormat) {
+            const int32_t header[] = {sorter::kExtendedBlockMarker, size, encodedSize, _plainSize};
+            const uint8_t codec =
+                static_cast<uint8_t>(shouldCompress ? _codec : sorter::SpillCodec::kNone);
+            const uint8_t flags = _prefixCompressKeys ? sorter::kPrefixCompressedKeys : 0;
+            _file.write(reinterpret_cast<const char*>(&header[0]), sizeof(header[0]));
+            _file.write(reinterpret_cast<const char*>(&codec), sizeof(codec));
+            _file.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+            _file.write(reinterpret_cast<const char*>(&header[1]), 3 * sizeof(header[0]));
+        } else {
+            // negative size means compressed
+            const int32_t rawSize = shouldCompress ? -size : size;
+            _file.write(reinterpret_cast<const char*>(&rawSize), sizeof(rawSize));
+        }
+        _file.write(outBuffer, size);
     } catch (const std::system_error& ex) {
         if (ex.code() == std::errc::no_space_on_device) {
             msgasserted(ErrorCodes::OutOfDiskSpace,
@@ -1147,6 +1321,8 @@ void SortedFileWriter<Key, Value>::spill() {
     }
 
     _buffer.reset();
+    _lastKey.clear();
+    _plainSize = 0;
 }
 
 template <typename Key, typename Value>
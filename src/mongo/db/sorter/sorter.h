@@ -39,6 +39,7 @@
 #include <vector>
 
 #include "mongo/bson/util/builder.h"
+#include "mongo/db/sorter/sorter_file_format.h"
 #include "mongo/db/sorter/sorter_gen.h"
 #include "mongo/util/bufreader.h"
 
@@ -360,11 +361,25 @@ public:
 private:
     void spill();
 
+    /**
+     * Appends the key and value to '_buffer' as an entry of a prefix compressed block.
+     */
+    void _addPrefixCompressed(const Key& key, const Value& val);
+
     const Settings _settings;
     std::string _fileFullPath;
     std::ofstream _file;
     BufBuilder _buffer;
 
+    // The number of bytes the entries in '_buffer' take up once serialized, which differs from
+    // _buffer.len() when keys are prefix compressed.
+    int32_t _plainSize = 0;
+
+    // Holds the current key and value while they are being prefix compressed, along with the
+    // previous serialized key in the block being built.
+    BufBuilder _scratch;
+    std::string _lastKey;
+
     // Keeps track of the hash of all data objects spilled to disk. Passed to the FileIterator
     // to ensure data has not been corrupted after reading from disk.
     uint32_t _checksum = 0;
@@ -376,6 +391,12 @@ private:
     std::streampos _fileEndOffset;
 
     boost::optional<std::string> _dbName;
+
+    // Block size and encoding, fixed for the lifetime of the writer from the sorterSpill* server
+    // parameters.
+    const int32_t _blockSizeBytes;
+    const sorter::SpillCodec _codec;
+    const bool _prefixCompressKeys;
 };
 }  // namespace mongo
 
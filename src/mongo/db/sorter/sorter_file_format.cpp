@@ -0,0 +1,219 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter_file_format.h"
+
+#include <cstring>
+#include <snappy.h>
+#include <zstd.h>
+
+#include "mongo/db/sorter/sorter_gen.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace sorter {
+namespace {
+
+void appendVarUInt(BufBuilder* out, uint64_t value) {
+    while (value >= 0x80) {
+        out->appendChar(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out->appendChar(static_cast<char>(value));
+}
+
+uint64_t readVarUInt(const char*& pos, const char* end) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uassert(5716230, "Truncated prefix compressed sorter block", pos < end);
+        const uint8_t byte = static_cast<uint8_t>(*pos++);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    uasserted(5716231, "Invalid length in prefix compressed sorter block");
+}
+
+ThreadPool::Options makeReadAheadPoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "SorterReadAheadThreadPool";
+    options.threadNamePrefix = "SorterReadAhead-";
+    options.minThreads = 0;
+    options.maxThreads = 4;
+    return options;
+}
+
+}  // namespace
+
+Status validateSorterSpillCompressor(const std::string& value) {
+    if (value != "none" && value != "snappy" && value != "zstd") {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Unsupported sorter spill compressor '" << value
+                              << "', expected one of 'none', 'snappy' or 'zstd'"};
+    }
+    return Status::OK();
+}
+
+SpillCodec getConfiguredSpillCodec() {
+    if (gSorterSpillCompressor == "none") {
+        return SpillCodec::kNone;
+    }
+    if (gSorterSpillCompressor == "zstd") {
+        return SpillCodec::kZstd;
+    }
+    return SpillCodec::kSnappy;
+}
+
+void compressSpillBlock(SpillCodec codec, const char* data, size_t size, std::string* out) {
+    switch (codec) {
+        case SpillCodec::kSnappy:
+            snappy::Compress(data, size, out);
+            return;
+        case SpillCodec::kZstd: {
+            out->resize(ZSTD_compressBound(size));
+            size_t ret = ZSTD_compress(out->data(), out->size(), data, size, ZSTD_CLEVEL_DEFAULT);
+            uassert(5716232,
+                    str::stream() << "Failed to compress sorter block: " << ZSTD_getErrorName(ret),
+                    !ZSTD_isError(ret));
+            out->resize(ret);
+            return;
+        }
+        case SpillCodec::kNone:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void uncompressSpillBlock(
+    SpillCodec codec, const char* data, size_t size, char* out, size_t outSize) {
+    switch (codec) {
+        case SpillCodec::kSnappy: {
+            size_t uncompressedSize;
+            uassert(5716233,
+                    "Failed to decompress sorter block",
+                    snappy::GetUncompressedLength(data, size, &uncompressedSize) &&
+                        uncompressedSize == outSize && snappy::RawUncompress(data, size, out));
+            return;
+        }
+        case SpillCodec::kZstd: {
+            size_t ret = ZSTD_decompress(out, outSize, data, size);
+            uassert(5716234,
+                    str::stream() << "Failed to decompress sorter block: "
+                                  << (ZSTD_isError(ret) ? ZSTD_getErrorName(ret) : "size mismatch"),
+                    !ZSTD_isError(ret) && ret == outSize);
+            return;
+        }
+        case SpillCodec::kNone:
+            break;
+    }
+    uasserted(5716235,
+              str::stream() << "Unknown sorter block codec " << static_cast<int>(codec));
+}
+
+void appendPrefixCompressedEntry(BufBuilder* out,
+                                 StringData previousKey,
+                                 StringData key,
+                                 StringData value) {
+    const size_t maxShared = std::min(previousKey.size(), key.size());
+    size_t shared = 0;
+    while (shared < maxShared && previousKey[shared] == key[shared]) {
+        ++shared;
+    }
+
+    appendVarUInt(out, shared);
+    appendVarUInt(out, key.size() - shared);
+    out->appendBuf(key.rawData() + shared, key.size() - shared);
+    appendVarUInt(out, value.size());
+    out->appendBuf(value.rawData(), value.size());
+}
+
+void decodePrefixCompressedBlock(const char* data, size_t size, char* out, size_t outSize) {
+    const char* pos = data;
+    const char* const end = data + size;
+    char* const outEnd = out + outSize;
+
+    // The previous key has already been expanded into 'out', so shared prefixes are copied from
+    // there rather than kept in a separate buffer.
+    const char* previousKey = nullptr;
+    size_t previousKeySize = 0;
+
+    auto copyOut = [&](const char* src, size_t len) {
+        uassert(5716236,
+                "Prefix compressed sorter block is larger than expected",
+                static_cast<size_t>(outEnd - out) >= len && static_cast<size_t>(end - src) >= len);
+        std::memcpy(out, src, len);
+        out += len;
+    };
+
+    while (pos < end) {
+        const size_t shared = readVarUInt(pos, end);
+        const size_t suffixSize = readVarUInt(pos, end);
+        uassert(5716237,
+                "Invalid shared prefix in sorter block",
+                shared <= previousKeySize && (shared == 0 || previousKey));
+
+        char* const key = out;
+        if (shared) {
+            uassert(5716238,
+                    "Prefix compressed sorter block is larger than expected",
+                    static_cast<size_t>(outEnd - out) >= shared);
+            std::memcpy(out, previousKey, shared);
+            out += shared;
+        }
+        copyOut(pos, suffixSize);
+        pos += suffixSize;
+        previousKey = key;
+        previousKeySize = shared + suffixSize;
+
+        const size_t valueSize = readVarUInt(pos, end);
+        copyOut(pos, valueSize);
+        pos += valueSize;
+    }
+
+    uassert(5716239, "Prefix compressed sorter block is smaller than expected", out == outEnd);
+}
+
+ThreadPool* getSorterReadAheadPool() {
+    // Intentionally leaked, since file iterators may be destroyed during static destruction.
+    static ThreadPool* const pool = [] {
+        auto pool = new ThreadPool(makeReadAheadPoolOptions());
+        pool->startup();
+        return pool;
+    }();
+    return pool;
+}
+
+}  // namespace sorter
+}  // namespace mongo
@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/util/builder.h"
+
+namespace mongo {
+
+class ThreadPool;
+
+namespace sorter {
+
+/**
+ * Spilled blocks normally start with their size as an int32_t, negated if the block is compressed
+ * with snappy. A block starting with this marker, which is never a valid size, instead uses the
+ * extended format:
+ *
+ *      int32_t kExtendedBlockMarker
+ *      uint8_t codec          the SpillCodec used to compress the stored bytes
+ *      uint8_t flags          a bitmask of ExtendedBlockFlags
+ *      int32_t storedSize     the number of bytes that follow the header on disk
+ *      int32_t encodedSize    the size of the block after undoing encryption and compression
+ *      int32_t plainSize      the size of the serialized key-value pairs held in the block
+ *      char[storedSize]
+ */
+constexpr int32_t kExtendedBlockMarker = std::numeric_limits<int32_t>::min();
+
+enum class SpillCodec : uint8_t { kNone = 0, kSnappy = 1, kZstd = 2 };
+
+enum ExtendedBlockFlags : uint8_t {
+    // Each key is stored as the length of the prefix it shares with the previous key in the block
+    // followed by the remaining bytes. See appendPrefixCompressedEntry().
+    kPrefixCompressedKeys = 1 << 0,
+};
+
+/**
+ * Validates the 'sorterSpillCompressor' server parameter.
+ */
+Status validateSorterSpillCompressor(const std::string& value);
+
+/**
+ * Returns the codec selected by the 'sorterSpillCompressor' server parameter.
+ */
+SpillCodec getConfiguredSpillCodec();
+
+/**
+ * Compresses 'size' bytes at 'data' with 'codec' into 'out'. 'codec' must not be kNone.
+ */
+void compressSpillBlock(SpillCodec codec, const char* data, size_t size, std::string* out);
+
+/**
+ * Decompresses 'size' bytes at 'data', which were compressed with 'codec', into the 'outSize' bytes
+ * at 'out'. Throws if the data cannot be decompressed to exactly 'outSize' bytes.
+ */
+void uncompressSpillBlock(
+    SpillCodec codec, const char* data, size_t size, char* out, size_t outSize);
+
+/**
+ * Appends the serialized key-value pair 'key' and 'value' to the block being built in 'out',
+ * storing only the suffix of 'key' that differs from 'previousKey'.
+ */
+void appendPrefixCompressedEntry(BufBuilder* out,
+                                 StringData previousKey,
+                                 StringData key,
+                                 StringData value);
+
+/**
+ * Expands a block of entries written by appendPrefixCompressedEntry() back into the serialized
+ * key-value pairs, which must take up exactly 'outSize' bytes at 'out'.
+ */
+void decodePrefixCompressedBlock(const char* data, size_t size, char* out, size_t outSize);
+
+/**
+ * Returns the pool used by file iterators to read the next block of a spilled range while the
+ * current one is being consumed.
+ */
+ThreadPool* getSorterReadAheadPool();
+
+}  // namespace sorter
+}  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/base/static_assert.h"
 #include "mongo/config.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/logv2/log.h"
 #include "mongo/platform/random.h"
 #include "mongo/stdx/thread.h"
@@ -867,6 +868,68 @@ TEST_F(SorterMakeFromExistingRangesTest, RoundTrip) {
     }
 }
 
+TEST(SorterFileFormatTest, PrefixCompressedBlockRoundTrip) {
+    const std::vector<std::pair<std::string, std::string>> entries = {
+        {"", "empty key"},
+        {"apple", ""},
+        {"applesauce", "v1"},
+        {"apples", "v2"},
+        {"banana", "v3"},
+        {"banana", std::string(300, 'x')},
+    };
+
+    BufBuilder plain;
+    BufBuilder encoded;
+    StringData previousKey;
+    for (auto&& [key, value] : entries) {
+        plain.appendBuf(key.data(), key.size());
+        plain.appendBuf(value.data(), value.size());
+        appendPrefixCompressedEntry(&encoded, previousKey, key, value);
+        previousKey = key;
+    }
+    ASSERT_LT(encoded.len(), plain.len());
+
+    std::vector<char> decoded(plain.len());
+    decodePrefixCompressedBlock(encoded.buf(), encoded.len(), decoded.data(), decoded.size());
+    ASSERT_EQ(StringData(plain.buf(), plain.len()), StringData(decoded.data(), decoded.size()));
+
+    // The expected size is checked, so a corrupted header cannot overrun the output buffer.
+    std::vector<char> tooSmall(plain.len() - 1);
+    ASSERT_THROWS_CODE(
+        decodePrefixCompressedBlock(encoded.buf(), encoded.len(), tooSmall.data(), tooSmall.size()),
+        DBException,
+        5716236);
+}
+
+TEST(SorterFileFormatTest, ExtendedFormatRoundTrip) {
+    unittest::TempDir tempDir("sorterFileFormatTests");
+    const SortOptions opts = SortOptions().TempDir(tempDir.path());
+
+    for (auto compressor : {"none", "snappy", "zstd"}) {
+        for (bool prefixCompression : {false, true}) {
+            for (bool readAhead : {false, true}) {
+                RAIIServerParameterControllerForTest compressorController("sorterSpillCompressor",
+                                                                          compressor);
+                RAIIServerParameterControllerForTest prefixController(
+                    "sorterSpillPrefixCompression", prefixCompression);
+                RAIIServerParameterControllerForTest readAheadController("sorterSpillReadAhead",
+                                                                         readAhead);
+                RAIIServerParameterControllerForTest blockSizeController(
+                    "sorterSpillBlockSizeBytes", 4096);
+
+                std::string fileName = opts.tempDir + "/" + nextFileName();
+                SortedFileWriter<IntWrapper, IntWrapper> sorter(opts, fileName, 0);
+                for (int i = 0; i < 100 * 1000; i++)
+                    sorter.addAlreadySorted(i, -i);
+
+                ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
+                                            std::make_shared<IntIterator>(0, 100 * 1000));
+                ASSERT_TRUE(boost::filesystem::remove(fileName));
+            }
+        }
+    }
+}
+
 }  // namespace
 }  // namespace sorter
 }  // namespace mongo
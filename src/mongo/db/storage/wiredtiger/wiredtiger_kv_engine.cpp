@@ -515,6 +515,10 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sessionSweeper = std::make_unique<WiredTigerSessionSweeper>(_sessionCache.get());
     _sessionSweeper->go();
 
+    if (!_ephemeral) {
+        _readAhead = std::make_unique<WiredTigerReadAhead>(_sessionCache.get());
+    }
+
     // Until the Replication layer installs a real callback, prevent truncating the oplog.
     setOldestActiveTransactionTimestampCallback(
         [](Timestamp) { return StatusWith(boost::make_optional(Timestamp::min())); });
@@ -722,6 +726,9 @@ void WiredTigerKVEngine::cleanShutdown() {
         _sessionSweeper->shutdown();
         LOGV2(22319, "Finished shutting down session sweeper thread");
     }
+    if (_readAhead) {
+        _readAhead->shutdown();
+    }
     LOGV2_FOR_RECOVERY(23988,
                        2,
                        "Shutdown timestamps.",
@@ -1707,27 +1714,19 @@ void WiredTigerKVEngine::dropIdentForImport(OperationContext* opCtx, StringData
     invariantWTOK(ret);
 }
 
-std::list<WiredTigerCachedCursor> WiredTigerKVEngine::filterCursorsWithQueuedDrops(
-    std::list<WiredTigerCachedCursor>* cache) {
-    std::list<WiredTigerCachedCursor> toDrop;
-
+std::vector<WiredTigerCachedCursor> WiredTigerKVEngine::filterCursorsWithQueuedDrops(
+    WiredTigerCursorCache* cache) {
     stdx::lock_guard<Latch> lk(_identToDropMutex);
     if (_identToDrop.empty())
-        return toDrop;
-
-    for (auto i = cache->begin(); i != cache->end();) {
-        if (!i->_cursor ||
-            std::find_if(_identToDrop.begin(), _identToDrop.end(), [i](const auto& identToDrop) {
-                return identToDrop.uri == std::string(i->_cursor->uri);
-            }) == _identToDrop.end()) {
-            ++i;
-            continue;
-        }
-        toDrop.push_back(*i);
-        i = cache->erase(i);
-    }
-
-    return toDrop;
+        return {};
+
+    return cache->extractIf([&](const WiredTigerCachedCursor& cachedCursor) {
+        return std::find_if(_identToDrop.begin(),
+                            _identToDrop.end(),
+                            [&](const auto& identToDrop) {
+                                return identToDrop.uri == std::string(cachedCursor._cursor->uri);
+                            }) != _identToDrop.end();
+    });
 }
 
 bool WiredTigerKVEngine::haveDropsQueued() const {
@@ -43,6 +43,7 @@
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/platform/mutex.h"
@@ -269,9 +270,17 @@ public:
     WT_CONNECTION* getConnection() {
         return _conn;
     }
+
+    /**
+     * Returns the read-ahead service for collection scans, or nullptr if this engine does not read
+     * ahead, e.g. because it is in-memory.
+     */
+    WiredTigerReadAhead* getReadAhead() const {
+        return _readAhead.get();
+    }
     void dropSomeQueuedIdents();
-    std::list<WiredTigerCachedCursor> filterCursorsWithQueuedDrops(
-        std::list<WiredTigerCachedCursor>* cache);
+    std::vector<WiredTigerCachedCursor> filterCursorsWithQueuedDrops(
+        WiredTigerCursorCache* cache);
     bool haveDropsQueued() const;
 
     void syncSizeInfo(bool sync) const;
@@ -460,6 +469,9 @@ private:
 
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
 
+    // Reads ahead of forward collection scans. Not used by in-memory engines.
+    std::unique_ptr<WiredTigerReadAhead> _readAhead;
+
     std::string _rsOptions;
     std::string _indexOptions;
 
@@ -0,0 +1,190 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+ThreadPool::Options makeReadAheadPoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "WTReadAheadThreadPool";
+    options.threadNamePrefix = "WTReadAhead-";
+    options.minThreads = 0;
+    options.maxThreads = static_cast<size_t>(gWiredTigerCursorReadAheadThreads);
+    return options;
+}
+
+}  // namespace
+
+WiredTigerReadAhead::WiredTigerReadAhead(WiredTigerSessionCache* sessionCache)
+    : _sessionCache(sessionCache), _pool(makeReadAheadPoolOptions()) {
+    _pool.startup();
+}
+
+WiredTigerReadAhead::~WiredTigerReadAhead() {
+    shutdown();
+}
+
+void WiredTigerReadAhead::shutdown() {
+    _pool.shutdown();
+    _pool.join();
+}
+
+bool WiredTigerReadAhead::isEnabled() {
+    return gWiredTigerCursorReadAheadEnabled.load();
+}
+
+void WiredTigerReadAhead::appendStats(BSONObjBuilder* builder) const {
+    builder->append("requests", _requests.load());
+    builder->append("records read", _recordsRead.load());
+    builder->append("bytes read", _bytesRead.load());
+}
+
+void WiredTigerReadAhead::_schedule(std::shared_ptr<Scan::Progress> progress,
+                                    const std::string& uri,
+                                    uint64_t tableId,
+                                    RecordId start,
+                                    int64_t bytes) {
+    progress->inProgress.store(true);
+    _requests.fetchAndAdd(1);
+    _pool.schedule([this, progress, uri, tableId, start, bytes](Status status) {
+        ON_BLOCK_EXIT([&] { progress->inProgress.store(false); });
+        if (!status.isOK() || progress->cancelled.load()) {
+            return;
+        }
+
+        try {
+            _readRecords(progress.get(), uri, tableId, start, bytes);
+        } catch (const DBException& ex) {
+            // Reading ahead is only an optimization, e.g. the table may be getting dropped.
+            LOGV2_DEBUG(5716200,
+                        2,
+                        "Stopped reading ahead of a collection scan",
+                        "uri"_attr = uri,
+                        "error"_attr = ex.toStatus());
+        }
+    });
+}
+
+void WiredTigerReadAhead::_readRecords(Scan::Progress* progress,
+                                       const std::string& uri,
+                                       uint64_t tableId,
+                                       RecordId start,
+                                       int64_t bytes) {
+    auto session = _sessionCache->getSession();
+    WT_CURSOR* c = session->getCachedCursor(tableId, "");
+    if (!c) {
+        c = session->getNewCursor(uri);
+    }
+    ON_BLOCK_EXIT([&] { session->releaseCursor(tableId, c, ""); });
+
+    // Each cursor operation runs in an implicit transaction of its own. Any error, e.g. a prepare
+    // conflict, simply ends reading ahead; the scan itself will deal with it.
+    c->set_key(c, start.getLong());
+    int cmp;
+    int ret = c->search_near(c, &cmp);
+    int64_t recordsRead = 0;
+    int64_t bytesRead = 0;
+    ON_BLOCK_EXIT([&] {
+        _recordsRead.fetchAndAdd(recordsRead);
+        _bytesRead.fetchAndAdd(bytesRead);
+    });
+    while (ret == 0 && bytesRead < bytes && !progress->cancelled.loadRelaxed()) {
+        WT_ITEM value;
+        int64_t key;
+        if (c->get_value(c, &value) != 0 || c->get_key(c, &key) != 0) {
+            break;
+        }
+        ++recordsRead;
+        bytesRead += value.size;
+        progress->lastRecord.store(key);
+        ret = c->next(c);
+    }
+
+    if (ret != 0 && ret != WT_NOTFOUND) {
+        LOGV2_DEBUG(5716201,
+                    2,
+                    "Stopped reading ahead of a collection scan",
+                    "uri"_attr = uri,
+                    "error"_attr = wtRCToStatus(ret));
+    }
+}
+
+WiredTigerReadAhead::Scan::Scan(WiredTigerReadAhead* readAhead, std::string uri, uint64_t tableId)
+    : _readAhead(readAhead), _uri(std::move(uri)), _tableId(tableId) {}
+
+WiredTigerReadAhead::Scan::~Scan() {
+    reset();
+}
+
+void WiredTigerReadAhead::Scan::onNext(const RecordId& id, int64_t size) {
+    _bytesSinceRequest += size;
+    if (_bytesSinceRequest < _windowBytes / 2) {
+        return;
+    }
+
+    RecordId start = id;
+    if (!_progress) {
+        _progress = std::make_shared<Progress>();
+    } else if (_progress->inProgress.load()) {
+        return;
+    } else if (auto lastRecord = _progress->lastRecord.load(); lastRecord > id.getLong()) {
+        // Continue from where the previous read-ahead stopped, as the scan has not reached it yet.
+        start = RecordId(lastRecord);
+    }
+
+    _readAhead->_schedule(_progress, _uri, _tableId, start, _windowBytes);
+
+    // The scan stayed sequential, so read further ahead next time.
+    const int64_t maxWindowBytes = gWiredTigerCursorReadAheadMaxBytes.load();
+    _bytesSinceRequest = 0;
+    _windowBytes = std::max(kInitialWindowBytes, std::min(_windowBytes * 2, maxWindowBytes));
+}
+
+void WiredTigerReadAhead::Scan::reset() {
+    if (_progress) {
+        _progress->cancelled.store(true);
+        _progress.reset();
+    }
+    _windowBytes = kInitialWindowBytes;
+    _bytesSinceRequest = 0;
+}
+
+}  // namespace mongo
@@ -0,0 +1,154 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+class WiredTigerSessionCache;
+
+/**
+ * Warms the WiredTiger cache ahead of forward collection scans. Records that a scan is about to
+ * reach are read on a background thread, through a session of its own, so that the pages holding
+ * them are already in cache when the scan gets there. The background reads run outside of the
+ * scan's transaction and their results are discarded.
+ *
+ * Only record stores with KeyFormat::Long keys are supported.
+ */
+class WiredTigerReadAhead {
+    WiredTigerReadAhead(const WiredTigerReadAhead&) = delete;
+    WiredTigerReadAhead& operator=(const WiredTigerReadAhead&) = delete;
+
+public:
+    // Number of bytes a scan must return before reading ahead starts, and the size of its first
+    // read-ahead window.
+    static constexpr int64_t kInitialWindowBytes = 1024 * 1024;
+
+    explicit WiredTigerReadAhead(WiredTigerSessionCache* sessionCache);
+
+    ~WiredTigerReadAhead();
+
+    /**
+     * Waits for in-progress read-ahead to finish. Read-ahead requested afterwards is ignored. Must
+     * be called before the session cache shuts down.
+     */
+    void shutdown();
+
+    /**
+     * Returns true if forward scans should read ahead.
+     */
+    static bool isEnabled();
+
+    /**
+     * Appends the number of read-ahead requests and the records and bytes they read to 'builder'.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+    /**
+     * The read-ahead state of a single forward scan, owned by its cursor. The read-ahead window
+     * doubles, up to wiredTigerCursorReadAheadMaxBytes, each time the scan continues sequentially
+     * past the point at which more records are requested.
+     */
+    class Scan {
+        Scan(const Scan&) = delete;
+        Scan& operator=(const Scan&) = delete;
+
+    public:
+        Scan(WiredTigerReadAhead* readAhead, std::string uri, uint64_t tableId);
+
+        ~Scan();
+
+        /**
+         * Called each time the scan returns the record 'id', of 'size' bytes. Requests more
+         * records to be read ahead of 'id' once the scan has used up half of the current window.
+         */
+        void onNext(const RecordId& id, int64_t size);
+
+        /**
+         * Called when the scan is repositioned. Abandons in-progress read-ahead and shrinks the
+         * window back to its initial size.
+         */
+        void reset();
+
+    private:
+        friend class WiredTigerReadAhead;
+
+        // Shared with the read-ahead task in progress, which may outlive the scan. Created once the
+        // scan first reads ahead.
+        struct Progress {
+            AtomicWord<bool> inProgress{false};
+            AtomicWord<bool> cancelled{false};
+            // The last record read ahead.
+            AtomicWord<long long> lastRecord{0};
+        };
+
+        WiredTigerReadAhead* const _readAhead;
+        const std::string _uri;
+        const uint64_t _tableId;
+
+        std::shared_ptr<Progress> _progress;
+        int64_t _windowBytes = kInitialWindowBytes;
+        int64_t _bytesSinceRequest = 0;
+    };
+
+private:
+    void _schedule(std::shared_ptr<Scan::Progress> progress,
+                   const std::string& uri,
+                   uint64_t tableId,
+                   RecordId start,
+                   int64_t bytes);
+
+    /**
+     * Reads the records of 'uri' starting at 'start' until at least 'bytes' bytes were read, the
+     * end of the table is reached, or the scan is cancelled.
+     */
+    void _readRecords(Scan::Progress* progress,
+                      const std::string& uri,
+                      uint64_t tableId,
+                      RecordId start,
+                      int64_t bytes);
+
+    WiredTigerSessionCache* const _sessionCache;
+    ThreadPool _pool;
+
+    // Cumulative number of read-ahead requests scheduled, and of records and bytes read by them.
+    AtomicWord<long long> _requests{0};
+    AtomicWord<long long> _recordsRead{0};
+    AtomicWord<long long> _bytesRead{0};
+};
+
+}  // namespace mongo
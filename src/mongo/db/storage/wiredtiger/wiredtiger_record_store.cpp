@@ -269,11 +269,19 @@ void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
 }
 
 bool WiredTigerRecordStore::OplogStones::hasExcessStones_inlock() const {
+    if (_stones.empty()) {
+        return false;
+    }
+
     int64_t totalBytes = 0;
     for (auto&& stone : _stones) {
         totalBytes += stone.bytes;
     }
+    return _isExcessStone_inlock(_stones.front(), totalBytes);
+}
 
+bool WiredTigerRecordStore::OplogStones::_isExcessStone_inlock(const Stone& stone,
+                                                               int64_t totalBytes) const {
     // check that oplog stones is at capacity
     if (totalBytes <= *_rs->_oplogMaxSize) {
         return false;
@@ -288,27 +296,39 @@ bool WiredTigerRecordStore::OplogStones::hasExcessStones_inlock() const {
     }
 
     auto nowWall = Date_t::now();
-    auto lastStoneWall = _stones.front().wallTime;
+    auto lastStoneWall = stone.wallTime;
 
     auto currRetentionMS = durationCount<Milliseconds>(nowWall - lastStoneWall);
     double currRetentionHours = currRetentionMS / kNumMSInHour;
     return currRetentionHours >= minRetentionHours;
 }
 
-boost::optional<WiredTigerRecordStore::OplogStones::Stone>
-WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
+std::vector<WiredTigerRecordStore::OplogStones::Stone>
+WiredTigerRecordStore::OplogStones::peekOldestStonesIfNeeded(size_t maxStones) const {
     stdx::lock_guard<Latch> lk(_mutex);
 
-    if (!hasExcessStones_inlock()) {
-        return {};
+    int64_t totalBytes = 0;
+    for (auto&& stone : _stones) {
+        totalBytes += stone.bytes;
     }
 
-    return _stones.front();
+    // Each stone is only reclaimable if the oplog is still over capacity once all the older stones
+    // are gone.
+    std::vector<Stone> stones;
+    for (auto&& stone : _stones) {
+        if (stones.size() >= maxStones || !_isExcessStone_inlock(stone, totalBytes)) {
+            break;
+        }
+        stones.push_back(stone);
+        totalBytes -= stone.bytes;
+    }
+    return stones;
 }
 
-void WiredTigerRecordStore::OplogStones::popOldestStone() {
+void WiredTigerRecordStore::OplogStones::popOldestStones(size_t numStones) {
     stdx::lock_guard<Latch> lk(_mutex);
-    _stones.pop_front();
+    invariant(numStones <= _stones.size());
+    _stones.erase(_stones.begin(), _stones.begin() + numStones);
 }
 
 void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(OperationContext* opCtx,
@@ -980,6 +1000,7 @@ void WiredTigerRecordStore::getOplogTruncateStats(BSONObjBuilder& builder) const
     }
     builder.append("totalTimeTruncatingMicros", _totalTimeTruncating.load());
     builder.append("truncateCount", _truncateCount.load());
+    builder.append("truncateRangeCount", _truncateRangeCount.load());
 }
 
 const char* WiredTigerRecordStore::name() const {
@@ -1142,23 +1163,45 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
     invariant(_keyFormat == KeyFormat::Long);
 
     Timer timer;
-    while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
-        invariant(stone->lastRecord.isValid());
+    while (true) {
+        // Consecutive stones are reclaimed together with a single range truncation.
+        auto stones = _oplogStones->peekOldestStonesIfNeeded(
+            static_cast<size_t>(gOplogTruncationPointsPerBatch.load()));
+        if (stones.empty()) {
+            break;
+        }
+
+        int64_t records = 0;
+        int64_t bytes = 0;
+        for (size_t i = 0; i < stones.size(); ++i) {
+            invariant(stones[i].lastRecord.isValid());
 
-        if (static_cast<std::uint64_t>(stone->lastRecord.getLong()) >= mayTruncateUpTo.asULL()) {
-            // Do not truncate oplogs needed for replication recovery.
+            if (static_cast<std::uint64_t>(stones[i].lastRecord.getLong()) >=
+                mayTruncateUpTo.asULL()) {
+                // Do not truncate oplogs needed for replication recovery.
+                stones.erase(stones.begin() + i, stones.end());
+                break;
+            }
+            records += stones[i].records;
+            bytes += stones[i].bytes;
+        }
+
+        if (stones.empty()) {
             return;
         }
+        const OplogStones::Stone* stone = &stones.back();
 
         LOGV2_DEBUG(
             22399,
             1,
             "Truncating the oplog between {oplogStones_firstRecord} and {stone_lastRecord} to "
-            "remove approximately {stone_records} records totaling to {stone_bytes} bytes",
+            "remove approximately {stone_records} records totaling to {stone_bytes} bytes in "
+            "{numStones} stones",
             "oplogStones_firstRecord"_attr = _oplogStones->firstRecord,
             "stone_lastRecord"_attr = stone->lastRecord,
-            "stone_records"_attr = stone->records,
-            "stone_bytes"_attr = stone->bytes);
+            "stone_records"_attr = records,
+            "stone_bytes"_attr = bytes,
+            "numStones"_attr = stones.size());
 
         WiredTigerRecoveryUnit* ru = WiredTigerRecoveryUnit::get(opCtx);
         WT_SESSION* session = ru->getSession()->getSession();
@@ -1185,38 +1228,55 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
             // It is necessary that there exists a record after the stone but before or including
             // the mayTruncateUpTo point.  Since the mayTruncateUpTo point may fall between
             // records, the stone check is not sufficient.
-            CursorKey truncateUpToKey = makeCursorKey(stone->lastRecord, _keyFormat);
-            setKey(cursor, &truncateUpToKey);
-            int cmp;
-            ret = wiredTigerPrepareConflictRetry(opCtx,
-                                                 [&] { return cursor->search_near(cursor, &cmp); });
-            invariantWTOK(ret);
+            auto hasRecordAfterStone = [&](const CursorKey& truncateUpToKey) {
+                setKey(cursor, &truncateUpToKey);
+                int cmp;
+                int ret = wiredTigerPrepareConflictRetry(
+                    opCtx, [&] { return cursor->search_near(cursor, &cmp); });
+                invariantWTOK(ret);
 
-            // Check 'cmp' to determine if we landed on the requested record. While it is often the
-            // case that stones represent a perfect partitioning of the oplog, it's not guaranteed.
-            // The truncation method is lenient to overlapping stones. See SERVER-56590 for details.
-            // If we landed land on a higher record (cmp > 0), we likely truncated a duplicate stone
-            // in a previous iteration. In this case we can skip the check for oplog entries after
-            // the stone we are truncating. If we landed on a prior record, then we have records
-            // that are not in truncation range of any stone. This will have been logged as a
-            // warning, above.
-            if (cmp <= 0) {
-                ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return cursor->next(cursor); });
-                if (ret == WT_NOTFOUND) {
-                    LOGV2_DEBUG(5140900, 0, "Will not truncate entire oplog");
+                // Check 'cmp' to determine if we landed on the requested record. While it is often
+                // the case that stones represent a perfect partitioning of the oplog, it's not
+                // guaranteed. The truncation method is lenient to overlapping stones. See
+                // SERVER-56590 for details. If we landed land on a higher record (cmp > 0), we
+                // likely truncated a duplicate stone in a previous iteration. In this case we can
+                // skip the check for oplog entries after the stone we are truncating. If we landed
+                // on a prior record, then we have records that are not in truncation range of any
+                // stone. This will have been logged as a warning, above.
+                if (cmp <= 0) {
+                    ret = wiredTigerPrepareConflictRetry(opCtx,
+                                                         [&] { return cursor->next(cursor); });
+                    if (ret == WT_NOTFOUND) {
+                        LOGV2_DEBUG(5140900, 0, "Will not truncate entire oplog");
+                        return false;
+                    }
+                    invariantWTOK(ret);
+                }
+                RecordId nextRecord = getKey(cursor);
+                if (static_cast<std::uint64_t>(nextRecord.getLong()) > mayTruncateUpTo.asULL()) {
+                    LOGV2_DEBUG(5140901,
+                                0,
+                                "Cannot truncate as there are no oplog entries after the stone but "
+                                "before the truncate-up-to point",
+                                "nextRecord"_attr = Timestamp(nextRecord.getLong()),
+                                "mayTruncateUpTo"_attr = mayTruncateUpTo);
+                    return false;
+                }
+                return true;
+            };
+
+            // When the last stone of the batch cannot be truncated, the earlier stones still can,
+            // as they would have been had each stone been truncated separately.
+            CursorKey truncateUpToKey = makeCursorKey(stone->lastRecord, _keyFormat);
+            while (!hasRecordAfterStone(truncateUpToKey)) {
+                if (stones.size() == 1) {
                     return;
                 }
-                invariantWTOK(ret);
-            }
-            RecordId nextRecord = getKey(cursor);
-            if (static_cast<std::uint64_t>(nextRecord.getLong()) > mayTruncateUpTo.asULL()) {
-                LOGV2_DEBUG(5140901,
-                            0,
-                            "Cannot truncate as there are no oplog entries after the stone but "
-                            "before the truncate-up-to point",
-                            "nextRecord"_attr = Timestamp(nextRecord.getLong()),
-                            "mayTruncateUpTo"_attr = mayTruncateUpTo);
-                return;
+                records -= stones.back().records;
+                bytes -= stones.back().bytes;
+                stones.pop_back();
+                stone = &stones.back();
+                truncateUpToKey = makeCursorKey(stone->lastRecord, _keyFormat);
             }
 
             // After checking whether or not we should truncate, reposition the cursor back to the
@@ -1224,13 +1284,14 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
             invariantWTOK(cursor->reset(cursor));
             setKey(cursor, &truncateUpToKey);
             invariantWTOK(session->truncate(session, nullptr, nullptr, cursor, nullptr));
-            _changeNumRecords(opCtx, -stone->records);
-            _increaseDataSize(opCtx, -stone->bytes);
+            _changeNumRecords(opCtx, -records);
+            _increaseDataSize(opCtx, -bytes);
 
             wuow.commit();
+            _truncateRangeCount.fetchAndAdd(1);
 
-            // Remove the stone after a successful truncation.
-            _oplogStones->popOldestStone();
+            // Remove the stones after a successful truncation.
+            _oplogStones->popOldestStones(stones.size());
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
             _oplogStones->firstRecord = stone->lastRecord;
@@ -2003,6 +2064,13 @@ WiredTigerRecordStoreCursorBase::WiredTigerRecordStoreCursorBase(OperationContex
         _oplogVisibleTs = WiredTigerRecoveryUnit::get(opCtx)->getOplogVisibilityTs();
     }
     _cursor.emplace(rs.getURI(), rs.tableId(), true, opCtx);
+
+    // The oplog is mostly read at its end by tailing cursors, which would not benefit.
+    if (_forward && !_rs._isOplog && _rs.keyFormat() == KeyFormat::Long && _rs._kvEngine &&
+        _rs._kvEngine->getReadAhead() && WiredTigerReadAhead::isEnabled()) {
+        _readAhead = std::make_unique<WiredTigerReadAhead::Scan>(
+            _rs._kvEngine->getReadAhead(), _rs.getURI(), _rs.tableId());
+    }
 }
 
 boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
@@ -2064,6 +2132,10 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     auto& metricsCollector = ResourceConsumption::MetricsCollector::get(_opCtx);
     metricsCollector.incrementOneDocRead(value.size);
 
+    if (_readAhead) {
+        _readAhead->onNext(id, value.size);
+    }
+
     _lastReturnedId = id;
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
@@ -2080,6 +2152,10 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
     // options we pass when we explicitly start transactions in the RecoveryUnit.
     WiredTigerRecoveryUnit::get(_opCtx)->getSession();
 
+    if (_readAhead) {
+        _readAhead->reset();
+    }
+
     _skipNextAdvance = false;
     WT_CURSOR* c = _cursor->get();
     auto key = makeCursorKey(id, _rs.keyFormat());
@@ -2118,6 +2194,10 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekNear(const RecordId
     WiredTigerRecoveryUnit::get(_opCtx)->getSession();
     WT_CURSOR* c = _cursor->get();
 
+    if (_readAhead) {
+        _readAhead->reset();
+    }
+
     auto key = makeCursorKey(start, _rs.keyFormat());
     setKey(c, &key);
 
@@ -38,6 +38,7 @@
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -365,6 +366,8 @@ private:
     AtomicWord<int64_t>
         _totalTimeTruncating;            // Cumulative amount of time spent truncating the oplog.
     AtomicWord<int64_t> _truncateCount;  // Cumulative number of truncates of the oplog.
+    AtomicWord<int64_t>
+        _truncateRangeCount;  // Cumulative number of WiredTiger range truncations of the oplog.
 };
 
 
@@ -427,6 +430,9 @@ protected:
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
     bool _hasRestored = true;
 
+    // Set for forward scans that read ahead of their position.
+    std::unique_ptr<WiredTigerReadAhead::Scan> _readAhead;
+
 private:
     bool isVisible(const RecordId& id);
 
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <vector>
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/platform/atomic_word.h"
@@ -73,9 +74,13 @@ public:
         }
     }
 
-    boost::optional<OplogStones::Stone> peekOldestStoneIfNeeded() const;
+    /**
+     * Returns up to 'maxStones' of the oldest stones, in order, that can be reclaimed together
+     * while keeping the oplog at capacity and honoring the minimum retention period.
+     */
+    std::vector<OplogStones::Stone> peekOldestStonesIfNeeded(size_t maxStones) const;
 
-    void popOldestStone();
+    void popOldestStones(size_t numStones);
 
     void createNewStoneIfNeeded(OperationContext* opCtx, RecordId lastRecord, Date_t wallTime);
 
@@ -133,6 +138,10 @@ private:
 
     void _pokeReclaimThreadIfNeeded();
 
+    // Returns true if 'stone' may be reclaimed when the stones not yet reclaimed total
+    // 'totalBytes'.
+    bool _isExcessStone_inlock(const Stone& stone, int64_t totalBytes) const;
+
     static const uint64_t kRandomSamplesPerStone = 10;
 
     WiredTigerRecordStore* _rs;
@@ -47,10 +47,12 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -151,6 +153,82 @@ TEST(WiredTigerRecordStoreTest, Isolation1) {
     }
 }
 
+TEST(WiredTigerRecordStoreTest, ForwardScanWithReadAhead) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    auto readAhead = checked_cast<WiredTigerKVEngine*>(harnessHelper->getEngine())->getReadAhead();
+    ASSERT(readAhead);
+    auto getStat = [&](StringData name) {
+        BSONObjBuilder builder;
+        readAhead->appendStats(&builder);
+        return builder.obj()[name].numberLong();
+    };
+
+    // Insert enough data for the scan to read ahead several times.
+    const int kNumRecords = 1000;
+    const std::string data(8 * 1024, 'x');
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < kNumRecords; ++i) {
+            auto res = rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp());
+            ASSERT_OK(res.getStatus());
+        }
+        uow.commit();
+    }
+
+    // Scans do not read ahead unless it is enabled.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        auto cursor = rs->getCursor(opCtx.get());
+        while (cursor->next()) {
+        }
+        ASSERT_EQ(0, getStat("requests"));
+    }
+
+    RAIIServerParameterControllerForTest enableReadAhead("wiredTigerCursorReadAheadEnabled", true);
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto cursor = rs->getCursor(opCtx.get());
+    RecordId lastId;
+    int numRecords = 0;
+    while (auto record = cursor->next()) {
+        ASSERT_GT(record->id, lastId);
+        ASSERT_EQ(record->data.size(), static_cast<int>(data.size() + 1));
+        lastId = record->id;
+        ++numRecords;
+
+        // Yielding in the middle of the scan must not affect the records returned.
+        if (numRecords == kNumRecords / 2) {
+            cursor->save();
+            ASSERT(cursor->restore());
+        }
+    }
+    ASSERT_EQ(numRecords, kNumRecords);
+
+    // The scan asked for records to be read ahead of it once it had returned half of the initial
+    // window. The read-ahead runs in the background, so wait for it to read them.
+    const auto requests = getStat("requests");
+    ASSERT_GT(requests, 0);
+    const auto deadline = Date_t::now() + Seconds(30);
+    while (getStat("records read") == 0 && Date_t::now() < deadline) {
+        sleepmillis(10);
+    }
+    ASSERT_GT(getStat("records read"), 0);
+    ASSERT_GTE(getStat("bytes read"), static_cast<long long>(data.size() + 1));
+
+    // Repositioning the scan starts reading ahead from its new position.
+    auto record = cursor->seekExact(RecordId(1));
+    ASSERT(record);
+    numRecords = 1;
+    while (cursor->next()) {
+        ++numRecords;
+    }
+    ASSERT_EQ(numRecords, kNumRecords);
+    ASSERT_GT(getStat("requests"), requests);
+}
+
 TEST(WiredTigerRecordStoreTest, Isolation2) {
     const auto harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
@@ -808,6 +886,138 @@ TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStones) {
     }
 }
 
+// Verify that consecutive stones are reclaimed together, up to the configured batch size, without
+// going past the truncate-up-to point.
+TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStonesInBatches) {
+    RAIIServerParameterControllerForTest batchSize("oplogTruncationPointsPerBatch", 2);
+
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+    std::unique_ptr<RecordStore> rs(harnessHelper->newOplogRecordStore());
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    ASSERT_OK(wtrs->updateOplogSize(230));
+
+    oplogStones->setMinBytesPerStone(100);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        for (int i = 1; i <= 5; ++i) {
+            ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, i), 100),
+                      RecordId(1, i));
+        }
+
+        ASSERT_EQ(5, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(500, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(5U, oplogStones->numStones());
+    }
+
+    // Only the stones strictly before the truncate-up-to point are reclaimed, even when the batch
+    // would cover more of them.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 2));
+
+        ASSERT_EQ(4, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(400, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(4U, oplogStones->numStones());
+    }
+
+    // Two stones are reclaimed by one truncation, then the oplog is back within its maximum size.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 5));
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(200, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+    }
+}
+
+// Verify that reclaiming several stones at once takes fewer range truncations than reclaiming them
+// one at a time, and that both leave the oplog in the same state.
+TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStonesInBatchesUsesFewerTruncations) {
+    auto reclaimExcessStones = [](int stonesPerBatch) {
+        RAIIServerParameterControllerForTest batchSize("oplogTruncationPointsPerBatch",
+                                                       stonesPerBatch);
+
+        std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+        std::unique_ptr<RecordStore> rs(harnessHelper->newOplogRecordStore());
+
+        WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+        WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+        ASSERT_OK(wtrs->updateOplogSize(230));
+
+        oplogStones->setMinBytesPerStone(100);
+
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        for (int i = 1; i <= 6; ++i) {
+            ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, i), 100),
+                      RecordId(1, i));
+        }
+        ASSERT_EQ(6U, oplogStones->numStones());
+
+        wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 6));
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(200, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+
+        BSONObjBuilder builder;
+        wtrs->getOplogTruncateStats(builder);
+        return builder.obj()["truncateRangeCount"].numberLong();
+    };
+
+    ASSERT_EQ(4, reclaimExcessStones(1));
+    ASSERT_EQ(2, reclaimExcessStones(2));
+    ASSERT_EQ(1, reclaimExcessStones(10));
+}
+
+// Verify that when the last stone of a batch cannot be truncated because no record follows it up to
+// the truncate-up-to point, the earlier stones of the batch are still reclaimed.
+TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStonesInBatchesFallsBackToEarlierStones) {
+    RAIIServerParameterControllerForTest batchSize("oplogTruncationPointsPerBatch", 2);
+
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+    std::unique_ptr<RecordStore> rs(harnessHelper->newOplogRecordStore());
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    ASSERT_OK(wtrs->updateOplogSize(150));
+
+    oplogStones->setMinBytesPerStone(100);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 100), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 4), 100), RecordId(1, 4));
+
+        ASSERT_EQ(3, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(300, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(3U, oplogStones->numStones());
+    }
+
+    // Both of the first two stones end before the truncate-up-to point, but the record after the
+    // second one is past it. Only the first stone is reclaimed.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 3));
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(200, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+    }
+}
+
 // Verify that an oplog stone isn't created if it would cause the logical representation of the
 // records to not be in increasing order.
 TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
@@ -96,6 +96,11 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
                           Timestamp(_engine->getOplogManager()->getOplogReadTimestamp()));
     }
 
+    if (auto readAhead = _engine->getReadAhead()) {
+        BSONObjBuilder subsection(bob.subobjStart("read-ahead"));
+        readAhead->appendStats(&subsection);
+    }
+
     return bob.obj();
 }
 
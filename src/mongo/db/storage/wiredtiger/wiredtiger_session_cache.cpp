@@ -111,20 +111,129 @@ void _openCursor(WT_SESSION* session,
 }
 }  // namespace
 
-WT_CURSOR* WiredTigerSession::getCachedCursor(uint64_t id, const std::string& config) {
-    // Find the most recently used cursor
-    for (CursorCache::iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
+WT_CURSOR* WiredTigerCursorCache::take(uint64_t id, const std::string& config) {
+    if (_size == 0) {
+        return nullptr;
+    }
+
+    // All cursors for 'id' live in the probe sequence between its home slot and the next empty
+    // slot. Find the most recently used one.
+    const size_t mask = _slots.size() - 1;
+    boost::optional<size_t> found;
+    for (size_t pos = _home(id); _slots[pos]._cursor; pos = (pos + 1) & mask) {
+        const auto& slot = _slots[pos];
         // Ensure that all properties of this cursor are identical to avoid mixing cursor
         // configurations. Note that this uses an exact string match, so cursor configurations with
         // parameters in different orders will not be considered equivalent.
-        if (i->_id == id && i->_config == config) {
-            WT_CURSOR* c = i->_cursor;
-            _cursors.erase(i);
-            _cursorsOut++;
-            return c;
+        if (slot._id == id && slot._config == config &&
+            (!found || slot._gen > _slots[*found]._gen)) {
+            found = pos;
+        }
+    }
+
+    if (!found) {
+        return nullptr;
+    }
+
+    WT_CURSOR* cursor = _slots[*found]._cursor;
+    _eraseAt(*found);
+    return cursor;
+}
+
+void WiredTigerCursorCache::put(WiredTigerCachedCursor cachedCursor) {
+    invariant(cachedCursor._cursor);
+    invariant(_generations.empty() || _generations.back().first < cachedCursor._gen);
+
+    // Keep the load factor at or below one half so that probe sequences stay short.
+    if ((_size + 1) * 2 > _slots.size()) {
+        std::vector<WiredTigerCachedCursor> cachedCursors;
+        cachedCursors.reserve(_size);
+        for (auto& slot : _slots) {
+            if (slot._cursor) {
+                cachedCursors.push_back(std::move(slot));
+            }
+        }
+        _rebuild(std::max(kMinCapacity, _slots.size() * 2), std::move(cachedCursors));
+    }
+
+    _generations.emplace_back(cachedCursor._gen, cachedCursor._id);
+    _insert(std::move(cachedCursor));
+}
+
+std::vector<WiredTigerCachedCursor> WiredTigerCursorCache::evictOlderThan(uint64_t minGen) {
+    std::vector<WiredTigerCachedCursor> evicted;
+    if (_size == 0) {
+        _generations.clear();
+        return evicted;
+    }
+
+    const size_t mask = _slots.size() - 1;
+    while (!_generations.empty() && _generations.front().first < minGen) {
+        auto [gen, id] = _generations.front();
+        _generations.pop_front();
+
+        // The cursor may already have been taken out of the cache, in which case there is nothing
+        // left to evict for this generation.
+        for (size_t pos = _home(id); _slots[pos]._cursor; pos = (pos + 1) & mask) {
+            if (_slots[pos]._gen == gen) {
+                invariant(_slots[pos]._id == id);
+                evicted.push_back(std::move(_slots[pos]));
+                _eraseAt(pos);
+                break;
+            }
+        }
+    }
+    return evicted;
+}
+
+void WiredTigerCursorCache::_insert(WiredTigerCachedCursor cachedCursor) {
+    const size_t mask = _slots.size() - 1;
+    size_t pos = _home(cachedCursor._id);
+    while (_slots[pos]._cursor) {
+        pos = (pos + 1) & mask;
+    }
+    _slots[pos] = std::move(cachedCursor);
+    ++_size;
+}
+
+void WiredTigerCursorCache::_eraseAt(size_t pos) {
+    // Backward-shift deletion: pull later members of the probe sequence into the hole so that
+    // lookups never have to skip over tombstones.
+    const size_t mask = _slots.size() - 1;
+    size_t hole = pos;
+    for (size_t next = (hole + 1) & mask; _slots[next]._cursor; next = (next + 1) & mask) {
+        const size_t home = _home(_slots[next]._id);
+        // The entry at 'next' may move into the hole only if its home slot does not lie
+        // cyclically within (hole, next].
+        const bool homeInRange =
+            hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!homeInRange) {
+            _slots[hole] = std::move(_slots[next]);
+            hole = next;
         }
     }
-    return nullptr;
+    _slots[hole] = WiredTigerCachedCursor(0, 0, nullptr, "");
+    --_size;
+}
+
+void WiredTigerCursorCache::_rebuild(size_t capacity,
+                                     std::vector<WiredTigerCachedCursor> cachedCursors) {
+    _slots.assign(capacity, WiredTigerCachedCursor(0, 0, nullptr, ""));
+    _size = 0;
+    for (auto& cachedCursor : cachedCursors) {
+        _insert(std::move(cachedCursor));
+    }
+    if (_size == 0) {
+        _generations.clear();
+    }
+}
+
+WT_CURSOR* WiredTigerSession::getCachedCursor(uint64_t id, const std::string& config) {
+    WT_CURSOR* c = _cursors.take(id, config);
+    if (c) {
+        _cursorsOut++;
+    }
+    return c;
 }
 
 WT_CURSOR* WiredTigerSession::getNewCursor(const std::string& uri, const char* config) {
@@ -141,16 +250,15 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor, const std:
 
     invariantWTOK(cursor->reset(cursor));
 
-    // Cursors are pushed to the front of the list and removed from the back
-    _cursors.push_front(WiredTigerCachedCursor(id, _cursorGen++, cursor, config));
+    _cursors.put(WiredTigerCachedCursor(id, _cursorGen++, cursor, config));
 
     // A negative value for wiredTigercursorCacheSize means to use hybrid caching.
     std::uint32_t cacheSize = abs(gWiredTigerCursorCacheSize.load());
 
-    while (!_cursors.empty() && _cursorGen - _cursors.back()._gen > cacheSize) {
-        cursor = _cursors.back()._cursor;
-        _cursors.pop_back();
-        invariantWTOK(cursor->close(cursor));
+    if (_cursorGen > cacheSize) {
+        for (auto& evicted : _cursors.evictOlderThan(_cursorGen - cacheSize)) {
+            invariantWTOK(evicted._cursor->close(evicted._cursor));
+        }
     }
 }
 
@@ -166,13 +274,11 @@ void WiredTigerSession::closeAllCursors(const std::string& uri) {
     invariant(_session);
 
     bool all = (uri == "");
-    for (auto i = _cursors.begin(); i != _cursors.end();) {
-        WT_CURSOR* cursor = i->_cursor;
-        if (cursor && (all || uri == cursor->uri)) {
-            invariantWTOK(cursor->close(cursor));
-            i = _cursors.erase(i);
-        } else
-            ++i;
+    auto toClose = _cursors.extractIf([&](const WiredTigerCachedCursor& cachedCursor) {
+        return all || uri == cachedCursor._cursor->uri;
+    });
+    for (auto& cachedCursor : toClose) {
+        invariantWTOK(cachedCursor._cursor->close(cachedCursor._cursor));
     }
 }
 
@@ -192,7 +298,18 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
 
 namespace {
 AtomicWord<unsigned long long> nextTableId(WiredTigerSession::kLastTableId);
+
+AtomicWord<unsigned> nextFastPathSlot{0};
+
+/**
+ * Returns the index of the session cache fast path slot assigned to the calling thread. Threads
+ * are assigned slots round-robin the first time they use a session cache.
+ */
+size_t fastPathSlotIndex(size_t numSlots) {
+    thread_local const unsigned threadSlot = nextFastPathSlot.fetchAndAdd(1);
+    return threadSlot % numSlots;
 }
+}  // namespace
 // static
 uint64_t WiredTigerSession::genTableId() {
     return nextTableId.fetchAndAdd(1);
@@ -378,6 +495,7 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
     stdx::lock_guard<Latch> lock(_cacheLock);
+    _drainFastPathSlots(lock);
     for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
         (*i)->closeAllCursors(uri);
     }
@@ -388,6 +506,7 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     _cursorEpoch.fetchAndAdd(1);
 
     stdx::lock_guard<Latch> lock(_cacheLock);
+    _drainFastPathSlots(lock);
     for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
         (*i)->closeCursorsForQueuedDrops(_engine);
     }
@@ -395,6 +514,7 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
 
 size_t WiredTigerSessionCache::getIdleSessionsCount() {
     stdx::lock_guard<Latch> lock(_cacheLock);
+    _drainFastPathSlots(lock);
     return _sessions.size();
 }
 
@@ -409,6 +529,7 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
 
     {
         stdx::lock_guard<Latch> lock(_cacheLock);
+        _drainFastPathSlots(lock);
         // Discard all sessions that became idle before the cutoff time
         for (auto it = _sessions.begin(); it != _sessions.end();) {
             auto session = *it;
@@ -437,6 +558,8 @@ void WiredTigerSessionCache::closeAll() {
         stdx::lock_guard<Latch> lock(_cacheLock);
         _epoch.fetchAndAdd(1);
         _sessions.swap(swap);
+        // Every session parked in a slot now belongs to an older epoch, so this only closes them.
+        _drainFastPathSlots(lock);
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -453,6 +576,20 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
+    // First try to reuse the session this thread released last, without taking _cacheLock.
+    auto& slot = _fastPathSlots[fastPathSlotIndex(kNumFastPathSlots)];
+    if (slot.loadRelaxed()) {
+        if (WiredTigerSession* cachedSession = slot.swap(nullptr)) {
+            if (cachedSession->_getEpoch() == _epoch.load()) {
+                // Reset the idle time
+                cachedSession->setIdleExpireTime(Date_t::min());
+                return UniqueWiredTigerSession(cachedSession);
+            }
+            // The session was parked concurrently with closeAll().
+            delete cachedSession;
+        }
+    }
+
     {
         stdx::lock_guard<Latch> lock(_cacheLock);
         if (!_sessions.empty()) {
@@ -521,10 +658,25 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->setIdleExpireTime(_clockSource->now());
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<Latch> lock(_cacheLock);
-        if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
+        // Park the session in this thread's slot if it is free, so that it can be handed back
+        // without taking _cacheLock.
+        auto& slot = _fastPathSlots[fastPathSlotIndex(kNumFastPathSlots)];
+        WiredTigerSession* expected = nullptr;
+        if (!slot.loadRelaxed() && slot.compareAndSwap(&expected, session)) {
+            // Another thread may reclaim the session as soon as it is parked, so it must not be
+            // accessed past this point. If closeAll() bumped the epoch concurrently it may have
+            // drained the slots before we filled ours, so drain them again to close it.
+            if (_epoch.load() != currentEpoch) {
+                stdx::lock_guard<Latch> lock(_cacheLock);
+                _drainFastPathSlots(lock);
+            }
             returnedToCache = true;
-            _sessions.push_back(session);
+        } else {
+            stdx::lock_guard<Latch> lock(_cacheLock);
+            if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
+                returnedToCache = true;
+                _sessions.push_back(session);
+            }
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -537,6 +689,19 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
 }
 
 
+void WiredTigerSessionCache::_drainFastPathSlots(WithLock) {
+    const uint64_t currentEpoch = _epoch.load();
+    for (auto& slot : _fastPathSlots) {
+        if (WiredTigerSession* session = slot.swap(nullptr)) {
+            if (session->_getEpoch() == currentEpoch) {
+                _sessions.push_back(session);
+            } else {
+                delete session;
+            }
+        }
+    }
+}
+
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<Latch> lk(_journalListenerMutex);
 
@@ -29,8 +29,10 @@
 
 #pragma once
 
-#include <list>
+#include <array>
+#include <deque>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
@@ -39,6 +41,8 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -56,6 +60,86 @@ public:
     std::string _config;  // Cursor config. Do not serve cursors with different configurations
 };
 
+/**
+ * An open-addressing hash table of cached cursors keyed by table id, using linear probing and
+ * backward-shift deletion. Several cursors for the same table id (and possibly differing
+ * configurations) may be cached at once; lookups return the most recently released match.
+ *
+ * Cursors are aged out in generation order. The generations of inserted cursors are remembered in
+ * a FIFO so that the oldest cached cursors can be found without scanning the table; entries for
+ * cursors that have since been taken out of the cache are discarded lazily.
+ * NOT THREADSAFE
+ */
+class WiredTigerCursorCache {
+public:
+    WiredTigerCursorCache() = default;
+
+    WiredTigerCursorCache(const WiredTigerCursorCache&) = delete;
+    WiredTigerCursorCache& operator=(const WiredTigerCursorCache&) = delete;
+
+    /**
+     * Removes and returns the most recently released cursor with table id 'id' and configuration
+     * 'config', or nullptr if there is no such cursor in the cache.
+     */
+    WT_CURSOR* take(uint64_t id, const std::string& config);
+
+    /**
+     * Adds a cursor to the cache. Its generation must be greater than that of any cursor added
+     * before.
+     */
+    void put(WiredTigerCachedCursor cachedCursor);
+
+    /**
+     * Removes and returns all cached cursors with a generation less than 'minGen'.
+     */
+    std::vector<WiredTigerCachedCursor> evictOlderThan(uint64_t minGen);
+
+    /**
+     * Removes and returns all cached cursors for which 'pred' returns true.
+     */
+    template <typename Pred>
+    std::vector<WiredTigerCachedCursor> extractIf(Pred pred) {
+        std::vector<WiredTigerCachedCursor> extracted;
+        std::vector<WiredTigerCachedCursor> kept;
+        for (auto& slot : _slots) {
+            if (slot._cursor) {
+                (pred(slot) ? extracted : kept).push_back(slot);
+            }
+        }
+        if (!extracted.empty()) {
+            _rebuild(_slots.size(), std::move(kept));
+        }
+        return extracted;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+private:
+    static constexpr size_t kMinCapacity = 16;
+
+    size_t _home(uint64_t id) const {
+        // Fibonacci hashing spreads consecutive table ids across the table.
+        return static_cast<size_t>((id * 0x9E3779B97F4A7C15ULL) >> 32) & (_slots.size() - 1);
+    }
+
+    void _insert(WiredTigerCachedCursor cachedCursor);
+    void _eraseAt(size_t pos);
+    void _rebuild(size_t capacity, std::vector<WiredTigerCachedCursor> cachedCursors);
+
+    // Empty slots have a null '_cursor'. The capacity is always zero or a power of two.
+    std::vector<WiredTigerCachedCursor> _slots;
+    size_t _size = 0;
+
+    // (generation, table id) of cursors in the order they were put into the cache.
+    std::deque<std::pair<uint64_t, uint64_t>> _generations;
+};
+
 /**
  * This is a structure that caches 1 cursor for each uri.
  * The idea is that there is a pool of these somewhere.
@@ -182,8 +266,8 @@ private:
     friend class WiredTigerSessionCache;
     friend class WiredTigerKVEngine;
 
-    // The cursor cache is a list of pairs that contain an ID and cursor
-    typedef std::list<WiredTigerCachedCursor> CursorCache;
+    // The cursor cache is a hash table of cursors keyed by table ID
+    typedef WiredTigerCursorCache CursorCache;
 
     // Used internally by WiredTigerSessionCache
     uint64_t _getEpoch() const {
@@ -383,6 +467,14 @@ private:
     typedef std::vector<WiredTigerSession*> SessionCache;
     SessionCache _sessions;
 
+    // Each thread is assigned one of these slots. A released session is parked in the releasing
+    // thread's slot when it is empty, so that the next getSession() call on that thread can hand it
+    // back with a single atomic exchange and without taking _cacheLock. Sessions that do not fit
+    // fall back to _sessions. Slots may briefly hold sessions from an older epoch, which are closed
+    // instead of being reused.
+    static constexpr size_t kNumFastPathSlots = 64;
+    std::array<CacheAligned<AtomicWord<WiredTigerSession*>>, kNumFastPathSlots> _fastPathSlots;
+
     // Bumped when all open sessions need to be closed
     AtomicWord<unsigned long long> _epoch;  // atomic so we can check it outside of the lock
 
@@ -418,6 +510,12 @@ private:
      * session and releasing it, the session is directly released. This method is thread safe.
      */
     void releaseSession(WiredTigerSession* session);
+
+    /**
+     * Moves the sessions parked in the per-thread slots into _sessions, closing those from an
+     * older epoch. Callers must hold _cacheLock.
+     */
+    void _drainFastPathSlots(WithLock);
 };
 
 /**
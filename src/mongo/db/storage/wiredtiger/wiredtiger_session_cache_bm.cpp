@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxPerfThreads = 16;
+
+class WiredTigerConnection {
+public:
+    WiredTigerConnection(StringData dbpath, StringData extraStrings) : _conn(nullptr) {
+        std::stringstream ss;
+        ss << "create,";
+        ss << extraStrings;
+        std::string config = ss.str();
+        int ret = wiredtiger_open(dbpath.toString().c_str(), nullptr, config.c_str(), &_conn);
+        invariant(wtRCToStatus(ret).isOK());
+    }
+    ~WiredTigerConnection() {
+        _conn->close(_conn, nullptr);
+    }
+    WT_CONNECTION* getConnection() const {
+        return _conn;
+    }
+
+private:
+    WT_CONNECTION* _conn;
+};
+
+/**
+ * A session cache over a connection with a few tables, shared by all benchmark threads.
+ */
+class WiredTigerSessionCacheTestHelper {
+public:
+    static constexpr int kNumTables = 32;
+
+    WiredTigerSessionCacheTestHelper()
+        : _dbpath("wt_test"),
+          _connection(_dbpath.path(), ""),
+          _sessionCache(_connection.getConnection(), &_clockSource) {
+        auto session = _sessionCache.getSession();
+        WT_SESSION* wtSession = session->getSession();
+        for (int i = 0; i < kNumTables; ++i) {
+            _uris.push_back(str::stream() << "table:mytable" << i);
+            _tableIds.push_back(WiredTigerSession::genTableId());
+            invariant(
+                wtRCToStatus(wtSession->create(wtSession, _uris.back().c_str(), nullptr)).isOK());
+        }
+    }
+
+    static WiredTigerSessionCacheTestHelper& get() {
+        static WiredTigerSessionCacheTestHelper helper;
+        return helper;
+    }
+
+    WiredTigerSessionCache* getSessionCache() {
+        return &_sessionCache;
+    }
+
+    const std::string& uri(int i) const {
+        return _uris[i];
+    }
+
+    uint64_t tableId(int i) const {
+        return _tableIds[i];
+    }
+
+private:
+    unittest::TempDir _dbpath;
+    WiredTigerConnection _connection;
+    ClockSourceMock _clockSource;
+    WiredTigerSessionCache _sessionCache;
+    std::vector<std::string> _uris;
+    std::vector<uint64_t> _tableIds;
+};
+
+void BM_GetAndReleaseSession(benchmark::State& state) {
+    auto sessionCache = WiredTigerSessionCacheTestHelper::get().getSessionCache();
+    for (auto _ : state) {
+        auto session = sessionCache->getSession();
+        benchmark::DoNotOptimize(session.get());
+    }
+}
+
+void BM_GetAndReleaseCachedCursor(benchmark::State& state) {
+    auto& helper = WiredTigerSessionCacheTestHelper::get();
+    auto session = helper.getSessionCache()->getSession();
+    const int numTables = state.range(0);
+
+    // Populate the cursor cache with one cursor per table.
+    for (int i = 0; i < numTables; ++i) {
+        session->releaseCursor(helper.tableId(i), session->getNewCursor(helper.uri(i)), "");
+    }
+
+    int i = 0;
+    for (auto _ : state) {
+        const uint64_t tableId = helper.tableId(i);
+        WT_CURSOR* cursor = session->getCachedCursor(tableId, "");
+        invariant(cursor);
+        session->releaseCursor(tableId, cursor, "");
+        i = (i + 1) % numTables;
+    }
+
+    session->closeAllCursors("");
+}
+
+BENCHMARK(BM_GetAndReleaseSession)->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK(BM_GetAndReleaseCachedCursor)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(WiredTigerSessionCacheTestHelper::kNumTables)
+    ->ThreadRange(1, kMaxPerfThreads);
+
+}  // namespace
+}  // namespace mongo
@@ -114,4 +114,59 @@ TEST(WiredTigerSessionCacheTest, CheckSessionCacheCleanup) {
     ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
 }
 
+TEST(WiredTigerSessionCacheTest, ReleasedSessionIsReusedBySameThread) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    WiredTigerSession* released = nullptr;
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        released = session.get();
+    }
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        ASSERT_EQUALS(session.get(), released);
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+
+    // Closing all sessions must also close the ones that can be reused without the cache lock.
+    sessionCache->closeAll();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+}
+
+TEST(WiredTigerSessionCacheTest, CachedCursorsAreReturnedMostRecentFirst) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+    UniqueWiredTigerSession session = sessionCache->getSession();
+    WT_SESSION* wtSession = session->getSession();
+    ASSERT_OK(wtRCToStatus(wtSession->create(wtSession, "table:a", nullptr)));
+    ASSERT_OK(wtRCToStatus(wtSession->create(wtSession, "table:b", nullptr)));
+
+    const uint64_t idA = WiredTigerSession::genTableId();
+    const uint64_t idB = WiredTigerSession::genTableId();
+    WT_CURSOR* a1 = session->getNewCursor("table:a");
+    WT_CURSOR* a2 = session->getNewCursor("table:a");
+    WT_CURSOR* b = session->getNewCursor("table:b");
+    session->releaseCursor(idA, a1, "");
+    session->releaseCursor(idB, b, "");
+    session->releaseCursor(idA, a2, "");
+    ASSERT_EQUALS(session->cachedCursors(), 3);
+
+    // Cursors with a different configuration are never served.
+    ASSERT_EQUALS(session->getCachedCursor(idA, "read_once=true"), nullptr);
+
+    ASSERT_EQUALS(session->getCachedCursor(idA, ""), a2);
+    ASSERT_EQUALS(session->getCachedCursor(idA, ""), a1);
+    ASSERT_EQUALS(session->getCachedCursor(idA, ""), nullptr);
+    ASSERT_EQUALS(session->cachedCursors(), 1);
+    session->releaseCursor(idA, a1, "");
+    session->releaseCursor(idA, a2, "");
+
+    session->closeAllCursors("table:a");
+    ASSERT_EQUALS(session->cachedCursors(), 1);
+    ASSERT_EQUALS(session->getCachedCursor(idB, ""), b);
+    session->closeCursor(b);
+    ASSERT_EQUALS(session->cursorsOut(), 0);
+}
+
 }  // namespace mongo
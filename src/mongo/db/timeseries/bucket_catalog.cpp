@@ -38,10 +38,10 @@
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/timeseries/timeseries_constants.h"
 #include "mongo/db/timeseries/timeseries_options.h"
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/platform/compiler.h"
-#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point.h"
 
 namespace mongo {
@@ -137,10 +137,24 @@ BSONObj buildControlMinTimestampDoc(StringData timeField, long long roundedSecon
     builder.append(timeField, Date_t::fromMillisSinceEpoch(1000 * roundedSeconds));
     return builder.obj();
 }
-}  // namespace
 
-const std::shared_ptr<BucketCatalog::ExecutionStats> BucketCatalog::kEmptyStats{
-    std::make_shared<BucketCatalog::ExecutionStats>()};
+// Hashes a metadata value the same way regardless of the order of the fields of any (sub)object in
+// it, so that a key hashes identically before and after normalization. Objects are hashed by
+// summing the hashes of their fields, everything else by its binary value.
+std::size_t hashMetadataIgnoringFieldOrder(const BSONElement& elem) {
+    if (elem.type() != BSONType::Object) {
+        return absl::Hash<absl::string_view>{}(absl::string_view(elem.value(), elem.valuesize()));
+    }
+
+    std::size_t hash = 0;
+    for (auto&& field : elem.Obj()) {
+        hash += absl::Hash<std::pair<absl::string_view, std::size_t>>{}(
+            {absl::string_view(field.fieldName(), field.fieldNameSize() - 1),
+             hashMetadataIgnoringFieldOrder(field)});
+    }
+    return hash;
+}
+}  // namespace
 
 BucketCatalog& BucketCatalog::get(ServiceContext* svcCtx) {
     return getBucketCatalog(svcCtx);
@@ -150,8 +164,9 @@ BucketCatalog& BucketCatalog::get(OperationContext* opCtx) {
     return get(opCtx->getServiceContext());
 }
 
-BSONObj BucketCatalog::getMetadata(Bucket* ptr) const {
-    BucketAccess bucket{const_cast<BucketCatalog*>(this), ptr};
+BSONObj BucketCatalog::getMetadata(const std::shared_ptr<WriteBatch>& batch) const {
+    auto catalog = const_cast<BucketCatalog*>(this);
+    BucketAccess bucket{catalog, &catalog->_stripes[batch->_stripe], batch->bucket()};
     if (!bucket) {
         return {};
     }
@@ -173,8 +188,9 @@ StatusWith<std::shared_ptr<BucketCatalog::WriteBatch>> BucketCatalog::insert(
         metadata = doc[*metaFieldName];
     }
     auto key = BucketKey{ns, BucketMetadata{metadata, comparator}};
+    auto stripe = _getStripe(key);
 
-    auto stats = _getExecutionStats(ns);
+    auto stats = _getExecutionStats(stripe, ns);
     invariant(stats);
 
     auto timeElem = doc[options.getTimeField()];
@@ -186,7 +202,7 @@ StatusWith<std::shared_ptr<BucketCatalog::WriteBatch>> BucketCatalog::insert(
 
     auto time = timeElem.Date();
 
-    BucketAccess bucket{this, key, options, stats.get(), time};
+    BucketAccess bucket{this, stripe, key, options, stats.get(), time};
     invariant(bucket);
 
     NewFieldNames newFieldNamesToBeInserted;
@@ -244,20 +260,170 @@ StatusWith<std::shared_ptr<BucketCatalog::WriteBatch>> BucketCatalog::insert(
         key.metadata.normalize();
         bucket->_metadata = key.metadata;
 
-        // The namespace is stored two times: the bucket itself and _openBuckets.
+        // The namespace is stored two times: the bucket itself and openBuckets.
         // The metadata is stored two times, normalized and un-normalized. A unique pointer to the
-        // bucket is stored once: _allBuckets. A raw pointer to the bucket is stored at most twice:
-        // _openBuckets, _idleBuckets.
+        // bucket is stored once: allBuckets. A raw pointer to the bucket is stored at most twice:
+        // openBuckets, idleBuckets.
         bucket->_memoryUsage += (ns.size() * 2) + (bucket->_metadata.toBSON().objsize() * 2) +
             sizeof(Bucket) + sizeof(std::unique_ptr<Bucket>) + (sizeof(Bucket*) * 2);
     } else {
-        _memoryUsage.fetchAndSubtract(bucket->_memoryUsage);
+        stripe->memoryUsage.fetchAndSubtract(bucket->_memoryUsage);
     }
-    _memoryUsage.fetchAndAdd(bucket->_memoryUsage);
+    stripe->memoryUsage.fetchAndAdd(bucket->_memoryUsage);
 
     return batch;
 }
 
+bool BucketCatalog::tryReopenBucket(
+    const NamespaceString& ns,
+    const StringData::ComparatorInterface* comparator,
+    const TimeseriesOptions& options,
+    const BSONObj& doc,
+    const std::function<boost::optional<BSONObj>(const BSONObj&)>& findBucket) {
+    auto timeElem = doc[options.getTimeField()];
+    if (!timeElem || BSONType::Date != timeElem.type()) {
+        return false;
+    }
+    auto time = timeElem.Date();
+
+    BSONElement metadata;
+    auto metaFieldName = options.getMetaField();
+    if (metaFieldName) {
+        metadata = doc[*metaFieldName];
+    }
+    auto key = BucketKey{ns, BucketMetadata{metadata, comparator}};
+    auto stripe = _getStripe(key);
+    {
+        stdx::lock_guard lk{stripe->mutex};
+        if (stripe->openBuckets.contains(key)) {
+            return false;
+        }
+    }
+    key.metadata.normalize();
+    {
+        stdx::lock_guard lk{stripe->mutex};
+        if (stripe->openBuckets.contains(key)) {
+            return false;
+        }
+    }
+
+    // Any bucket of the series that is still uncompressed and whose time range can cover the
+    // measurement is a candidate. The catalog stores the normalized metadata, so that is what the
+    // persisted bucket holds.
+    auto maxSpan = Seconds(*options.getBucketMaxSpanSeconds());
+    BSONObjBuilder queryBuilder;
+    queryBuilder.append(str::stream() << timeseries::kBucketControlFieldName << "."
+                                      << timeseries::kBucketControlVersionFieldName,
+                        timeseries::kTimeseriesControlDefaultVersion);
+    queryBuilder.append(str::stream() << timeseries::kControlMinFieldNamePrefix
+                                      << options.getTimeField(),
+                        BSON("$lte" << time << "$gt" << time - maxSpan));
+    auto metaElem = key.metadata.getMetaElement();
+    if (metaElem) {
+        queryBuilder.appendAs(metaElem, timeseries::kBucketMetaFieldName);
+    } else {
+        queryBuilder.append(timeseries::kBucketMetaFieldName, BSON("$exists" << false));
+    }
+
+    uint64_t numOutsideWritesFinished;
+    {
+        stdx::lock_guard lk{_rewriteMutex};
+        numOutsideWritesFinished = _numOutsideWritesFinished;
+    }
+
+    auto bucketDoc = findBucket(queryBuilder.obj());
+    if (!bucketDoc) {
+        return false;
+    }
+
+    // Check the candidate against everything the catalog assumes about an open bucket, since the
+    // caller may have returned a document that no longer matches the query.
+    auto idElem = (*bucketDoc)[timeseries::kBucketIdFieldName];
+    auto control = (*bucketDoc)[timeseries::kBucketControlFieldName];
+    auto data = (*bucketDoc)[timeseries::kBucketDataFieldName];
+    auto bucketMeta = (*bucketDoc)[timeseries::kBucketMetaFieldName];
+    if (idElem.type() != BSONType::jstOID || control.type() != BSONType::Object ||
+        data.type() != BSONType::Object ||
+        control.Obj()[timeseries::kBucketControlVersionFieldName].numberInt() !=
+            timeseries::kTimeseriesControlDefaultVersion) {
+        return false;
+    }
+    if (bucketMeta.type() != metaElem.type() ||
+        (metaElem && !metaElem.binaryEqualValues(bucketMeta))) {
+        return false;
+    }
+
+    auto id = idElem.OID();
+    auto timeColumn = data.Obj()[options.getTimeField()];
+    auto controlMin = control.Obj()["min"];
+    auto controlMax = control.Obj()["max"];
+    if (timeColumn.type() != BSONType::Object || controlMin.type() != BSONType::Object ||
+        controlMax.type() != BSONType::Object) {
+        return false;
+    }
+    auto numMeasurements = timeColumn.Obj().nFields();
+    if (numMeasurements == 0 ||
+        numMeasurements >= static_cast<int>(gTimeseriesBucketMaxCount) ||
+        bucketDoc->objsize() >= static_cast<int>(gTimeseriesBucketMaxSize) ||
+        time < id.asDateT() || time - id.asDateT() >= maxSpan) {
+        return false;
+    }
+
+    auto bucket = std::make_unique<Bucket>();
+    bucket->_id = id;
+    bucket->_stripe = stripe - _stripes.data();
+    bucket->_ns = ns;
+    bucket->_metadata = key.metadata;
+    for (auto&& column : data.Obj()) {
+        bucket->_fieldNames.emplace(column.fieldNameStringData());
+    }
+    bucket->_minmax.update(controlMin.Obj(), boost::none, comparator);
+    bucket->_minmax.update(controlMax.Obj(), boost::none, comparator);
+    // The persisted control fields are the starting point, so the first commit only writes what
+    // changed since.
+    bucket->_minmax.minUpdates();
+    bucket->_minmax.maxUpdates();
+    auto latestTime = controlMax.Obj()[options.getTimeField()];
+    bucket->_latestTime = latestTime.type() == BSONType::Date ? latestTime.Date() : id.asDateT();
+    bucket->_size = bucketDoc->objsize();
+    bucket->_numMeasurements = numMeasurements;
+    bucket->_numCommittedMeasurements = numMeasurements;
+    bucket->_memoryUsage += (ns.size() * 2) + (bucket->_metadata.toBSON().objsize() * 2) +
+        sizeof(Bucket) + sizeof(std::unique_ptr<Bucket>) + (sizeof(Bucket*) * 2) +
+        controlMin.objsize() + controlMax.objsize();
+
+    auto stats = _getExecutionStats(stripe, ns);
+    stdx::lock_guard lk{stripe->mutex};
+    if (stripe->openBuckets.contains(key)) {
+        return false;
+    }
+    _expireIdleBuckets(stripe, stats.get());
+
+    // The document read above is only current if no rewrite or direct modification of the bucket
+    // was in progress or finished while reading it. A modification that starts after this point
+    // clears the reopened bucket through clear(OID).
+    stdx::lock_guard rewriteLk{_rewriteMutex};
+    if (_numOutsideWritesFinished != numOutsideWritesFinished ||
+        _bucketsBeingRewritten.contains(id) || _bucketsBeingModified.contains(id)) {
+        return false;
+    }
+    {
+        stdx::lock_guard statesLk{stripe->statesMutex};
+        if (!stripe->bucketStates.emplace(id, BucketState::kNormal).second) {
+            // The bucket is still in the catalog, waiting for its last commit after being closed.
+            return false;
+        }
+    }
+
+    Bucket* ptr = stripe->allBuckets.insert(std::move(bucket)).first->get();
+    stripe->openBuckets[key] = ptr;
+    stripe->memoryUsage.fetchAndAdd(ptr->_memoryUsage);
+    _markBucketIdle(stripe, ptr);
+    stats->numBucketsReopened.fetchAndAddRelaxed(1);
+
+    return true;
+}
+
 bool BucketCatalog::prepareCommit(std::shared_ptr<WriteBatch> batch) {
     if (batch->finished()) {
         // In this case, someone else aborted the batch behind our back. Oops.
@@ -266,7 +432,8 @@ bool BucketCatalog::prepareCommit(std::shared_ptr<WriteBatch> batch) {
 
     _waitToCommitBatch(batch);
 
-    BucketAccess bucket(this, batch->bucket(), BucketState::kPrepared);
+    auto stripe = &_stripes[batch->_stripe];
+    BucketAccess bucket(this, stripe, batch->bucket(), BucketState::kPrepared);
     if (batch->finished()) {
         // Someone may have aborted it while we were waiting.
         return false;
@@ -277,21 +444,23 @@ bool BucketCatalog::prepareCommit(std::shared_ptr<WriteBatch> batch) {
 
     auto prevMemoryUsage = bucket->_memoryUsage;
     batch->_prepareCommit();
-    _memoryUsage.fetchAndAdd(bucket->_memoryUsage - prevMemoryUsage);
+    stripe->memoryUsage.fetchAndAdd(bucket->_memoryUsage - prevMemoryUsage);
 
     bucket->_batches.erase(batch->_lsid);
 
     return true;
 }
 
-void BucketCatalog::finish(std::shared_ptr<WriteBatch> batch, const CommitInfo& info) {
+boost::optional<BucketCatalog::ClosedBucket> BucketCatalog::finish(
+    std::shared_ptr<WriteBatch> batch, const CommitInfo& info) {
     invariant(!batch->finished());
     invariant(!batch->active());
 
     Bucket* ptr(batch->bucket());
     batch->_finish(info);
 
-    BucketAccess bucket(this, ptr, BucketState::kNormal);
+    auto stripe = &_stripes[batch->_stripe];
+    BucketAccess bucket(this, stripe, ptr, BucketState::kNormal);
     if (bucket) {
         bucket->_preparedBatch.reset();
     }
@@ -309,38 +478,42 @@ void BucketCatalog::finish(std::shared_ptr<WriteBatch> batch, const CommitInfo&
         bucket->_numCommittedMeasurements += batch->measurements().size();
     }
 
+    boost::optional<ClosedBucket> closedBucket;
+
     if (!bucket) {
         // It's possible that we cleared the bucket in between preparing the commit and finishing
         // here. In this case, we should abort any other ongoing batches and clear the bucket from
         // the catalog so it's not hanging around idle.
-        auto lk = _lockExclusive();
-        if (_allBuckets.contains(ptr)) {
+        stdx::lock_guard lk{stripe->mutex};
+        if (stripe->allBuckets.contains(ptr)) {
             stdx::unique_lock blk{ptr->_mutex};
             ptr->_preparedBatch.reset();
-            _abort(blk, ptr, nullptr, boost::none);
+            _abort(stripe, blk, ptr, nullptr, boost::none);
         }
     } else if (bucket->allCommitted()) {
         if (bucket->_full) {
             // Everything in the bucket has been committed, and nothing more will be added since the
             // bucket is full. Thus, we can remove it.
-            _memoryUsage.fetchAndSubtract(bucket->_memoryUsage);
+            stripe->memoryUsage.fetchAndSubtract(bucket->_memoryUsage);
 
             bucket.release();
-            auto lk = _lockExclusive();
+            stdx::lock_guard lk{stripe->mutex};
 
-            // Only remove from _allBuckets and _idleBuckets. If it was marked full, we know that
+            // Only remove from allBuckets and idleBuckets. If it was marked full, we know that
             // happened in BucketAccess::rollover, and that there is already a new open bucket for
             // this metadata.
-            _markBucketNotIdle(ptr, false /* locked */);
+            _markBucketNotIdle(stripe, ptr, false /* locked */);
             {
-                stdx::lock_guard statesLk{_statesMutex};
-                _bucketStates.erase(ptr->_id);
+                stdx::lock_guard statesLk{stripe->statesMutex};
+                stripe->bucketStates.erase(ptr->_id);
             }
-            _allBuckets.erase(ptr);
+            closedBucket = ClosedBucket{ptr->_id, ptr->_ns};
+            stripe->allBuckets.erase(ptr);
         } else {
-            _markBucketIdle(bucket);
+            _markBucketIdle(stripe, bucket);
         }
     }
+    return closedBucket;
 }
 
 void BucketCatalog::abort(std::shared_ptr<WriteBatch> batch,
@@ -356,40 +529,77 @@ void BucketCatalog::abort(std::shared_ptr<WriteBatch> batch,
     Bucket* bucket = batch->bucket();
 
     // Before we access the bucket, make sure it's still there.
-    auto lk = _lockExclusive();
-    if (!_allBuckets.contains(bucket)) {
+    auto stripe = &_stripes[batch->_stripe];
+    stdx::lock_guard lk{stripe->mutex};
+    if (!stripe->allBuckets.contains(bucket)) {
         // Special case, bucket has already been cleared, and we need only abort this batch.
         batch->_abort(status, false);
         return;
     }
 
     stdx::unique_lock blk{bucket->_mutex};
-    _abort(blk, bucket, batch, status);
+    _abort(stripe, blk, bucket, batch, status);
 }
 
 void BucketCatalog::clear(const OID& oid) {
-    auto result = _setBucketState(oid, BucketState::kCleared);
-    if (result && *result == BucketState::kPreparedAndCleared) {
-        hangTimeseriesDirectModificationBeforeWriteConflict.pauseWhileSet();
-        throw WriteConflictException();
+    // The id says nothing about which stripe owns the bucket, so look for it in each of them.
+    for (auto& stripe : _stripes) {
+        auto result = _setBucketState(&stripe, oid, BucketState::kCleared);
+        if (!result) {
+            continue;
+        }
+        if (*result == BucketState::kPreparedAndCleared) {
+            hangTimeseriesDirectModificationBeforeWriteConflict.pauseWhileSet();
+            throw WriteConflictException();
+        }
+        return;
     }
 }
 
-void BucketCatalog::clear(const std::function<bool(const NamespaceString&)>& shouldClear) {
-    auto lk = _lockExclusive();
-    auto statsLk = _statsMutex.lockExclusive();
+void BucketCatalog::clear(OperationContext* opCtx, const OID& oid) {
+    clear(oid);
+
+    {
+        stdx::lock_guard lk{_rewriteMutex};
+        ++_bucketsBeingModified[oid];
+    }
+    auto finishModification = [this, oid] {
+        stdx::lock_guard lk{_rewriteMutex};
+        auto it = _bucketsBeingModified.find(oid);
+        invariant(it != _bucketsBeingModified.end());
+        if (--it->second == 0) {
+            _bucketsBeingModified.erase(it);
+        }
+        ++_numOutsideWritesFinished;
+    };
+    opCtx->recoveryUnit()->onCommit(
+        [finishModification](boost::optional<Timestamp>) { finishModification(); });
+    opCtx->recoveryUnit()->onRollback(finishModification);
+}
 
-    for (auto it = _allBuckets.begin(); it != _allBuckets.end();) {
-        auto nextIt = std::next(it);
+void BucketCatalog::clear(const std::function<bool(const NamespaceString&)>& shouldClear) {
+    for (auto& stripe : _stripes) {
+        stdx::lock_guard lk{stripe.mutex};
 
-        const auto& bucket = *it;
-        stdx::unique_lock blk{bucket->_mutex};
-        if (shouldClear(bucket->_ns)) {
-            _executionStats.erase(bucket->_ns);
-            _abort(blk, bucket.get(), nullptr, boost::none);
+        for (auto it = stripe.executionStats.begin(); it != stripe.executionStats.end();) {
+            auto nextIt = std::next(it);
+            if (shouldClear(it->first)) {
+                stripe.executionStats.erase(it);
+            }
+            it = nextIt;
         }
 
-        it = nextIt;
+        for (auto it = stripe.allBuckets.begin(); it != stripe.allBuckets.end();) {
+            auto nextIt = std::next(it);
+
+            const auto& bucket = *it;
+            stdx::unique_lock blk{bucket->_mutex};
+            if (shouldClear(bucket->_ns)) {
+                _abort(&stripe, blk, bucket.get(), nullptr, boost::none);
+            }
+
+            it = nextIt;
+        }
     }
 }
 
@@ -401,58 +611,93 @@ void BucketCatalog::clear(StringData dbName) {
     clear([&dbName](const NamespaceString& bucketNs) { return bucketNs.db() == dbName; });
 }
 
-void BucketCatalog::appendExecutionStats(const NamespaceString& ns, BSONObjBuilder* builder) const {
-    const auto stats = _getExecutionStats(ns);
-
-    builder->appendNumber("numBucketInserts", stats->numBucketInserts.load());
-    builder->appendNumber("numBucketUpdates", stats->numBucketUpdates.load());
-    builder->appendNumber("numBucketsOpenedDueToMetadata",
-                          stats->numBucketsOpenedDueToMetadata.load());
-    builder->appendNumber("numBucketsClosedDueToCount", stats->numBucketsClosedDueToCount.load());
-    builder->appendNumber("numBucketsClosedDueToSize", stats->numBucketsClosedDueToSize.load());
-    builder->appendNumber("numBucketsClosedDueToTimeForward",
-                          stats->numBucketsClosedDueToTimeForward.load());
-    builder->appendNumber("numBucketsClosedDueToTimeBackward",
-                          stats->numBucketsClosedDueToTimeBackward.load());
-    builder->appendNumber("numBucketsClosedDueToMemoryThreshold",
-                          stats->numBucketsClosedDueToMemoryThreshold.load());
-    auto commits = stats->numCommits.load();
-    builder->appendNumber("numCommits", commits);
-    builder->appendNumber("numWaits", stats->numWaits.load());
-    auto measurementsCommitted = stats->numMeasurementsCommitted.load();
-    builder->appendNumber("numMeasurementsCommitted", measurementsCommitted);
-    if (commits) {
-        builder->appendNumber("avgNumMeasurementsPerCommit", measurementsCommitted / commits);
+bool BucketCatalog::claimBucketForRewrite(const OID& id) {
+    stdx::lock_guard lk{_rewriteMutex};
+    if (_bucketsBeingRewritten.contains(id)) {
+        return false;
     }
-}
 
-BucketCatalog::StripedMutex::ExclusiveLock::ExclusiveLock(const StripedMutex& sm) {
-    invariant(sm._mutexes.size() == _locks.size());
-    for (std::size_t i = 0; i < sm._mutexes.size(); ++i) {
-        _locks[i] = stdx::unique_lock<Mutex>(sm._mutexes[i]);
+    // The id says nothing about which stripe would own the bucket, so check all of them.
+    for (auto& stripe : _stripes) {
+        stdx::lock_guard statesLk{stripe.statesMutex};
+        if (stripe.bucketStates.contains(id)) {
+            return false;
+        }
     }
-}
 
-BucketCatalog::StripedMutex::SharedLock BucketCatalog::StripedMutex::lockShared() const {
-    static const std::hash<stdx::thread::id> hasher;
-    return SharedLock{_mutexes[hasher(stdx::this_thread::get_id()) % kNumStripes]};
+    _bucketsBeingRewritten.insert(id);
+    return true;
 }
 
-BucketCatalog::StripedMutex::ExclusiveLock BucketCatalog::StripedMutex::lockExclusive() const {
-    return ExclusiveLock{*this};
+void BucketCatalog::releaseBucketForRewrite(const OID& id) {
+    stdx::lock_guard lk{_rewriteMutex};
+    invariant(_bucketsBeingRewritten.erase(id));
+    ++_numOutsideWritesFinished;
 }
 
-BucketCatalog::StripedMutex::SharedLock BucketCatalog::_lockShared() const {
-    return _bucketMutex.lockShared();
+void BucketCatalog::appendExecutionStats(const NamespaceString& ns, BSONObjBuilder* builder) const {
+    // Each stripe counts the work done on its own buckets; sum them up for the namespace.
+    long long numBucketInserts = 0;
+    long long numBucketUpdates = 0;
+    long long numBucketsOpenedDueToMetadata = 0;
+    long long numBucketsReopened = 0;
+    long long numBucketsClosedDueToCount = 0;
+    long long numBucketsClosedDueToSize = 0;
+    long long numBucketsClosedDueToTimeForward = 0;
+    long long numBucketsClosedDueToTimeBackward = 0;
+    long long numBucketsClosedDueToMemoryThreshold = 0;
+    long long commits = 0;
+    long long numWaits = 0;
+    long long measurementsCommitted = 0;
+    for (const auto& stripe : _stripes) {
+        stdx::lock_guard lk{stripe.mutex};
+        auto it = stripe.executionStats.find(ns);
+        if (it == stripe.executionStats.end()) {
+            continue;
+        }
+
+        const auto& stats = it->second;
+        numBucketInserts += stats->numBucketInserts.load();
+        numBucketUpdates += stats->numBucketUpdates.load();
+        numBucketsOpenedDueToMetadata += stats->numBucketsOpenedDueToMetadata.load();
+        numBucketsReopened += stats->numBucketsReopened.load();
+        numBucketsClosedDueToCount += stats->numBucketsClosedDueToCount.load();
+        numBucketsClosedDueToSize += stats->numBucketsClosedDueToSize.load();
+        numBucketsClosedDueToTimeForward += stats->numBucketsClosedDueToTimeForward.load();
+        numBucketsClosedDueToTimeBackward += stats->numBucketsClosedDueToTimeBackward.load();
+        numBucketsClosedDueToMemoryThreshold += stats->numBucketsClosedDueToMemoryThreshold.load();
+        commits += stats->numCommits.load();
+        numWaits += stats->numWaits.load();
+        measurementsCommitted += stats->numMeasurementsCommitted.load();
+    }
+
+    builder->appendNumber("numBucketInserts", numBucketInserts);
+    builder->appendNumber("numBucketUpdates", numBucketUpdates);
+    builder->appendNumber("numBucketsOpenedDueToMetadata", numBucketsOpenedDueToMetadata);
+    builder->appendNumber("numBucketsReopened", numBucketsReopened);
+    builder->appendNumber("numBucketsClosedDueToCount", numBucketsClosedDueToCount);
+    builder->appendNumber("numBucketsClosedDueToSize", numBucketsClosedDueToSize);
+    builder->appendNumber("numBucketsClosedDueToTimeForward", numBucketsClosedDueToTimeForward);
+    builder->appendNumber("numBucketsClosedDueToTimeBackward", numBucketsClosedDueToTimeBackward);
+    builder->appendNumber("numBucketsClosedDueToMemoryThreshold",
+                          numBucketsClosedDueToMemoryThreshold);
+    builder->appendNumber("numCommits", commits);
+    builder->appendNumber("numWaits", numWaits);
+    builder->appendNumber("numMeasurementsCommitted", measurementsCommitted);
+    if (commits) {
+        builder->appendNumber("avgNumMeasurementsPerCommit", measurementsCommitted / commits);
+    }
 }
 
-BucketCatalog::StripedMutex::ExclusiveLock BucketCatalog::_lockExclusive() const {
-    return _bucketMutex.lockExclusive();
+BucketCatalog::Stripe* BucketCatalog::_getStripe(const BucketKey& key) {
+    auto hash = absl::Hash<NamespaceString>{}(key.ns) ^
+        hashMetadataIgnoringFieldOrder(key.metadata.getMetaElement());
+    return &_stripes[hash % kNumberOfStripes];
 }
 
 void BucketCatalog::_waitToCommitBatch(const std::shared_ptr<WriteBatch>& batch) {
     while (true) {
-        BucketAccess bucket{this, batch->bucket()};
+        BucketAccess bucket{this, &_stripes[batch->_stripe], batch->bucket()};
         if (!bucket) {
             return;
         }
@@ -470,36 +715,37 @@ void BucketCatalog::_waitToCommitBatch(const std::shared_ptr<WriteBatch>& batch)
     }
 }
 
-bool BucketCatalog::_removeBucket(Bucket* bucket, bool expiringBuckets) {
-    auto it = _allBuckets.find(bucket);
-    if (it == _allBuckets.end()) {
+bool BucketCatalog::_removeBucket(Stripe* stripe, Bucket* bucket, bool expiringBuckets) {
+    auto it = stripe->allBuckets.find(bucket);
+    if (it == stripe->allBuckets.end()) {
         return false;
     }
 
     invariant(bucket->_batches.empty());
     invariant(!bucket->_preparedBatch);
 
-    _memoryUsage.fetchAndSubtract(bucket->_memoryUsage);
-    _markBucketNotIdle(bucket, expiringBuckets /* locked */);
-    _removeNonNormalizedKeysForBucket(bucket);
-    _openBuckets.erase({bucket->_ns, bucket->_metadata});
+    stripe->memoryUsage.fetchAndSubtract(bucket->_memoryUsage);
+    _markBucketNotIdle(stripe, bucket, expiringBuckets /* locked */);
+    _removeNonNormalizedKeysForBucket(stripe, bucket);
+    stripe->openBuckets.erase({bucket->_ns, bucket->_metadata});
     {
-        stdx::lock_guard statesLk{_statesMutex};
-        _bucketStates.erase(bucket->_id);
+        stdx::lock_guard statesLk{stripe->statesMutex};
+        stripe->bucketStates.erase(bucket->_id);
     }
-    _allBuckets.erase(it);
+    stripe->allBuckets.erase(it);
 
     return true;
 }
 
-void BucketCatalog::_removeNonNormalizedKeysForBucket(Bucket* bucket) {
+void BucketCatalog::_removeNonNormalizedKeysForBucket(Stripe* stripe, Bucket* bucket) {
     auto comparator = bucket->_metadata.getComparator();
     for (auto&& metadata : bucket->_nonNormalizedKeyMetadatas) {
-        _openBuckets.erase({bucket->_ns, {metadata.firstElement(), metadata, comparator}});
+        stripe->openBuckets.erase({bucket->_ns, {metadata.firstElement(), metadata, comparator}});
     }
 }
 
-void BucketCatalog::_abort(stdx::unique_lock<Mutex>& lk,
+void BucketCatalog::_abort(Stripe* stripe,
+                           stdx::unique_lock<Mutex>& lk,
                            Bucket* bucket,
                            std::shared_ptr<WriteBatch> batch,
                            const boost::optional<Status>& status) {
@@ -526,68 +772,97 @@ void BucketCatalog::_abort(stdx::unique_lock<Mutex>& lk,
 
     lk.unlock();
     if (doRemove) {
-        [[maybe_unused]] bool removed = _removeBucket(bucket, false /* expiringBuckets */);
+        [[maybe_unused]] bool removed = _removeBucket(stripe, bucket, false /* expiringBuckets */);
     }
 }
 
-void BucketCatalog::_markBucketIdle(Bucket* bucket) {
+void BucketCatalog::_markBucketIdle(Stripe* stripe, Bucket* bucket) {
     invariant(bucket);
-    stdx::lock_guard lk{_idleMutex};
-    _idleBuckets.push_front(bucket);
-    bucket->_idleListEntry = _idleBuckets.begin();
+    stdx::lock_guard lk{stripe->idleMutex};
+    stripe->idleBuckets.push_front(bucket);
+    bucket->_idleListEntry = stripe->idleBuckets.begin();
 }
 
-void BucketCatalog::_markBucketNotIdle(Bucket* bucket, bool locked) {
+void BucketCatalog::_markBucketNotIdle(Stripe* stripe, Bucket* bucket, bool locked) {
     invariant(bucket);
     if (bucket->_idleListEntry) {
         stdx::unique_lock<Mutex> guard;
         if (!locked) {
-            guard = stdx::unique_lock{_idleMutex};
+            guard = stdx::unique_lock{stripe->idleMutex};
         }
-        _idleBuckets.erase(*bucket->_idleListEntry);
+        stripe->idleBuckets.erase(*bucket->_idleListEntry);
         bucket->_idleListEntry = boost::none;
     }
 }
 
 void BucketCatalog::_verifyBucketIsUnused(Bucket* bucket) const {
     // Take a lock on the bucket so we guarantee no one else is accessing it. We can release it
-    // right away since no one else can take it again without taking the catalog lock, which we
+    // right away since no one else can take it again without taking the stripe lock, which we
     // also hold outside this method.
     stdx::lock_guard<Mutex> lk{bucket->_mutex};
 }
 
-void BucketCatalog::_expireIdleBuckets(ExecutionStats* stats) {
-    // Must hold an exclusive lock on _bucketMutex from outside.
-    stdx::lock_guard lk{_idleMutex};
+void BucketCatalog::_expireIdleBuckets(Stripe* stripe, ExecutionStats* stats) {
+    // Must hold the stripe lock from outside.
+    if (_expireIdleBucketsOfStripe(stripe, stats)) {
+        return;
+    }
+
+    // The threshold applies to the catalog as a whole, so once this stripe has run out of idle
+    // buckets, expire those of the other stripes. Their locks are only tried, so that an allocation
+    // never waits on another stripe and two stripes expiring each other's buckets cannot deadlock.
+    for (auto& other : _stripes) {
+        if (&other == stripe) {
+            continue;
+        }
+        stdx::unique_lock otherLk{other.mutex, stdx::try_to_lock};
+        if (otherLk.owns_lock() && _expireIdleBucketsOfStripe(&other, stats)) {
+            return;
+        }
+    }
+}
+
+bool BucketCatalog::_expireIdleBucketsOfStripe(Stripe* stripe, ExecutionStats* stats) {
+    // Must hold the stripe lock from outside.
+    stdx::lock_guard lk{stripe->idleMutex};
 
     // As long as we still need space and have entries, close idle buckets.
-    while (!_idleBuckets.empty() &&
-           _memoryUsage.load() >
-               static_cast<std::uint64_t>(gTimeseriesIdleBucketExpiryMemoryUsageThreshold)) {
-        Bucket* bucket = _idleBuckets.back();
+    while (_memoryUsage() >
+           static_cast<std::uint64_t>(gTimeseriesIdleBucketExpiryMemoryUsageThreshold)) {
+        if (stripe->idleBuckets.empty()) {
+            return false;
+        }
+
+        Bucket* bucket = stripe->idleBuckets.back();
         _verifyBucketIsUnused(bucket);
-        if (_removeBucket(bucket, true /* expiringBuckets */)) {
+        if (_removeBucket(stripe, bucket, true /* expiringBuckets */)) {
             stats->numBucketsClosedDueToMemoryThreshold.fetchAndAddRelaxed(1);
         }
     }
+    return true;
 }
 
-std::size_t BucketCatalog::_numberOfIdleBuckets() const {
-    stdx::lock_guard lk{_idleMutex};
-    return _idleBuckets.size();
+uint64_t BucketCatalog::_memoryUsage() const {
+    uint64_t memoryUsage = 0;
+    for (const auto& stripe : _stripes) {
+        memoryUsage += stripe.memoryUsage.load();
+    }
+    return memoryUsage;
 }
 
-BucketCatalog::Bucket* BucketCatalog::_allocateBucket(const BucketKey& key,
+BucketCatalog::Bucket* BucketCatalog::_allocateBucket(Stripe* stripe,
+                                                      const BucketKey& key,
                                                       const Date_t& time,
                                                       const TimeseriesOptions& options,
                                                       ExecutionStats* stats,
                                                       bool openedDuetoMetadata) {
-    _expireIdleBuckets(stats);
+    _expireIdleBuckets(stripe, stats);
 
-    auto [it, inserted] = _allBuckets.insert(std::make_unique<Bucket>());
+    auto [it, inserted] = stripe->allBuckets.insert(std::make_unique<Bucket>());
     Bucket* bucket = it->get();
-    _setIdTimestamp(bucket, time, options);
-    _openBuckets[key] = bucket;
+    bucket->_stripe = stripe - _stripes.data();
+    _setIdTimestamp(stripe, bucket, time, options);
+    stripe->openBuckets[key] = bucket;
 
     if (openedDuetoMetadata) {
         stats->numBucketsOpenedDueToMetadata.fetchAndAddRelaxed(1);
@@ -597,32 +872,17 @@ BucketCatalog::Bucket* BucketCatalog::_allocateBucket(const BucketKey& key,
 }
 
 std::shared_ptr<BucketCatalog::ExecutionStats> BucketCatalog::_getExecutionStats(
-    const NamespaceString& ns) {
-    {
-        auto lock = _statsMutex.lockShared();
-        auto it = _executionStats.find(ns);
-        if (it != _executionStats.end()) {
-            return it->second;
-        }
+    Stripe* stripe, const NamespaceString& ns) {
+    stdx::lock_guard lk{stripe->mutex};
+    auto res = stripe->executionStats.try_emplace(ns);
+    if (res.second) {
+        res.first->second = std::make_shared<ExecutionStats>();
     }
-
-    auto lock = _statsMutex.lockExclusive();
-    auto res = _executionStats.emplace(ns, std::make_shared<ExecutionStats>());
     return res.first->second;
 }
 
-const std::shared_ptr<BucketCatalog::ExecutionStats> BucketCatalog::_getExecutionStats(
-    const NamespaceString& ns) const {
-    auto lock = _statsMutex.lockShared();
-
-    auto it = _executionStats.find(ns);
-    if (it != _executionStats.end()) {
-        return it->second;
-    }
-    return kEmptyStats;
-}
-
-void BucketCatalog::_setIdTimestamp(Bucket* bucket,
+void BucketCatalog::_setIdTimestamp(Stripe* stripe,
+                                    Bucket* bucket,
                                     const Date_t& time,
                                     const TimeseriesOptions& options) {
     auto const roundedSeconds = roundTimestampDown(time, options);
@@ -633,15 +893,16 @@ void BucketCatalog::_setIdTimestamp(Bucket* bucket,
     bucket->_minmax.update(
         controlDoc, bucket->_metadata.getMetaField(), bucket->_metadata.getComparator());
 
-    stdx::lock_guard statesLk{_statesMutex};
-    _bucketStates.emplace(bucket->_id, BucketState::kNormal);
+    stdx::lock_guard statesLk{stripe->statesMutex};
+    stripe->bucketStates.emplace(bucket->_id, BucketState::kNormal);
 }
 
-boost::optional<BucketCatalog::BucketState> BucketCatalog::_setBucketState(const OID& id,
+boost::optional<BucketCatalog::BucketState> BucketCatalog::_setBucketState(Stripe* stripe,
+                                                                           const OID& id,
                                                                            BucketState target) {
-    stdx::lock_guard statesLk{_statesMutex};
-    auto it = _bucketStates.find(id);
-    if (it == _bucketStates.end()) {
+    stdx::lock_guard statesLk{stripe->statesMutex};
+    auto it = stripe->bucketStates.find(id);
+    if (it == stripe->bucketStates.end()) {
         return boost::none;
     }
 
@@ -791,11 +1052,17 @@ std::shared_ptr<BucketCatalog::WriteBatch> BucketCatalog::Bucket::_activeBatch(
 }
 
 BucketCatalog::BucketAccess::BucketAccess(BucketCatalog* catalog,
+                                          Stripe* stripe,
                                           BucketKey& key,
                                           const TimeseriesOptions& options,
                                           ExecutionStats* stats,
                                           const Date_t& time)
-    : _catalog(catalog), _key(&key), _options(&options), _stats(stats), _time(&time) {
+    : _catalog(catalog),
+      _stripe(stripe),
+      _key(&key),
+      _options(&options),
+      _stats(stats),
+      _time(&time) {
 
     auto bucketFound = [](BucketState bucketState) {
         return bucketState == BucketState::kNormal || bucketState == BucketState::kPrepared;
@@ -824,7 +1091,7 @@ BucketCatalog::BucketAccess::BucketAccess(BucketCatalog* catalog,
             return;
         }
 
-        // Release the bucket as we need to acquire the exclusive lock for the catalog.
+        // Release the bucket as we need to reacquire the stripe lock.
         release();
 
         // Re-construct the key as it were before normalization.
@@ -833,8 +1100,8 @@ BucketCatalog::BucketAccess::BucketAccess(BucketCatalog* catalog,
             : key.withCopiedMetadata(BSONObj());
         hashedKey.key = &originalBucketKey;
 
-        // Find the bucket under a catalog exclusive lock for the catalog. It may have been modified
-        // since we released our locks. If found we store the key to avoid the need to normalize for
+        // Find the bucket under the stripe lock again. It may have been modified since we released
+        // our locks. If found we store the key to avoid the need to normalize for
         // future lookups with this incoming field order.
         BSONObj nonNormalizedMetadataObj =
             nonNormalizedMetadata ? nonNormalizedMetadata.wrap() : BSONObj();
@@ -844,23 +1111,24 @@ BucketCatalog::BucketAccess::BucketAccess(BucketCatalog* catalog,
         }
     }
 
-    // Bucket not found, grab exclusive lock and create bucket with the key before normalization.
+    // Bucket not found, grab the stripe lock and create bucket with the key before normalization.
     auto originalBucketKey = nonNormalizedMetadata
         ? key.withCopiedMetadata(nonNormalizedMetadata.wrap())
         : key.withCopiedMetadata(BSONObj());
     hashedKey.key = &originalBucketKey;
-    auto lk = _catalog->_lockExclusive();
+    stdx::lock_guard lk{_stripe->mutex};
     _findOrCreateOpenBucketThenLock(hashedNormalizedKey, hashedKey);
 }
 
 BucketCatalog::BucketAccess::BucketAccess(BucketCatalog* catalog,
+                                          Stripe* stripe,
                                           Bucket* bucket,
                                           boost::optional<BucketState> targetState)
-    : _catalog(catalog) {
+    : _catalog(catalog), _stripe(stripe) {
     {
-        auto lk = _catalog->_lockShared();
-        auto bucketIt = _catalog->_allBuckets.find(bucket);
-        if (bucketIt == _catalog->_allBuckets.end()) {
+        stdx::lock_guard lk{_stripe->mutex};
+        auto bucketIt = _stripe->allBuckets.find(bucket);
+        if (bucketIt == _stripe->allBuckets.end()) {
             return;
         }
 
@@ -871,11 +1139,11 @@ BucketCatalog::BucketAccess::BucketAccess(BucketCatalog* catalog,
     boost::optional<BucketState> state{BucketState::kCleared};
     if (targetState) {
         invariant(*targetState == BucketState::kNormal || *targetState == BucketState::kPrepared);
-        state = _catalog->_setBucketState(_bucket->_id, *targetState);
+        state = _catalog->_setBucketState(_stripe, _bucket->_id, *targetState);
     } else {
-        stdx::lock_guard statesLk{_catalog->_statesMutex};
-        auto statesIt = _catalog->_bucketStates.find(_bucket->_id);
-        if (statesIt != _catalog->_bucketStates.end()) {
+        stdx::lock_guard statesLk{_stripe->statesMutex};
+        auto statesIt = _stripe->bucketStates.find(_bucket->_id);
+        if (statesIt != _stripe->bucketStates.end()) {
             state = statesIt->second;
         }
     }
@@ -893,9 +1161,9 @@ BucketCatalog::BucketAccess::~BucketAccess() {
 BucketCatalog::BucketState BucketCatalog::BucketAccess::_findOpenBucketThenLock(
     const HashedBucketKey& key) {
     {
-        auto lk = _catalog->_lockShared();
-        auto it = _catalog->_openBuckets.find(key);
-        if (it == _catalog->_openBuckets.end()) {
+        stdx::lock_guard lk{_stripe->mutex};
+        auto it = _stripe->openBuckets.find(key);
+        if (it == _stripe->openBuckets.end()) {
             // Bucket does not exist.
             return BucketState::kCleared;
         }
@@ -913,9 +1181,9 @@ BucketCatalog::BucketState BucketCatalog::BucketAccess::_findOpenBucketThenLockA
     BSONObj nonNormalizedMetadata) {
     invariant(!isLocked());
     {
-        auto lk = _catalog->_lockExclusive();
-        auto it = _catalog->_openBuckets.find(normalizedKey);
-        if (it == _catalog->_openBuckets.end()) {
+        stdx::lock_guard lk{_stripe->mutex};
+        auto it = _stripe->openBuckets.find(normalizedKey);
+        if (it == _stripe->openBuckets.end()) {
             // Bucket does not exist.
             return BucketState::kCleared;
         }
@@ -927,10 +1195,10 @@ BucketCatalog::BucketState BucketCatalog::BucketAccess::_findOpenBucketThenLockA
         if (_bucket->_nonNormalizedKeyMetadatas.size() <
             _bucket->_nonNormalizedKeyMetadatas.capacity()) {
             auto [_, inserted] =
-                _catalog->_openBuckets.insert(std::make_pair(nonNormalizedKey, _bucket));
+                _stripe->openBuckets.insert(std::make_pair(nonNormalizedKey, _bucket));
             if (inserted) {
                 _bucket->_nonNormalizedKeyMetadatas.push_back(nonNormalizedMetadata);
-                // Increment the memory usage to store this key and value in _openBuckets
+                // Increment the memory usage to store this key and value in openBuckets
                 _bucket->_memoryUsage += nonNormalizedKey.key->ns.size() +
                     nonNormalizedMetadata.objsize() + sizeof(_bucket);
             }
@@ -941,14 +1209,14 @@ BucketCatalog::BucketState BucketCatalog::BucketAccess::_findOpenBucketThenLockA
 }
 
 BucketCatalog::BucketState BucketCatalog::BucketAccess::_confirmStateForAcquiredBucket() {
-    stdx::lock_guard statesLk{_catalog->_statesMutex};
-    auto statesIt = _catalog->_bucketStates.find(_bucket->_id);
-    invariant(statesIt != _catalog->_bucketStates.end());
+    stdx::lock_guard statesLk{_stripe->statesMutex};
+    auto statesIt = _stripe->bucketStates.find(_bucket->_id);
+    invariant(statesIt != _stripe->bucketStates.end());
     auto& [_, state] = *statesIt;
     if (state == BucketState::kCleared || state == BucketState::kPreparedAndCleared) {
         release();
     } else {
-        _catalog->_markBucketNotIdle(_bucket, false /* locked */);
+        _catalog->_markBucketNotIdle(_stripe, _bucket, false /* locked */);
     }
 
     return state;
@@ -956,8 +1224,8 @@ BucketCatalog::BucketState BucketCatalog::BucketAccess::_confirmStateForAcquired
 
 void BucketCatalog::BucketAccess::_findOrCreateOpenBucketThenLock(
     const HashedBucketKey& normalizedKey, const HashedBucketKey& nonNormalizedKey) {
-    auto it = _catalog->_openBuckets.find(normalizedKey);
-    if (it == _catalog->_openBuckets.end()) {
+    auto it = _stripe->openBuckets.find(normalizedKey);
+    if (it == _stripe->openBuckets.end()) {
         // No open bucket for this metadata.
         _create(normalizedKey, nonNormalizedKey);
         return;
@@ -967,17 +1235,17 @@ void BucketCatalog::BucketAccess::_findOrCreateOpenBucketThenLock(
     _acquire();
 
     {
-        stdx::lock_guard statesLk{_catalog->_statesMutex};
-        auto statesIt = _catalog->_bucketStates.find(_bucket->_id);
-        invariant(statesIt != _catalog->_bucketStates.end());
+        stdx::lock_guard statesLk{_stripe->statesMutex};
+        auto statesIt = _stripe->bucketStates.find(_bucket->_id);
+        invariant(statesIt != _stripe->bucketStates.end());
         auto& [_, state] = *statesIt;
         if (state == BucketState::kNormal || state == BucketState::kPrepared) {
-            _catalog->_markBucketNotIdle(_bucket, false /* locked */);
+            _catalog->_markBucketNotIdle(_stripe, _bucket, false /* locked */);
             return;
         }
     }
 
-    _catalog->_abort(_guard, _bucket, nullptr, boost::none);
+    _catalog->_abort(_stripe, _guard, _bucket, nullptr, boost::none);
     _create(normalizedKey, nonNormalizedKey);
 }
 
@@ -990,9 +1258,9 @@ void BucketCatalog::BucketAccess::_create(const HashedBucketKey& normalizedKey,
                                           const HashedBucketKey& nonNormalizedKey,
                                           bool openedDuetoMetadata) {
     invariant(_options);
-    _bucket =
-        _catalog->_allocateBucket(normalizedKey, *_time, *_options, _stats, openedDuetoMetadata);
-    _catalog->_openBuckets[nonNormalizedKey] = _bucket;
+    _bucket = _catalog->_allocateBucket(
+        _stripe, normalizedKey, *_time, *_options, _stats, openedDuetoMetadata);
+    _stripe->openBuckets[nonNormalizedKey] = _bucket;
     _bucket->_nonNormalizedKeyMetadatas.push_back(nonNormalizedKey.key->metadata.toBSON());
     _acquire();
 }
@@ -1036,7 +1304,7 @@ void BucketCatalog::BucketAccess::rollover(const std::function<bool(BucketAccess
                                       : _key->withCopiedMetadata(BSONObj());
     auto hashedKey = BucketHasher{}.hashed_key(prevBucketKey);
 
-    auto lk = _catalog->_lockExclusive();
+    stdx::lock_guard lk{_stripe->mutex};
     _findOrCreateOpenBucketThenLock(hashedNormalizedKey, hashedKey);
 
     // Recheck if still full now that we've reacquired the bucket.
@@ -1049,14 +1317,15 @@ void BucketCatalog::BucketAccess::rollover(const std::function<bool(BucketAccess
             // remove it now. Otherwise, we must keep the bucket around until it is committed.
             oldBucket = _bucket;
             release();
-            bool removed = _catalog->_removeBucket(oldBucket, false /* expiringBuckets */);
+            bool removed =
+                _catalog->_removeBucket(_stripe, oldBucket, false /* expiringBuckets */);
             invariant(removed);
         } else {
             _bucket->_full = true;
 
             // We will recreate a new bucket for the same key below. We also need to cleanup all
             // extra metadata keys added for the old bucket instance.
-            _catalog->_removeNonNormalizedKeysForBucket(_bucket);
+            _catalog->_removeNonNormalizedKeysForBucket(_stripe, _bucket);
             release();
         }
 
@@ -1071,7 +1340,7 @@ Date_t BucketCatalog::BucketAccess::getTime() const {
 BucketCatalog::WriteBatch::WriteBatch(Bucket* bucket,
                                       const UUID& lsid,
                                       const std::shared_ptr<ExecutionStats>& stats)
-    : _bucket{bucket}, _lsid(lsid), _stats{stats} {}
+    : _bucket{bucket}, _stripe{bucket->_stripe}, _lsid(lsid), _stats{stats} {}
 
 bool BucketCatalog::WriteBatch::claimCommitRights() {
     return !_commitRights.swap(true);
@@ -1219,23 +1488,32 @@ public:
 
     BSONObj generateSection(OperationContext* opCtx, const BSONElement&) const override {
         const auto& bucketCatalog = BucketCatalog::get(opCtx);
-        {
-            auto statsLk = bucketCatalog._statsMutex.lockShared();
-            if (bucketCatalog._executionStats.empty()) {
-                return {};
-            }
+
+        // The counts are gathered one stripe at a time, so they are not a point-in-time snapshot
+        // of the whole catalog.
+        bool hasStats = false;
+        long long numBuckets = 0;
+        long long numOpenBuckets = 0;
+        long long numIdleBuckets = 0;
+        for (const auto& stripe : bucketCatalog._stripes) {
+            stdx::lock_guard lk{stripe.mutex};
+            hasStats = hasStats || !stripe.executionStats.empty();
+            numBuckets += stripe.allBuckets.size();
+            numOpenBuckets += stripe.openBuckets.size();
+
+            stdx::lock_guard idleLk{stripe.idleMutex};
+            numIdleBuckets += stripe.idleBuckets.size();
+        }
+        if (!hasStats) {
+            return {};
         }
 
-        auto lk = bucketCatalog._lockShared();
         BSONObjBuilder builder;
-        builder.appendNumber("numBuckets",
-                             static_cast<long long>(bucketCatalog._allBuckets.size()));
-        builder.appendNumber("numOpenBuckets",
-                             static_cast<long long>(bucketCatalog._openBuckets.size()));
-        builder.appendNumber("numIdleBuckets",
-                             static_cast<long long>(bucketCatalog._numberOfIdleBuckets()));
+        builder.appendNumber("numBuckets", numBuckets);
+        builder.appendNumber("numOpenBuckets", numOpenBuckets);
+        builder.appendNumber("numIdleBuckets", numIdleBuckets);
         builder.appendNumber("memoryUsage",
-                             static_cast<long long>(bucketCatalog._memoryUsage.load()));
+                             static_cast<long long>(bucketCatalog._memoryUsage()));
         return builder.obj();
     }
 } bucketCatalogServerStatus;
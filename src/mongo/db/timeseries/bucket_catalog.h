@@ -65,6 +65,15 @@ public:
         boost::optional<OID> electionId;
     };
 
+    /**
+     * Identifies a bucket that has been closed, because it was full, once its last batch was
+     * committed. Nothing more will be written to the bucket by the catalog.
+     */
+    struct ClosedBucket {
+        OID bucketId;
+        NamespaceString ns;
+    };
+
     /**
      * The basic unit of work for a bucket. Each insert will return a shared_ptr to a WriteBatch.
      * When a writer is finished with all their insertions, they should then take steps to ensure
@@ -149,6 +158,11 @@ public:
 
 
         Bucket* _bucket;
+
+        // The stripe of the catalog that owns '_bucket'. Kept separately so that the bucket can be
+        // looked up again without dereferencing the pointer, which may have been freed.
+        const std::size_t _stripe;
+
         const UUID _lsid;
         std::shared_ptr<ExecutionStats> _stats;
 
@@ -173,14 +187,15 @@ public:
     BucketCatalog operator=(const BucketCatalog&) = delete;
 
     /**
-     * Returns the metadata for the given bucket in the following format:
+     * Returns the metadata for the bucket the given batch was inserted into in the following
+     * format:
      *     {<metadata field name>: <value>}
      * All measurements in the given bucket share same metadata value.
      *
      * Returns an empty document if the given bucket cannot be found or if this time-series
      * collection was not created with a metadata field name.
      */
-    BSONObj getMetadata(Bucket* bucket) const;
+    BSONObj getMetadata(const std::shared_ptr<WriteBatch>& batch) const;
 
     /**
      * Returns the WriteBatch into which the document was inserted. Any caller who receives the same
@@ -195,6 +210,32 @@ public:
         const BSONObj& doc,
         CombineWithInsertsFromOtherClients combine);
 
+    /**
+     * If the catalog has no open bucket for the series of the measurement 'doc', looks for a
+     * persisted bucket that can still hold it and makes it the open bucket of the series, so that
+     * the next insert of 'doc' appends to it instead of opening a new bucket. Only uncompressed
+     * buckets that are neither full nor being rewritten can be reopened.
+     *
+     * 'findBucket' is given a query over the buckets collection that matches the candidate buckets
+     * and should return any one of them. It is called without holding any catalog locks. Returns
+     * whether a bucket was reopened.
+     */
+    bool tryReopenBucket(
+        const NamespaceString& ns,
+        const StringData::ComparatorInterface* comparator,
+        const TimeseriesOptions& options,
+        const BSONObj& doc,
+        const std::function<boost::optional<BSONObj>(const BSONObj&)>& findBucket);
+
+    /**
+     * Claims the persisted bucket with the given id for a rewrite outside of the catalog, such as
+     * compression or merging. Fails if the bucket is currently open in the catalog, or already
+     * claimed. While claimed, the bucket cannot be reopened. Every successful claim must be
+     * followed by releaseBucketForRewrite().
+     */
+    bool claimBucketForRewrite(const OID& id);
+    void releaseBucketForRewrite(const OID& id);
+
     /**
      * Prepares a batch for commit, transitioning it to an inactive state. Caller must already have
      * commit rights on batch. Returns true if the batch was successfully prepared, or false if the
@@ -204,9 +245,10 @@ public:
 
     /**
      * Records the result of a batch commit. Caller must already have commit rights on batch, and
-     * batch must have been previously prepared.
+     * batch must have been previously prepared. Returns the bucket if this commit closed it.
      */
-    void finish(std::shared_ptr<WriteBatch> batch, const CommitInfo& info);
+    boost::optional<ClosedBucket> finish(std::shared_ptr<WriteBatch> batch,
+                                         const CommitInfo& info);
 
     /**
      * Aborts the given write batch and any other outstanding batches on the same bucket. Caller
@@ -222,6 +264,14 @@ public:
      */
     void clear(const OID& oid);
 
+    /**
+     * Clears the bucket with the specified OID as above, for a direct modification of the buckets
+     * collection by the operation 'opCtx'. Until that operation's storage transaction commits or
+     * rolls back, the persisted bucket cannot be reopened, since a reopen may read the bucket as
+     * it was before the modification. Must be called in a WriteUnitOfWork.
+     */
+    void clear(OperationContext* opCtx, const OID& oid);
+
     /**
      * Clears any bucket whose namespace satisfies the predicate.
      */
@@ -243,41 +293,7 @@ public:
     void appendExecutionStats(const NamespaceString& ns, BSONObjBuilder* builder) const;
 
 private:
-    /**
-     * This class provides a mutex with shared and exclusive locking semantics. Unlike some shared
-     * mutex implementations, it does not allow for writer starvation (assuming the underlying
-     * Mutex implemenation does not allow for starvation). The underlying mechanism is simply an
-     * array of Mutex instances. To take a shared lock, a thread's ID is hashed, mapping the thread
-     * to a particular mutex, which is then locked. To take an exclusive lock, all mutexes are
-     * locked.
-     *
-     * This behavior makes it easy to allow concurrent read access while still allowing writes to
-     * occur safely with exclusive access. It should only be used for situations where observed
-     * access patterns are read-mostly.
-     *
-     * A shared lock *cannot* be upgraded to an exclusive lock.
-     */
-    class StripedMutex {
-    public:
-        static constexpr std::size_t kNumStripes = 16;
-        StripedMutex() = default;
-
-        using SharedLock = stdx::unique_lock<Mutex>;
-        SharedLock lockShared() const;
-
-        class ExclusiveLock {
-        public:
-            ExclusiveLock() = default;
-            explicit ExclusiveLock(const StripedMutex&);
-
-        private:
-            std::array<stdx::unique_lock<Mutex>, kNumStripes> _locks;
-        };
-        ExclusiveLock lockExclusive() const;
-
-    private:
-        mutable std::array<Mutex, kNumStripes> _mutexes;
-    };
+    struct Stripe;
 
     struct BucketMetadata {
     public:
@@ -375,6 +391,9 @@ public:
         // The bucket ID for the underlying document
         OID _id = OID::gen();
 
+        // The stripe of the catalog that owns this bucket.
+        std::size_t _stripe = 0;
+
         // The namespace that this bucket is used for.
         NamespaceString _ns;
 
@@ -417,7 +436,7 @@ public:
         // Batches, per logical session, that haven't been committed or aborted yet.
         stdx::unordered_map<UUID, std::shared_ptr<WriteBatch>, UUID::Hash> _batches;
 
-        // If the bucket is in _idleBuckets, then its position is recorded here.
+        // If the bucket is in its stripe's idleBuckets, then its position is recorded here.
         boost::optional<IdleList::iterator> _idleListEntry = boost::none;
 
         // Approximate memory usage of this bucket.
@@ -429,6 +448,7 @@ private:
         AtomicWord<long long> numBucketInserts;
         AtomicWord<long long> numBucketUpdates;
         AtomicWord<long long> numBucketsOpenedDueToMetadata;
+        AtomicWord<long long> numBucketsReopened;
         AtomicWord<long long> numBucketsClosedDueToCount;
         AtomicWord<long long> numBucketsClosedDueToSize;
         AtomicWord<long long> numBucketsClosedDueToTimeForward;
@@ -546,11 +566,13 @@ private:
     public:
         BucketAccess() = delete;
         BucketAccess(BucketCatalog* catalog,
+                     Stripe* stripe,
                      BucketKey& key,
                      const TimeseriesOptions& options,
                      ExecutionStats* stats,
                      const Date_t& time);
         BucketAccess(BucketCatalog* catalog,
+                     Stripe* stripe,
                      Bucket* bucket,
                      boost::optional<BucketState> targetState = boost::none);
         ~BucketAccess();
@@ -560,7 +582,7 @@ private:
         operator bool() const;
         operator Bucket*() const;
 
-        // Release the bucket lock, typically in order to reacquire the catalog lock.
+        // Release the bucket lock, typically in order to reacquire the stripe lock.
         void release();
 
         /**
@@ -576,17 +598,16 @@ private:
 
     private:
         /**
-         * Helper to find and lock an open bucket for the given metadata if it exists. Takes a
-         * shared lock on the catalog. Returns the state of the bucket if it is locked and usable.
+         * Helper to find and lock an open bucket for the given metadata if it exists. Takes the
+         * stripe lock. Returns the state of the bucket if it is locked and usable.
          * In case the bucket does not exist or was previously cleared and thus is not usable, the
          * return value will be BucketState::kCleared.
          */
         BucketState _findOpenBucketThenLock(const HashedBucketKey& key);
 
         /**
-         * Same as _findOpenBucketThenLock above but takes an exclusive lock on the catalog. In
-         * addition to finding the bucket it also store a non-normalized key if there are available
-         * slots in the bucket.
+         * Same as _findOpenBucketThenLock above, but in addition to finding the bucket it also
+         * stores a non-normalized key if there are available slots in the bucket.
          */
         BucketState _findOpenBucketThenLockAndStoreKey(const HashedBucketKey& normalizedKey,
                                                        const HashedBucketKey& key,
@@ -600,7 +621,7 @@ private:
         BucketState _confirmStateForAcquiredBucket();
 
         // Helper to find an open bucket for the given metadata if it exists, create it if it
-        // doesn't, and lock it. Requires an exclusive lock on the catalog.
+        // doesn't, and lock it. Requires the stripe lock.
         void _findOrCreateOpenBucketThenLock(const HashedBucketKey& normalizedKey,
                                              const HashedBucketKey& key);
 
@@ -614,6 +635,7 @@ private:
                      bool openedDuetoMetadata = true);
 
         BucketCatalog* _catalog;
+        Stripe* _stripe;
         BucketKey* _key = nullptr;
         const TimeseriesOptions* _options = nullptr;
         ExecutionStats* _stats = nullptr;
@@ -623,29 +645,76 @@ private:
         stdx::unique_lock<Mutex> _guard;
     };
 
+    /**
+     * An independent partition of the catalog. Every bucket lives in the stripe chosen by hashing
+     * its namespace and metadata, so writers to different series never share a lock, an idle list,
+     * or a stats counter. Catalog-wide figures are aggregated over the stripes when requested.
+     *
+     * You must hold 'mutex' when accessing 'allBuckets', 'openBuckets' or 'executionStats'. While
+     * holding it, you can take a lock on an individual bucket, then release 'mutex'. Any iterators
+     * on the protected structures should be considered invalid once the lock is released. You must
+     * *not* be holding a lock on a bucket when you attempt to acquire 'mutex', as this can result
+     * in deadlock. 'statesMutex' and 'idleMutex' may be taken while holding a bucket lock.
+     *
+     * Typically, if you want to acquire a bucket, you should use the BucketAccess RAII class to do
+     * so, as it will take care of most of this logic for you. Only use 'mutex' directly for more
+     * global maintenance where you want to take the lock once and interact with multiple buckets
+     * atomically.
+     */
+    struct Stripe {
+        mutable Mutex mutex = MONGO_MAKE_LATCH("BucketCatalog::Stripe::mutex");
+
+        // All buckets currently in the stripe, including buckets which are full but not yet
+        // committed.
+        stdx::unordered_set<std::unique_ptr<Bucket>> allBuckets;
+
+        // The current open bucket for each namespace and metadata pair.
+        stdx::unordered_map<BucketKey, Bucket*, BucketHasher, BucketEq> openBuckets;
+
+        // Per-namespace execution stats for the buckets of this stripe. Once you complete your
+        // lookup, you can keep the shared_ptr to an individual namespace's stats object and release
+        // the lock. The object itself is thread-safe (using atomics).
+        stdx::unordered_map<NamespaceString, std::shared_ptr<ExecutionStats>> executionStats;
+
+        // Bucket state
+        mutable Mutex statesMutex = MONGO_MAKE_LATCH("BucketCatalog::Stripe::statesMutex");
+        stdx::unordered_map<OID, BucketState, OID::Hasher> bucketStates;
+
+        // Buckets that do not have any writers, protected by 'idleMutex'.
+        mutable Mutex idleMutex = MONGO_MAKE_LATCH("BucketCatalog::Stripe::idleMutex");
+        IdleList idleBuckets;
+
+        // Approximate memory usage of the buckets in this stripe.
+        AtomicWord<uint64_t> memoryUsage;
+    };
+
     class ServerStatus;
 
-    StripedMutex::SharedLock _lockShared() const;
-    StripedMutex::ExclusiveLock _lockExclusive() const;
+    /**
+     * Returns the stripe that owns buckets with the given key. Equal keys map to the same stripe
+     * whether or not their metadata has been normalized.
+     */
+    Stripe* _getStripe(const BucketKey& key);
 
     void _waitToCommitBatch(const std::shared_ptr<WriteBatch>& batch);
 
     /**
      * Removes the given bucket from the bucket catalog's internal data structures.
      */
-    bool _removeBucket(Bucket* bucket, bool expiringBuckets);
+    bool _removeBucket(Stripe* stripe, Bucket* bucket, bool expiringBuckets);
 
     /**
      * Removes extra non-normalized BucketKey's for the given bucket from the
      * bucket catalog's internal data structures.
      */
-    void _removeNonNormalizedKeysForBucket(Bucket* bucket);
+    void _removeNonNormalizedKeysForBucket(Stripe* stripe, Bucket* bucket);
 
     /**
      * Aborts any batches it can for the given bucket, then removes the bucket. If batch is
      * non-null, it is assumed that the caller has commit rights for that batch.
      */
-    void _abort(stdx::unique_lock<Mutex>& lk,
+    void _abort(Stripe* stripe,
+                stdx::unique_lock<Mutex>& lk,
                 Bucket* bucket,
                 std::shared_ptr<WriteBatch> batch,
                 const boost::optional<Status>& status);
@@ -653,38 +722,53 @@ private:
     /**
      * Adds the bucket to a list of idle buckets to be expired at a later date
      */
-    void _markBucketIdle(Bucket* bucket);
+    void _markBucketIdle(Stripe* stripe, Bucket* bucket);
 
     /**
-     * Remove the bucket from the list of idle buckets. The second parameter encodes whether the
-     * caller holds a lock on _idleMutex.
+     * Remove the bucket from the list of idle buckets. The last parameter encodes whether the
+     * caller holds a lock on the stripe's idleMutex.
      */
-    void _markBucketNotIdle(Bucket* bucket, bool locked);
+    void _markBucketNotIdle(Stripe* stripe, Bucket* bucket, bool locked);
 
     /**
-     * Verify the bucket is currently unused by taking a lock on it. Must hold exclusive lock from
+     * Verify the bucket is currently unused by taking a lock on it. Must hold the stripe lock from
      * the outside for the result to be meaningful.
      */
     void _verifyBucketIsUnused(Bucket* bucket) const;
 
     /**
-     * Expires idle buckets until the bucket catalog's memory usage is below the expiry threshold.
+     * Expires idle buckets until the bucket catalog's memory usage is below the expiry threshold,
+     * starting with those of the given stripe and falling back to the stripes that are not locked
+     * by another thread. Must hold the lock on the given stripe.
+     */
+    void _expireIdleBuckets(Stripe* stripe, ExecutionStats* stats);
+
+    /**
+     * Expires idle buckets of the given stripe until the bucket catalog's memory usage is below
+     * the expiry threshold, and returns whether it is. Returns false if the stripe runs out of idle
+     * buckets first. Must hold the lock on the stripe.
      */
-    void _expireIdleBuckets(ExecutionStats* stats);
+    bool _expireIdleBucketsOfStripe(Stripe* stripe, ExecutionStats* stats);
 
-    std::size_t _numberOfIdleBuckets() const;
+    /**
+     * Returns the approximate memory usage of the whole catalog, summed over the stripes.
+     */
+    uint64_t _memoryUsage() const;
 
-    // Allocate a new bucket (and ID) and add it to the catalog
-    Bucket* _allocateBucket(const BucketKey& key,
+    // Allocate a new bucket (and ID) and add it to the stripe
+    Bucket* _allocateBucket(Stripe* stripe,
+                            const BucketKey& key,
                             const Date_t& time,
                             const TimeseriesOptions& options,
                             ExecutionStats* stats,
                             bool openedDuetoMetadata);
 
-    std::shared_ptr<ExecutionStats> _getExecutionStats(const NamespaceString& ns);
-    const std::shared_ptr<ExecutionStats> _getExecutionStats(const NamespaceString& ns) const;
+    std::shared_ptr<ExecutionStats> _getExecutionStats(Stripe* stripe, const NamespaceString& ns);
 
-    void _setIdTimestamp(Bucket* bucket, const Date_t& time, const TimeseriesOptions& options);
+    void _setIdTimestamp(Stripe* stripe,
+                         Bucket* bucket,
+                         const Date_t& time,
+                         const TimeseriesOptions& options);
 
     /**
      * Changes the bucket state, taking into account the current state, the specified target state,
@@ -694,59 +778,18 @@ private:
      * Ex. For a bucket with state kPrepared, and a target of kCleared, the return will be
      * kPreparedAndCleared.
      */
-    boost::optional<BucketState> _setBucketState(const OID& id, BucketState target);
-
-    /**
-     * You must hold a lock on _bucketMutex when accessing _allBuckets or _openBuckets.
-     * While holding a lock on _bucketMutex, you can take a lock on an individual bucket, then
-     * release _bucketMutex. Any iterators on the protected structures should be considered invalid
-     * once the lock is released. Any subsequent access to the structures requires relocking
-     * _bucketMutex. You must *not* be holding a lock on a bucket when you attempt to acquire the
-     * lock on _mutex, as this can result in deadlock.
-     *
-     * The StripedMutex class has both shared (read-only) and exclusive (write) locks. If you are
-     * going to write to any of the protected structures, you must hold an exclusive lock.
-     *
-     * Typically, if you want to acquire a bucket, you should use the BucketAccess RAII
-     * class to do so, as it will take care of most of this logic for you. Only use the _bucketMutex
-     * directly for more global maintenance where you want to take the lock once and interact with
-     * multiple buckets atomically.
-     */
-    mutable StripedMutex _bucketMutex;
-
-    // All buckets currently in the catalog, including buckets which are full but not yet committed.
-    stdx::unordered_set<std::unique_ptr<Bucket>> _allBuckets;
-
-    // The current open bucket for each namespace and metadata pair.
-    stdx::unordered_map<BucketKey, Bucket*, BucketHasher, BucketEq> _openBuckets;
-
-    // Bucket state
-    mutable Mutex _statesMutex = MONGO_MAKE_LATCH("BucketCatalog::_statesMutex");
-    stdx::unordered_map<OID, BucketState, OID::Hasher> _bucketStates;
-
-    // This mutex protects access to _idleBuckets
-    mutable Mutex _idleMutex = MONGO_MAKE_LATCH("BucketCatalog::_idleMutex");
-
-    // Buckets that do not have any writers.
-    IdleList _idleBuckets;
-
-    /**
-     * This mutex protects access to the _executionStats map. Once you complete your lookup, you
-     * can keep the shared_ptr to an individual namespace's stats object and release the lock. The
-     * object itself is thread-safe (using atomics).
-     */
-    mutable StripedMutex _statsMutex;
-
-    // Per-namespace execution stats.
-    stdx::unordered_map<NamespaceString, std::shared_ptr<ExecutionStats>> _executionStats;
-
-    // A placeholder to be returned in case a namespace has no allocated statistics object
-    static const std::shared_ptr<ExecutionStats> kEmptyStats;
-
-    // Counter for buckets created by the bucket catalog.
-    uint64_t _bucketNum = 0;
-
-    // Approximate memory usage of the bucket catalog.
-    AtomicWord<uint64_t> _memoryUsage;
+    boost::optional<BucketState> _setBucketState(Stripe* stripe, const OID& id, BucketState target);
+
+    static constexpr std::size_t kNumberOfStripes = 32;
+    std::array<Stripe, kNumberOfStripes> _stripes;
+
+    // Persisted buckets claimed for a rewrite, persisted buckets with direct modifications in
+    // progress and how many of each, and the number of rewrites and modifications finished so far,
+    // which lets a reopen notice that the bucket it read may have changed in the meantime. The
+    // mutex may be taken while holding a stripe lock, but not while holding a bucket lock.
+    mutable Mutex _rewriteMutex = MONGO_MAKE_LATCH("BucketCatalog::_rewriteMutex");
+    stdx::unordered_set<OID, OID::Hasher> _bucketsBeingRewritten;
+    stdx::unordered_map<OID, int, OID::Hasher> _bucketsBeingModified;
+    uint64_t _numOutsideWritesFinished = 0;
 };
 }  // namespace mongo
@@ -34,11 +34,13 @@
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/stdx/future.h"
 #include "mongo/unittest/bson_test_util.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -71,6 +73,17 @@ protected:
 
     long long _getNumWaits(const NamespaceString& ns);
 
+    /**
+     * Returns a persisted bucket of the series 'meta' in _ns1 holding a single measurement at
+     * 'time', as the bucket catalog would have written it.
+     */
+    BSONObj _makePersistedBucket(const OID& id, Date_t time, int meta) const;
+
+    bool _tryReopenBucket(
+        const BSONObj& doc,
+        const std::function<boost::optional<BSONObj>(const BSONObj&)>& findBucket);
+    std::shared_ptr<BucketCatalog::WriteBatch> _insert(const BSONObj& doc);
+
     OperationContext* _opCtx;
     BucketCatalog* _bucketCatalog;
 
@@ -167,6 +180,36 @@ long long BucketCatalogTest::_getNumWaits(const NamespaceString& ns) {
     return builder.obj().getIntField("numWaits");
 }
 
+BSONObj BucketCatalogTest::_makePersistedBucket(const OID& id, Date_t time, int meta) const {
+    return BSON("_id" << id << "control"
+                      << BSON("version" << 1 << "min" << BSON(_timeField << time) << "max"
+                                        << BSON(_timeField << time))
+                      << "meta" << meta << "data" << BSON(_timeField << BSON("0" << time)));
+}
+
+bool BucketCatalogTest::_tryReopenBucket(
+    const BSONObj& doc, const std::function<boost::optional<BSONObj>(const BSONObj&)>& findBucket) {
+    return _bucketCatalog->tryReopenBucket(
+        _ns1, _getCollator(_ns1), _getTimeseriesOptions(_ns1), doc, findBucket);
+}
+
+std::shared_ptr<BucketCatalog::WriteBatch> BucketCatalogTest::_insert(const BSONObj& doc) {
+    return _bucketCatalog
+        ->insert(_opCtx,
+                 _ns1,
+                 _getCollator(_ns1),
+                 _getTimeseriesOptions(_ns1),
+                 doc,
+                 BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+        .getValue();
+}
+
+OID makeBucketId(Date_t time) {
+    auto id = OID::gen();
+    id.setTimestamp(durationCount<Seconds>(time.toDurationSinceEpoch()));
+    return id;
+}
+
 TEST_F(BucketCatalogTest, InsertIntoSameBucket) {
     // The first insert should be able to take commit rights, but batch is still active
     auto result1 =
@@ -224,9 +267,8 @@ TEST_F(BucketCatalogTest, GetMetadataReturnsEmptyDocOnMissingBucket) {
                               BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
                      .getValue();
     ASSERT(batch->claimCommitRights());
-    auto bucket = batch->bucket();
     _bucketCatalog->abort(batch);
-    ASSERT_BSONOBJ_EQ(BSONObj(), _bucketCatalog->getMetadata(bucket));
+    ASSERT_BSONOBJ_EQ(BSONObj(), _bucketCatalog->getMetadata(batch));
 }
 
 TEST_F(BucketCatalogTest, InsertIntoDifferentBuckets) {
@@ -259,10 +301,10 @@ TEST_F(BucketCatalogTest, InsertIntoDifferentBuckets) {
 
     // Check metadata in buckets.
     ASSERT_BSONOBJ_EQ(BSON(_metaField << "123"),
-                      _bucketCatalog->getMetadata(result1.getValue()->bucket()));
+                      _bucketCatalog->getMetadata(result1.getValue()));
     ASSERT_BSONOBJ_EQ(BSON(_metaField << BSONObj()),
-                      _bucketCatalog->getMetadata(result2.getValue()->bucket()));
-    ASSERT(_bucketCatalog->getMetadata(result3.getValue()->bucket()).isEmpty());
+                      _bucketCatalog->getMetadata(result2.getValue()));
+    ASSERT(_bucketCatalog->getMetadata(result3.getValue()).isEmpty());
 
     // Committing one bucket should only return the one document in that bucket and should not
     // affect the other bucket.
@@ -292,8 +334,8 @@ TEST_F(BucketCatalogTest, InsertNullAndMissingMetaFieldIntoDifferentBuckets) {
 
     // Check metadata in buckets.
     ASSERT_BSONOBJ_EQ(BSON(_metaField << BSONNULL),
-                      _bucketCatalog->getMetadata(result1.getValue()->bucket()));
-    ASSERT(_bucketCatalog->getMetadata(result2.getValue()->bucket()).isEmpty());
+                      _bucketCatalog->getMetadata(result1.getValue()));
+    ASSERT(_bucketCatalog->getMetadata(result2.getValue()).isEmpty());
 
     // Committing one bucket should only return the one document in that bucket and should not
     // affect the other bucket.
@@ -302,6 +344,91 @@ TEST_F(BucketCatalogTest, InsertNullAndMissingMetaFieldIntoDifferentBuckets) {
     }
 }
 
+TEST_F(BucketCatalogTest, ReorderedMetadataFieldsShareBucket) {
+    // Buckets are partitioned by a hash of their metadata, which must not depend on field order so
+    // that both orders are routed to the same partition and find the same bucket.
+    auto meta1 = BSON("a" << 1 << "b" << BSON("c" << 1 << "d" << 2));
+    auto meta2 = BSON("b" << BSON("d" << 2 << "c" << 1) << "a" << 1);
+    auto batch1 = _bucketCatalog
+                      ->insert(_opCtx,
+                               _ns1,
+                               _getCollator(_ns1),
+                               _getTimeseriesOptions(_ns1),
+                               BSON(_timeField << Date_t::now() << _metaField << meta1),
+                               BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+                      .getValue();
+    auto batch2 = _bucketCatalog
+                      ->insert(_opCtx,
+                               _ns1,
+                               _getCollator(_ns1),
+                               _getTimeseriesOptions(_ns1),
+                               BSON(_timeField << Date_t::now() << _metaField << meta2),
+                               BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+                      .getValue();
+    ASSERT_EQ(batch1, batch2);
+    _commit(batch1, 0, 2);
+}
+
+TEST_F(BucketCatalogTest, ExecutionStatsAggregateAcrossMetadataValues) {
+    // Distinct metadata values are spread over the partitions of the catalog, each of which keeps
+    // its own counters. The reported stats must still cover all of them.
+    const int numMetadataValues = 100;
+    for (int i = 0; i < numMetadataValues; ++i) {
+        auto batch = _bucketCatalog
+                         ->insert(_opCtx,
+                                  _ns1,
+                                  _getCollator(_ns1),
+                                  _getTimeseriesOptions(_ns1),
+                                  BSON(_timeField << Date_t::now() << _metaField << i),
+                                  BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+                         .getValue();
+        _commit(batch, 0);
+    }
+    _insertOneAndCommit(_ns2, 0);
+
+    BSONObjBuilder builder;
+    _bucketCatalog->appendExecutionStats(_ns1, &builder);
+    auto stats = builder.obj();
+    ASSERT_EQ(stats.getIntField("numBucketInserts"), numMetadataValues);
+    ASSERT_EQ(stats.getIntField("numBucketsOpenedDueToMetadata"), numMetadataValues);
+    ASSERT_EQ(stats.getIntField("numCommits"), numMetadataValues);
+    ASSERT_EQ(stats.getIntField("numMeasurementsCommitted"), numMetadataValues);
+
+    _bucketCatalog->clear(_ns1);
+    BSONObjBuilder clearedBuilder;
+    _bucketCatalog->appendExecutionStats(_ns1, &clearedBuilder);
+    ASSERT_EQ(clearedBuilder.obj().getIntField("numCommits"), 0);
+}
+
+TEST_F(BucketCatalogTest, IdleBucketsOfOtherStripesAreExpired) {
+    // Distinct metadata values are spread over the stripes of the catalog, so their idle buckets
+    // end up in most of them.
+    const int numMetadataValues = 100;
+    for (int i = 0; i < numMetadataValues; ++i) {
+        auto batch = _bucketCatalog
+                         ->insert(_opCtx,
+                                  _ns1,
+                                  _getCollator(_ns1),
+                                  _getTimeseriesOptions(_ns1),
+                                  BSON(_timeField << Date_t::now() << _metaField << i),
+                                  BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+                         .getValue();
+        _commit(batch, 0);
+    }
+
+    // Once the catalog is over the threshold, the next bucket allocated expires every idle bucket,
+    // not only those of the stripe it is allocated in.
+    auto threshold = gTimeseriesIdleBucketExpiryMemoryUsageThreshold;
+    gTimeseriesIdleBucketExpiryMemoryUsageThreshold = 1;
+    ON_BLOCK_EXIT([&] { gTimeseriesIdleBucketExpiryMemoryUsageThreshold = threshold; });
+    _insertOneAndCommit(_ns2, 0);
+
+    BSONObjBuilder builder;
+    _bucketCatalog->appendExecutionStats(_ns2, &builder);
+    ASSERT_EQ(builder.obj().getIntField("numBucketsClosedDueToMemoryThreshold"),
+              numMetadataValues);
+}
+
 TEST_F(BucketCatalogTest, NumCommittedMeasurementsAccumulates) {
     // The numCommittedMeasurements returned when committing should accumulate as more entries in
     // the bucket are committed.
@@ -396,7 +523,7 @@ TEST_F(BucketCatalogWithoutMetadataTest, GetMetadataReturnsEmptyDoc) {
                               BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
                      .getValue();
 
-    ASSERT_BSONOBJ_EQ(BSONObj(), _bucketCatalog->getMetadata(batch->bucket()));
+    ASSERT_BSONOBJ_EQ(BSONObj(), _bucketCatalog->getMetadata(batch));
 
     _commit(batch, 0);
 }
@@ -781,5 +908,118 @@ TEST_F(BucketCatalogTest, DuplicateNewFieldNamesAcrossConcurrentBatches) {
     _bucketCatalog->finish(batch1, {});
 }
 
+TEST_F(BucketCatalogTest, ReopenedBucketTakesTheNextMeasurement) {
+    auto time = Date_t::now();
+    auto id = makeBucketId(time);
+    auto doc = BSON(_timeField << time << _metaField << 1);
+
+    ASSERT(_tryReopenBucket(doc, [&](const BSONObj&) -> boost::optional<BSONObj> {
+        return _makePersistedBucket(id, time, 1);
+    }));
+
+    auto batch = _insert(doc);
+    ASSERT_EQ(batch->bucket()->id(), id);
+    _commit(batch, 1);
+
+    // The series has an open bucket now, so no persisted bucket is looked up.
+    ASSERT_FALSE(_tryReopenBucket(doc, [&](const BSONObj&) -> boost::optional<BSONObj> {
+        FAIL("Looked up a bucket for a series with an open bucket");
+        return boost::none;
+    }));
+}
+
+TEST_F(BucketCatalogTest, ReopenRejectsUnexpectedBuckets) {
+    auto time = Date_t::now();
+    auto id = makeBucketId(time);
+    auto doc = BSON(_timeField << time << _metaField << 1);
+    auto reopen = [&](const BSONObj& bucket) {
+        return _tryReopenBucket(
+            doc, [&](const BSONObj&) -> boost::optional<BSONObj> { return bucket; });
+    };
+
+    // A bucket of another series.
+    ASSERT_FALSE(reopen(_makePersistedBucket(id, time, 2)));
+    // A compressed bucket.
+    ASSERT_FALSE(reopen(_makePersistedBucket(id, time, 1).addFields(BSON(
+        "control" << BSON("version" << 2 << "min" << BSON(_timeField << time) << "max"
+                                    << BSON(_timeField << time))))));
+    // A bucket whose time range cannot cover the measurement.
+    ASSERT_FALSE(reopen(_makePersistedBucket(makeBucketId(time + Hours(2)), time, 1)));
+    // No bucket at all.
+    ASSERT_FALSE(
+        _tryReopenBucket(doc, [](const BSONObj&) -> boost::optional<BSONObj> { return {}; }));
+
+    ASSERT(reopen(_makePersistedBucket(id, time, 1)));
+}
+
+TEST_F(BucketCatalogTest, ClaimedBucketIsNotReopened) {
+    auto time = Date_t::now();
+    auto id = makeBucketId(time);
+    auto doc = BSON(_timeField << time << _metaField << 1);
+    auto findBucket = [&](const BSONObj&) -> boost::optional<BSONObj> {
+        return _makePersistedBucket(id, time, 1);
+    };
+
+    ASSERT(_bucketCatalog->claimBucketForRewrite(id));
+    ASSERT_FALSE(_bucketCatalog->claimBucketForRewrite(id));
+    ASSERT_FALSE(_tryReopenBucket(doc, findBucket));
+
+    _bucketCatalog->releaseBucketForRewrite(id);
+    ASSERT(_tryReopenBucket(doc, findBucket));
+
+    // A bucket that is open in the catalog cannot be claimed.
+    ASSERT_FALSE(_bucketCatalog->claimBucketForRewrite(id));
+}
+
+TEST_F(BucketCatalogTest, ReopenIsCancelledByRewriteWhileReadingTheBucket) {
+    auto time = Date_t::now();
+    auto id = makeBucketId(time);
+    auto doc = BSON(_timeField << time << _metaField << 1);
+
+    ASSERT_FALSE(_tryReopenBucket(doc, [&](const BSONObj&) -> boost::optional<BSONObj> {
+        auto bucket = _makePersistedBucket(id, time, 1);
+        ASSERT(_bucketCatalog->claimBucketForRewrite(id));
+        _bucketCatalog->releaseBucketForRewrite(id);
+        return bucket;
+    }));
+}
+
+TEST_F(BucketCatalogTest, ReopenIsCancelledByDirectModification) {
+    auto time = Date_t::now();
+    auto id = makeBucketId(time);
+    auto doc = BSON(_timeField << time << _metaField << 1);
+    auto findBucket = [&](const BSONObj&) -> boost::optional<BSONObj> {
+        return _makePersistedBucket(id, time, 1);
+    };
+
+    // The bucket read may predate a modification that has not committed yet.
+    {
+        WriteUnitOfWork wuow(_opCtx);
+        _bucketCatalog->clear(_opCtx, id);
+        ASSERT_FALSE(_tryReopenBucket(doc, findBucket));
+    }
+
+    // Or one that committed while the bucket was being read.
+    ASSERT_FALSE(_tryReopenBucket(doc, [&](const BSONObj& query) {
+        auto bucket = findBucket(query);
+        WriteUnitOfWork wuow(_opCtx);
+        _bucketCatalog->clear(_opCtx, id);
+        wuow.commit();
+        return bucket;
+    }));
+
+    ASSERT(_tryReopenBucket(doc, findBucket));
+
+    // A modification once the bucket is open clears it, so the next measurement opens a new one.
+    {
+        WriteUnitOfWork wuow(_opCtx);
+        _bucketCatalog->clear(_opCtx, id);
+        wuow.commit();
+    }
+    auto batch = _insert(doc);
+    ASSERT_NE(batch->bucket()->id(), id);
+    _commit(batch, 0);
+}
+
 }  // namespace
 }  // namespace mongo
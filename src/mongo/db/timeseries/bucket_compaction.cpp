@@ -0,0 +1,530 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_compaction.h"
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/record_id_helpers.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/db/timeseries/bucket_compression.h"
+#include "mongo/db/timeseries/minmax.h"
+#include "mongo/db/timeseries/timeseries_constants.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
+#include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo::timeseries {
+
+namespace {
+
+// Bounds the number of closed buckets waiting to be compressed.
+constexpr size_t kMaxBucketsQueuedForCompression = 10000;
+
+struct CompressionQueue {
+    Mutex mutex = MONGO_MAKE_LATCH("CompressionQueue::mutex");
+    std::deque<BucketCatalog::ClosedBucket> buckets;
+};
+
+const auto getCompressionQueue = ServiceContext::declareDecoration<CompressionQueue>();
+
+// Where the next compaction pass over each collection picks up, for collections whose last pass
+// stopped before reaching the end.
+struct CompactionResumePositions {
+    Mutex mutex = MONGO_MAKE_LATCH("CompactionResumePositions::mutex");
+    stdx::unordered_map<UUID, RecordId, UUID::Hash> positions;
+};
+
+const auto getCompactionResumePositions =
+    ServiceContext::declareDecoration<CompactionResumePositions>();
+
+bool isBucketCompressionEnabled() {
+    // (Generic FCV reference): Compressed buckets cannot be read by binaries of an earlier version,
+    // so they are only written once the FCV is fully upgraded.
+    return gTimeseriesBucketCompression.load() &&
+        serverGlobalParams.featureCompatibility.isVersionInitialized() &&
+        serverGlobalParams.featureCompatibility.getVersion() ==
+        ServerGlobalParams::FeatureCompatibility::kLatest;
+}
+
+/**
+ * Appends the fields of 'column', which are keyed by measurement index, to 'builder' with their
+ * index shifted by 'offset'. Returns false if any of the keys is not a valid index.
+ */
+bool appendShiftedColumn(const BSONObj& column, unsigned int offset, BSONObjBuilder* builder) {
+    for (auto&& elem : column) {
+        unsigned int index;
+        if (!NumberParser{}.base(10)(elem.fieldNameStringData(), &index).isOK()) {
+            return false;
+        }
+        builder->appendAs(elem, std::to_string(index + offset));
+    }
+    return true;
+}
+
+RecordId findBucketRecord(OperationContext* opCtx, const CollectionPtr& coll, const OID& id) {
+    // TODO (SERVER-56270): Remove handling for non-clustered time-series collections.
+    return coll->isClustered() ? record_id_helpers::keyForOID(id)
+                               : Helpers::findOne(opCtx, coll, BSON("_id" << id), false);
+}
+
+/**
+ * Merges the bucket 'sourceId' into the bucket 'targetId', which must be the earlier of the two,
+ * and deletes it, if the result stays within the bucket limits. Both buckets are claimed in the
+ * bucket catalog for the duration, so that neither can be reopened concurrently.
+ */
+bool mergeBucketInto(OperationContext* opCtx,
+                     const NamespaceString& bucketsNs,
+                     const OID& targetId,
+                     const OID& sourceId) {
+    auto& bucketCatalog = BucketCatalog::get(opCtx);
+    if (!bucketCatalog.claimBucketForRewrite(targetId)) {
+        return false;
+    }
+    ON_BLOCK_EXIT([&] { bucketCatalog.releaseBucketForRewrite(targetId); });
+    if (!bucketCatalog.claimBucketForRewrite(sourceId)) {
+        return false;
+    }
+    ON_BLOCK_EXIT([&] { bucketCatalog.releaseBucketForRewrite(sourceId); });
+
+    return writeConflictRetry(opCtx, "compactTimeseriesBuckets", bucketsNs.ns(), [&] {
+        AutoGetCollection coll(opCtx, bucketsNs, MODE_IX);
+        if (!coll || !coll->getTimeseriesOptions() ||
+            !repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, bucketsNs)) {
+            return false;
+        }
+        const auto& options = *coll->getTimeseriesOptions();
+
+        auto targetRecordId = findBucketRecord(opCtx, *coll, targetId);
+        auto sourceRecordId = findBucketRecord(opCtx, *coll, sourceId);
+        Snapshotted<BSONObj> target;
+        Snapshotted<BSONObj> source;
+        if (targetRecordId.isNull() || sourceRecordId.isNull() ||
+            !coll->findDoc(opCtx, targetRecordId, &target) ||
+            !coll->findDoc(opCtx, sourceRecordId, &source)) {
+            return false;
+        }
+
+        auto merged = mergeBuckets(
+            target.value(), source.value(), options.getTimeField(), coll->getDefaultCollator());
+        if (!merged) {
+            return false;
+        }
+
+        // The merged bucket must be one the bucket catalog could have written itself.
+        auto timeColumn = dotted_path_support::extractElementAtPath(
+            *merged, str::stream() << kBucketDataFieldName << "." << options.getTimeField());
+        auto maxTime = dotted_path_support::extractElementAtPath(
+            *merged, str::stream() << kControlMaxFieldNamePrefix << options.getTimeField());
+        if (timeColumn.type() != BSONType::Object || maxTime.type() != BSONType::Date ||
+            timeColumn.Obj().nFields() > gTimeseriesBucketMaxCount ||
+            merged->objsize() > gTimeseriesBucketMaxSize ||
+            maxTime.Date() - targetId.asDateT() >= Seconds(*options.getBucketMaxSpanSeconds())) {
+            return false;
+        }
+
+        WriteUnitOfWork wuow(opCtx);
+        CollectionUpdateArgs args;
+        args.criteria = BSON("_id" << targetId);
+        args.update = *merged;
+        args.preImageDoc = target.value();
+        args.source = OperationSource::kTimeseries;
+        coll->updateDocument(opCtx,
+                             targetRecordId,
+                             target,
+                             *merged,
+                             true /* indexesAffected */,
+                             nullptr /* opDebug */,
+                             &args);
+        coll->deleteDocument(opCtx, source, kUninitializedStmtId, sourceRecordId, nullptr);
+        wuow.commit();
+        return true;
+    });
+}
+
+/**
+ * Rewrites the closed bucket 'bucketId' with each of its columns compressed. The bucket is claimed
+ * in the bucket catalog for the duration, so that it cannot be reopened concurrently.
+ */
+bool compressClosedBucket(OperationContext* opCtx,
+                          const NamespaceString& bucketsNs,
+                          const OID& bucketId) {
+    // A bucket that has been reopened since it was closed is queued again once it is closed again.
+    auto& bucketCatalog = BucketCatalog::get(opCtx);
+    if (!bucketCatalog.claimBucketForRewrite(bucketId)) {
+        return false;
+    }
+    ON_BLOCK_EXIT([&] { bucketCatalog.releaseBucketForRewrite(bucketId); });
+
+    return writeConflictRetry(opCtx, "compressTimeseriesBucket", bucketsNs.ns(), [&] {
+        AutoGetCollection coll(opCtx, bucketsNs, MODE_IX);
+        if (!coll || !coll->getTimeseriesOptions() ||
+            !repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, bucketsNs) ||
+            !isBucketCompressionEnabled()) {
+            return false;
+        }
+
+        auto recordId = findBucketRecord(opCtx, *coll, bucketId);
+        Snapshotted<BSONObj> bucket;
+        if (recordId.isNull() || !coll->findDoc(opCtx, recordId, &bucket)) {
+            return false;
+        }
+
+        auto compressed =
+            compressBucket(bucket.value(), coll->getTimeseriesOptions()->getTimeField());
+        if (!compressed) {
+            return false;
+        }
+
+        WriteUnitOfWork wuow(opCtx);
+        CollectionUpdateArgs args;
+        args.criteria = BSON("_id" << bucketId);
+        args.update = *compressed;
+        args.preImageDoc = bucket.value();
+        args.source = OperationSource::kTimeseries;
+        coll->updateDocument(opCtx,
+                             recordId,
+                             bucket,
+                             *compressed,
+                             true /* indexesAffected */,
+                             nullptr /* opDebug */,
+                             &args);
+        wuow.commit();
+        return true;
+    });
+}
+
+/**
+ * Returns whether 'coll' has an index which the query of BucketCatalog::tryReopenBucket() can use
+ * to find a bucket without scanning the collection, that is one whose key pattern starts with the
+ * metadata, if the collection has a metaField, followed by the minimum time of the bucket.
+ */
+bool hasBucketReopeningIndex(OperationContext* opCtx, const CollectionPtr& coll) {
+    const auto& options = *coll->getTimeseriesOptions();
+    std::vector<std::string> prefix;
+    if (options.getMetaField()) {
+        prefix.push_back(kBucketMetaFieldName.toString());
+    }
+    prefix.push_back(str::stream() << kControlMinFieldNamePrefix << options.getTimeField());
+
+    auto it = coll->getIndexCatalog()->getIndexIterator(opCtx, false /* includeUnfinished */);
+    while (it->more()) {
+        auto entry = it->next();
+        auto desc = entry->descriptor();
+        if (desc->getAccessMethodName() != IndexNames::BTREE || desc->isPartial() ||
+            desc->isSparse() ||
+            !CollatorInterface::collatorsMatch(entry->getCollator(), coll->getDefaultCollator())) {
+            continue;
+        }
+
+        BSONObjIterator keys(desc->keyPattern());
+        if (std::all_of(prefix.begin(), prefix.end(), [&](const std::string& field) {
+                return keys.more() && keys.next().fieldNameStringData() == field;
+            })) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+boost::optional<BSONObj> mergeBuckets(const BSONObj& first,
+                                      const BSONObj& second,
+                                      StringData timeFieldName,
+                                      const StringData::ComparatorInterface* comparator) {
+    if (isCompressedBucket(first) || isCompressedBucket(second)) {
+        return boost::none;
+    }
+
+    auto firstData = first[kBucketDataFieldName];
+    auto secondData = second[kBucketDataFieldName];
+    if (firstData.type() != Object || secondData.type() != Object) {
+        return boost::none;
+    }
+
+    // Every measurement has a time, so the time column determines the number of measurements.
+    auto firstTimeColumn = firstData.Obj()[timeFieldName];
+    if (firstTimeColumn.type() != Object) {
+        return boost::none;
+    }
+    const unsigned int numFirstMeasurements = firstTimeColumn.Obj().nFields();
+
+    MinMax minmax;
+    for (auto&& bucket : {first, second}) {
+        auto control = bucket[kBucketControlFieldName];
+        if (control.type() != Object) {
+            return boost::none;
+        }
+        auto min = control.Obj()["min"];
+        auto max = control.Obj()["max"];
+        if (min.type() != Object || max.type() != Object) {
+            return boost::none;
+        }
+        minmax.update(min.Obj(), boost::none, comparator);
+        minmax.update(max.Obj(), boost::none, comparator);
+    }
+
+    BSONObjBuilder builder;
+    for (auto&& elem : first) {
+        auto fieldName = elem.fieldNameStringData();
+        if (fieldName == kBucketControlFieldName) {
+            BSONObjBuilder controlBuilder(builder.subobjStart(fieldName));
+            controlBuilder.append(kBucketControlVersionFieldName,
+                                  kTimeseriesControlDefaultVersion);
+            controlBuilder.append("min", minmax.min());
+            controlBuilder.append("max", minmax.max());
+        } else if (fieldName == kBucketDataFieldName) {
+            BSONObjBuilder dataBuilder(builder.subobjStart(fieldName));
+            auto firstColumns = elem.Obj();
+            auto secondColumns = secondData.Obj();
+            for (auto&& column : firstColumns) {
+                auto secondColumn = secondColumns[column.fieldNameStringData()];
+                if (column.type() != Object ||
+                    (secondColumn && secondColumn.type() != Object)) {
+                    return boost::none;
+                }
+
+                BSONObjBuilder columnBuilder(dataBuilder.subobjStart(column.fieldNameStringData()));
+                columnBuilder.appendElements(column.Obj());
+                if (secondColumn &&
+                    !appendShiftedColumn(
+                        secondColumn.Obj(), numFirstMeasurements, &columnBuilder)) {
+                    return boost::none;
+                }
+            }
+            for (auto&& column : secondColumns) {
+                if (firstColumns.hasField(column.fieldNameStringData())) {
+                    continue;
+                }
+                if (column.type() != Object) {
+                    return boost::none;
+                }
+
+                BSONObjBuilder columnBuilder(dataBuilder.subobjStart(column.fieldNameStringData()));
+                if (!appendShiftedColumn(column.Obj(), numFirstMeasurements, &columnBuilder)) {
+                    return boost::none;
+                }
+            }
+        } else {
+            builder.append(elem);
+        }
+    }
+
+    return builder.obj();
+}
+
+int compactBuckets(OperationContext* opCtx,
+                   const NamespaceString& bucketsNs,
+                   int maxBucketsScanned) {
+    struct Candidate {
+        OID id;
+        Date_t minTime;
+    };
+    auto candidatesBySeries =
+        SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<std::vector<Candidate>>();
+    Seconds maxSpan;
+    {
+        AutoGetCollectionForRead coll(opCtx, bucketsNs);
+        if (!coll || !coll->getTimeseriesOptions()) {
+            return 0;
+        }
+        const auto& options = *coll->getTimeseriesOptions();
+        maxSpan = Seconds(*options.getBucketMaxSpanSeconds());
+        const std::string timeColumnPath = str::stream()
+            << kBucketDataFieldName << "." << options.getTimeField();
+        const std::string minTimePath = str::stream()
+            << kControlMinFieldNamePrefix << options.getTimeField();
+        const int minCount = gTimeseriesBucketCompactionMinCount.load();
+
+        auto& resumePositions = getCompactionResumePositions(opCtx->getServiceContext());
+        const auto uuid = coll->uuid();
+        boost::optional<RecordId> resumeAfter;
+        {
+            stdx::lock_guard lk(resumePositions.mutex);
+            if (auto it = resumePositions.positions.find(uuid);
+                it != resumePositions.positions.end()) {
+                resumeAfter = it->second;
+            }
+        }
+
+        // Pick up after the last bucket scanned by the previous pass, so that every bucket is
+        // eventually looked at however large the collection is.
+        auto cursor = coll->getCursor(opCtx);
+        auto record = resumeAfter ? cursor->seekNear(*resumeAfter) : cursor->next();
+        if (record && resumeAfter && record->id <= *resumeAfter) {
+            record = cursor->next();
+        }
+
+        int numScanned = 0;
+        boost::optional<RecordId> lastScanned;
+        for (; record; record = cursor->next()) {
+            if (numScanned++ == maxBucketsScanned) {
+                break;
+            }
+            lastScanned = record->id;
+
+            auto bucket = record->data.toBson();
+            if (isCompressedBucket(bucket)) {
+                continue;
+            }
+            auto id = bucket[kBucketIdFieldName];
+            auto timeColumn = dotted_path_support::extractElementAtPath(bucket, timeColumnPath);
+            auto minTime = dotted_path_support::extractElementAtPath(bucket, minTimePath);
+            if (id.type() != BSONType::jstOID || timeColumn.type() != BSONType::Object ||
+                minTime.type() != BSONType::Date || timeColumn.Obj().nFields() >= minCount) {
+                continue;
+            }
+
+            // The bucket catalog writes normalized metadata, so equal series have binary equal
+            // metadata.
+            auto meta = bucket[kBucketMetaFieldName];
+            candidatesBySeries[meta ? meta.wrap() : BSONObj()].push_back(
+                {id.OID(), minTime.Date()});
+        }
+
+        stdx::lock_guard lk(resumePositions.mutex);
+        if (!record) {
+            resumePositions.positions.erase(uuid);
+        } else if (lastScanned) {
+            resumePositions.positions[uuid] = *lastScanned;
+        }
+    }
+
+    int numMerged = 0;
+    for (auto& [_, candidates] : candidatesBySeries) {
+        std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.minTime < rhs.minTime;
+        });
+
+        // Fold each bucket into the earliest preceding one that can still take it. Buckets that
+        // start more than the maximum span apart can never be merged.
+        size_t target = 0;
+        for (size_t i = 1; i < candidates.size(); ++i) {
+            if (candidates[i].minTime - candidates[target].minTime < maxSpan &&
+                mergeBucketInto(opCtx, bucketsNs, candidates[target].id, candidates[i].id)) {
+                ++numMerged;
+                continue;
+            }
+            target = i;
+        }
+    }
+
+    if (numMerged > 0) {
+        LOGV2_DEBUG(5716277,
+                    1,
+                    "Merged undersized time-series buckets",
+                    "namespace"_attr = bucketsNs,
+                    "numMerged"_attr = numMerged);
+    }
+    return numMerged;
+}
+
+boost::optional<BSONObj> findBucketToReopen(OperationContext* opCtx,
+                                            const NamespaceString& bucketsNs,
+                                            const BSONObj& query) {
+    AutoGetCollectionForRead coll(opCtx, bucketsNs);
+    if (!coll || !coll->getTimeseriesOptions() ||
+        !hasBucketReopeningIndex(opCtx, coll.getCollection())) {
+        return boost::none;
+    }
+
+    BSONObj bucketDoc;
+    if (!Helpers::findOne(opCtx, coll.getCollection(), query, bucketDoc)) {
+        return boost::none;
+    }
+    return bucketDoc.getOwned();
+}
+
+void scheduleBucketCompression(OperationContext* opCtx,
+                               const BucketCatalog::ClosedBucket& closedBucket) {
+    if (!isBucketCompressionEnabled()) {
+        return;
+    }
+
+    auto& queue = getCompressionQueue(opCtx->getServiceContext());
+    stdx::lock_guard lk(queue.mutex);
+    if (queue.buckets.size() < kMaxBucketsQueuedForCompression) {
+        queue.buckets.push_back(closedBucket);
+    }
+}
+
+int compressScheduledBuckets(OperationContext* opCtx) {
+    std::deque<BucketCatalog::ClosedBucket> buckets;
+    {
+        auto& queue = getCompressionQueue(opCtx->getServiceContext());
+        stdx::lock_guard lk(queue.mutex);
+        buckets.swap(queue.buckets);
+    }
+
+    int numCompressed = 0;
+    for (const auto& closedBucket : buckets) {
+        auto bucketsNs = closedBucket.ns.makeTimeseriesBucketsNamespace();
+        try {
+            if (compressClosedBucket(opCtx, bucketsNs, closedBucket.bucketId)) {
+                ++numCompressed;
+            }
+        } catch (ExceptionForCat<ErrorCategory::CancellationError>&) {
+            throw;
+        } catch (const DBException& ex) {
+            LOGV2_DEBUG(5716272,
+                        1,
+                        "Failed to compress time-series bucket",
+                        "namespace"_attr = bucketsNs,
+                        "bucketId"_attr = closedBucket.bucketId,
+                        "error"_attr = ex.toStatus());
+        }
+    }
+    return numCompressed;
+}
+
+}  // namespace mongo::timeseries
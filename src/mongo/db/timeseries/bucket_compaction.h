@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+
+namespace mongo {
+
+class OperationContext;
+
+namespace timeseries {
+
+/**
+ * Returns a bucket holding the measurements of 'first' followed by those of 'second', keeping the
+ * _id and metadata of 'first'. The measurements of 'second' are renumbered to follow those of
+ * 'first' and the control fields cover both buckets. Returns boost::none if either bucket is
+ * compressed or its data region is not laid out as expected. Whether the merged bucket respects the
+ * bucket limits is left to the caller.
+ */
+boost::optional<BSONObj> mergeBuckets(const BSONObj& first,
+                                      const BSONObj& second,
+                                      StringData timeFieldName,
+                                      const StringData::ComparatorInterface* comparator);
+
+/**
+ * Bounds the work of a single compaction pass over a collection, and the memory used to remember
+ * the undersized buckets it has seen.
+ */
+constexpr int kMaxBucketsScannedPerCompactionPass = 100000;
+
+/**
+ * Merges undersized, uncompressed buckets of the given buckets collection into the adjacent bucket
+ * of the same series, as long as the result stays within the bucket limits. Buckets that are open
+ * in the bucket catalog are left alone. A pass looks at no more than 'maxBucketsScanned' buckets,
+ * and the next pass over the collection picks up where it stopped. Returns the number of buckets
+ * removed by merging.
+ */
+int compactBuckets(OperationContext* opCtx,
+                   const NamespaceString& bucketsNs,
+                   int maxBucketsScanned = kMaxBucketsScannedPerCompactionPass);
+
+/**
+ * Returns a bucket of the given buckets collection that matches 'query', as built by
+ * BucketCatalog::tryReopenBucket(), or boost::none if there is none. Does not look at all unless
+ * the collection has an index on the metadata and the minimum time of its buckets, since scanning
+ * the whole collection under the locks of an insert costs more than opening a new bucket.
+ */
+boost::optional<BSONObj> findBucketToReopen(OperationContext* opCtx,
+                                            const NamespaceString& bucketsNs,
+                                            const BSONObj& query);
+
+/**
+ * Queues a bucket that the bucket catalog has closed, so that the background bucket maintenance job
+ * rewrites it with its columns compressed instead of the insert that closed it. Does nothing unless
+ * timeseriesBucketCompression is enabled and the FCV is fully upgraded, since older binaries cannot
+ * read compressed buckets. Buckets closed while the queue is full stay uncompressed.
+ */
+void scheduleBucketCompression(OperationContext* opCtx,
+                               const BucketCatalog::ClosedBucket& closedBucket);
+
+/**
+ * Compresses the buckets queued by scheduleBucketCompression(). A bucket that cannot be compressed,
+ * for instance because it has been reopened or removed in the meantime, is left as it is. Returns
+ * the number of buckets compressed.
+ */
+int compressScheduledBuckets(OperationContext* opCtx);
+
+}  // namespace timeseries
+}  // namespace mongo
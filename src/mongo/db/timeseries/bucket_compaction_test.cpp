@@ -0,0 +1,308 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_compaction.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog/create_collection.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/timeseries/bucket_compression.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo::timeseries {
+namespace {
+
+class BucketMaintenanceTest : public CatalogTestFixture {
+protected:
+    void setUp() override {
+        CatalogTestFixture::setUp();
+        ASSERT_OK(createCollection(operationContext(),
+                                   _ns.db().toString(),
+                                   BSON("create" << _ns.coll() << "timeseries"
+                                                 << BSON("timeField"
+                                                         << "time"
+                                                         << "metaField"
+                                                         << "meta"))));
+    }
+
+    /**
+     * Inserts a bucket of the series 'meta' holding one measurement for each of 'times', laid out
+     * the way the bucket catalog writes it, and returns its _id.
+     */
+    OID _insertBucket(StringData meta, const std::vector<Date_t>& times) {
+        auto id = OID::gen();
+        id.setTimestamp(durationCount<Seconds>(times.front().toDurationSinceEpoch()));
+
+        BSONObjBuilder timeColumn;
+        for (size_t i = 0; i < times.size(); ++i) {
+            timeColumn.append(std::to_string(i), times[i]);
+        }
+        auto bucket = BSON("_id" << id << "control"
+                                 << BSON("version" << 1 << "min"
+                                                   << BSON("time" << *std::min_element(
+                                                               times.begin(), times.end()))
+                                                   << "max"
+                                                   << BSON("time" << *std::max_element(
+                                                               times.begin(), times.end())))
+                                 << "meta" << meta << "data"
+                                 << BSON("time" << timeColumn.obj()));
+
+        auto opCtx = operationContext();
+        AutoGetCollection coll(opCtx, _ns.makeTimeseriesBucketsNamespace(), MODE_IX);
+        WriteUnitOfWork wuow(opCtx);
+        ASSERT_OK(coll->insertDocument(opCtx, InsertStatement(bucket), nullptr));
+        wuow.commit();
+        return id;
+    }
+
+    /**
+     * Has the bucket catalog try to reopen a persisted bucket for the measurement 'doc', looking it
+     * up the way inserts do.
+     */
+    bool _tryReopenBucket(const BSONObj& doc) {
+        auto opCtx = operationContext();
+        auto bucketsNs = _ns.makeTimeseriesBucketsNamespace();
+        auto bucketsColl =
+            CollectionCatalog::get(opCtx)->lookupCollectionByNamespaceForRead(opCtx, bucketsNs);
+        return BucketCatalog::get(opCtx).tryReopenBucket(
+            _ns,
+            bucketsColl->getDefaultCollator(),
+            *bucketsColl->getTimeseriesOptions(),
+            doc,
+            [&](const BSONObj& query) { return findBucketToReopen(opCtx, bucketsNs, query); });
+    }
+
+    /**
+     * Returns the bucket with the given _id, or an empty object if there is none.
+     */
+    BSONObj _findBucket(const OID& id) {
+        AutoGetCollection coll(operationContext(), _ns.makeTimeseriesBucketsNamespace(), MODE_IS);
+        BSONObj bucket;
+        Helpers::findOne(operationContext(), coll.getCollection(), BSON("_id" << id), bucket);
+        return bucket;
+    }
+
+    const NamespaceString _ns{"bucket_compaction_test", "t"};
+};
+
+TEST(BucketCompaction, MergeRenumbersMeasurementsOfSecondBucket) {
+    auto first = fromjson(
+        "{_id: 1, control: {version: 1, min: {_id: 1, t: {$date: 1000}, a: 1}, "
+        "max: {_id: 2, t: {$date: 2000}, a: 2}}, meta: 'm', "
+        "data: {_id: {'0': 1, '1': 2}, t: {'0': {$date: 1000}, '1': {$date: 2000}}, "
+        "a: {'0': 1, '1': 2}}}");
+    auto second = fromjson(
+        "{_id: 2, control: {version: 1, min: {_id: 3, t: {$date: 500}, b: 'x'}, "
+        "max: {_id: 3, t: {$date: 500}, b: 'x'}}, meta: 'm', "
+        "data: {_id: {'0': 3}, t: {'0': {$date: 500}}, b: {'0': 'x'}}}");
+
+    auto merged = mergeBuckets(first, second, "t"_sd, nullptr);
+    ASSERT(merged);
+    ASSERT_BSONOBJ_EQ(
+        *merged,
+        fromjson("{_id: 1, control: {version: 1, min: {_id: 1, t: {$date: 500}, a: 1, b: 'x'}, "
+                 "max: {_id: 3, t: {$date: 2000}, a: 2, b: 'x'}}, meta: 'm', "
+                 "data: {_id: {'0': 1, '1': 2, '2': 3}, "
+                 "t: {'0': {$date: 1000}, '1': {$date: 2000}, '2': {$date: 500}}, "
+                 "a: {'0': 1, '1': 2}, b: {'2': 'x'}}}"));
+}
+
+TEST(BucketCompaction, MergeKeepsSparseColumnsSparse) {
+    auto first = fromjson(
+        "{control: {version: 1, min: {t: 1, a: 1}, max: {t: 2, a: 1}}, "
+        "data: {t: {'0': 1, '1': 2}, a: {'1': 1}}}");
+    auto second = fromjson(
+        "{control: {version: 1, min: {t: 3, a: 5}, max: {t: 4, a: 5}}, "
+        "data: {t: {'0': 3, '1': 4}, a: {'1': 5}}}");
+
+    auto merged = mergeBuckets(first, second, "t"_sd, nullptr);
+    ASSERT(merged);
+    ASSERT_BSONOBJ_EQ(merged->getObjectField("data"),
+                      fromjson("{t: {'0': 1, '1': 2, '2': 3, '3': 4}, a: {'1': 1, '3': 5}}"));
+}
+
+TEST(BucketCompaction, MergeRejectsCompressedBuckets) {
+    auto bucket = fromjson(
+        "{control: {version: 1, min: {t: 1}, max: {t: 1}}, data: {t: {'0': 1}}}");
+    auto compressed = compressBucket(bucket, "t"_sd);
+    ASSERT(compressed);
+
+    ASSERT_FALSE(mergeBuckets(bucket, *compressed, "t"_sd, nullptr));
+    ASSERT_FALSE(mergeBuckets(*compressed, bucket, "t"_sd, nullptr));
+}
+
+TEST(BucketCompaction, MergeRejectsUnexpectedLayouts) {
+    auto bucket = fromjson(
+        "{control: {version: 1, min: {t: 1}, max: {t: 1}}, data: {t: {'0': 1}}}");
+
+    // Missing control summary.
+    ASSERT_FALSE(mergeBuckets(bucket, fromjson("{data: {t: {'0': 2}}}"), "t"_sd, nullptr));
+    // Missing time column.
+    ASSERT_FALSE(mergeBuckets(
+        fromjson("{control: {version: 1, min: {a: 1}, max: {a: 1}}, data: {a: {'0': 1}}}"),
+        bucket,
+        "t"_sd,
+        nullptr));
+    // Non-numeric measurement index.
+    ASSERT_FALSE(mergeBuckets(
+        bucket,
+        fromjson("{control: {version: 1, min: {t: 2}, max: {t: 2}}, data: {t: {x: 2}}}"),
+        "t"_sd,
+        nullptr));
+}
+
+TEST_F(BucketMaintenanceTest, ScheduledBucketsAreCompressedInTheBackground) {
+    RAIIServerParameterControllerForTest compression("timeseriesBucketCompression", true);
+    auto opCtx = operationContext();
+
+    auto id = _insertBucket(
+        "a", {Date_t::fromMillisSinceEpoch(1000), Date_t::fromMillisSinceEpoch(2000)});
+    scheduleBucketCompression(opCtx, {id, _ns});
+    ASSERT_FALSE(isCompressedBucket(_findBucket(id)));
+
+    ASSERT_EQ(1, compressScheduledBuckets(opCtx));
+    auto bucket = _findBucket(id);
+    ASSERT(isCompressedBucket(bucket));
+    ASSERT_EQ(bucket.getObjectField("control").getIntField("count"), 2);
+
+    // The queue has been drained.
+    ASSERT_EQ(0, compressScheduledBuckets(opCtx));
+}
+
+TEST_F(BucketMaintenanceTest, BucketsAreNotCompressedUnlessFCVIsFullyUpgraded) {
+    RAIIServerParameterControllerForTest compression("timeseriesBucketCompression", true);
+    auto opCtx = operationContext();
+    ON_BLOCK_EXIT([] {
+        serverGlobalParams.mutableFeatureCompatibility.setVersion(
+            ServerGlobalParams::FeatureCompatibility::kLatest);
+    });
+
+    // Buckets closed while the FCV is downgraded are not queued.
+    auto first = _insertBucket("a", {Date_t::fromMillisSinceEpoch(1000)});
+    serverGlobalParams.mutableFeatureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::kLastLTS);
+    scheduleBucketCompression(opCtx, {first, _ns});
+    serverGlobalParams.mutableFeatureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::kLatest);
+    ASSERT_EQ(0, compressScheduledBuckets(opCtx));
+
+    // Buckets queued before a downgrade starts are not compressed.
+    auto second = _insertBucket("b", {Date_t::fromMillisSinceEpoch(1000)});
+    scheduleBucketCompression(opCtx, {second, _ns});
+    serverGlobalParams.mutableFeatureCompatibility.setVersion(
+        ServerGlobalParams::FeatureCompatibility::kDowngradingFromLatestToLastLTS);
+    ASSERT_EQ(0, compressScheduledBuckets(opCtx));
+
+    ASSERT_FALSE(isCompressedBucket(_findBucket(first)));
+    ASSERT_FALSE(isCompressedBucket(_findBucket(second)));
+}
+
+TEST_F(BucketMaintenanceTest, CompactionPassesResumeWhereThePreviousPassStopped) {
+    auto opCtx = operationContext();
+    auto bucketsNs = _ns.makeTimeseriesBucketsNamespace();
+
+    auto a1 = _insertBucket("a", {Date_t::fromMillisSinceEpoch(1000 * 1000)});
+    auto a2 = _insertBucket("a", {Date_t::fromMillisSinceEpoch(1001 * 1000)});
+    auto b1 = _insertBucket("b", {Date_t::fromMillisSinceEpoch(1002 * 1000)});
+    auto b2 = _insertBucket("b", {Date_t::fromMillisSinceEpoch(1003 * 1000)});
+
+    // Each pass only gets to see one of the series, in _id order.
+    ASSERT_EQ(1, compactBuckets(opCtx, bucketsNs, 2));
+    ASSERT_FALSE(_findBucket(a1).isEmpty());
+    ASSERT(_findBucket(a2).isEmpty());
+    ASSERT_FALSE(_findBucket(b2).isEmpty());
+
+    ASSERT_EQ(1, compactBuckets(opCtx, bucketsNs, 2));
+    ASSERT_FALSE(_findBucket(b1).isEmpty());
+    ASSERT(_findBucket(b2).isEmpty());
+
+    // Having reached the end of the collection, the next passes start over.
+    ASSERT_EQ(0, compactBuckets(opCtx, bucketsNs, 2));
+    ASSERT_EQ(0, compactBuckets(opCtx, bucketsNs, 2));
+    ASSERT_EQ(_findBucket(a1).getObjectField("data").getObjectField("time").nFields(), 2);
+}
+
+TEST_F(BucketMaintenanceTest, BucketsAreReopenedUsingTheMetaAndTimeIndex) {
+    auto opCtx = operationContext();
+    ASSERT_OK(storageInterface()->createIndexesOnEmptyCollection(
+        opCtx,
+        _ns.makeTimeseriesBucketsNamespace(),
+        {BSON("v" << 2 << "name"
+                  << "meta_1_time_1"
+                  << "key"
+                  << BSON("meta" << 1 << "control.min.time" << 1 << "control.max.time" << 1))}));
+    auto id = _insertBucket("a", {Date_t::fromMillisSinceEpoch(1000 * 1000)});
+
+    // A measurement of another series has no bucket to reopen.
+    ASSERT_FALSE(_tryReopenBucket(
+        BSON("time" << Date_t::fromMillisSinceEpoch(1001 * 1000) << "meta"
+                    << "b")));
+
+    auto doc = BSON("time" << Date_t::fromMillisSinceEpoch(1001 * 1000) << "meta"
+                           << "a");
+    ASSERT(_tryReopenBucket(doc));
+
+    auto& bucketCatalog = BucketCatalog::get(opCtx);
+    auto bucketsColl = CollectionCatalog::get(opCtx)->lookupCollectionByNamespaceForRead(
+        opCtx, _ns.makeTimeseriesBucketsNamespace());
+    auto batch = bucketCatalog
+                     .insert(opCtx,
+                             _ns,
+                             bucketsColl->getDefaultCollator(),
+                             *bucketsColl->getTimeseriesOptions(),
+                             doc,
+                             BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+                     .getValue();
+    ASSERT_EQ(batch->bucket()->id(), id);
+    ASSERT_EQ(batch->numPreviouslyCommittedMeasurements(), 1);
+
+    ASSERT(batch->claimCommitRights());
+    bucketCatalog.abort(batch);
+}
+
+TEST_F(BucketMaintenanceTest, BucketsAreNotReopenedWithoutAnIndexToFindThem) {
+    _insertBucket("a", {Date_t::fromMillisSinceEpoch(1000 * 1000)});
+
+    // Finding the bucket would take a collection scan.
+    ASSERT_FALSE(_tryReopenBucket(
+        BSON("time" << Date_t::fromMillisSinceEpoch(1001 * 1000) << "meta"
+                    << "a")));
+}
+
+}  // namespace
+}  // namespace mongo::timeseries
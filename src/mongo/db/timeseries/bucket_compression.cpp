@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_compression.h"
+
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/util/bsoncolumn.h"
+#include "mongo/db/timeseries/timeseries_constants.h"
+
+namespace mongo::timeseries {
+
+namespace {
+
+/**
+ * Appends the BSONColumn encoding of 'column', whose fields are keyed by measurement index, to
+ * 'builder'. Returns false if any of the keys is not a valid index in increasing order.
+ */
+bool appendCompressedColumn(const BSONElement& column,
+                            size_t numMeasurements,
+                            BSONObjBuilder* builder) {
+    if (column.type() != Object) {
+        return false;
+    }
+
+    BSONColumnBuilder columnBuilder;
+    for (auto&& elem : column.Obj()) {
+        unsigned int index;
+        if (!NumberParser{}.base(10)(elem.fieldNameStringData(), &index).isOK() ||
+            index < columnBuilder.size() || index >= numMeasurements) {
+            return false;
+        }
+
+        while (columnBuilder.size() < index) {
+            columnBuilder.skip();
+        }
+        columnBuilder.append(elem);
+    }
+    while (columnBuilder.size() < numMeasurements) {
+        columnBuilder.skip();
+    }
+
+    auto binData = columnBuilder.finalize();
+    builder->appendBinData(
+        column.fieldNameStringData(), binData.length, binData.type, binData.data);
+    return true;
+}
+
+}  // namespace
+
+boost::optional<BSONObj> compressBucket(const BSONObj& bucketDoc, StringData timeFieldName) {
+    if (isCompressedBucket(bucketDoc)) {
+        return boost::none;
+    }
+
+    auto dataElem = bucketDoc[kBucketDataFieldName];
+    auto controlElem = bucketDoc[kBucketControlFieldName];
+    if (dataElem.type() != Object || controlElem.type() != Object) {
+        return boost::none;
+    }
+
+    // Every measurement has a time, so the time column determines the number of measurements.
+    auto timeColumn = dataElem.Obj()[timeFieldName];
+    if (timeColumn.type() != Object) {
+        return boost::none;
+    }
+    const size_t numMeasurements = timeColumn.Obj().nFields();
+
+    BSONObjBuilder builder;
+    for (auto&& elem : bucketDoc) {
+        auto fieldName = elem.fieldNameStringData();
+        if (fieldName == kBucketControlFieldName) {
+            BSONObjBuilder controlBuilder(builder.subobjStart(fieldName));
+            bool hasVersion = false;
+            for (auto&& controlField : elem.Obj()) {
+                if (controlField.fieldNameStringData() == kBucketControlCountFieldName) {
+                    continue;
+                } else if (controlField.fieldNameStringData() ==
+                           kBucketControlVersionFieldName) {
+                    controlBuilder.append(kBucketControlVersionFieldName,
+                                          kTimeseriesControlCompressedVersion);
+                    hasVersion = true;
+                } else {
+                    controlBuilder.append(controlField);
+                }
+            }
+            if (!hasVersion) {
+                controlBuilder.append(kBucketControlVersionFieldName,
+                                      kTimeseriesControlCompressedVersion);
+            }
+            // The number of measurements can no longer be derived from the size of the time
+            // column, so record it for readers that only look at the control fields.
+            controlBuilder.append(kBucketControlCountFieldName,
+                                  static_cast<int>(numMeasurements));
+        } else if (fieldName == kBucketDataFieldName) {
+            BSONObjBuilder dataBuilder(builder.subobjStart(fieldName));
+            for (auto&& column : elem.Obj()) {
+                if (!appendCompressedColumn(column, numMeasurements, &dataBuilder)) {
+                    return boost::none;
+                }
+            }
+        } else {
+            builder.append(elem);
+        }
+    }
+
+    return builder.obj();
+}
+
+bool isCompressedBucket(const BSONObj& bucketDoc) {
+    auto controlElem = bucketDoc[kBucketControlFieldName];
+    return controlElem.type() == Object &&
+        controlElem.Obj()[kBucketControlVersionFieldName].numberInt() ==
+        kTimeseriesControlCompressedVersion;
+}
+
+}  // namespace mongo::timeseries
@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_compression.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/bson/util/bsoncolumn.h"
+#include "mongo/db/timeseries/timeseries_constants.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/decimal_counter.h"
+
+namespace mongo::timeseries {
+namespace {
+
+TEST(BucketCompression, CompressesEachColumn) {
+    auto bucket = fromjson(
+        "{_id: 1, control: {version: 1, min: {t: 1}, max: {t: 3}}, meta: 'm', "
+        "data: {t: {'0': 1, '1': 2, '2': 3}, a: {'1': 'x', '2': 'y'}}}");
+    auto compressed = compressBucket(bucket, "t"_sd);
+    ASSERT(compressed);
+    ASSERT(isCompressedBucket(*compressed));
+    ASSERT_FALSE(isCompressedBucket(bucket));
+
+    // Everything outside of the data region is unchanged, apart from the version and count.
+    ASSERT_BSONOBJ_EQ(compressed->removeField(kBucketDataFieldName),
+                      fromjson("{_id: 1, control: {version: 2, min: {t: 1}, max: {t: 3}, "
+                               "count: 3}, meta: 'm'}"));
+
+    auto it = BSONColumn(compressed->getObjectField(kBucketDataFieldName)["a"]).begin();
+    ASSERT_TRUE(it.next().eoo());
+    ASSERT_EQ(it.next().str(), "x");
+    ASSERT_EQ(it.next().str(), "y");
+    ASSERT_FALSE(it.more());
+
+    // Already compressed buckets are left alone.
+    ASSERT_FALSE(compressBucket(*compressed, "t"_sd));
+}
+
+TEST(BucketCompression, PadsColumnsToTheNumberOfMeasurements) {
+    auto bucket = fromjson(
+        "{control: {version: 1}, data: {t: {'0': 1, '1': 2, '2': 3}, a: {'0': true}}}");
+    auto compressed = compressBucket(bucket, "t"_sd);
+    ASSERT(compressed);
+    ASSERT_EQ(BSONColumn(compressed->getObjectField(kBucketDataFieldName)["a"]).size(), 3U);
+}
+
+TEST(BucketCompression, RejectsUnexpectedLayouts) {
+    // Missing time column.
+    ASSERT_FALSE(compressBucket(fromjson("{control: {version: 1}, data: {a: {'0': 1}}}"), "t"_sd));
+
+    // Index out of range, out of order, or not a number.
+    ASSERT_FALSE(compressBucket(
+        fromjson("{control: {version: 1}, data: {t: {'0': 1}, a: {'1': 1}}}"), "t"_sd));
+    ASSERT_FALSE(compressBucket(
+        fromjson("{control: {version: 1}, data: {t: {'0': 1, '1': 2}, a: {'1': 1, '0': 1}}}"),
+        "t"_sd));
+    ASSERT_FALSE(compressBucket(
+        fromjson("{control: {version: 1}, data: {t: {'0': 1}, a: {x: 1}}}"), "t"_sd));
+}
+
+TEST(BucketCompression, FullBucketIsMuchSmaller) {
+    BSONObjBuilder builder;
+    builder.append("_id", OID::gen());
+    builder.append("control", BSON("version" << kTimeseriesControlDefaultVersion));
+    {
+        BSONObjBuilder data(builder.subobjStart("data"));
+        BSONObjBuilder time(data.subobjStart("t"));
+        DecimalCounter<uint32_t> count;
+        for (int i = 0; i < 1000; ++i, ++count) {
+            time.append(count, Date_t::fromMillisSinceEpoch(1600000000000LL + i * 1000));
+        }
+        time.done();
+
+        BSONObjBuilder temperature(data.subobjStart("temperature"));
+        count = 0;
+        for (int i = 0; i < 1000; ++i, ++count) {
+            temperature.append(count, 20 + (i % 10) / 10.0);
+        }
+    }
+    auto bucket = builder.obj();
+
+    auto compressed = compressBucket(bucket, "t"_sd);
+    ASSERT(compressed);
+    ASSERT_LT(compressed->objsize() * 5, bucket.objsize());
+}
+
+}  // namespace
+}  // namespace mongo::timeseries
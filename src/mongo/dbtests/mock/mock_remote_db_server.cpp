@@ -219,11 +219,25 @@ mongo::BSONArray MockRemoteDBServer::query(MockRemoteDBServer::InstanceID id,
     scoped_spinlock sLock(_lock);
     _queryCount++;
 
+    // Index bounds given as $min and $max filter the documents on the fields the bounds name.
+    const auto min = query.obj["$min"];
+    const auto max = query.obj["$max"];
+    auto isInBounds = [&](const BSONObj& doc) {
+        if (min.isABSONObj() &&
+            doc.extractFieldsUndotted(min.Obj()).woCompare(min.Obj(), BSONObj(), false) < 0) {
+            return false;
+        }
+        return !max.isABSONObj() ||
+            doc.extractFieldsUndotted(max.Obj()).woCompare(max.Obj(), BSONObj(), false) < 0;
+    };
+
     auto ns = nsOrUuid.uuid() ? _uuidToNs[*nsOrUuid.uuid()] : nsOrUuid.nss()->ns();
     const vector<BSONObj>& coll = _dataMgr[ns];
     BSONArrayBuilder result;
     for (vector<BSONObj>::const_iterator iter = coll.begin(); iter != coll.end(); ++iter) {
-        result.append(project(projectionExecutor.get(), *iter));
+        if (isInBounds(*iter)) {
+            result.append(project(projectionExecutor.get(), *iter));
+        }
     }
 
     return BSONArray(result.obj());
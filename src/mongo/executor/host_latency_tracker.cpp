@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/host_latency_tracker.h"
+
+#include <absl/hash/hash.h>
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/random.h"
+
+namespace mongo {
+namespace {
+
+const auto getHostLatencyTracker = ServiceContext::declareDecoration<HostLatencyTracker>();
+
+thread_local PseudoRandom threadPrng{SecureRandom().nextInt64()};
+
+}  // namespace
+
+HostLatencyTracker* HostLatencyTracker::get(ServiceContext* service) {
+    return &getHostLatencyTracker(service);
+}
+
+HostLatencyTracker* HostLatencyTracker::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+void HostLatencyTracker::onRequestStarted(const HostAndPort& host) {
+    auto& shard = _getShard(host);
+    stdx::lock_guard<Latch> lk(shard.mutex);
+    ++shard.hostStats[host].numInFlight;
+}
+
+void HostLatencyTracker::onRequestFinished(const HostAndPort& host,
+                                           boost::optional<Milliseconds> latency) {
+    auto& shard = _getShard(host);
+    stdx::lock_guard<Latch> lk(shard.mutex);
+    auto& stats = shard.hostStats[host];
+    if (stats.numInFlight > 0) {
+        --stats.numInFlight;
+    }
+
+    if (!latency) {
+        return;
+    }
+
+    if (stats.latencies.size() < kWindowSize) {
+        stats.latencies.push_back(*latency);
+    } else {
+        stats.latencies[stats.next] = *latency;
+        stats.next = (stats.next + 1) % kWindowSize;
+    }
+
+    if (++stats.numSinceRefresh < kRefreshInterval && !stats.sortedLatencies.empty()) {
+        return;
+    }
+
+    if (stats.latencies.size() >= kMinSamples) {
+        stats.sortedLatencies = stats.latencies;
+        std::sort(stats.sortedLatencies.begin(), stats.sortedLatencies.end());
+        stats.numSinceRefresh = 0;
+    }
+}
+
+boost::optional<Milliseconds> HostLatencyTracker::getLatencyPercentile(const HostAndPort& host,
+                                                                       double percentile) const {
+    const auto& shard = _getShard(host);
+    stdx::lock_guard<Latch> lk(shard.mutex);
+    auto it = shard.hostStats.find(host);
+    if (it == shard.hostStats.end() || it->second.sortedLatencies.empty()) {
+        return boost::none;
+    }
+
+    // Use the nearest-rank method.
+    const auto& latencies = it->second.sortedLatencies;
+    const auto rank = size_t(std::ceil(percentile / 100 * latencies.size()));
+    return latencies[std::min(std::max(rank, size_t(1)), latencies.size()) - 1];
+}
+
+long long HostLatencyTracker::getNumInFlight(const HostAndPort& host) const {
+    const auto& shard = _getShard(host);
+    stdx::lock_guard<Latch> lk(shard.mutex);
+    auto it = shard.hostStats.find(host);
+    return it == shard.hostStats.end() ? 0 : it->second.numInFlight;
+}
+
+void HostLatencyTracker::promotePowerOfTwoChoice(std::vector<HostAndPort>& hosts) const {
+    if (hosts.size() < 2) {
+        return;
+    }
+
+    const auto numHosts = int64_t(hosts.size());
+    const auto first = threadPrng.nextInt64(numHosts);
+    auto second = threadPrng.nextInt64(numHosts - 1);
+    if (second >= first) {
+        ++second;
+    }
+
+    const auto chosen = _getCost(hosts[second]) < _getCost(hosts[first]) ? second : first;
+    std::rotate(hosts.begin(), hosts.begin() + chosen, hosts.begin() + chosen + 1);
+}
+
+HostLatencyTracker::Shard& HostLatencyTracker::_getShard(const HostAndPort& host) {
+    return _shards[absl::Hash<HostAndPort>{}(host) % kNumShards];
+}
+
+const HostLatencyTracker::Shard& HostLatencyTracker::_getShard(const HostAndPort& host) const {
+    return _shards[absl::Hash<HostAndPort>{}(host) % kNumShards];
+}
+
+long long HostLatencyTracker::_getCost(const HostAndPort& host) const {
+    const auto& shard = _getShard(host);
+    stdx::lock_guard<Latch> lk(shard.mutex);
+    auto it = shard.hostStats.find(host);
+    if (it == shard.hostStats.end() || it->second.sortedLatencies.empty()) {
+        return 0;
+    }
+
+    // Add one so that a host with a median latency of zero is still penalized by its load.
+    const auto& latencies = it->second.sortedLatencies;
+    const auto median = latencies[(latencies.size() - 1) / 2];
+    return (median.count() + 1) * (it->second.numInFlight + 1);
+}
+
+}  // namespace mongo
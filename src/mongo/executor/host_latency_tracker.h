@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/net/hostandport.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Decoration on ServiceContext which tracks the latency of the requests most recently sent to each
+ * remote host, along with the number of requests to it which are still in flight. It is used to
+ * prefer the less loaded of the eligible hosts when targeting reads and to size hedged reads.
+ *
+ * Instances of this class are thread-safe.
+ */
+class HostLatencyTracker {
+    HostLatencyTracker(const HostLatencyTracker&) = delete;
+    HostLatencyTracker& operator=(const HostLatencyTracker&) = delete;
+
+public:
+    // The number of most recent latencies kept per host.
+    static constexpr size_t kWindowSize = 256;
+
+    // The number of latencies a host needs before its percentiles are reported.
+    static constexpr size_t kMinSamples = 16;
+
+    // The number of latencies recorded for a host between refreshes of its reported percentiles,
+    // which saves sorting its latencies on every lookup.
+    static constexpr size_t kRefreshInterval = 16;
+
+    static constexpr size_t kNumShards = 16;
+
+    HostLatencyTracker() = default;
+
+    static HostLatencyTracker* get(ServiceContext* service);
+    static HostLatencyTracker* get(OperationContext* opCtx);
+
+    /**
+     * Must be called when a request is sent to 'host', and be followed by a call to
+     * onRequestFinished() once it completes.
+     */
+    void onRequestStarted(const HostAndPort& host);
+
+    /**
+     * Records 'latency' as the time 'host' took to respond to a request. 'latency' is boost::none
+     * if the request failed without a response from 'host'. A request abandoned before 'host'
+     * responded, such as the loser of a hedged read, records the time it waited as a lower bound.
+     */
+    void onRequestFinished(const HostAndPort& host, boost::optional<Milliseconds> latency);
+
+    /**
+     * Returns the 'percentile' (between 0 and 100) of the latencies recently recorded for 'host',
+     * or boost::none if fewer than kMinSamples latencies have been recorded for it. Percentiles
+     * are refreshed once every kRefreshInterval latencies, so may miss the most recent ones.
+     */
+    boost::optional<Milliseconds> getLatencyPercentile(const HostAndPort& host,
+                                                       double percentile) const;
+
+    /**
+     * Returns the number of requests sent to 'host' which haven't completed yet.
+     */
+    long long getNumInFlight(const HostAndPort& host) const;
+
+    /**
+     * Picks two of 'hosts' at random and moves the one expected to respond sooner to the front,
+     * leaving the order of the remaining hosts unchanged. A host's cost is its median latency plus
+     * one millisecond, multiplied by its number of in-flight requests plus one. A host without
+     * enough recorded latencies has no cost, so that it gets tried.
+     */
+    void promotePowerOfTwoChoice(std::vector<HostAndPort>& hosts) const;
+
+private:
+    struct HostStats {
+        // Ring buffer of the most recent latencies, of which 'next' is the oldest once full.
+        std::vector<Milliseconds> latencies;
+        size_t next{0};
+
+        // Copy of 'latencies' in ascending order as of the last refresh, from which percentiles
+        // are reported, and the number of latencies recorded since then.
+        std::vector<Milliseconds> sortedLatencies;
+        size_t numSinceRefresh{0};
+
+        long long numInFlight{0};
+    };
+
+    // Hosts are spread across shards by hash so that requests to different hosts rarely contend
+    // on the same mutex.
+    struct Shard {
+        mutable Mutex mutex = MONGO_MAKE_LATCH("HostLatencyTracker::Shard::mutex");
+        stdx::unordered_map<HostAndPort, HostStats> hostStats;
+    };
+
+    Shard& _getShard(const HostAndPort& host);
+    const Shard& _getShard(const HostAndPort& host) const;
+
+    long long _getCost(const HostAndPort& host) const;
+
+    std::array<Shard, kNumShards> _shards;
+};
+
+}  // namespace mongo
@@ -0,0 +1,133 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/host_latency_tracker.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const HostAndPort kHost1("host1", 27017);
+const HostAndPort kHost2("host2", 27017);
+
+void recordLatencies(HostLatencyTracker& tracker,
+                     const HostAndPort& host,
+                     int first,
+                     int last) {
+    for (int i = first; i <= last; ++i) {
+        tracker.onRequestStarted(host);
+        tracker.onRequestFinished(host, Milliseconds(i));
+    }
+}
+
+TEST(HostLatencyTrackerTest, ReportsPercentilesOnceEnoughLatenciesRecorded) {
+    HostLatencyTracker tracker;
+    recordLatencies(tracker, kHost1, 1, HostLatencyTracker::kMinSamples - 1);
+    ASSERT_FALSE(tracker.getLatencyPercentile(kHost1, 50));
+
+    recordLatencies(tracker, kHost1, HostLatencyTracker::kMinSamples, 160);
+    ASSERT_EQ(*tracker.getLatencyPercentile(kHost1, 50), Milliseconds(80));
+    ASSERT_EQ(*tracker.getLatencyPercentile(kHost1, 99), Milliseconds(159));
+    ASSERT_EQ(*tracker.getLatencyPercentile(kHost1, 100), Milliseconds(160));
+    ASSERT_FALSE(tracker.getLatencyPercentile(kHost2, 50));
+}
+
+TEST(HostLatencyTrackerTest, RefreshesPercentilesOncePerRefreshInterval) {
+    HostLatencyTracker tracker;
+    const int numSamples = HostLatencyTracker::kMinSamples;
+    recordLatencies(tracker, kHost1, 1, numSamples);
+    ASSERT_EQ(*tracker.getLatencyPercentile(kHost1, 100), Milliseconds(numSamples));
+
+    const int slowLatency = 1000;
+    for (size_t i = 1; i < HostLatencyTracker::kRefreshInterval; ++i) {
+        tracker.onRequestStarted(kHost1);
+        tracker.onRequestFinished(kHost1, Milliseconds(slowLatency));
+    }
+    ASSERT_EQ(*tracker.getLatencyPercentile(kHost1, 100), Milliseconds(numSamples));
+
+    tracker.onRequestStarted(kHost1);
+    tracker.onRequestFinished(kHost1, Milliseconds(slowLatency));
+    ASSERT_EQ(*tracker.getLatencyPercentile(kHost1, 100), Milliseconds(slowLatency));
+}
+
+TEST(HostLatencyTrackerTest, OnlyKeepsMostRecentLatencies) {
+    HostLatencyTracker tracker;
+    const int numLatencies = HostLatencyTracker::kWindowSize;
+    recordLatencies(tracker, kHost1, 1, numLatencies);
+    recordLatencies(tracker, kHost1, 1001, 1000 + numLatencies);
+
+    ASSERT_EQ(*tracker.getLatencyPercentile(kHost1, 0), Milliseconds(1001));
+}
+
+TEST(HostLatencyTrackerTest, CountsInFlightRequests) {
+    HostLatencyTracker tracker;
+    tracker.onRequestStarted(kHost1);
+    tracker.onRequestStarted(kHost1);
+    ASSERT_EQ(tracker.getNumInFlight(kHost1), 2);
+
+    // A request which failed without a response still completes but records no latency.
+    tracker.onRequestFinished(kHost1, boost::none);
+    ASSERT_EQ(tracker.getNumInFlight(kHost1), 1);
+    ASSERT_EQ(tracker.getNumInFlight(kHost2), 0);
+}
+
+TEST(HostLatencyTrackerTest, PromotesCheaperOfTwoHosts) {
+    HostLatencyTracker tracker;
+    recordLatencies(tracker, kHost1, 10, 10 + HostLatencyTracker::kMinSamples);
+    recordLatencies(tracker, kHost2, 1, 1 + HostLatencyTracker::kMinSamples);
+
+    std::vector<HostAndPort> hosts{kHost1, kHost2};
+    tracker.promotePowerOfTwoChoice(hosts);
+    ASSERT_EQ(hosts.front(), kHost2);
+
+    // The faster host stops being preferred once it is loaded down with in-flight requests.
+    for (int i = 0; i < 20; ++i) {
+        tracker.onRequestStarted(kHost2);
+    }
+
+    tracker.promotePowerOfTwoChoice(hosts);
+    ASSERT_EQ(hosts.front(), kHost1);
+    ASSERT_EQ(hosts.back(), kHost2);
+}
+
+TEST(HostLatencyTrackerTest, PromotesHostWithoutRecordedLatencies) {
+    HostLatencyTracker tracker;
+    recordLatencies(tracker, kHost1, 1, HostLatencyTracker::kMinSamples);
+
+    std::vector<HostAndPort> hosts{kHost1, kHost2};
+    tracker.promotePowerOfTwoChoice(hosts);
+    ASSERT_EQ(hosts.front(), kHost2);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/wire_version.h"
 #include "mongo/executor/connection_pool_tl.h"
 #include "mongo/executor/hedging_metrics.h"
+#include "mongo/executor/host_latency_tracker.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/transport/transport_layer_manager.h"
@@ -795,6 +796,10 @@ void NetworkInterfaceTL::RequestManager::trySend(
         counters->recordSent();
     }
 
+    if (cmdState->interface->_svcCtx && requestState->request->recordHostLatency) {
+        HostLatencyTracker::get(cmdState->interface->_svcCtx)->onRequestStarted(requestState->host);
+    }
+
     requestState->resolve(cmdState->sendRequest(requestState));
 }
 
@@ -822,6 +827,18 @@ void NetworkInterfaceTL::RequestState::resolve(Future<RemoteCommandResponse> fut
 
             returnConnection(status);
 
+            if (cmdState->interface->_svcCtx && request->recordHostLatency) {
+                // A request which failed says nothing about the latency of the host, unless it was
+                // cancelled because the command finished first, in which case the host took at
+                // least as long as the request waited.
+                const auto abandoned = !status.isOK() && cmdState->finishLine.isReady();
+                HostLatencyTracker::get(cmdState->interface->_svcCtx)
+                    ->onRequestFinished(host,
+                                        status.isOK() || abandoned
+                                            ? boost::make_optional(stopwatch.elapsed())
+                                            : boost::none);
+            }
+
             const auto commandStatus = getStatusFromCommandResult(response.data);
             if (isHedge) {
                 // Ignore maxTimeMS expiration, StaleDbVersion or any error belonging to
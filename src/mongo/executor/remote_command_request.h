@@ -101,6 +101,10 @@ struct RemoteCommandRequestBase {
 
     transport::ConnectSSLMode sslMode = transport::kGlobalSSLMode;
 
+    // When true, the latency of the request is recorded in the HostLatencyTracker, which informs
+    // the choice of host for later reads.
+    bool recordHostLatency = false;
+
 protected:
     ~RemoteCommandRequestBase() = default;
 
@@ -37,6 +37,7 @@
 #include <memory>
 
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/executor/host_latency_tracker.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -176,6 +177,9 @@ auto AsyncRequestsSender::RemoteData::scheduleRequest()
     return resolveShardIdToHostAndPorts(_ars->_readPreference)
         .thenRunOn(*_ars->_subBaton)
         .then([this](auto&& hostAndPorts) {
+            // Of the hosts eligible under the read preference, prefer whichever of two random
+            // choices is expected to respond sooner given its recent latency and current load.
+            HostLatencyTracker::get(_ars->_opCtx)->promotePowerOfTwoChoice(hostAndPorts);
             _shardHostAndPort.emplace(hostAndPorts.front());
             return scheduleRemoteCommand(std::move(hostAndPorts));
         })
@@ -212,12 +216,19 @@ auto AsyncRequestsSender::RemoteData::scheduleRemoteCommand(std::vector<HostAndP
         });
 
     auto hedgeOptions = extractHedgeOptions(_cmdObj, _ars->_readPreference);
+    if (hedgeOptions && hostAndPorts.size() > 1) {
+        hedgeOptions->maxTimeMSForHedgedReads = computeMaxTimeMSForHedgedReads(
+            *HostLatencyTracker::get(_ars->_opCtx),
+            std::vector<HostAndPort>(hostAndPorts.begin() + 1, hostAndPorts.end()));
+    }
     executor::RemoteCommandRequestOnAny request(std::move(hostAndPorts),
                                                 _ars->_db,
                                                 _cmdObj,
                                                 _ars->_metadataObj,
                                                 _ars->_opCtx,
                                                 hedgeOptions);
+    // Only reads which had a choice of host inform the choice for later ones.
+    request.recordHostLatency = request.target.size() > 1;
 
     // We have to make a promise future pair because the TaskExecutor doesn't currently support a
     // future returning variant of scheduleRemoteCommand
@@ -33,6 +33,8 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <limits>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
@@ -111,146 +113,295 @@ std::vector<std::shared_ptr<ChunkInfo>> flatten(const std::vector<ChunkType>& ch
     return flattened;
 }
 
+void checkContiguous(const ChunkInfo& chunk, const ChunkInfo& nextChunk) {
+    if (SimpleBSONObjComparator::kInstance.evaluate(chunk.getMax() == nextChunk.getMin()))
+        return;
+
+    uasserted(ErrorCodes::ConflictingOperationInProgress,
+              str::stream() << (SimpleBSONObjComparator::kInstance.evaluate(chunk.getMax() <
+                                                                          nextChunk.getMin())
+                                    ? "Gap"
+                                    : "Overlap")
+                            << " exists in the routing table between chunks "
+                            << chunk.getRange().toString() << " and "
+                            << nextChunk.getRange().toString());
+}
+
+void validateChunk(const std::shared_ptr<ChunkInfo>& chunk, const ChunkVersion& version) {
+    uassert(ErrorCodes::ConflictingOperationInProgress,
+            str::stream() << "Changed chunk " << chunk->toString()
+                          << " has epoch different from that of the collection " << version.epoch(),
+            version.epoch() == chunk->getLastmod().epoch());
+
+    invariant(version.isOlderOrEqualThan(chunk->getLastmod()));
+}
+
+/**
+ * Returns the position of the first of the 'count' max keys starting at 'first' which does not
+ * sort before 'key' (or, when the max is exclusive, is not less than 'key'), or 'first + count' if
+ * there is none. StringData and std::string both order KeyStrings bytewise.
+ */
+template <typename GetMaxKey>
+size_t searchMaxKeys(const GetMaxKey& getMaxKey,
+                     StringData key,
+                     size_t first,
+                     size_t count,
+                     bool isMaxInclusive) {
+    while (count > 0) {
+        const size_t half = count / 2;
+        const auto maxKey = getMaxKey(first + half);
+        const bool isBeforeKey = isMaxInclusive ? !(key < maxKey) : maxKey < key;
+        if (isBeforeKey) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+
+    return first;
+}
+
+/**
+ * Same as searchMaxKeys() over the max keys [first, size), but gallops forward so that the range
+ * searched grows with the number of max keys skipped, which keeps a pass over sorted keys
+ * proportional to the distance travelled.
+ */
+template <typename GetMaxKey>
+size_t gallopMaxKeys(const GetMaxKey& getMaxKey, StringData key, size_t first, size_t size) {
+    size_t bound = 1;
+    while (first + bound < size && !(key < getMaxKey(first + bound - 1))) {
+        first += bound;
+        bound *= 2;
+    }
+
+    return searchMaxKeys(getMaxKey, key, first, std::min(bound, size - first), true);
+}
+
 }  // namespace
 
-ShardVersionMap ChunkMap::constructShardVersionMap() const {
-    ShardVersionMap shardVersions;
-    ChunkVector::const_iterator current = _chunkMap.cbegin();
-
-    boost::optional<BSONObj> firstMin = boost::none;
-    boost::optional<BSONObj> lastMax = boost::none;
-
-    while (current != _chunkMap.cend()) {
-        const auto& firstChunkInRange = *current;
-        const auto& currentRangeShardId = firstChunkInRange->getShardIdAt(boost::none);
-
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(currentRangeShardId);
-        if (shardVersionIt == shardVersions.end()) {
-            shardVersionIt = shardVersions
-                                 .emplace(std::piecewise_construct,
-                                          std::forward_as_tuple(currentRangeShardId),
-                                          std::forward_as_tuple(_collectionVersion.epoch(),
-                                                                _collectionVersion.getTimestamp()))
-                                 .first;
+ChunkMap::Block::Block(ChunkVector::const_iterator begin, ChunkVector::const_iterator end)
+    : _chunks(begin, end) {
+    invariant(!_chunks.empty());
+    _maxKeyStringEnds.reserve(_chunks.size());
+
+    for (size_t i = 0; i < _chunks.size(); ++i) {
+        const auto& chunk = _chunks[i];
+
+        const auto& maxKeyString = chunk->getMaxKeyString();
+        invariant(_maxKeyStrings.size() + maxKeyString.size() <=
+                  std::numeric_limits<uint32_t>::max());
+        _maxKeyStrings.append(maxKeyString);
+        _maxKeyStringEnds.push_back(static_cast<uint32_t>(_maxKeyStrings.size()));
+
+        const auto& shardId = chunk->getShardIdAt(boost::none);
+        auto it = std::find_if(_shardVersions.begin(), _shardVersions.end(), [&](const auto& entry) {
+            return entry.first == shardId;
+        });
+        if (it == _shardVersions.end()) {
+            _shardVersions.emplace_back(shardId, chunk->getLastmod());
+        } else if (it->second.isOlderThan(chunk->getLastmod())) {
+            it->second = chunk->getLastmod();
         }
 
-        auto& maxShardVersion = shardVersionIt->second.shardVersion;
+        if (i > 0 && !_discontinuity &&
+            !SimpleBSONObjComparator::kInstance.evaluate(_chunks[i - 1]->getMax() ==
+                                                         chunk->getMin())) {
+            _discontinuity = i;
+        }
+    }
+}
 
-        current =
-            std::find_if(current,
-                         _chunkMap.cend(),
-                         [&currentRangeShardId, &maxShardVersion](const auto& currentChunk) {
-                             if (currentChunk->getShardIdAt(boost::none) != currentRangeShardId)
-                                 return true;
+StringData ChunkMap::Block::getMaxKeyString(size_t index) const {
+    const auto begin = index == 0 ? 0 : _maxKeyStringEnds[index - 1];
+    return StringData(_maxKeyStrings.data() + begin, _maxKeyStringEnds[index] - begin);
+}
 
-                             if (maxShardVersion.isOlderThan(currentChunk->getLastmod()))
-                                 maxShardVersion = currentChunk->getLastmod();
+size_t ChunkMap::Block::findChunkIndex(StringData key, size_t first, bool isMaxInclusive) const {
+    return searchMaxKeys([this](size_t index) { return getMaxKeyString(index); },
+                         key,
+                         first,
+                         _chunks.size() - first,
+                         isMaxInclusive);
+}
 
-                             return false;
-                         });
+size_t ChunkMap::Block::findChunkIndexFrom(StringData key, size_t first) const {
+    return gallopMaxKeys(
+        [this](size_t index) { return getMaxKeyString(index); }, key, first, _chunks.size());
+}
 
-        const auto rangeLast = *std::prev(current);
+ShardVersionMap ChunkMap::constructShardVersionMap() const {
+    ShardVersionMap shardVersions;
+    const Block* previousBlock = nullptr;
 
-        const auto& rangeMin = firstChunkInRange->getMin();
-        const auto& rangeMax = rangeLast->getMax();
+    for (const auto& block : _blocks) {
+        // Check the continuity of the chunks map, within the block and with the block before it
+        if (const auto& discontinuity = block->getDiscontinuity()) {
+            checkContiguous(*block->getChunk(*discontinuity - 1),
+                            *block->getChunk(*discontinuity));
+        }
 
-        // Check the continuity of the chunks map
-        if (lastMax && !SimpleBSONObjComparator::kInstance.evaluate(*lastMax == rangeMin)) {
-            if (SimpleBSONObjComparator::kInstance.evaluate(*lastMax < rangeMin))
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream() << "Gap exists in the routing table between chunks "
-                                        << findIntersectingChunk(*lastMax)->getRange().toString()
-                                        << " and " << rangeLast->getRange().toString());
-            else
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream() << "Overlap exists in the routing table between chunks "
-                                        << findIntersectingChunk(*lastMax)->getRange().toString()
-                                        << " and " << rangeLast->getRange().toString());
+        if (previousBlock) {
+            checkContiguous(*previousBlock->getChunk(previousBlock->size() - 1),
+                            *block->getChunk(0));
         }
 
-        if (!firstMin)
-            firstMin = rangeMin;
+        // Tracks the max shard version for each shard on which the chunks of the block reside
+        for (const auto& [shardId, blockShardVersion] : block->getShardVersions()) {
+            auto shardVersionIt = shardVersions.find(shardId);
+            if (shardVersionIt == shardVersions.end()) {
+                shardVersionIt = shardVersions
+                                     .emplace(std::piecewise_construct,
+                                              std::forward_as_tuple(shardId),
+                                              std::forward_as_tuple(
+                                                  _collectionVersion.epoch(),
+                                                  _collectionVersion.getTimestamp()))
+                                     .first;
+            }
+
+            auto& maxShardVersion = shardVersionIt->second.shardVersion;
+            if (maxShardVersion.isOlderThan(blockShardVersion))
+                maxShardVersion = blockShardVersion;
+        }
 
-        lastMax = rangeMax;
+        previousBlock = block.get();
+    }
 
-        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
-        // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
+    // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
+    // somewhere, which should have been caught at chunk load time
+    for (const auto& [shardId, targetingInfo] : shardVersions) {
+        invariant(targetingInfo.shardVersion.isSet());
     }
 
-    if (!_chunkMap.empty()) {
+    if (!_blocks.empty()) {
         invariant(!shardVersions.empty());
-        invariant(firstMin.is_initialized());
-        invariant(lastMax.is_initialized());
 
-        checkAllElementsAreOfType(MinKey, firstMin.get());
-        checkAllElementsAreOfType(MaxKey, lastMax.get());
+        checkAllElementsAreOfType(MinKey, _blocks.front()->getChunk(0)->getMin());
+        checkAllElementsAreOfType(MaxKey,
+                                  _blocks.back()->getChunk(_blocks.back()->size() - 1)->getMax());
     }
 
     return shardVersions;
 }
 
-void ChunkMap::appendChunk(const std::shared_ptr<ChunkInfo>& chunk) {
-    appendChunkTo(_chunkMap, chunk);
-
-    if (_collectionVersion.isOlderThan(chunk->getLastmod()))
-        _collectionVersion = chunk->getLastmod();
-}
-
 std::shared_ptr<ChunkInfo> ChunkMap::findIntersectingChunk(const BSONObj& shardKey) const {
     const auto it = _findIntersectingChunk(shardKey);
 
-    if (it != _chunkMap.end())
+    if (it != _end())
         return *it;
 
     return std::shared_ptr<ChunkInfo>();
 }
 
-void validateChunk(const std::shared_ptr<ChunkInfo>& chunk, const ChunkVersion& version) {
-    uassert(ErrorCodes::ConflictingOperationInProgress,
-            str::stream() << "Changed chunk " << chunk->toString()
-                          << " has epoch different from that of the collection " << version.epoch(),
-            version.epoch() == chunk->getLastmod().epoch());
+size_t ChunkMap::numBlocksSharedWith(const ChunkMap& other) const {
+    std::vector<const Block*> otherBlocks;
+    otherBlocks.reserve(other._blocks.size());
+    for (const auto& block : other._blocks) {
+        otherBlocks.push_back(block.get());
+    }
+    std::sort(otherBlocks.begin(), otherBlocks.end());
 
-    invariant(version.isOlderOrEqualThan(chunk->getLastmod()));
+    return std::count_if(_blocks.begin(), _blocks.end(), [&](const auto& block) {
+        return std::binary_search(otherBlocks.begin(), otherBlocks.end(), block.get());
+    });
 }
 
 ChunkMap ChunkMap::createMerged(
     const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks) const {
-    size_t chunkMapIndex = 0;
+    ChunkMap updatedChunkMap(getVersion().epoch(), getVersion().getTimestamp());
+    updatedChunkMap._collectionVersion = _collectionVersion;
+    updatedChunkMap._blocks.reserve(_blocks.size() + changedChunks.size() / kMaxBlockSize + 1);
+
+    const auto shareBlocks = [&](size_t first, size_t last) {
+        for (; first < last; ++first) {
+            updatedChunkMap._blocks.push_back(_blocks[first]);
+            updatedChunkMap._size += _blocks[first]->size();
+        }
+    };
+
+    size_t blockIndex = 0;
     size_t changedChunkIndex = 0;
 
-    ChunkMap updatedChunkMap(
-        getVersion().epoch(), getVersion().getTimestamp(), _chunkMap.size() + changedChunks.size());
+    while (changedChunkIndex < changedChunks.size()) {
+        // The blocks which end at or before the min of the next changed chunk are kept as they are.
+        auto minKeyString =
+            ShardKeyPattern::toKeyString(changedChunks[changedChunkIndex]->getMin());
+        const size_t firstBlockIndex = _findBlockIndex(minKeyString, blockIndex, true);
+        shareBlocks(blockIndex, firstBlockIndex);
+
+        // Extend the run of blocks to rebuild over all the blocks which the changed chunks
+        // starting inside of it overlap.
+        size_t lastBlockIndex = firstBlockIndex;
+        size_t changedChunkEnd = changedChunkIndex;
+        while (changedChunkEnd < changedChunks.size()) {
+            if (changedChunkEnd > changedChunkIndex) {
+                minKeyString =
+                    ShardKeyPattern::toKeyString(changedChunks[changedChunkEnd]->getMin());
+                if (lastBlockIndex < _blocks.size() &&
+                    !(StringData(minKeyString) <
+                      _blocks[lastBlockIndex - 1]->getLastMaxKeyString())) {
+                    break;
+                }
+            }
 
-    while (chunkMapIndex < _chunkMap.size() || changedChunkIndex < changedChunks.size()) {
-        if (chunkMapIndex >= _chunkMap.size()) {
-            validateChunk(changedChunks[changedChunkIndex], getVersion());
-            updatedChunkMap.appendChunk(changedChunks[changedChunkIndex++]);
-            continue;
+            const auto& maxKeyString = changedChunks[changedChunkEnd++]->getMaxKeyString();
+            lastBlockIndex = std::max(
+                lastBlockIndex,
+                std::min(_findBlockIndex(maxKeyString, firstBlockIndex, false) + 1,
+                         _blocks.size()));
         }
 
-        if (changedChunkIndex >= changedChunks.size()) {
-            updatedChunkMap.appendChunk(_chunkMap[chunkMapIndex++]);
-            continue;
+        // Merge the chunks of the run of blocks with the changed chunks which overlap them
+        ChunkVector chunks;
+        for (size_t i = firstBlockIndex; i < lastBlockIndex; ++i) {
+            const auto& blockChunks = _blocks[i]->getChunks();
+            chunks.insert(chunks.end(), blockChunks.begin(), blockChunks.end());
         }
 
-        auto overlap = _chunkMap[chunkMapIndex]->getRange().overlaps(
-            changedChunks[changedChunkIndex]->getRange());
+        ChunkVector mergedChunks;
+        mergedChunks.reserve(chunks.size() + changedChunkEnd - changedChunkIndex);
 
-        if (overlap) {
-            auto& changedChunk = changedChunks[changedChunkIndex++];
-            auto& chunkInfo = _chunkMap[chunkMapIndex];
+        size_t chunkIndex = 0;
+        while (chunkIndex < chunks.size() || changedChunkIndex < changedChunkEnd) {
+            if (chunkIndex >= chunks.size()) {
+                validateChunk(changedChunks[changedChunkIndex], getVersion());
+                appendChunkTo(mergedChunks, changedChunks[changedChunkIndex++]);
+                continue;
+            }
 
-            auto bytesInReplacedChunk = chunkInfo->getWritesTracker()->getBytesWritten();
-            changedChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
+            if (changedChunkIndex >= changedChunkEnd) {
+                appendChunkTo(mergedChunks, chunks[chunkIndex++]);
+                continue;
+            }
 
-            validateChunk(changedChunk, getVersion());
-            updatedChunkMap.appendChunk(changedChunk);
-        } else {
-            updatedChunkMap.appendChunk(_chunkMap[chunkMapIndex++]);
+            const auto& changedChunk = changedChunks[changedChunkIndex];
+            const auto& chunkInfo = chunks[chunkIndex];
+
+            if (chunkInfo->getRange().overlaps(changedChunk->getRange())) {
+                auto bytesInReplacedChunk = chunkInfo->getWritesTracker()->getBytesWritten();
+                changedChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
+
+                validateChunk(changedChunk, getVersion());
+                appendChunkTo(mergedChunks, changedChunk);
+                ++changedChunkIndex;
+            } else if (changedChunk->getMaxKeyString() < chunkInfo->getMaxKeyString()) {
+                validateChunk(changedChunk, getVersion());
+                appendChunkTo(mergedChunks, changedChunk);
+                ++changedChunkIndex;
+            } else {
+                appendChunkTo(mergedChunks, chunks[chunkIndex++]);
+            }
         }
+
+        updatedChunkMap._appendBlocks(mergedChunks);
+        blockIndex = lastBlockIndex;
+    }
+
+    shareBlocks(blockIndex, _blocks.size());
+
+    for (const auto& changedChunk : changedChunks) {
+        if (updatedChunkMap._collectionVersion.isOlderThan(changedChunk->getLastmod()))
+            updatedChunkMap._collectionVersion = changedChunk->getLastmod();
     }
 
     return updatedChunkMap;
@@ -260,45 +411,71 @@ BSONObj ChunkMap::toBSON() const {
     BSONObjBuilder builder;
 
     builder.append("startingVersion"_sd, getVersion().toBSON());
-    builder.append("chunkCount", static_cast<int64_t>(_chunkMap.size()));
+    builder.append("chunkCount", static_cast<int64_t>(_size));
 
     {
         BSONArrayBuilder arrayBuilder(builder.subarrayStart("chunks"_sd));
-        for (const auto& chunk : _chunkMap) {
+        forEach([&](const auto& chunk) {
             arrayBuilder.append(chunk->toString());
-        }
+            return true;
+        });
     }
 
     return builder.obj();
 }
 
-ChunkMap::ChunkVector::const_iterator ChunkMap::_findIntersectingChunk(const BSONObj& shardKey,
-                                                                       bool isMaxInclusive) const {
-    auto shardKeyString = ShardKeyPattern::toKeyString(shardKey);
+ChunkMap::ConstIterator ChunkMap::_findIntersectingChunk(const BSONObj& shardKey,
+                                                         bool isMaxInclusive) const {
+    const auto shardKeyString = ShardKeyPattern::toKeyString(shardKey);
+    const size_t blockIndex = _findBlockIndex(shardKeyString, 0, isMaxInclusive);
+    if (blockIndex == _blocks.size())
+        return _end();
+
+    return ConstIterator(
+        &_blocks,
+        blockIndex,
+        _blocks[blockIndex]->findChunkIndex(shardKeyString, 0, isMaxInclusive));
+}
 
-    if (!isMaxInclusive) {
-        return std::lower_bound(_chunkMap.begin(),
-                                _chunkMap.end(),
-                                shardKey,
-                                [&shardKeyString](const auto& chunkInfo, const BSONObj& shardKey) {
-                                    return chunkInfo->getMaxKeyString() < shardKeyString;
-                                });
-    } else {
-        return std::upper_bound(_chunkMap.begin(),
-                                _chunkMap.end(),
-                                shardKey,
-                                [&shardKeyString](const BSONObj& shardKey, const auto& chunkInfo) {
-                                    return shardKeyString < chunkInfo->getMaxKeyString();
-                                });
+size_t ChunkMap::_findBlockIndex(StringData key, size_t first, bool isMaxInclusive) const {
+    return searchMaxKeys(
+        [this](size_t index) { return _blocks[index]->getLastMaxKeyString(); },
+        key,
+        first,
+        _blocks.size() - first,
+        isMaxInclusive);
+}
+
+size_t ChunkMap::_findBlockIndexFrom(StringData key, size_t first) const {
+    return gallopMaxKeys([this](size_t index) { return _blocks[index]->getLastMaxKeyString(); },
+                         key,
+                         first,
+                         _blocks.size());
+}
+
+void ChunkMap::_appendBlocks(const ChunkVector& chunks) {
+    if (chunks.empty())
+        return;
+
+    // Spread the chunks evenly so that a run which grew just past the max size does not leave a
+    // tiny block behind.
+    const size_t numBlocks = (chunks.size() + kMaxBlockSize - 1) / kMaxBlockSize;
+    const size_t blockSize = (chunks.size() + numBlocks - 1) / numBlocks;
+
+    for (size_t first = 0; first < chunks.size(); first += blockSize) {
+        const size_t last = std::min(first + blockSize, chunks.size());
+        _blocks.push_back(std::make_shared<const Block>(chunks.begin() + first,
+                                                        chunks.begin() + last));
+        _size += last - first;
     }
 }
 
-std::pair<ChunkMap::ChunkVector::const_iterator, ChunkMap::ChunkVector::const_iterator>
-ChunkMap::_overlappingBounds(const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const {
+std::pair<ChunkMap::ConstIterator, ChunkMap::ConstIterator> ChunkMap::_overlappingBounds(
+    const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const {
     const auto itMin = _findIntersectingChunk(min);
     const auto itMax = [&]() {
         auto it = _findIntersectingChunk(max, isMaxInclusive);
-        return it == _chunkMap.end() ? it : ++it;
+        return it == _end() ? it : ++it;
     }();
 
     return {itMin, itMax};
@@ -782,22 +959,26 @@ RoutingTableHistory RoutingTableHistory::makeUpdatedReplacingTimestamp(
     const boost::optional<Timestamp>& timestamp) const {
     invariant(getVersion().getTimestamp().is_initialized() != timestamp.is_initialized());
 
-    ChunkMap newMap(getVersion().epoch(), timestamp, _chunkMap.size());
+    std::vector<std::shared_ptr<ChunkInfo>> chunks;
+    chunks.reserve(_chunkMap.size());
     _chunkMap.forEach([&](const std::shared_ptr<ChunkInfo>& chunkInfo) {
         const ChunkVersion oldVersion = chunkInfo->getLastmod();
-        newMap.appendChunk(std::make_shared<ChunkInfo>(chunkInfo->getRange(),
-                                                       chunkInfo->getMaxKeyString(),
-                                                       chunkInfo->getShardId(),
-                                                       ChunkVersion(oldVersion.majorVersion(),
-                                                                    oldVersion.minorVersion(),
-                                                                    oldVersion.epoch(),
-                                                                    timestamp),
-                                                       chunkInfo->getHistory(),
-                                                       chunkInfo->isJumbo(),
-                                                       chunkInfo->getWritesTracker()));
+        chunks.push_back(std::make_shared<ChunkInfo>(chunkInfo->getRange(),
+                                                     chunkInfo->getMaxKeyString(),
+                                                     chunkInfo->getShardId(),
+                                                     ChunkVersion(oldVersion.majorVersion(),
+                                                                  oldVersion.minorVersion(),
+                                                                  oldVersion.epoch(),
+                                                                  timestamp),
+                                                     chunkInfo->getHistory(),
+                                                     chunkInfo->isJumbo(),
+                                                     chunkInfo->getWritesTracker()));
         return true;
     });
 
+    // Every chunk changes, so build the new map from scratch rather than merging into this one
+    auto newMap = ChunkMap(getVersion().epoch(), timestamp).createMerged(chunks);
+
     return RoutingTableHistory(_nss,
                                _uuid,
                                getShardKeyPattern().getKeyPattern(),
@@ -76,27 +76,142 @@ class ChunkMap {
     // Vector of chunks ordered by max key.
     using ChunkVector = std::vector<std::shared_ptr<ChunkInfo>>;
 
+    /**
+     * A run of consecutive chunks of the map along with their max KeyStrings, concatenated into
+     * one contiguous buffer, and a summary of the shard versions and continuity of the run. Blocks
+     * are never modified once built, which lets a map produced by createMerged() share with its
+     * source every block that the changed chunks do not touch.
+     */
+    class Block {
+    public:
+        Block(ChunkVector::const_iterator begin, ChunkVector::const_iterator end);
+
+        size_t size() const {
+            return _chunks.size();
+        }
+
+        const std::shared_ptr<ChunkInfo>& getChunk(size_t index) const {
+            return _chunks[index];
+        }
+
+        const ChunkVector& getChunks() const {
+            return _chunks;
+        }
+
+        /**
+         * Returns the max KeyString of the chunk at position 'index' in the block.
+         */
+        StringData getMaxKeyString(size_t index) const;
+
+        StringData getLastMaxKeyString() const {
+            return getMaxKeyString(_chunks.size() - 1);
+        }
+
+        /**
+         * Returns the position of the first chunk at or after 'first' whose max key does not sort
+         * before 'key' (or, when the max is exclusive, is not less than 'key'), or size().
+         */
+        size_t findChunkIndex(StringData key, size_t first, bool isMaxInclusive) const;
+
+        /**
+         * Same as findChunkIndex(), but gallops forward from 'first' so that the cost is
+         * proportional to the distance travelled rather than to the size of the block.
+         */
+        size_t findChunkIndexFrom(StringData key, size_t first) const;
+
+        /**
+         * Max version of the chunks of the block on each shard which owns any of them.
+         */
+        const std::vector<std::pair<ShardId, ChunkVersion>>& getShardVersions() const {
+            return _shardVersions;
+        }
+
+        /**
+         * Position of the first chunk whose min is not the max of the chunk before it, if any.
+         */
+        const boost::optional<size_t>& getDiscontinuity() const {
+            return _discontinuity;
+        }
+
+    private:
+        ChunkVector _chunks;
+
+        // '_maxKeyStringEnds[i]' is the offset in '_maxKeyStrings' just past the key of chunk 'i'.
+        std::string _maxKeyStrings;
+        std::vector<uint32_t> _maxKeyStringEnds;
+
+        std::vector<std::pair<ShardId, ChunkVersion>> _shardVersions;
+        boost::optional<size_t> _discontinuity;
+    };
+
+    using BlockVector = std::vector<std::shared_ptr<const Block>>;
+
+    /**
+     * Forward iterator over the chunks of the map, in order of max key.
+     */
+    class ConstIterator {
+    public:
+        ConstIterator(const BlockVector* blocks, size_t blockIndex, size_t chunkIndex)
+            : _blocks(blocks), _blockIndex(blockIndex), _chunkIndex(chunkIndex) {}
+
+        const std::shared_ptr<ChunkInfo>& operator*() const {
+            return (*_blocks)[_blockIndex]->getChunk(_chunkIndex);
+        }
+
+        ConstIterator& operator++() {
+            if (++_chunkIndex == (*_blocks)[_blockIndex]->size()) {
+                ++_blockIndex;
+                _chunkIndex = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const ConstIterator& other) const {
+            return _blockIndex == other._blockIndex && _chunkIndex == other._chunkIndex;
+        }
+
+        bool operator!=(const ConstIterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        const BlockVector* _blocks;
+        size_t _blockIndex;
+        size_t _chunkIndex;
+    };
+
 public:
-    explicit ChunkMap(OID epoch,
-                      const boost::optional<Timestamp>& timestamp,
-                      size_t initialCapacity = 0)
-        : _collectionVersion(0, 0, epoch, timestamp) {
-        _chunkMap.reserve(initialCapacity);
-    }
+    // Number of chunks above which the run of chunks rebuilt by createMerged() is split into
+    // several blocks. A refresh which changes k chunks rebuilds O(k) blocks of this size and only
+    // copies the pointers to the other blocks.
+    static constexpr size_t kMaxBlockSize = 256;
+
+    explicit ChunkMap(OID epoch, const boost::optional<Timestamp>& timestamp)
+        : _collectionVersion(0, 0, epoch, timestamp) {}
 
     size_t size() const {
-        return _chunkMap.size();
+        return _size;
     }
 
     ChunkVersion getVersion() const {
         return _collectionVersion;
     }
 
+    /**
+     * Number of blocks of the map which are shared with 'other', for example because one of the
+     * maps was produced from the other by createMerged().
+     */
+    size_t numBlocksSharedWith(const ChunkMap& other) const;
+
+    size_t numBlocks() const {
+        return _blocks.size();
+    }
+
     template <typename Callable>
     void forEach(Callable&& handler, const BSONObj& shardKey = BSONObj()) const {
-        auto it = shardKey.isEmpty() ? _chunkMap.begin() : _findIntersectingChunk(shardKey);
+        auto it = shardKey.isEmpty() ? _begin() : _findIntersectingChunk(shardKey);
 
-        for (; it != _chunkMap.end(); ++it) {
+        for (const auto end = _end(); it != end; ++it) {
             if (!handler(*it))
                 break;
         }
@@ -115,22 +230,94 @@ public:
         }
     }
 
+    /**
+     * Resolves 'sortedShardKeyStrings', which must be ShardKeyPattern::toKeyString() encodings in
+     * ascending order, in a single forward pass over the chunks. Calls 'handler(begin, end,
+     * chunkInfo)' for each run of keys [begin, end) which fall in the same chunk, where
+     * 'chunkInfo' is null for the keys which sort after the last chunk.
+     */
+    template <typename Callable>
+    void forEachIntersectingChunk(const std::vector<StringData>& sortedShardKeyStrings,
+                                  Callable&& handler) const {
+        const size_t numKeys = sortedShardKeyStrings.size();
+        size_t blockIndex = 0;
+        size_t chunkIndex = 0;
+
+        for (size_t begin = 0, end = 0; begin < numKeys; begin = end) {
+            const auto key = sortedShardKeyStrings[begin];
+            if (blockIndex < _blocks.size() &&
+                !(key < _blocks[blockIndex]->getMaxKeyString(chunkIndex))) {
+                if (key < _blocks[blockIndex]->getLastMaxKeyString()) {
+                    chunkIndex = _blocks[blockIndex]->findChunkIndexFrom(key, chunkIndex + 1);
+                } else {
+                    blockIndex = _findBlockIndexFrom(key, blockIndex + 1);
+                    chunkIndex = blockIndex < _blocks.size()
+                        ? _blocks[blockIndex]->findChunkIndex(key, 0, true)
+                        : 0;
+                }
+            }
+
+            if (blockIndex == _blocks.size()) {
+                handler(begin, numKeys, nullptr);
+                return;
+            }
+
+            const auto& block = *_blocks[blockIndex];
+            const auto maxKey = block.getMaxKeyString(chunkIndex);
+            for (end = begin + 1; end < numKeys && sortedShardKeyStrings[end] < maxKey; ++end) {
+            }
+
+            handler(begin, end, block.getChunk(chunkIndex).get());
+        }
+    }
+
     ShardVersionMap constructShardVersionMap() const;
     std::shared_ptr<ChunkInfo> findIntersectingChunk(const BSONObj& shardKey) const;
 
-    void appendChunk(const std::shared_ptr<ChunkInfo>& chunk);
-
+    /**
+     * Returns a map with 'changedChunks', which must be ordered by max key and not overlap each
+     * other, replacing the chunks of this map which they overlap. Only the blocks overlapped by
+     * the changed chunks are rebuilt, all the others are shared between the two maps.
+     */
     ChunkMap createMerged(const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks) const;
 
     BSONObj toBSON() const;
 
 private:
-    ChunkVector::const_iterator _findIntersectingChunk(const BSONObj& shardKey,
-                                                       bool isMaxInclusive = true) const;
-    std::pair<ChunkVector::const_iterator, ChunkVector::const_iterator> _overlappingBounds(
-        const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const;
+    ConstIterator _begin() const {
+        return ConstIterator(&_blocks, 0, 0);
+    }
+
+    ConstIterator _end() const {
+        return ConstIterator(&_blocks, _blocks.size(), 0);
+    }
+
+    ConstIterator _findIntersectingChunk(const BSONObj& shardKey, bool isMaxInclusive = true) const;
+    std::pair<ConstIterator, ConstIterator> _overlappingBounds(const BSONObj& min,
+                                                               const BSONObj& max,
+                                                               bool isMaxInclusive) const;
+
+    /**
+     * Returns the position of the first block at or after 'first' whose last max key does not
+     * sort before 'key' (or, when the max is exclusive, is not less than 'key').
+     */
+    size_t _findBlockIndex(StringData key, size_t first, bool isMaxInclusive) const;
+
+    /**
+     * Returns the position of the block containing 'key', or the number of blocks if there is
+     * none, knowing that all the blocks before 'first' end at or before 'key'.
+     */
+    size_t _findBlockIndexFrom(StringData key, size_t first) const;
+
+    /**
+     * Splits 'chunks', which must be ordered by max key, into blocks appended to the map.
+     */
+    void _appendBlocks(const ChunkVector& chunks);
+
+    BlockVector _blocks;
 
-    ChunkVector _chunkMap;
+    // Total number of chunks across '_blocks'
+    size_t _size{0};
 
     // Max version across all chunks
     ChunkVersion _collectionVersion;
@@ -266,6 +453,13 @@ public:
         return _chunkMap.findIntersectingChunk(shardKey);
     }
 
+    template <typename Callable>
+    void forEachIntersectingChunk(const std::vector<StringData>& sortedShardKeyStrings,
+                                  Callable&& handler) const {
+        _chunkMap.forEachIntersectingChunk(sortedShardKeyStrings,
+                                           std::forward<Callable>(handler));
+    }
+
     /**
      * Returns the ids of all shards on which the collection has any chunks.
      */
@@ -607,6 +801,26 @@ public:
      */
     Chunk findIntersectingChunk(const BSONObj& shardKey, const BSONObj& collation) const;
 
+    /**
+     * Batch form of findIntersectingChunkWithSimpleCollation() for shard keys which have been
+     * encoded with ShardKeyPattern::toKeyString() and sorted in ascending order. Calls
+     * 'handler(begin, end, chunk)' for each run of keys [begin, end) which fall in the same chunk,
+     * in a single pass over the routing table. 'chunk' is boost::none for the keys which sort
+     * after the last chunk. Unlike findIntersectingChunk(), the chunk is not checked to contain
+     * the keys, which as they are sorted only needs to be done for the first key of each run.
+     */
+    template <typename Callable>
+    void forEachIntersectingChunkWithSimpleCollation(
+        const std::vector<StringData>& sortedShardKeyStrings, Callable&& handler) const {
+        _rt->optRt->forEachIntersectingChunk(
+            sortedShardKeyStrings, [&](size_t begin, size_t end, ChunkInfo* chunkInfo) {
+                handler(begin,
+                        end,
+                        chunkInfo ? boost::optional<Chunk>(Chunk(*chunkInfo, _clusterTime))
+                                  : boost::none);
+            });
+    }
+
     /**
      * Same as findIntersectingChunk, but assumes the simple collation.
      */
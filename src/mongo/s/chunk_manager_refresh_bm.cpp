@@ -286,6 +286,36 @@ void BM_FindIntersectingChunk(benchmark::State& state,
     state.SetItemsProcessed(state.iterations());
 }
 
+template <typename CollectionMetadataBuilderFn>
+void BM_FindIntersectingChunkAfterIncrementalRefresh(
+    benchmark::State& state, CollectionMetadataBuilderFn makeCollectionMetadata) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+
+    // Move every tenth chunk so that the routing table being searched was produced by merging
+    // changed chunks into an existing one rather than by a full build.
+    auto initialMetadata = makeCollectionMetadata(nShards, nChunks);
+    auto postMoveVersion = initialMetadata.getChunkManager()->getVersion();
+    std::vector<ChunkType> newChunks;
+    for (int i = 0; i < nChunks; i += 10) {
+        postMoveVersion.incMajor();
+        newChunks.emplace_back(
+            kNss, getRangeForChunk(i, nChunks), postMoveVersion, ShardId("shard0"));
+    }
+    auto metadata = runIncrementalUpdate(initialMetadata, newChunks);
+
+    auto keys = makeKeys(nChunks);
+    auto keysIter = makeCircularIterator(keys);
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(
+            metadata.getChunkManager()->findIntersectingChunkWithSimpleCollation(*keysIter));
+        ++keysIter;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
 template <typename CollectionMetadataBuilderFn>
 void BM_GetShardIdsForRange(benchmark::State& state,
                             CollectionMetadataBuilderFn makeCollectionMetadata) {
@@ -386,6 +416,12 @@ MONGO_INITIALIZER(RegisterBenchmarks)(InitializerContext* context) {
             BM_FindIntersectingChunk, Pessimal, makeChunkManagerWithPessimalBalancedDistribution),
         REGISTER_BENCHMARK_CAPTURE(
             BM_FindIntersectingChunk, Optimal, makeChunkManagerWithOptimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(BM_FindIntersectingChunkAfterIncrementalRefresh,
+                                   Pessimal,
+                                   makeChunkManagerWithPessimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(BM_FindIntersectingChunkAfterIncrementalRefresh,
+                                   Optimal,
+                                   makeChunkManagerWithOptimalBalancedDistribution),
         REGISTER_BENCHMARK_CAPTURE(
             BM_GetShardIdsForRange, Pessimal, makeChunkManagerWithPessimalBalancedDistribution),
         REGISTER_BENCHMARK_CAPTURE(
@@ -382,6 +382,81 @@ ShardEndpoint ChunkManagerTargeter::targetInsert(OperationContext* opCtx,
         _nss.isOnInternalDb() ? boost::optional<DatabaseVersion>() : _cm->dbVersion());
 }
 
+NSTargeter::TargetedInserts ChunkManagerTargeter::targetInserts(
+    OperationContext* opCtx, const std::vector<BSONObj>& docs) const {
+    if (!_cm->isSharded()) {
+        return NSTargeter::targetInserts(opCtx, docs);
+    }
+
+    TargetedInserts targeted;
+    targeted.endpointIndexes.reserve(docs.size());
+
+    const auto& shardKeyPattern = _cm->getShardKeyPattern();
+    std::vector<BSONObj> shardKeys(docs.size());
+    std::vector<std::string> shardKeyStrings(docs.size());
+    std::vector<size_t> targetableDocs;
+    targetableDocs.reserve(docs.size());
+
+    for (size_t i = 0; i < docs.size(); ++i) {
+        shardKeys[i] = shardKeyPattern.extractShardKeyFromDoc(docs[i]);
+        // See targetInsert() for why an empty shard key can only come from an array value.
+        if (shardKeys[i].isEmpty()) {
+            targeted.endpointIndexes.emplace_back(
+                Status(ErrorCodes::ShardKeyNotFound,
+                       "Shard key cannot contain array values or array descendants."));
+            continue;
+        }
+
+        shardKeyStrings[i] = ShardKeyPattern::toKeyString(shardKeys[i]);
+        targeted.endpointIndexes.emplace_back(size_t(0));
+        targetableDocs.push_back(i);
+    }
+
+    std::sort(targetableDocs.begin(), targetableDocs.end(), [&](size_t lhs, size_t rhs) {
+        return shardKeyStrings[lhs] < shardKeyStrings[rhs];
+    });
+
+    std::vector<StringData> sortedShardKeyStrings;
+    sortedShardKeyStrings.reserve(targetableDocs.size());
+    for (auto i : targetableDocs) {
+        sortedShardKeyStrings.emplace_back(shardKeyStrings[i]);
+    }
+
+    stdx::unordered_map<ShardId, size_t, ShardId::Hasher> endpointIndexByShard;
+
+    _cm->forEachIntersectingChunkWithSimpleCollation(
+        sortedShardKeyStrings, [&](size_t begin, size_t end, boost::optional<Chunk> chunk) {
+            if (!chunk || !chunk->containsKey(shardKeys[targetableDocs[begin]])) {
+                // The routing table has no chunk for the start of this run, so leave it to
+                // targetInsert() to work out which of its documents can be targeted.
+                for (size_t sortedIndex = begin; sortedIndex < end; ++sortedIndex) {
+                    const size_t i = targetableDocs[sortedIndex];
+                    try {
+                        auto endpoint = targetInsert(opCtx, docs[i]);
+                        targeted.endpointIndexes[i] = targeted.endpoints.size();
+                        targeted.endpoints.push_back(std::move(endpoint));
+                    } catch (const DBException& ex) {
+                        targeted.endpointIndexes[i] = ex.toStatus();
+                    }
+                }
+                return;
+            }
+
+            const auto& shardId = chunk->getShardId();
+            auto it = endpointIndexByShard.find(shardId);
+            if (it == endpointIndexByShard.end()) {
+                it = endpointIndexByShard.emplace(shardId, targeted.endpoints.size()).first;
+                targeted.endpoints.emplace_back(shardId, _cm->getVersion(shardId), boost::none);
+            }
+
+            for (size_t sortedIndex = begin; sortedIndex < end; ++sortedIndex) {
+                targeted.endpointIndexes[targetableDocs[sortedIndex]] = it->second;
+            }
+        });
+
+    return targeted;
+}
+
 std::vector<ShardEndpoint> ChunkManagerTargeter::targetUpdate(OperationContext* opCtx,
                                                               const BatchItemRef& itemRef) const {
     // If the update is replacement-style:
@@ -76,6 +76,13 @@ public:
 
     ShardEndpoint targetInsert(OperationContext* opCtx, const BSONObj& doc) const override;
 
+    /**
+     * Extracts the shard keys of all of 'docs', sorts them and resolves them against the routing
+     * table in a single pass, instead of searching the routing table once per document.
+     */
+    TargetedInserts targetInserts(OperationContext* opCtx,
+                                  const std::vector<BSONObj>& docs) const override;
+
     std::vector<ShardEndpoint> targetUpdate(OperationContext* opCtx,
                                             const BatchItemRef& itemRef) const override;
 
@@ -144,6 +144,44 @@ TEST_F(ChunkManagerTargeterTest, TargetInsertsWithVaryingHashedPrefixAndConstant
                        ErrorCodes::ShardKeyNotFound);
 }
 
+TEST_F(ChunkManagerTargeterTest, TargetInsertsInBatchMatchesTargetingEachDocument) {
+    // Create 5 chunks and 5 shards such that shardId '0' has chunk [MinKey, null), '1' has chunk
+    // [null, -100), '2' has chunk [-100, 0), '3' has chunk ['0', 100) and '4' has chunk
+    // [100, MaxKey).
+    std::vector<BSONObj> splitPoints = {
+        BSON("a.b" << BSONNULL), BSON("a.b" << -100), BSON("a.b" << 0), BSON("a.b" << 100)};
+    auto cmTargeter = prepare(BSON("a.b" << 1 << "c.d"
+                                         << "hashed"),
+                              splitPoints);
+
+    // Interleave the shards and sprinkle in documents which cannot be targeted, so that the
+    // sorted pass has to put the results back into document order.
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 500; i++) {
+        docs.push_back(BSON("a" << BSON("b" << ((i * 37) % 400) - 200) << "c" << BSON("d" << i)));
+        if (i % 50 == 0) {
+            docs.push_back(fromjson("{a: [1,2]}"));
+            docs.push_back(BSONObj());
+        }
+    }
+
+    const auto targeted = cmTargeter.targetInserts(operationContext(), docs);
+    ASSERT_EQ(docs.size(), targeted.endpointIndexes.size());
+    ASSERT_EQ(4U, targeted.endpoints.size());
+
+    for (size_t i = 0; i < docs.size(); i++) {
+        const auto& swEndpointIndex = targeted.endpointIndexes[i];
+        try {
+            auto expected = cmTargeter.targetInsert(operationContext(), docs[i]);
+            ASSERT_OK(swEndpointIndex.getStatus());
+            ASSERT_EQUALS(expected.shardName,
+                          targeted.endpoints[swEndpointIndex.getValue()].shardName);
+        } catch (const DBException& ex) {
+            ASSERT_EQUALS(ex.code(), swEndpointIndex.getStatus().code());
+        }
+    }
+}
+
 TEST_F(ChunkManagerTargeterTest, TargetInsertsWithConstantHashedPrefixAndVaryingRangedSuffix) {
     // For the purpose of this test, we will keep the hashed field constant to 0 so that we can
     // correctly test the targeting based on range field.
@@ -165,4 +165,134 @@ TEST_F(ChunkMapTest, TestEnumerateOverlappingChunks) {
     ASSERT_EQ(count, 3);
 }
 
+TEST_F(ChunkMapTest, TestIntersectingChunkAfterIncrementalMerge) {
+    const OID epoch = OID::gen();
+    ChunkMap chunkMap{epoch, boost::none /* timestamp */};
+    ChunkVersion version{1, 0, epoch, boost::none /* timestamp */};
+
+    auto initialChunkMap = chunkMap.createMerged(
+        {std::make_shared<ChunkInfo>(
+             ChunkType{kNss,
+                       ChunkRange{getShardKeyPattern().globalMin(), BSON("a" << 0)},
+                       version,
+                       kThisShard}),
+
+         std::make_shared<ChunkInfo>(
+             ChunkType{kNss, ChunkRange{BSON("a" << 0), BSON("a" << 100)}, version, kThisShard}),
+
+         std::make_shared<ChunkInfo>(ChunkType{
+             kNss,
+             ChunkRange{BSON("a" << 100), getShardKeyPattern().globalMax()},
+             version,
+             kThisShard})});
+
+    // Split the middle chunk.
+    version.incMajor();
+    ChunkVersion splitVersion = version;
+    version.incMinor();
+    auto newChunkMap = initialChunkMap.createMerged(
+        {std::make_shared<ChunkInfo>(ChunkType{
+             kNss, ChunkRange{BSON("a" << 0), BSON("a" << 50)}, splitVersion, kThisShard}),
+         std::make_shared<ChunkInfo>(
+             ChunkType{kNss, ChunkRange{BSON("a" << 50), BSON("a" << 100)}, version, kThisShard})});
+
+    ASSERT_EQ(newChunkMap.size(), 4);
+
+    auto assertIntersects = [&](const BSONObj& shardKey, const BSONObj& min, const BSONObj& max) {
+        auto chunk = newChunkMap.findIntersectingChunk(shardKey);
+        ASSERT(chunk);
+        ASSERT_BSONOBJ_EQ(chunk->getMin(), min);
+        ASSERT_BSONOBJ_EQ(chunk->getMax(), max);
+    };
+    assertIntersects(BSON("a" << -10), getShardKeyPattern().globalMin(), BSON("a" << 0));
+    assertIntersects(BSON("a" << 0), BSON("a" << 0), BSON("a" << 50));
+    assertIntersects(BSON("a" << 25), BSON("a" << 0), BSON("a" << 50));
+    assertIntersects(BSON("a" << 50), BSON("a" << 50), BSON("a" << 100));
+    assertIntersects(BSON("a" << 99), BSON("a" << 50), BSON("a" << 100));
+    assertIntersects(BSON("a" << 100), BSON("a" << 100), getShardKeyPattern().globalMax());
+
+    // A range ending exactly on a chunk boundary does not include the next chunk when the max is
+    // exclusive.
+    int count = 0;
+    newChunkMap.forEachOverlappingChunk(BSON("a" << 10), BSON("a" << 50), false, [&](const auto&) {
+        count++;
+        return true;
+    });
+    ASSERT_EQ(count, 1);
+}
+
+TEST_F(ChunkMapTest, IncrementalMergeOnlyRebuildsTouchedBlocks) {
+    const OID epoch = OID::gen();
+    ChunkMap chunkMap{epoch, boost::none /* timestamp */};
+    ChunkVersion version{1, 0, epoch, boost::none /* timestamp */};
+
+    // Enough chunks to span several blocks: [MinKey, 0), [0, 10), ..., [9980, MaxKey)
+    const int numChunks = 1000;
+    std::vector<std::shared_ptr<ChunkInfo>> chunks;
+    for (int i = 0; i < numChunks; ++i) {
+        const auto min = i == 0 ? getShardKeyPattern().globalMin() : BSON("a" << (i - 1) * 10);
+        const auto max =
+            i == numChunks - 1 ? getShardKeyPattern().globalMax() : BSON("a" << i * 10);
+        chunks.push_back(std::make_shared<ChunkInfo>(
+            ChunkType{kNss, ChunkRange{min, max}, version, kThisShard}));
+        version.incMinor();
+    }
+
+    auto initialChunkMap = chunkMap.createMerged(chunks);
+    ASSERT_EQ(initialChunkMap.size(), numChunks);
+    ASSERT_GT(initialChunkMap.numBlocks(), 1);
+
+    // Split the chunk [5000, 5010) in the middle of the map.
+    version.incMajor();
+    ChunkVersion splitVersion = version;
+    version.incMinor();
+    auto newChunkMap = initialChunkMap.createMerged(
+        {std::make_shared<ChunkInfo>(ChunkType{
+             kNss, ChunkRange{BSON("a" << 5000), BSON("a" << 5005)}, splitVersion, kThisShard}),
+         std::make_shared<ChunkInfo>(ChunkType{
+             kNss, ChunkRange{BSON("a" << 5005), BSON("a" << 5010)}, version, kThisShard})});
+
+    ASSERT_EQ(newChunkMap.size(), numChunks + 1);
+    ASSERT_EQ(newChunkMap.getVersion(), version);
+    ASSERT_EQ(newChunkMap.numBlocksSharedWith(initialChunkMap), initialChunkMap.numBlocks() - 1);
+    ASSERT_EQ(newChunkMap.constructShardVersionMap().at(kThisShard).shardVersion, version);
+
+    auto chunk = newChunkMap.findIntersectingChunk(BSON("a" << 5007));
+    ASSERT(chunk);
+    ASSERT_BSONOBJ_EQ(chunk->getMin(), BSON("a" << 5005));
+    ASSERT_BSONOBJ_EQ(chunk->getMax(), BSON("a" << 5010));
+
+    // The source map is left untouched.
+    chunk = initialChunkMap.findIntersectingChunk(BSON("a" << 5007));
+    ASSERT(chunk);
+    ASSERT_BSONOBJ_EQ(chunk->getMin(), BSON("a" << 5000));
+    ASSERT_BSONOBJ_EQ(chunk->getMax(), BSON("a" << 5010));
+
+    // Iteration and key resolution cross block boundaries in order.
+    int count = 0;
+    auto lastMax = getShardKeyPattern().globalMin();
+    newChunkMap.forEach([&](const auto& chunkInfo) {
+        ASSERT_BSONOBJ_EQ(chunkInfo->getMin(), lastMax);
+        lastMax = chunkInfo->getMax();
+        count++;
+        return true;
+    });
+    ASSERT_EQ(count, numChunks + 1);
+
+    std::vector<std::string> keyStrings;
+    for (int i = 0; i < numChunks * 10; i += 7) {
+        keyStrings.push_back(ShardKeyPattern::toKeyString(BSON("a" << i)));
+    }
+    std::vector<StringData> sortedKeyStrings(keyStrings.begin(), keyStrings.end());
+
+    newChunkMap.forEachIntersectingChunk(
+        sortedKeyStrings, [&](size_t begin, size_t end, const ChunkInfo* chunkInfo) {
+            ASSERT(chunkInfo);
+            for (size_t i = begin; i < end; ++i) {
+                const auto key = BSON("a" << static_cast<int>(i * 7));
+                ASSERT(chunkInfo->containsKey(key));
+            }
+        });
+}
+
 }  // namespace mongo
@@ -62,6 +62,37 @@ public:
      */
     uint64_t clearBytesWritten();
 
+    /**
+     * Records one write of 'bytesWritten' bytes against the chunk, for reporting the load on the
+     * chunk to the balancer. Unlike the bytes written tracked for splitting, these counters are
+     * never cleared.
+     */
+    void addOperation(uint64_t bytesWritten) {
+        _numOperations.fetchAndAdd(1);
+        _operationBytes.fetchAndAdd(bytesWritten);
+    }
+
+    /**
+     * Returns the total number of operations recorded against the chunk.
+     */
+    uint64_t getNumOperations() {
+        return _numOperations.loadRelaxed();
+    }
+
+    /**
+     * Returns the total number of bytes written by the operations recorded against the chunk.
+     */
+    uint64_t getOperationBytes() {
+        return _operationBytes.loadRelaxed();
+    }
+
+    /**
+     * Marks the chunk as registered for load reporting. Returns false if it already was.
+     */
+    bool markRegisteredForLoadReporting() {
+        return !_registeredForLoadReporting.swap(true);
+    }
+
     /**
      * Returns whether or not this chunk is ready to be split based on the
      * maximum allowable size of a chunk.
@@ -86,6 +117,18 @@ private:
      */
     AtomicWord<unsigned long long> _bytesWritten{0};
 
+    /**
+     * The number of operations and the bytes they wrote, used for load reporting. May be modified
+     * concurrently by several threads.
+     */
+    AtomicWord<unsigned long long> _numOperations{0};
+    AtomicWord<unsigned long long> _operationBytes{0};
+
+    /**
+     * Whether or not the chunk has been registered for load reporting.
+     */
+    AtomicWord<bool> _registeredForLoadReporting{false};
+
     /**
      * Protects _splitState when starting a split.
      */
@@ -64,6 +64,29 @@ TEST(ChunkWritesTrackerTest, ClearBytesWrittenReturnsBytesWrittenBeforeClearing)
     ASSERT_EQ(previousBytesWritten, bytesToAdd);
 }
 
+TEST(ChunkWritesTrackerTest, AddOperationCountsOperationsAndBytes) {
+    ChunkWritesTracker wt;
+    wt.addOperation(4ull);
+    wt.addOperation(6ull);
+    ASSERT_EQ(wt.getNumOperations(), 2ull);
+    ASSERT_EQ(wt.getOperationBytes(), 10ull);
+}
+
+TEST(ChunkWritesTrackerTest, ClearBytesWrittenDoesNotClearOperations) {
+    ChunkWritesTracker wt;
+    wt.addBytesWritten(4ull);
+    wt.addOperation(4ull);
+    wt.clearBytesWritten();
+    ASSERT_EQ(wt.getNumOperations(), 1ull);
+    ASSERT_EQ(wt.getOperationBytes(), 4ull);
+}
+
+TEST(ChunkWritesTrackerTest, MarkRegisteredForLoadReportingSucceedsOnce) {
+    ChunkWritesTracker wt;
+    ASSERT_TRUE(wt.markRegisteredForLoadReporting());
+    ASSERT_FALSE(wt.markRegisteredForLoadReporting());
+}
+
 TEST(ChunkWritesTrackerTest, ShouldSplitReturnsTrueWithBytesWrittenAndMaxChunkSizeZero) {
     ChunkWritesTracker wt;
     wt.addBytesWritten(4ull);
@@ -29,6 +29,9 @@
 
 #include "mongo/s/hedge_options_util.h"
 
+#include <algorithm>
+
+#include "mongo/executor/host_latency_tracker.h"
 #include "mongo/s/mongos_server_parameters_gen.h"
 
 namespace mongo {
@@ -63,4 +66,23 @@ boost::optional<executor::RemoteCommandRequestOnAny::HedgeOptions> extractHedgeO
     return boost::none;
 }
 
+int computeMaxTimeMSForHedgedReads(const HostLatencyTracker& tracker,
+                                   const std::vector<HostAndPort>& hedgeTargets) {
+    const auto percentile = gHedgedReadsLatencyPercentile.load();
+    if (percentile == 0 || hedgeTargets.empty()) {
+        return gMaxTimeMSForHedgedReads.load();
+    }
+
+    Milliseconds maxTime{1};
+    for (const auto& host : hedgeTargets) {
+        auto latency = tracker.getLatencyPercentile(host, percentile);
+        if (!latency) {
+            return gMaxTimeMSForHedgedReads.load();
+        }
+        maxTime = std::max(maxTime, *latency);
+    }
+
+    return durationCount<Milliseconds>(maxTime);
+}
+
 }  // namespace mongo
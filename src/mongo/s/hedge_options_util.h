@@ -30,11 +30,16 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
 #include "mongo/client/read_preference.h"
 #include "mongo/executor/remote_command_request.h"
+#include "mongo/util/net/hostandport.h"
 
 namespace mongo {
 
+class HostLatencyTracker;
+
 /**
  * Constructs and returns hedge options based on the given cmd object and read preference
  * setting. If no hedging should be performed, returns boost::none.
@@ -42,4 +47,14 @@ namespace mongo {
 boost::optional<executor::RemoteCommandRequestOnAny::HedgeOptions> extractHedgeOptions(
     const BSONObj& cmdObj, const ReadPreferenceSetting& readPref);
 
+/**
+ * Returns the maxTimeMS to set on hedged requests which may be sent to any of 'hedgeTargets'. This
+ * is the hedgedReadsLatencyPercentile of the latencies 'tracker' recently observed for the slowest
+ * of those hosts, so a hedge is given about as long as a typical request to its host takes. Returns
+ * maxTimeMSForHedgedReads when that percentile is disabled or any of the hosts hasn't been observed
+ * enough yet.
+ */
+int computeMaxTimeMSForHedgedReads(const HostLatencyTracker& tracker,
+                                   const std::vector<HostAndPort>& hedgeTargets);
+
 }  // namespace mongo
@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/client/read_preference.h"
+#include "mongo/executor/host_latency_tracker.h"
 #include "mongo/s/hedge_options_util.h"
 #include "mongo/s/mongos_server_parameters_gen.h"
 #include "mongo/unittest/unittest.h"
@@ -94,9 +95,13 @@ protected:
     static inline const std::string kMaxTimeMSForHedgedReadsFieldName = "maxTimeMSForHedgedReads";
     static inline const int kMaxTimeMSForHedgedReadsDefault = 10;
 
+    static inline const std::string kHedgedReadsLatencyPercentileFieldName =
+        "hedgedReadsLatencyPercentile";
+
     static inline const BSONObj kDefaultParameters =
         BSON(kReadHedgingModeFieldName << "on" << kMaxTimeMSForHedgedReadsFieldName
-                                       << kMaxTimeMSForHedgedReadsDefault);
+                                       << kMaxTimeMSForHedgedReadsDefault
+                                       << kHedgedReadsLatencyPercentileFieldName << 95);
 
 private:
     ServiceContext::UniqueServiceContext _serviceCtx = ServiceContext::make();
@@ -191,5 +196,27 @@ TEST_F(HedgeOptionsUtilTestFixture, MaxTimeMSForHedgedReads) {
     checkHedgeOptions(parameters, cmdObj, rspObj, true, 100);
 }
 
+TEST_F(HedgeOptionsUtilTestFixture, MaxTimeMSFromObservedLatencyPercentile) {
+    const HostAndPort host1("host1", 27017);
+    const HostAndPort host2("host2", 27017);
+    const HostAndPort unobservedHost("host3", 27017);
+
+    HostLatencyTracker tracker;
+    for (int i = 1; i <= 80; ++i) {
+        tracker.onRequestStarted(host1);
+        tracker.onRequestFinished(host1, Milliseconds(i));
+        tracker.onRequestStarted(host2);
+        tracker.onRequestFinished(host2, Milliseconds(2 * i));
+    }
+
+    ASSERT_EQ(computeMaxTimeMSForHedgedReads(tracker, {host1}), 76);
+    ASSERT_EQ(computeMaxTimeMSForHedgedReads(tracker, {host1, host2}), 152);
+    ASSERT_EQ(computeMaxTimeMSForHedgedReads(tracker, {host1, unobservedHost}),
+              kMaxTimeMSForHedgedReadsDefault);
+
+    setParameters(BSON(kHedgedReadsLatencyPercentileFieldName << 0));
+    ASSERT_EQ(computeMaxTimeMSForHedgedReads(tracker, {host1}), kMaxTimeMSForHedgedReadsDefault);
+}
+
 }  // namespace
 }  // namespace mongo
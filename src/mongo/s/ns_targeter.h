@@ -76,6 +76,41 @@ public:
      */
     virtual ShardEndpoint targetInsert(OperationContext* opCtx, const BSONObj& doc) const = 0;
 
+    /**
+     * The result of targeting a batch of documents with targetInserts().
+     */
+    struct TargetedInserts {
+        // The endpoints which the documents target. Implementations should list each endpoint
+        // once, so that callers can group the documents by position, but are not required to.
+        std::vector<ShardEndpoint> endpoints;
+
+        // For each document, in order, the position in 'endpoints' of the endpoint which it
+        // targets, or the error which targetInsert() would have thrown for it.
+        std::vector<StatusWith<size_t>> endpointIndexes;
+    };
+
+    /**
+     * Batch form of targetInsert(), which targets all of 'docs' at once. Implementations should
+     * override it when they can target many documents more cheaply than one at a time.
+     */
+    virtual TargetedInserts targetInserts(OperationContext* opCtx,
+                                          const std::vector<BSONObj>& docs) const {
+        TargetedInserts targeted;
+        targeted.endpointIndexes.reserve(docs.size());
+
+        for (const auto& doc : docs) {
+            try {
+                auto endpoint = targetInsert(opCtx, doc);
+                targeted.endpointIndexes.emplace_back(targeted.endpoints.size());
+                targeted.endpoints.push_back(std::move(endpoint));
+            } catch (const DBException& ex) {
+                targeted.endpointIndexes.emplace_back(ex.toStatus());
+            }
+        }
+
+        return targeted;
+    }
+
     /**
      * Returns a vector of ShardEndpoints for a potentially multi-shard update or throws
      * ShardKeyNotFound if 'updateOp' misses a shard key, but the type of update requires it.
@@ -41,6 +41,8 @@
 #include "mongo/db/query/getmore_command_gen.h"
 #include "mongo/db/query/kill_cursors_gen.h"
 #include "mongo/db/query/query_feature_flags_gen.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/s/catalog/type_shard.h"
@@ -95,6 +97,17 @@ int compareSortKeys(BSONObj leftSortKey, BSONObj rightSortKey, BSONObj sortKeyPa
     return leftSortKey.woCompare(rightSortKey, sortKeyPattern, rules);
 }
 
+/**
+ * Returns the ordering with which to encode sort keys as KeyStrings for the merge, or boost::none
+ * if there is no sort or its pattern has more fields than a KeyString ordering can describe.
+ */
+boost::optional<Ordering> makeSortKeyOrdering(const boost::optional<BSONObj>& sort) {
+    if (!sort || static_cast<size_t>(sort->nFields()) > Ordering::kMaxCompoundIndexKeys) {
+        return boost::none;
+    }
+    return Ordering::make(*sort);
+}
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
@@ -107,8 +120,11 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       // since that is not supported we treat boost::none (unspecified) to mean 'kNormal'.
       _tailableMode(params.getTailableMode().value_or(TailableModeEnum::kNormal)),
       _params(std::move(params)),
-      _mergeQueue(MergingComparator(
-          _remotes, _params.getSort().value_or(BSONObj()), _params.getCompareWholeSortKey())),
+      _sortKeyOrdering(makeSortKeyOrdering(_params.getSort())),
+      _mergeTree(_remotes,
+                 _params.getSort().value_or(BSONObj()),
+                 _params.getCompareWholeSortKey(),
+                 _sortKeyOrdering.has_value()),
       _promisedMinSortKeys(PromisedMinSortKeyComparator(_params.getSort().value_or(BSONObj()))) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
@@ -315,11 +331,11 @@ bool AsyncResultsMerger::_readySorted(WithLock lk) {
 }
 
 bool AsyncResultsMerger::_readySortedTailable(WithLock lk) {
-    if (_mergeQueue.empty()) {
+    if (_mergeTree.empty()) {
         return false;
     }
 
-    auto smallestRemote = _mergeQueue.top();
+    auto smallestRemote = _mergeTree.top();
     auto smallestResult = _remotes[smallestRemote].docBuffer.front();
     auto keyWeWantToReturn =
         extractSortKey(*smallestResult.getResult(), _params.getCompareWholeSortKey());
@@ -363,29 +379,29 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
-    if (_mergeQueue.empty()) {
+    if (_mergeTree.empty()) {
         return {};
     }
 
-    size_t smallestRemote = _mergeQueue.top();
-    _mergeQueue.pop();
+    size_t smallestRemote = _mergeTree.top();
 
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
-
-    // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
-    // next result.
-    if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
+    if (_sortKeyOrdering) {
+        _remotes[smallestRemote].sortKeyBuffer.pop();
     }
 
+    // Replay 'smallestRemote' in the merging tree with its next result, if it has one.
+    _mergeTree.update(smallestRemote);
+    _prefetchNextBatchIfLow(lk, smallestRemote);
+
     // For sorted tailable awaitData cursors, update the high water mark to the document's sort key.
     if (_tailableMode == TailableModeEnum::kTailableAndAwaitData) {
         if (_remotes[smallestRemote].eligibleForHighWaterMark) {
@@ -487,6 +503,25 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     return Status::OK();
 }
 
+void AsyncResultsMerger::_prefetchNextBatchIfLow(WithLock lk, size_t remoteIndex) {
+    // Only plain sorted merges prefetch. Tailable cursors wait on the remote for new results, and
+    // an empty buffer is already handled by nextEvent().
+    auto& remote = _remotes[remoteIndex];
+    if (_tailableMode != TailableModeEnum::kNormal || !remote.hasNext() || remote.exhausted() ||
+        remote.cbHandle.isValid() || !remote.status.isOK() || _lifecycleState != kAlive ||
+        !_opCtx) {
+        return;
+    }
+
+    const auto prefetchPercent =
+        static_cast<size_t>(std::max(0, internalQueryMergePrefetchPercent.load()));
+    if (remote.docBuffer.size() * 100 >= remote.lastBatchSize * prefetchPercent) {
+        return;
+    }
+
+    remote.status = _askForNextBatch(lk, remoteIndex);
+}
+
 Status AsyncResultsMerger::scheduleGetMores() {
     stdx::lock_guard<Latch> lk(_mutex);
     return _scheduleGetMores(lk);
@@ -736,6 +771,12 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         remote.partialResultsReturned = (remote.status != ErrorCodes::ExchangePassthrough);
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        std::queue<std::string> emptySortKeyBuffer;
+        std::swap(remote.sortKeyBuffer, emptySortKeyBuffer);
+        if (_params.getSort()) {
+            // A prefetched batch may have failed while earlier results were still buffered.
+            _mergeTree.update(remoteIndex);
+        }
         remote.status = Status::OK();
         remote.cursorId = 0;
     }
@@ -790,6 +831,7 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            size_t remoteIndex,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
+    const bool wasBufferEmpty = !remote.hasNext();
     _updateRemoteMetadata(lk, remoteIndex, response);
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
@@ -810,15 +852,27 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
             }
         }
 
+        if (_sortKeyOrdering) {
+            KeyString::Builder sortKeyString(
+                KeyString::Version::kLatestVersion,
+                extractSortKey(obj, _params.getCompareWholeSortKey()),
+                *_sortKeyOrdering);
+            remote.sortKeyBuffer.emplace(sortKeyString.getBuffer(), sortKeyString.getSize());
+        }
+
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
         ++remote.fetchedCount;
     }
 
-    // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
-    // queue.
-    if (_params.getSort() && !response.getBatch().empty()) {
-        _mergeQueue.push(remoteIndex);
+    if (!response.getBatch().empty()) {
+        remote.lastBatchSize = response.getBatch().size();
+    }
+
+    // If we're doing a sorted merge, then we have to make sure this remote takes part in the merge
+    // tree. A remote which already had buffered results is there, with the same next result.
+    if (_params.getSort() && !response.getBatch().empty() && wasBufferEmpty) {
+        _mergeTree.update(remoteIndex);
     }
     return true;
 }
@@ -921,16 +975,65 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 }
 
 //
-// AsyncResultsMerger::MergingComparator
+// AsyncResultsMerger::MergeTree
 //
 
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+bool AsyncResultsMerger::MergeTree::empty() const {
+    return _nodes.empty() || _nodes[1] == kNoRemote;
+}
+
+size_t AsyncResultsMerger::MergeTree::top() const {
+    invariant(!empty());
+    return _nodes[1];
+}
+
+void AsyncResultsMerger::MergeTree::update(size_t remoteIndex) {
+    if (remoteIndex >= _numLeaves) {
+        // Rebuild the tree with room for all of the remotes, which doubles its capacity at least.
+        size_t numLeaves = std::max<size_t>(_numLeaves, 1);
+        while (numLeaves < _remotes.size()) {
+            numLeaves *= 2;
+        }
+
+        _numLeaves = numLeaves;
+        _nodes.assign(2 * _numLeaves, kNoRemote);
+        for (size_t i = 0; i < _remotes.size(); ++i) {
+            _nodes[_numLeaves + i] = _remotes[i].hasNext() ? i : kNoRemote;
+        }
+        for (size_t node = _numLeaves - 1; node > 0; --node) {
+            _nodes[node] = _play(_nodes[2 * node], _nodes[2 * node + 1]);
+        }
+        return;
+    }
+
+    size_t node = _numLeaves + remoteIndex;
+    _nodes[node] = _remotes[remoteIndex].hasNext() ? remoteIndex : kNoRemote;
+    for (node /= 2; node > 0; node /= 2) {
+        _nodes[node] = _play(_nodes[2 * node], _nodes[2 * node + 1]);
+    }
+}
+
+size_t AsyncResultsMerger::MergeTree::_play(size_t lhs, size_t rhs) const {
+    if (lhs == kNoRemote) {
+        return rhs;
+    }
+    if (rhs == kNoRemote) {
+        return lhs;
+    }
+
+    if (_compareKeyStrings) {
+        return _remotes[rhs].sortKeyBuffer.front() < _remotes[lhs].sortKeyBuffer.front() ? rhs
+                                                                                           : lhs;
+    }
+
     const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
     const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
 
-    return compareSortKeys(extractSortKey(*leftDoc.getResult(), _compareWholeSortKey),
-                           extractSortKey(*rightDoc.getResult(), _compareWholeSortKey),
-                           _sort) > 0;
+    return compareSortKeys(extractSortKey(*rightDoc.getResult(), _compareWholeSortKey),
+                           extractSortKey(*leftDoc.getResult(), _compareWholeSortKey),
+                           _sort) < 0
+        ? rhs
+        : lhs;
 }
 
 bool AsyncResultsMerger::PromisedMinSortKeyComparator::operator()(
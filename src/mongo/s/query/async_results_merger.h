@@ -30,11 +30,14 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <limits>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/platform/mutex.h"
@@ -67,6 +70,9 @@ class CursorResponse;
  * must be sorted, we pass the sort through to the remote nodes and then merge the sorted streams.
  * This requires waiting until we have a response from every remote before returning results.
  * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
+ * When merging sorted streams, the next batch is requested from a remote as soon as the results
+ * buffered from it run low, rather than once they run out, so that the merge does not stall on a
+ * round trip to every remote in turn.
  *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
@@ -90,7 +96,7 @@ public:
      *
      * Additionally copies each remote's first batch of results, if one exists, into that remote's
      * docBuffer. If a sort is specified in the ClusterClientCursorParams, places the remotes with
-     * buffered results onto _mergeQueue.
+     * buffered results into _mergeTree.
      *
      * The TaskExecutor* must remain valid for the lifetime of the ARM.
      *
@@ -306,6 +312,14 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // When merging sorted results, the KeyString encodings of the sort keys of the results in
+        // 'docBuffer', in the same order, so that the merge compares them bytewise. Empty if the
+        // sort pattern has too many fields to be encoded as a KeyString.
+        std::queue<std::string> sortKeyBuffer;
+
+        // The number of results in the last non-empty batch received from this remote.
+        size_t lastBatchSize = 0;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -321,16 +335,50 @@ private:
         bool invalidated = false;
     };
 
-    class MergingComparator {
+    /**
+     * A tournament tree over the remotes, which finds the remote whose next buffered result sorts
+     * first. Each leaf is a remote and each internal node holds the winner of the match between
+     * its children, where a remote with nothing buffered loses to any other. When the next result
+     * of a remote changes, only the matches on the path from its leaf to the root are replayed,
+     * which costs one comparison per level rather than the pop and push of a binary heap.
+     */
+    class MergeTree {
     public:
-        MergingComparator(const std::vector<RemoteCursorData>& remotes,
-                          const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+        MergeTree(const std::vector<RemoteCursorData>& remotes,
+                  const BSONObj& sort,
+                  bool compareWholeSortKey,
+                  bool compareKeyStrings)
+            : _remotes(remotes),
+              _sort(sort),
+              _compareWholeSortKey(compareWholeSortKey),
+              _compareKeyStrings(compareKeyStrings) {}
 
-        bool operator()(const size_t& lhs, const size_t& rhs);
+        /**
+         * Returns true if no remote has a buffered result.
+         */
+        bool empty() const;
+
+        /**
+         * Returns the index of the remote whose next buffered result sorts first. Invalid to call
+         * if empty().
+         */
+        size_t top() const;
+
+        /**
+         * Replays the matches of the remote at 'remoteIndex' after its next buffered result has
+         * changed, growing the tree first if the remote was added since it was last built.
+         */
+        void update(size_t remoteIndex);
 
     private:
+        /**
+         * Returns whichever of the remotes 'lhs' and 'rhs' has the next result which sorts first,
+         * or 'lhs' if they tie. Either may be kNoRemote.
+         */
+        size_t _play(size_t lhs, size_t rhs) const;
+
+        static constexpr size_t kNoRemote = std::numeric_limits<size_t>::max();
+
         const std::vector<RemoteCursorData>& _remotes;
 
         const BSONObj _sort;
@@ -339,6 +387,15 @@ private:
         // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
         // be {$sortKey: 1}.
         const bool _compareWholeSortKey;
+
+        // Whether to compare the remotes' 'sortKeyBuffer' entries rather than the BSON sort keys.
+        const bool _compareKeyStrings;
+
+        // The tree in heap order: the root is at position 1, the children of node 'i' are at
+        // '2 * i' and '2 * i + 1', and the leaf of remote 'r' is at '_numLeaves + r'. Each node
+        // holds the index of the winning remote, or kNoRemote if none of its remotes has a result.
+        size_t _numLeaves = 0;
+        std::vector<size_t> _nodes;
     };
 
     using MinSortKeyRemoteIdPair = std::pair<BSONObj, size_t>;
@@ -373,6 +430,13 @@ private:
      */
     Status _askForNextBatch(WithLock, size_t remoteIndex);
 
+    /**
+     * When merging sorted results, asks the remote at 'remoteIndex' for its next batch if the
+     * results buffered from it have dropped below the prefetch watermark, so that the batch arrives
+     * before the merge runs out of them.
+     */
+    void _prefetchNextBatchIfLow(WithLock, size_t remoteIndex);
+
     /**
      * Checks whether or not the remote cursors are all exhausted.
      */
@@ -493,9 +557,13 @@ private:
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
-    // The top of this priority queue is the index into '_remotes' for the remote host that has the
-    // next document to return, according to the sort order. Used only if there is a sort.
-    std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
+    // The ordering used to encode sort keys as KeyStrings, if there is a sort whose pattern has
+    // few enough fields to be encoded.
+    boost::optional<Ordering> _sortKeyOrdering;
+
+    // The top of this tree is the index into '_remotes' for the remote host that has the next
+    // document to return, according to the sort order. Used only if there is a sort.
+    MergeTree _mergeTree;
 
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
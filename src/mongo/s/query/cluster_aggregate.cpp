@@ -64,6 +64,7 @@
 #include "mongo/s/cluster_commands_helpers.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/multi_statement_transaction_requests_sender.h"
+#include "mongo/s/query/cluster_aggregate_result_cache.h"
 #include "mongo/s/query/cluster_aggregation_planner.h"
 #include "mongo/s/query/cluster_client_cursor_impl.h"
 #include "mongo/s/query/cluster_client_cursor_params.h"
@@ -335,6 +336,23 @@ Status ClusterAggregate::runAggregate(OperationContext* opCtx,
             opCtx, nullptr, namespaces.executionNss, boost::none, request.getLet());
     }
 
+    // A scatter-gather aggregation may be answered from the results of an identical aggregation
+    // which ran recently against the same routing table version.
+    boost::optional<std::string> resultCacheKey;
+    if (targeter.policy == cluster_aggregation_planner::AggregationTargeter::kAnyShard && cm &&
+        !hasChangeStream && involvedNamespaces.empty()) {
+        resultCacheKey = ClusterAggregateResultCache::makeKey(
+            opCtx, namespaces, request, *targeter.pipeline, *cm);
+    }
+
+    if (resultCacheKey) {
+        if (auto cursor = ClusterAggregateResultCache::get(opCtx).lookup(opCtx, *resultCacheKey)) {
+            result->append("cursor", *cursor);
+            liteParsedPipeline.tickGlobalStageCounters();
+            return Status::OK();
+        }
+    }
+
     if (request.getExplain()) {
         explain_common::generateServerInfo(result);
         explain_common::generateServerParameters(result);
@@ -399,6 +417,11 @@ Status ClusterAggregate::runAggregate(OperationContext* opCtx,
         // Report usage statistics for each stage in the pipeline.
         liteParsedPipeline.tickGlobalStageCounters();
 
+        if (resultCacheKey) {
+            ClusterAggregateResultCache::get(opCtx).insert(
+                opCtx, *resultCacheKey, result->asTempObj());
+        }
+
         // Add 'command' object to explain output.
         if (expCtx->explain) {
             explain_common::appendIfRoom(
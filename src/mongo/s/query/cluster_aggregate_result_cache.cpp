@@ -0,0 +1,282 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_aggregate_result_cache.h"
+
+#include "mongo/client/read_preference.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/pipeline/aggregation_request_helper.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/service_context.h"
+#include "mongo/s/chunk_manager.h"
+#include "mongo/s/query/cluster_query_knobs_gen.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace {
+
+const auto getClusterAggregateResultCache =
+    ServiceContext::declareDecoration<ClusterAggregateResultCache>();
+
+Counter64 resultCacheHits;
+Counter64 resultCacheMisses;
+ServerStatusMetricField<Counter64> displayResultCacheHits("mongos.aggregateResultCache.hits",
+                                                          &resultCacheHits);
+ServerStatusMetricField<Counter64> displayResultCacheMisses("mongos.aggregateResultCache.misses",
+                                                            &resultCacheMisses);
+
+// Stages whose output only depends on their input documents. The pipeline is serialized after it
+// has been optimized, so aliases such as $count and $sortByCount have already been desugared into
+// these stages.
+const StringDataSet kCacheableStages{"$addFields",
+                                     "$bucketAuto",
+                                     "$group",
+                                     "$limit",
+                                     "$match",
+                                     "$project",
+                                     "$redact",
+                                     "$replaceRoot",
+                                     "$set",
+                                     "$skip",
+                                     "$sort",
+                                     "$unwind"};
+
+// Expression operators whose results may differ between runs over the same documents.
+const StringDataSet kNonDeterministicOperators{"$accumulator", "$function", "$rand", "$where"};
+
+bool containsNonDeterministicExpression(const BSONObj& obj) {
+    for (auto&& elem : obj) {
+        if (kNonDeterministicOperators.count(elem.fieldNameStringData())) {
+            return true;
+        }
+
+        if (elem.type() == BSONType::String &&
+            (elem.valueStringData().startsWith("$$NOW") ||
+             elem.valueStringData().startsWith("$$CLUSTER_TIME"))) {
+            return true;
+        }
+
+        if (elem.isABSONObj() && containsNonDeterministicExpression(elem.Obj())) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}  // namespace
+
+ClusterAggregateResultCache& ClusterAggregateResultCache::get(ServiceContext* serviceContext) {
+    return getClusterAggregateResultCache(serviceContext);
+}
+
+ClusterAggregateResultCache& ClusterAggregateResultCache::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+boost::optional<std::string> ClusterAggregateResultCache::makeKey(
+    OperationContext* opCtx,
+    const ClusterAggregate::Namespaces& namespaces,
+    const AggregateCommandRequest& request,
+    const Pipeline& pipeline,
+    const ChunkManager& cm) {
+    if (internalQueryClusterAggregateResultCacheMaxSizeBytes.load() <= 0) {
+        return boost::none;
+    }
+
+    if (request.getExplain() || opCtx->inMultiDocumentTransaction()) {
+        return boost::none;
+    }
+
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    if (readConcernArgs.getArgsAtClusterTime() || readConcernArgs.getArgsOpTime()) {
+        return boost::none;
+    }
+
+    switch (readConcernArgs.getLevel()) {
+        case repl::ReadConcernLevel::kLocalReadConcern:
+        case repl::ReadConcernLevel::kMajorityReadConcern:
+        case repl::ReadConcernLevel::kAvailableReadConcern:
+            break;
+        default:
+            return boost::none;
+    }
+
+    auto serializedPipeline = pipeline.serializeToBson();
+    if (!isCacheablePipeline(serializedPipeline)) {
+        return boost::none;
+    }
+
+    const auto& let = request.getLet();
+    if (let && containsNonDeterministicExpression(*let)) {
+        return boost::none;
+    }
+
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("ns", namespaces.executionNss.ns());
+    keyBuilder.append("requestedNs", namespaces.requestedNss.ns());
+    keyBuilder.append("pipeline", serializedPipeline);
+    keyBuilder.append("collation", pipeline.getContext()->getCollatorBSON());
+    if (let) {
+        keyBuilder.append("let", *let);
+    }
+    keyBuilder.append("batchSize",
+                      request.getCursor().getBatchSize().value_or(
+                          aggregation_request_helper::kDefaultBatchSize));
+    keyBuilder.append("readConcern",
+                      repl::readConcernLevels::toString(readConcernArgs.getLevel()));
+
+    // Reads which may target secondaries can observe older data than reads from the primaries, so
+    // only aggregations which are eligible to read from the same members share entries. Hedging
+    // does not change which members are eligible.
+    const auto& readPref = ReadPreferenceSetting::get(opCtx);
+    {
+        BSONObjBuilder readPrefBuilder(keyBuilder.subobjStart("readPreference"));
+        readPrefBuilder.append("mode", ReadPreference_serializer(readPref.pref));
+        readPrefBuilder.append("tags", readPref.tags.getTagBSON());
+        readPrefBuilder.append("maxStalenessSeconds",
+                               durationCount<Seconds>(readPref.maxStalenessSeconds));
+    }
+
+    if (cm.isSharded()) {
+        cm.getVersion().appendWithField(&keyBuilder, "version");
+    } else {
+        keyBuilder.append("dbVersion", cm.dbVersion().toBSON());
+    }
+
+    auto key = keyBuilder.done();
+    return std::string(key.objdata(), key.objsize());
+}
+
+bool ClusterAggregateResultCache::isCacheablePipeline(
+    const std::vector<BSONObj>& serializedPipeline) {
+    for (const auto& stage : serializedPipeline) {
+        if (!kCacheableStages.count(stage.firstElementFieldNameStringData())) {
+            return false;
+        }
+
+        if (containsNonDeterministicExpression(stage)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+boost::optional<BSONObj> ClusterAggregateResultCache::lookup(OperationContext* opCtx,
+                                                             const std::string& key) {
+    const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
+    const auto staleness =
+        Milliseconds(internalQueryClusterAggregateResultCacheStalenessMillis.load());
+    const auto afterClusterTime = repl::ReadConcernArgs::get(opCtx).getArgsAfterClusterTime();
+
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    auto it = _cache.find(key);
+    if (it == _cache.end()) {
+        resultCacheMisses.increment();
+        return boost::none;
+    }
+
+    if (now - it->second.cachedAt > staleness) {
+        _erase(lk, it);
+        resultCacheMisses.increment();
+        return boost::none;
+    }
+
+    // An entry produced without reading at a cluster time, or at an earlier one, may not reflect
+    // writes the client has already observed.
+    if (afterClusterTime &&
+        (!it->second.afterClusterTime || *it->second.afterClusterTime < *afterClusterTime)) {
+        resultCacheMisses.increment();
+        return boost::none;
+    }
+
+    resultCacheHits.increment();
+    return _cache.promote(it)->second.cursor;
+}
+
+void ClusterAggregateResultCache::insert(OperationContext* opCtx,
+                                         const std::string& key,
+                                         const BSONObj& reply) {
+    auto cursorElem = reply["cursor"];
+    if (cursorElem.type() != BSONType::Object || reply.hasField("writeConcernError")) {
+        return;
+    }
+
+    // A non-zero cursor id means the remaining results are still held by an open cursor.
+    auto cursor = cursorElem.Obj();
+    if (cursor["id"].safeNumberLong() != 0) {
+        return;
+    }
+
+    const auto maxSizeBytes =
+        size_t(internalQueryClusterAggregateResultCacheMaxSizeBytes.load());
+    const auto entrySizeBytes = key.size() + size_t(cursor.objsize()) + sizeof(Entry);
+    if (entrySizeBytes > maxSizeBytes) {
+        return;
+    }
+
+    Entry entry{cursor.getOwned(),
+                opCtx->getServiceContext()->getFastClockSource()->now(),
+                repl::ReadConcernArgs::get(opCtx).getArgsAfterClusterTime(),
+                entrySizeBytes};
+
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    if (auto it = _cache.find(key); it != _cache.end()) {
+        _erase(lk, it);
+    }
+
+    _cache.add(key, std::move(entry));
+    _sizeBytes += entrySizeBytes;
+
+    // The server parameter may have been lowered since the last insert, so this may need to evict
+    // more than one entry.
+    while (_sizeBytes > maxSizeBytes) {
+        _erase(lk, std::prev(_cache.end()));
+    }
+}
+
+size_t ClusterAggregateResultCache::getSizeBytes() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _sizeBytes;
+}
+
+void ClusterAggregateResultCache::_erase(WithLock, Cache::iterator it) {
+    _sizeBytes -= it->second.sizeBytes;
+    _cache.erase(it);
+}
+
+}  // namespace mongo
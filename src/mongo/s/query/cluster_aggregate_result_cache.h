@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/logical_time.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/s/query/cluster_aggregate.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/lru_cache.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ChunkManager;
+class OperationContext;
+class Pipeline;
+class ServiceContext;
+
+/**
+ * Decoration on ServiceContext which caches the results of scatter-gather aggregations on mongos.
+ *
+ * Only aggregations whose complete result set was returned in the first batch are cached, so an
+ * entry is the 'cursor' field of the original reply. Entries are keyed by the normalized pipeline,
+ * the read concern and read preference, and the routing table version of the collection being
+ * aggregated, which makes entries for older routing table versions unreachable once the routing
+ * table changes. An entry is served for at most
+ * internalQueryClusterAggregateResultCacheStalenessMillis after it was cached, and the least
+ * recently used entries are evicted to keep the total size of the cache under
+ * internalQueryClusterAggregateResultCacheMaxSizeBytes.
+ *
+ * Instances of this class are thread-safe.
+ */
+class ClusterAggregateResultCache {
+    ClusterAggregateResultCache(const ClusterAggregateResultCache&) = delete;
+    ClusterAggregateResultCache& operator=(const ClusterAggregateResultCache&) = delete;
+
+public:
+    ClusterAggregateResultCache() = default;
+
+    static ClusterAggregateResultCache& get(ServiceContext* serviceContext);
+    static ClusterAggregateResultCache& get(OperationContext* opCtx);
+
+    /**
+     * Returns the key to cache the results of 'pipeline' under, or boost::none if the cache is
+     * disabled or the results of this aggregation must not be cached. Results aren't cached for
+     * explains, transactions, reads at a specific cluster time or with snapshot or linearizable
+     * read concern, or pipelines containing stages or expressions that aren't deterministic or
+     * read from other collections.
+     */
+    static boost::optional<std::string> makeKey(OperationContext* opCtx,
+                                                const ClusterAggregate::Namespaces& namespaces,
+                                                const AggregateCommandRequest& request,
+                                                const Pipeline& pipeline,
+                                                const ChunkManager& cm);
+
+    /**
+     * Returns true if every stage of the serialized pipeline only depends on the documents in the
+     * collection being aggregated, such that rerunning it against the same data gives the same
+     * results.
+     */
+    static bool isCacheablePipeline(const std::vector<BSONObj>& serializedPipeline);
+
+    /**
+     * Returns the cached 'cursor' reply for 'key', or boost::none if there is no entry which is
+     * still fresh enough. If the operation's read concern specifies an afterClusterTime, only an
+     * entry cached by an aggregation which read at or after that cluster time is returned.
+     */
+    boost::optional<BSONObj> lookup(OperationContext* opCtx, const std::string& key);
+
+    /**
+     * Caches the 'cursor' field of the aggregation reply 'reply' under 'key' if the reply holds the
+     * aggregation's complete result set and fits in the cache.
+     */
+    void insert(OperationContext* opCtx, const std::string& key, const BSONObj& reply);
+
+    /**
+     * Returns the total size in bytes of the cached entries.
+     */
+    size_t getSizeBytes() const;
+
+private:
+    struct Entry {
+        BSONObj cursor;
+        Date_t cachedAt;
+
+        // The afterClusterTime the aggregation which produced this entry read at, if any.
+        boost::optional<LogicalTime> afterClusterTime;
+
+        // The number of bytes this entry counts for towards the size of the cache.
+        size_t sizeBytes;
+    };
+
+    using Cache = LRUCache<std::string, Entry>;
+
+    // Removes 'it' from the cache and subtracts its size from _sizeBytes.
+    void _erase(WithLock, Cache::iterator it);
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ClusterAggregateResultCache::_mutex");
+
+    // Eviction is driven by _sizeBytes rather than the number of entries.
+    Cache _cache{std::numeric_limits<size_t>::max()};
+
+    size_t _sizeBytes{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,255 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_aggregate_result_cache.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/client/read_preference.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/chunk_manager.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.collection");
+
+class ClusterAggregateResultCacheTest : public ServiceContextTest {
+protected:
+    ClusterAggregateResultCacheTest() {
+        auto clockSource = std::make_unique<ClockSourceMock>();
+        _clockSource = clockSource.get();
+        getServiceContext()->setFastClockSource(std::move(clockSource));
+    }
+
+    OperationContext* opCtx() const {
+        return _opCtx.get();
+    }
+
+    ClusterAggregateResultCache& cache() {
+        return ClusterAggregateResultCache::get(getServiceContext());
+    }
+
+    void advanceTime(Milliseconds duration) {
+        _clockSource->advance(duration);
+    }
+
+    static BSONObj makeReply(CursorId cursorId, std::vector<BSONObj> batch) {
+        return CursorResponse(kNss, cursorId, std::move(batch))
+            .toBSON(CursorResponse::ResponseType::InitialResponse);
+    }
+
+    static ChunkManager makeChunkManager(const OID& epoch, uint32_t majorVersion) {
+        std::vector<ChunkType> chunks = {
+            ChunkType{kNss,
+                      ChunkRange{BSON("a" << MINKEY), BSON("a" << MAXKEY)},
+                      ChunkVersion(majorVersion, 0, epoch, boost::none /* timestamp */),
+                      ShardId("shard0")}};
+
+        auto rt = RoutingTableHistory::makeNew(kNss,
+                                               UUID::gen(),
+                                               BSON("a" << 1),
+                                               nullptr /* defaultCollator */,
+                                               false /* unique */,
+                                               epoch,
+                                               boost::none /* timestamp */,
+                                               boost::none /* timeseriesFields */,
+                                               boost::none /* reshardingFields */,
+                                               true /* allowMigrations */,
+                                               chunks);
+
+        const auto version = rt.getVersion();
+        return ChunkManager(ShardId("shard0"),
+                            DatabaseVersion(UUID::gen()),
+                            RoutingTableHistoryValueHandle(
+                                std::move(rt),
+                                ComparableChunkVersion::makeComparableChunkVersion(version)),
+                            boost::none /* clusterTime */);
+    }
+
+    boost::optional<std::string> makeKey(const std::vector<BSONObj>& rawPipeline,
+                                         const ChunkManager& cm) {
+        AggregateCommandRequest request(kNss, rawPipeline);
+        auto expCtx = make_intrusive<ExpressionContextForTest>(opCtx(), kNss);
+        auto pipeline = Pipeline::parse(rawPipeline, expCtx);
+        return ClusterAggregateResultCache::makeKey(
+            opCtx(), {kNss, kNss}, request, *pipeline, cm);
+    }
+
+private:
+    ServiceContext::UniqueOperationContext _opCtx{makeOperationContext()};
+
+    ClockSourceMock* _clockSource;
+
+    RAIIServerParameterControllerForTest _maxSizeController{
+        "internalQueryClusterAggregateResultCacheMaxSizeBytes", 1024LL * 1024};
+    RAIIServerParameterControllerForTest _stalenessController{
+        "internalQueryClusterAggregateResultCacheStalenessMillis", 1000};
+};
+
+TEST_F(ClusterAggregateResultCacheTest, OnlyDeterministicPipelinesAreCacheable) {
+    ASSERT_TRUE(ClusterAggregateResultCache::isCacheablePipeline(
+        {fromjson("{$match: {a: {$gt: 1}}}"),
+         fromjson("{$group: {_id: '$b', total: {$sum: '$c'}}}"),
+         fromjson("{$sort: {total: -1}}"),
+         fromjson("{$limit: 10}")}));
+
+    ASSERT_FALSE(
+        ClusterAggregateResultCache::isCacheablePipeline({fromjson("{$sample: {size: 5}}")}));
+    ASSERT_FALSE(ClusterAggregateResultCache::isCacheablePipeline(
+        {fromjson("{$lookup: {from: 'other', localField: 'a', foreignField: 'b', as: 'c'}}")}));
+    ASSERT_FALSE(ClusterAggregateResultCache::isCacheablePipeline(
+        {fromjson("{$addFields: {now: '$$NOW'}}")}));
+    ASSERT_FALSE(ClusterAggregateResultCache::isCacheablePipeline(
+        {fromjson("{$match: {$expr: {$lt: [{$rand: {}}, 0.5]}}}")}));
+}
+
+TEST_F(ClusterAggregateResultCacheTest, ReturnsCachedCursorUntilStale) {
+    auto reply = makeReply(0, {BSON("_id" << 1), BSON("_id" << 2)});
+    cache().insert(opCtx(), "key", reply);
+
+    auto cursor = cache().lookup(opCtx(), "key");
+    ASSERT(cursor);
+    ASSERT_BSONOBJ_EQ(*cursor, reply["cursor"].Obj());
+    ASSERT_FALSE(cache().lookup(opCtx(), "otherKey"));
+
+    advanceTime(Milliseconds(1001));
+    ASSERT_FALSE(cache().lookup(opCtx(), "key"));
+    ASSERT_EQ(cache().getSizeBytes(), 0U);
+}
+
+TEST_F(ClusterAggregateResultCacheTest, DoesNotCacheOpenCursors) {
+    cache().insert(opCtx(), "key", makeReply(123, {BSON("_id" << 1)}));
+    ASSERT_FALSE(cache().lookup(opCtx(), "key"));
+}
+
+TEST_F(ClusterAggregateResultCacheTest, EvictsLeastRecentlyUsedEntriesOverSizeLimit) {
+    auto reply = makeReply(0, {BSON("_id" << 1 << "pad" << std::string(200, 'x'))});
+
+    cache().insert(opCtx(), "key1", reply);
+    const auto entrySizeBytes = cache().getSizeBytes();
+
+    RAIIServerParameterControllerForTest controller{
+        "internalQueryClusterAggregateResultCacheMaxSizeBytes",
+        static_cast<long long>(entrySizeBytes * 2)};
+
+    cache().insert(opCtx(), "key2", reply);
+    ASSERT(cache().lookup(opCtx(), "key1"));
+
+    // Inserting a third entry evicts "key2", which was used less recently than "key1".
+    cache().insert(opCtx(), "key3", reply);
+    ASSERT(cache().lookup(opCtx(), "key1"));
+    ASSERT_FALSE(cache().lookup(opCtx(), "key2"));
+    ASSERT(cache().lookup(opCtx(), "key3"));
+    ASSERT_EQ(cache().getSizeBytes(), entrySizeBytes * 2);
+}
+
+TEST_F(ClusterAggregateResultCacheTest, AfterClusterTimeRequiresEntryReadAtLaterClusterTime) {
+    auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx());
+    cache().insert(opCtx(), "key", makeReply(0, {BSON("_id" << 1)}));
+
+    readConcernArgs = repl::ReadConcernArgs(LogicalTime(Timestamp(10, 1)),
+                                            repl::ReadConcernLevel::kMajorityReadConcern);
+    ASSERT_FALSE(cache().lookup(opCtx(), "key"));
+
+    cache().insert(opCtx(), "key", makeReply(0, {BSON("_id" << 1)}));
+    ASSERT(cache().lookup(opCtx(), "key"));
+
+    readConcernArgs = repl::ReadConcernArgs(LogicalTime(Timestamp(5, 1)),
+                                            repl::ReadConcernLevel::kMajorityReadConcern);
+    ASSERT(cache().lookup(opCtx(), "key"));
+
+    readConcernArgs = repl::ReadConcernArgs(LogicalTime(Timestamp(20, 1)),
+                                            repl::ReadConcernLevel::kMajorityReadConcern);
+    ASSERT_FALSE(cache().lookup(opCtx(), "key"));
+}
+
+TEST_F(ClusterAggregateResultCacheTest, MakeKeyIncludesRoutingTableVersion) {
+    const std::vector<BSONObj> rawPipeline{fromjson("{$match: {a: 1}}")};
+    const auto epoch = OID::gen();
+
+    auto key = makeKey(rawPipeline, makeChunkManager(epoch, 1));
+    ASSERT(key);
+    ASSERT_EQ(*key, *makeKey(rawPipeline, makeChunkManager(epoch, 1)));
+
+    // A chunk migration or split bumps the collection version, so the entries cached before it
+    // are not served anymore.
+    ASSERT_NE(*key, *makeKey(rawPipeline, makeChunkManager(epoch, 2)));
+    ASSERT_NE(*key, *makeKey(rawPipeline, makeChunkManager(OID::gen(), 1)));
+}
+
+TEST_F(ClusterAggregateResultCacheTest, MakeKeyIncludesReadPreference) {
+    const std::vector<BSONObj> rawPipeline{fromjson("{$match: {a: 1}}")};
+    const auto cm = makeChunkManager(OID::gen(), 1);
+    auto& readPref = ReadPreferenceSetting::get(opCtx());
+
+    const auto primaryKey = makeKey(rawPipeline, cm);
+    ASSERT(primaryKey);
+
+    readPref = ReadPreferenceSetting(ReadPreference::SecondaryPreferred);
+    const auto secondaryKey = makeKey(rawPipeline, cm);
+    ASSERT(secondaryKey);
+    ASSERT_NE(*primaryKey, *secondaryKey);
+
+    readPref = ReadPreferenceSetting(ReadPreference::SecondaryPreferred,
+                                     TagSet(BSON_ARRAY(BSON("dc"
+                                                            << "east"))));
+    const auto taggedKey = makeKey(rawPipeline, cm);
+    ASSERT(taggedKey);
+    ASSERT_NE(*secondaryKey, *taggedKey);
+
+    readPref = ReadPreferenceSetting(ReadPreference::SecondaryPreferred, Seconds(120));
+    ASSERT_NE(*secondaryKey, *makeKey(rawPipeline, cm));
+
+    readPref = ReadPreferenceSetting(ReadPreference::PrimaryOnly);
+    ASSERT_EQ(*primaryKey, *makeKey(rawPipeline, cm));
+}
+
+TEST_F(ClusterAggregateResultCacheTest, MakeKeyRejectsUncacheableAggregations) {
+    const auto cm = makeChunkManager(OID::gen(), 1);
+
+    ASSERT_FALSE(makeKey({fromjson("{$sample: {size: 5}}")}, cm));
+
+    repl::ReadConcernArgs::get(opCtx()) =
+        repl::ReadConcernArgs(repl::ReadConcernLevel::kSnapshotReadConcern);
+    ASSERT_FALSE(makeKey({fromjson("{$match: {a: 1}}")}, cm));
+}
+
+}  // namespace
+}  // namespace mongo
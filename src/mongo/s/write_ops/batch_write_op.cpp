@@ -310,6 +310,27 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
+    // The documents of an unordered insert are all targeted up front, so that the targeter can
+    // resolve them in one pass over the routing table. Their batches are then remembered by
+    // endpoint position, so that adding each document to its batch does not search 'batchMap'.
+    // Ordered batches stop at the first document which goes to another shard, so they keep
+    // targeting one document at a time.
+    boost::optional<NSTargeter::TargetedInserts> preTargetedInserts;
+    std::vector<TargetedWriteBatch*> preTargetedBatches;
+    size_t nextPreTargetedInsert = 0;
+
+    if (!ordered && _clientRequest.getBatchType() == BatchedCommandRequest::BatchType_Insert) {
+        std::vector<BSONObj> docs;
+        for (auto& writeOp : _writeOps) {
+            if (writeOp.getWriteState() == WriteOpState_Ready)
+                docs.push_back(writeOp.getWriteItem().getDocument());
+        }
+
+        preTargetedInserts = targeter.targetInserts(_opCtx, docs);
+        invariant(preTargetedInserts->endpointIndexes.size() == docs.size());
+        preTargetedBatches.resize(preTargetedInserts->endpoints.size(), nullptr);
+    }
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -325,9 +346,21 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         OwnedPointerVector<TargetedWrite> writesOwned;
         std::vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
+        // The slot remembering the batch for this write's endpoint, if it was targeted up front.
+        TargetedWriteBatch** preTargetedBatch = nullptr;
+
         Status targetStatus = Status::OK();
         try {
-            writeOp.targetWrites(_opCtx, targeter, &writes);
+            if (preTargetedInserts) {
+                const auto& swEndpointIndex =
+                    preTargetedInserts->endpointIndexes[nextPreTargetedInsert++];
+                const size_t endpointIndex = uassertStatusOK(swEndpointIndex);
+                writeOp.targetWrites(
+                    _opCtx, preTargetedInserts->endpoints[endpointIndex], &writes);
+                preTargetedBatch = &preTargetedBatches[endpointIndex];
+            } else {
+                writeOp.targetWrites(_opCtx, targeter, &writes);
+            }
         } catch (const DBException& ex) {
             targetStatus = ex.toStatus();
         }
@@ -399,8 +432,22 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         const int errorResponsePotentialSizeBytes =
             ordered ? 0 : write_ops::kWriteCommandBSONArrayPerElementOverheadBytes + 256;
 
-        if (wouldMakeBatchesTooBig(
-                writes, std::max(writeSizeBytes, errorResponsePotentialSizeBytes), batchMap)) {
+        const int batchWriteSizeBytes = std::max(writeSizeBytes, errorResponsePotentialSizeBytes);
+
+        if (preTargetedBatch && *preTargetedBatch && writes.size() == 1u) {
+            // This write joins a batch created earlier in this call for the same endpoint.
+            TargetedWriteBatch* batch = *preTargetedBatch;
+            if (batch->getEstimatedSizeBytes() + batchWriteSizeBytes > BSONObjMaxUserSize) {
+                writeOp.cancelWrites(nullptr);
+                break;
+            }
+
+            batch->addWrite(writes.front(), batchWriteSizeBytes);
+            writesOwned.mutableVector().clear();
+            continue;
+        }
+
+        if (wouldMakeBatchesTooBig(writes, batchWriteSizeBytes, batchMap)) {
             invariant(!batchMap.empty());
             writeOp.cancelWrites(nullptr);
             break;
@@ -425,7 +472,11 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
             }
 
             TargetedWriteBatch* batch = batchIt->second;
-            batch->addWrite(write, std::max(writeSizeBytes, errorResponsePotentialSizeBytes));
+            batch->addWrite(write, batchWriteSizeBytes);
+
+            if (preTargetedBatch) {
+                *preTargetedBatch = batch;
+            }
         }
 
         // Relinquish ownership of TargetedWrites, now the TargetedBatches own them
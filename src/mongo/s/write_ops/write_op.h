@@ -123,6 +123,14 @@ public:
                       const NSTargeter& targeter,
                       std::vector<TargetedWrite*>* targetedWrites);
 
+    /**
+     * Same as targetWrites(), but for an insert whose endpoint has already been resolved through
+     * NSTargeter::targetInserts().
+     */
+    void targetWrites(OperationContext* opCtx,
+                      ShardEndpoint endpoint,
+                      std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Returns the number of child writes that were last targeted.
      */
@@ -166,6 +174,13 @@ private:
      */
     void _updateOpState();
 
+    /**
+     * Creates a TargetedWrite for each of 'endpoints' on which this write has not yet succeeded.
+     */
+    void _addTargetedWrites(OperationContext* opCtx,
+                            std::vector<ShardEndpoint> endpoints,
+                            std::vector<TargetedWrite*>* targetedWrites);
+
     // Owned elsewhere, reference to a batch with a write item
     const BatchItemRef _itemRef;
 